@@ -0,0 +1,1262 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Throughput benchmarks for every decoder and encoder, the bit primitives and
+ * the MSM mask utilities.
+ *
+ * Every case runs over an in-memory corpus generated from a fixed seed, so the
+ * numbers are comparable between runs and library versions. The MSM cases are
+ * repeated for several cell counts, from a sparse message to a full 64 cell
+ * one.
+ *
+ *   rtcm_bench [--json] [--filter <substring>] [--min-time <seconds>]
+ */
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#else
+#define BENCH_HAVE_TSC 0
+#endif
+
+#include "rtcm3/bits.h"
+#include "rtcm3/constants.h"
+#include "rtcm3/decode.h"
+#include "rtcm3/encode.h"
+#include "rtcm3/eph_cache.h"
+#include "rtcm3/eph_decode.h"
+#include "rtcm3/eph_encode.h"
+#include "rtcm3/eph_store.h"
+#include "rtcm3/messages.h"
+#include "rtcm3/msm_utils.h"
+#include "rtcm3/sbp_tunnel.h"
+#include "rtcm3/ssr_decode.h"
+#include "rtcm3/ssr_encode.h"
+#include "rtcm3/station_registry.h"
+
+#define BENCH_CORPUS_SIZE 32
+#define BENCH_MAX_MSG_LEN 1024
+#define BENCH_BIT_OPS 256
+#define BENCH_MAX_CASES 160
+#define BENCH_DEFAULT_MIN_TIME_S 0.2
+#define BENCH_SEED 0x5eed5eed5eed5eedULL
+
+typedef union {
+  rtcm_obs_message obs;
+  rtcm_msm_message msm;
+  rtcm_msg_1005 msg_1005;
+  rtcm_msg_1006 msg_1006;
+  rtcm_msg_1007 msg_1007;
+  rtcm_msg_1008 msg_1008;
+  rtcm_msg_1029 msg_1029;
+  rtcm_msg_1033 msg_1033;
+  rtcm_msg_1230 msg_1230;
+  rtcm_msg_eph eph;
+  rtcm_msg_swift_proprietary msg_4062;
+  rtcm_msg_orbit orbit;
+  rtcm_msg_clock clock;
+  rtcm_msg_orbit_clock orbit_clock;
+  rtcm_msg_code_bias code_bias;
+  rtcm_msg_phase_bias phase_bias;
+} bench_msg;
+
+/* A set of encoded messages together with the structs they were encoded
+ * from, the structs are only filled in for the types that have an encoder */
+typedef struct {
+  uint8_t buff[BENCH_CORPUS_SIZE][BENCH_MAX_MSG_LEN];
+  uint16_t len[BENCH_CORPUS_SIZE];
+  bench_msg msg[BENCH_CORPUS_SIZE];
+} bench_corpus;
+
+struct bench_case_s;
+
+/* Run operation `index` of a case, returns the number of payload bits it
+ * processed or 0 on failure */
+typedef uint32_t (*bench_op)(const struct bench_case_s *c, uint16_t index);
+
+typedef struct bench_case_s {
+  char name[48];
+  const char *group;
+  uint8_t cells;
+  uint16_t ops_per_pass;
+  bench_op op;
+  const bench_corpus *corpus;
+} bench_case;
+
+typedef struct {
+  bool json;
+  const char *filter;
+  double min_time_s;
+} bench_options;
+
+static bench_case cases_[BENCH_MAX_CASES];
+static uint16_t num_cases_ = 0;
+
+/* scratch space for the decoders and encoders */
+static bench_msg scratch_msg_;
+static uint8_t scratch_buff_[BENCH_MAX_MSG_LEN];
+/* repeated ephemerides go through the store, which decodes each only once */
+static rtcm3_eph_store eph_store_;
+/* station metadata repeats too and is only decoded when it changes */
+static rtcm3_station_registry station_registry_;
+/* rebroadcasts of unchanged ephemerides are served as cached frames */
+static rtcm3_eph_cache eph_cache_;
+/* high rate clocks are decoded straight into a satellite table */
+static rtcm3_ssr_clock_table ssr_clocks_;
+static uint8_t bit_buff_[BENCH_MAX_MSG_LEN];
+static bool masks_[BENCH_CORPUS_SIZE][MSM_SATELLITE_MASK_SIZE];
+/* keeps the results of the operations alive */
+static volatile uint64_t sink_;
+
+static uint64_t prng_state_ = BENCH_SEED;
+
+/* xorshift64*, deterministic so every run sees the same corpus */
+static uint64_t prng_next(void) {
+  prng_state_ ^= prng_state_ >> 12;
+  prng_state_ ^= prng_state_ << 25;
+  prng_state_ ^= prng_state_ >> 27;
+  return prng_state_ * 0x2545F4914F6CDD1DULL;
+}
+
+static uint32_t prng_range(uint32_t max) {
+  return (uint32_t)(prng_next() % max);
+}
+
+static double prng_uniform(double low, double high) {
+  return low + (high - low) * (double)(prng_next() >> 11) / 9007199254740992.0;
+}
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void) {
+#if BENCH_HAVE_TSC
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
+
+static bench_corpus *new_corpus(void) {
+  bench_corpus *corpus = calloc(1, sizeof(bench_corpus));
+  if (NULL == corpus) {
+    fprintf(stderr, "out of memory\n");
+    exit(EXIT_FAILURE);
+  }
+  return corpus;
+}
+
+static bench_case *add_case(const char *group,
+                            const char *name,
+                            uint8_t cells,
+                            bench_op op,
+                            const bench_corpus *corpus) {
+  if (num_cases_ >= BENCH_MAX_CASES) {
+    fprintf(stderr, "too many benchmark cases\n");
+    exit(EXIT_FAILURE);
+  }
+  bench_case *c = &cases_[num_cases_++];
+  memset(c, 0, sizeof(*c));
+  snprintf(c->name, sizeof(c->name), "%s", name);
+  c->group = group;
+  c->cells = cells;
+  c->ops_per_pass = BENCH_CORPUS_SIZE;
+  c->op = op;
+  c->corpus = corpus;
+  return c;
+}
+
+/* Corpus generation */
+
+static void make_obs(rtcm_obs_message *msg,
+                     uint16_t msg_num,
+                     uint8_t num_sats) {
+  bool glo = (1010 == msg_num || 1012 == msg_num);
+  double l1_hz = glo ? GLO_L1_HZ : GPS_L1_HZ;
+  double l2_hz = glo ? GLO_L2_HZ : GPS_L2_HZ;
+  memset(msg, 0, sizeof(*msg));
+  msg->header.msg_num = msg_num;
+  msg->header.stn_id = (uint16_t)prng_range(4096);
+  msg->header.tow_ms = glo ? prng_range(RTCM_GLO_MAX_TOW_MS)
+                           : prng_range(RTCM_MAX_TOW_MS);
+  msg->header.sync = 1;
+  msg->header.n_sat = num_sats;
+  for (uint8_t i = 0; i < num_sats; i++) {
+    rtcm_sat_data *sat = &msg->sats[i];
+    sat->svId = i + 1;
+    sat->fcn = (uint8_t)prng_range(MSM_GLO_MAX_FCN + 1);
+    double range_m = prng_uniform(20e6, 25e6);
+    for (uint8_t freq = 0; freq < NUM_FREQS; freq++) {
+      rtcm_freq_data *obs = &sat->obs[freq];
+      double freq_hz = (L1_FREQ == freq) ? l1_hz : l2_hz;
+      obs->code = 0;
+      obs->pseudorange = range_m + prng_uniform(-5.0, 5.0);
+      obs->carrier_phase = obs->pseudorange / (GPS_C / freq_hz);
+      obs->lock = prng_uniform(0, 900);
+      obs->cnr = prng_uniform(30, 50);
+      obs->flags.valid_pr = 1;
+      obs->flags.valid_cp = 1;
+      obs->flags.valid_lock = 1;
+      obs->flags.valid_cnr = 1;
+    }
+  }
+}
+
+static void make_msm(rtcm_msm_message *msg,
+                     uint16_t msg_num,
+                     uint8_t num_sats,
+                     uint8_t num_sigs) {
+  memset(msg, 0, sizeof(*msg));
+  rtcm_msm_header *header = &msg->header;
+  header->msg_num = msg_num;
+  header->stn_id = (uint16_t)prng_range(4096);
+  header->tow_ms = prng_range(RTCM_MAX_TOW_MS);
+  header->iods = (uint8_t)prng_range(8);
+  for (uint8_t i = 0; i < num_sats; i++) {
+    header->satellite_mask[(i * 3) % MSM_SATELLITE_MASK_SIZE] = true;
+  }
+  for (uint8_t i = 0; i < num_sigs; i++) {
+    header->signal_mask[(i * 7 + 1) % MSM_SIGNAL_MASK_SIZE] = true;
+  }
+  uint8_t num_cells = num_sats * num_sigs;
+  for (uint8_t i = 0; i < num_cells; i++) {
+    header->cell_mask[i] = true;
+  }
+  for (uint8_t sat = 0; sat < num_sats; sat++) {
+    double range_ms = prng_uniform(65, 85);
+    double rate_m_s = prng_uniform(-800, 800);
+    msg->sats[sat].rough_range_ms = round(range_ms * 1024) / 1024;
+    msg->sats[sat].rough_range_rate_m_s = round(rate_m_s);
+    for (uint8_t sig = 0; sig < num_sigs; sig++) {
+      rtcm_msm_signal_data *data = &msg->signals[sat * num_sigs + sig];
+      data->pseudorange_ms = range_ms + prng_uniform(-1e-4, 1e-4);
+      data->carrier_phase_ms = data->pseudorange_ms;
+      data->lock_time_s = prng_uniform(0, 900);
+      data->cnr = prng_uniform(30, 50);
+      data->range_rate_m_s = rate_m_s + prng_uniform(-0.5, 0.5);
+      data->flags.valid_pr = 1;
+      data->flags.valid_cp = 1;
+      data->flags.valid_lock = 1;
+      data->flags.valid_cnr = 1;
+      data->flags.valid_dop = 1;
+    }
+  }
+}
+
+static void make_string(char str[], uint8_t *len) {
+  *len = (uint8_t)(8 + prng_range(RTCM_MAX_STRING_LEN - 8));
+  for (uint8_t i = 0; i < *len; i++) {
+    str[i] = (char)('A' + prng_range(26));
+  }
+}
+
+static void make_station(bench_msg *msg, uint16_t msg_num) {
+  memset(msg, 0, sizeof(*msg));
+  switch (msg_num) {
+    case 1005:
+    case 1006: {
+      rtcm_msg_1005 *msg_1005 = &msg->msg_1006.msg_1005;
+      msg_1005->stn_id = (uint16_t)prng_range(4096);
+      msg_1005->GPS_ind = 1;
+      msg_1005->GLO_ind = 1;
+      msg_1005->ref_stn_ind = 1;
+      msg_1005->arp_x = round(prng_uniform(-6e6, 6e6) * 1e4) / 1e4;
+      msg_1005->arp_y = round(prng_uniform(-6e6, 6e6) * 1e4) / 1e4;
+      msg_1005->arp_z = round(prng_uniform(-6e6, 6e6) * 1e4) / 1e4;
+      msg->msg_1006.ant_height = round(prng_uniform(0, 6) * 1e4) / 1e4;
+      break;
+    }
+    case 1007:
+    case 1008: {
+      rtcm_msg_1007 *msg_1007 = &msg->msg_1008.msg_1007;
+      msg_1007->stn_id = (uint16_t)prng_range(4096);
+      make_string(msg_1007->ant_descriptor, &msg_1007->ant_descriptor_counter);
+      make_string(msg->msg_1008.ant_serial_num,
+                  &msg->msg_1008.ant_serial_num_counter);
+      break;
+    }
+    case 1029: {
+      rtcm_msg_1029 *msg_1029 = &msg->msg_1029;
+      msg_1029->stn_id = (uint16_t)prng_range(4096);
+      msg_1029->mjd_num = (uint16_t)(58000 + prng_range(1000));
+      msg_1029->utc_sec_of_day = prng_range(86400);
+      msg_1029->utf8_code_units_n = (uint8_t)(32 + prng_range(96));
+      msg_1029->unicode_chars = msg_1029->utf8_code_units_n;
+      for (uint8_t i = 0; i < msg_1029->utf8_code_units_n; i++) {
+        msg_1029->utf8_code_units[i] = (uint8_t)(' ' + prng_range(94));
+      }
+      break;
+    }
+    case 1033: {
+      rtcm_msg_1033 *msg_1033 = &msg->msg_1033;
+      msg_1033->stn_id = (uint16_t)prng_range(4096);
+      make_string(msg_1033->ant_descriptor, &msg_1033->ant_descriptor_counter);
+      make_string(msg_1033->ant_serial_num, &msg_1033->ant_serial_num_counter);
+      make_string(msg_1033->rcv_descriptor, &msg_1033->rcv_descriptor_counter);
+      make_string(msg_1033->rcv_fw_version, &msg_1033->rcv_fw_version_counter);
+      make_string(msg_1033->rcv_serial_num, &msg_1033->rcv_serial_num_counter);
+      break;
+    }
+    case 1230: {
+      rtcm_msg_1230 *msg_1230 = &msg->msg_1230;
+      msg_1230->stn_id = (uint16_t)prng_range(4096);
+      msg_1230->bias_indicator = 1;
+      msg_1230->fdma_signal_mask = 0x0F;
+      msg_1230->L1_CA_cpb_meter = round(prng_uniform(-10, 10) * 50) / 50;
+      msg_1230->L1_P_cpb_meter = round(prng_uniform(-10, 10) * 50) / 50;
+      msg_1230->L2_CA_cpb_meter = round(prng_uniform(-10, 10) * 50) / 50;
+      msg_1230->L2_P_cpb_meter = round(prng_uniform(-10, 10) * 50) / 50;
+      break;
+    }
+    case 4062: {
+      rtcm_msg_swift_proprietary *msg_4062 = &msg->msg_4062;
+      msg_4062->msg_type = (uint16_t)prng_range(65536);
+      msg_4062->sender_id = (uint16_t)prng_range(65536);
+      msg_4062->len = (uint8_t)(16 + prng_range(240));
+      for (uint8_t i = 0; i < msg_4062->len; i++) {
+        msg_4062->data[i] = (uint8_t)prng_range(256);
+      }
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+static void make_kepler_eph(rtcm_msg_eph *eph, rtcm_constellation_t cons) {
+  memset(eph, 0, sizeof(*eph));
+  ephemeris_kepler_raw_rtcm_t *kepler = &eph->kepler;
+  eph->constellation = cons;
+  eph->sat_id = (uint8_t)(1 + prng_range(32));
+  eph->wn = (uint16_t)prng_range(1024);
+  eph->toe = prng_range(1 << 14);
+  eph->ura = (uint16_t)prng_range(16);
+  eph->health_bits = 0;
+  kepler->tgd_gal_s[0] = (int32_t)prng_range(512) - 256;
+  kepler->tgd_gal_s[1] = (int32_t)prng_range(512) - 256;
+  kepler->crc = (int32_t)prng_range(1 << 15) - (1 << 14);
+  kepler->crs = (int32_t)prng_range(1 << 15) - (1 << 14);
+  kepler->cuc = (int32_t)prng_range(1 << 15) - (1 << 14);
+  kepler->cus = (int32_t)prng_range(1 << 15) - (1 << 14);
+  kepler->cic = (int32_t)prng_range(1 << 15) - (1 << 14);
+  kepler->cis = (int32_t)prng_range(1 << 15) - (1 << 14);
+  kepler->dn = (int16_t)(prng_range(1 << 15) - (1 << 14));
+  kepler->m0 = (int32_t)prng_next();
+  kepler->ecc = (uint32_t)prng_range(1 << 25);
+  kepler->sqrta = (uint32_t)prng_next();
+  kepler->omega0 = (int32_t)prng_next();
+  kepler->omegadot = (int32_t)prng_range(1 << 23) - (1 << 22);
+  kepler->w = (int32_t)prng_next();
+  kepler->inc = (int32_t)prng_next();
+  kepler->inc_dot = (int16_t)(prng_range(1 << 13) - (1 << 12));
+  kepler->af0 = (int32_t)prng_range(1 << 20) - (1 << 19);
+  kepler->af1 = (int32_t)prng_range(1 << 15) - (1 << 14);
+  kepler->af2 = (int16_t)(prng_range(1 << 7) - (1 << 6));
+  kepler->toc = eph->toe;
+  kepler->iode = (uint16_t)prng_range(256);
+  kepler->iodc = kepler->iode;
+}
+
+/* Messages without an encoder are written field by field with random content
+ * in place of the real field values */
+
+static void write_random(uint8_t buff[], uint16_t *bit, uint8_t len) {
+  rtcm_setbitu(buff, *bit, len, (uint32_t)prng_next());
+  *bit += len;
+}
+
+static void write_field(uint8_t buff[],
+                        uint16_t *bit,
+                        uint8_t len,
+                        uint32_t value) {
+  rtcm_setbitu(buff, *bit, len, value);
+  *bit += len;
+}
+
+static uint16_t write_msm67(uint8_t buff[],
+                            uint16_t msg_num,
+                            uint8_t num_sats,
+                            uint8_t num_sigs) {
+  bool msm7 = (MSM7 == to_msm_type(msg_num));
+  uint16_t bit = 0;
+  memset(buff, 0, BENCH_MAX_MSG_LEN);
+  write_field(buff, &bit, 12, msg_num);
+  write_random(buff, &bit, 12);
+  write_field(buff, &bit, 30, prng_range(RTCM_MAX_TOW_MS));
+  write_field(buff, &bit, 1, 0);
+  write_random(buff, &bit, 3);
+  write_field(buff, &bit, 7, 0);
+  write_field(buff, &bit, 2, 0);
+  write_field(buff, &bit, 2, 0);
+  write_field(buff, &bit, 1, 0);
+  write_field(buff, &bit, 3, 0);
+  for (uint8_t i = 0; i < MSM_SATELLITE_MASK_SIZE; i++) {
+    write_field(buff, &bit, 1, (i % 3 == 0) && (i / 3 < num_sats));
+  }
+  for (uint8_t i = 0; i < MSM_SIGNAL_MASK_SIZE; i++) {
+    write_field(buff, &bit, 1, (i % 7 == 1) && (i / 7 < num_sigs));
+  }
+  uint8_t num_cells = num_sats * num_sigs;
+  for (uint8_t i = 0; i < num_cells; i++) {
+    write_field(buff, &bit, 1, 1);
+  }
+  /* satellite data */
+  for (uint8_t i = 0; i < num_sats; i++) {
+    write_field(buff, &bit, 8, 65 + prng_range(20));
+  }
+  if (msm7) {
+    for (uint8_t i = 0; i < num_sats; i++) {
+      write_field(buff, &bit, 4, 0);
+    }
+  }
+  for (uint8_t i = 0; i < num_sats; i++) {
+    write_random(buff, &bit, 10);
+  }
+  if (msm7) {
+    for (uint8_t i = 0; i < num_sats; i++) {
+      write_field(buff, &bit, 14, prng_range(1600));
+    }
+  }
+  /* signal data */
+  for (uint8_t i = 0; i < num_cells; i++) {
+    write_field(buff, &bit, 20, prng_range(1 << 18));
+  }
+  for (uint8_t i = 0; i < num_cells; i++) {
+    write_field(buff, &bit, 24, prng_range(1 << 22));
+  }
+  for (uint8_t i = 0; i < num_cells; i++) {
+    write_field(buff, &bit, 10, prng_range(700));
+  }
+  for (uint8_t i = 0; i < num_cells; i++) {
+    write_field(buff, &bit, 1, 0);
+  }
+  for (uint8_t i = 0; i < num_cells; i++) {
+    write_field(buff, &bit, 10, 480 + prng_range(320));
+  }
+  if (msm7) {
+    for (uint8_t i = 0; i < num_cells; i++) {
+      write_field(buff, &bit, 15, prng_range(1 << 12));
+    }
+  }
+  return (bit + 7) / 8;
+}
+
+static uint16_t write_raw_eph(uint8_t buff[], uint16_t msg_num) {
+  /* total length in bits of the ephemeris messages, RTCM 10403.3 */
+  uint16_t num_bits = 0;
+  switch (msg_num) {
+    case 1020:
+      num_bits = 360;
+      break;
+    case 1042:
+      num_bits = 511;
+      break;
+    case 1044:
+      num_bits = 485;
+      break;
+    default:
+      return 0;
+  }
+  memset(buff, 0, BENCH_MAX_MSG_LEN);
+  uint16_t bit = 0;
+  write_field(buff, &bit, 12, msg_num);
+  /* satellite ID, above the BDS GEO range */
+  write_field(buff, &bit, 6, 10 + prng_range(20));
+  while (bit + 32 <= num_bits) {
+    write_random(buff, &bit, 32);
+  }
+  write_random(buff, &bit, (uint8_t)(num_bits - bit));
+  return (bit + 7) / 8;
+}
+
+static uint16_t write_ssr(uint8_t buff[], uint16_t msg_num, uint8_t num_sats) {
+  bool orbit = (1057 == msg_num || 1060 == msg_num);
+  bool clock = (1058 == msg_num || 1060 == msg_num);
+  bool code_bias = (1059 == msg_num);
+  bool phase_bias = (1265 == msg_num);
+  bool hr_clock = (1062 == msg_num);
+  uint16_t bit = 0;
+  memset(buff, 0, BENCH_MAX_MSG_LEN);
+  write_field(buff, &bit, 12, msg_num);
+  write_field(buff, &bit, 20, prng_range(604800));
+  write_field(buff, &bit, 4, 2);
+  write_field(buff, &bit, 1, 0);
+  if (orbit) {
+    write_field(buff, &bit, 1, 0);
+  }
+  write_random(buff, &bit, 4);
+  write_random(buff, &bit, 16);
+  write_random(buff, &bit, 4);
+  if (phase_bias) {
+    write_field(buff, &bit, 1, 1);
+    write_field(buff, &bit, 1, 1);
+  }
+  write_field(buff, &bit, 6, num_sats);
+  for (uint8_t sat = 0; sat < num_sats; sat++) {
+    write_field(buff, &bit, 6, sat + 1);
+    if (orbit) {
+      write_random(buff, &bit, 8);
+      write_random(buff, &bit, 22);
+      write_random(buff, &bit, 20);
+      write_random(buff, &bit, 20);
+      write_random(buff, &bit, 21);
+      write_random(buff, &bit, 19);
+      write_random(buff, &bit, 19);
+    }
+    if (clock) {
+      write_random(buff, &bit, 22);
+      write_random(buff, &bit, 21);
+      write_random(buff, &bit, 27);
+    }
+    if (hr_clock) {
+      write_random(buff, &bit, 22);
+    }
+    if (code_bias) {
+      write_field(buff, &bit, 5, 3);
+      for (uint8_t sig = 0; sig < 3; sig++) {
+        write_field(buff, &bit, 5, sig);
+        write_random(buff, &bit, 14);
+      }
+    }
+    if (phase_bias) {
+      write_field(buff, &bit, 5, 3);
+      write_random(buff, &bit, 9);
+      write_random(buff, &bit, 8);
+      for (uint8_t sig = 0; sig < 3; sig++) {
+        write_field(buff, &bit, 5, sig);
+        write_random(buff, &bit, 1);
+        write_random(buff, &bit, 2);
+        write_random(buff, &bit, 4);
+        write_random(buff, &bit, 20);
+      }
+    }
+  }
+  return (bit + 7) / 8;
+}
+
+/* Operations */
+
+#define BENCH_DECODER(TheFunc, TheField)                                   \
+  static uint32_t bench_##TheFunc(const bench_case *c, uint16_t index) {   \
+    if (RC_OK !=                                                           \
+        TheFunc(c->corpus->buff[index], &scratch_msg_.TheField)) {         \
+      return 0;                                                            \
+    }                                                                      \
+    return 8u * c->corpus->len[index];                                     \
+  }
+
+#define BENCH_ENCODER(TheFunc, TheField)                                 \
+  static uint32_t bench_##TheFunc(const bench_case *c, uint16_t index) { \
+    return 8u * TheFunc(&c->corpus->msg[index].TheField, scratch_buff_); \
+  }
+
+BENCH_DECODER(rtcm3_decode_1001, obs)
+BENCH_DECODER(rtcm3_decode_1002, obs)
+BENCH_DECODER(rtcm3_decode_1003, obs)
+BENCH_DECODER(rtcm3_decode_1004, obs)
+BENCH_DECODER(rtcm3_decode_1005, msg_1005)
+BENCH_DECODER(rtcm3_decode_1006, msg_1006)
+BENCH_DECODER(rtcm3_decode_1007, msg_1007)
+BENCH_DECODER(rtcm3_decode_1008, msg_1008)
+BENCH_DECODER(rtcm3_decode_1010, obs)
+BENCH_DECODER(rtcm3_decode_1012, obs)
+BENCH_DECODER(rtcm3_decode_1029, msg_1029)
+BENCH_DECODER(rtcm3_decode_1033, msg_1033)
+BENCH_DECODER(rtcm3_decode_1230, msg_1230)
+BENCH_DECODER(rtcm3_decode_msm4, msm)
+BENCH_DECODER(rtcm3_decode_msm5, msm)
+BENCH_DECODER(rtcm3_decode_msm6, msm)
+BENCH_DECODER(rtcm3_decode_msm7, msm)
+BENCH_DECODER(rtcm3_decode_4062, msg_4062)
+BENCH_DECODER(rtcm3_decode_gps_eph, eph)
+BENCH_DECODER(rtcm3_decode_glo_eph, eph)
+BENCH_DECODER(rtcm3_decode_gal_eph, eph)
+BENCH_DECODER(rtcm3_decode_gal_eph_fnav, eph)
+BENCH_DECODER(rtcm3_decode_bds_eph, eph)
+BENCH_DECODER(rtcm3_decode_qzss_eph, eph)
+BENCH_DECODER(rtcm3_decode_orbit, orbit)
+BENCH_DECODER(rtcm3_decode_clock, clock)
+BENCH_DECODER(rtcm3_decode_orbit_clock, orbit_clock)
+BENCH_DECODER(rtcm3_decode_code_bias, code_bias)
+BENCH_DECODER(rtcm3_decode_phase_bias, phase_bias)
+
+BENCH_ENCODER(rtcm3_encode_1001, obs)
+BENCH_ENCODER(rtcm3_encode_1002, obs)
+BENCH_ENCODER(rtcm3_encode_1003, obs)
+BENCH_ENCODER(rtcm3_encode_1004, obs)
+BENCH_ENCODER(rtcm3_encode_1005, msg_1005)
+BENCH_ENCODER(rtcm3_encode_1006, msg_1006)
+BENCH_ENCODER(rtcm3_encode_1007, msg_1007)
+BENCH_ENCODER(rtcm3_encode_1008, msg_1008)
+BENCH_ENCODER(rtcm3_encode_1010, obs)
+BENCH_ENCODER(rtcm3_encode_1012, obs)
+BENCH_ENCODER(rtcm3_encode_1029, msg_1029)
+BENCH_ENCODER(rtcm3_encode_1033, msg_1033)
+BENCH_ENCODER(rtcm3_encode_1230, msg_1230)
+BENCH_ENCODER(rtcm3_encode_msm4, msm)
+BENCH_ENCODER(rtcm3_encode_msm5, msm)
+BENCH_ENCODER(rtcm3_encode_4062, msg_4062)
+BENCH_ENCODER(rtcm3_encode_gps_eph, eph)
+BENCH_ENCODER(rtcm3_encode_gal_eph_inav, eph)
+BENCH_ENCODER(rtcm3_encode_gal_eph_fnav, eph)
+BENCH_ENCODER(rtcm3_encode_glo_eph, eph)
+BENCH_ENCODER(rtcm3_encode_bds_eph, eph)
+BENCH_ENCODER(rtcm3_encode_qzss_eph, eph)
+BENCH_ENCODER(rtcm3_encode_orbit, orbit)
+BENCH_ENCODER(rtcm3_encode_clock, clock)
+BENCH_ENCODER(rtcm3_encode_orbit_clock, orbit_clock)
+BENCH_ENCODER(rtcm3_encode_code_bias, code_bias)
+BENCH_ENCODER(rtcm3_encode_phase_bias, phase_bias)
+
+static uint32_t bench_eph_store_update(const bench_case *c, uint16_t index) {
+  const rtcm_msg_eph *eph = NULL;
+  bool is_new = false;
+  if (RC_OK != rtcm3_eph_store_update(&eph_store_,
+                                      c->corpus->buff[index],
+                                      c->corpus->len[index],
+                                      &eph,
+                                      &is_new)) {
+    return 0;
+  }
+  return 8u * c->corpus->len[index];
+}
+
+static uint32_t bench_station_registry_update(const bench_case *c,
+                                              uint16_t index) {
+  bool is_new = false;
+  if (RC_OK != rtcm3_station_registry_update(&station_registry_,
+                                             c->corpus->buff[index],
+                                             c->corpus->len[index],
+                                             &is_new)) {
+    return 0;
+  }
+  return 8u * c->corpus->len[index];
+}
+
+static void visit_orbit(void *ctx, const rtcm_msg_ssr_orbit_corr *orbit) {
+  (void)ctx;
+  sink_ += (uint64_t)orbit->radial;
+}
+
+static void visit_clock(void *ctx, const rtcm_msg_ssr_clock_corr *clock) {
+  (void)ctx;
+  sink_ += (uint64_t)clock->c0;
+}
+
+static void visit_code_bias(void *ctx,
+                            uint8_t sat_id,
+                            const rtcm_msg_ssr_code_bias_sig *sig) {
+  (void)ctx;
+  sink_ += sat_id + (uint64_t)sig->code_bias;
+}
+
+static void visit_phase_bias(void *ctx,
+                             uint8_t sat_id,
+                             const rtcm_msg_ssr_phase_bias_sig *sig) {
+  (void)ctx;
+  sink_ += sat_id + (uint64_t)sig->phase_bias;
+}
+
+static const rtcm3_ssr_visitor ssr_visitor_ = {
+    NULL, visit_orbit, visit_clock, NULL, visit_code_bias, visit_phase_bias};
+
+/* the SSR messages walked with callbacks instead of into message structs */
+static uint32_t bench_ssr_visit(const bench_case *c, uint16_t index) {
+  if (RC_OK !=
+      rtcm3_decode_ssr_visit(c->corpus->buff[index], &ssr_visitor_, NULL)) {
+    return 0;
+  }
+  return 8u * c->corpus->len[index];
+}
+
+static uint32_t bench_hr_clock(const bench_case *c, uint16_t index) {
+  rtcm_msg_ssr_header header;
+  if (RC_OK !=
+      rtcm3_decode_hr_clock(c->corpus->buff[index], &header, &ssr_clocks_)) {
+    return 0;
+  }
+  return 8u * c->corpus->len[index];
+}
+
+/* SBP tunnelled through 4062 frames without the intermediate struct */
+static uint32_t bench_sbp_unwrap(const bench_case *c, uint16_t index) {
+  uint16_t len = c->corpus->len[index];
+  rtcm3_frame frame = {&c->corpus->buff[index][RTCM3_FRAME_HEADER_LEN],
+                       (uint16_t)(len - RTCM3_FRAME_OVERHEAD),
+                       4062,
+                       0};
+  rtcm_msg_swift_proprietary_view sbp;
+  if (RC_OK != rtcm3_sbp_unwrap(&frame, &sbp)) {
+    return 0;
+  }
+  sink_ += sbp.data[0];
+  return 8u * len;
+}
+
+static uint32_t bench_sbp_wrap(const bench_case *c, uint16_t index) {
+  const rtcm_msg_swift_proprietary *msg = &c->corpus->msg[index].msg_4062;
+  rtcm_msg_swift_proprietary_view sbp = {
+      msg->msg_type, msg->sender_id, msg->len, msg->data};
+  return 8u * rtcm3_sbp_wrap(&sbp, scratch_buff_);
+}
+
+static uint32_t bench_eph_cache_copy(const bench_case *c, uint16_t index) {
+  uint16_t msg_num = (uint16_t)rtcm_getbitu(c->corpus->buff[index], 0, 12);
+  return 8u * rtcm3_eph_cache_copy(
+                  &eph_cache_, msg_num, &c->corpus->msg[index].eph,
+                  scratch_buff_);
+}
+
+/* the bit primitives walk the buffer with field widths cycling through the
+ * supported range */
+static uint32_t bit_pos(uint16_t index) { return (index * 37u) % 7000u; }
+
+static uint8_t bit_len(uint16_t index, uint8_t max_len) {
+  return (uint8_t)(1 + index % max_len);
+}
+
+static uint32_t bench_getbitu(const bench_case *c, uint16_t index) {
+  (void)c;
+  uint8_t len = bit_len(index, 32);
+  sink_ += rtcm_getbitu(bit_buff_, bit_pos(index), len);
+  return len;
+}
+
+static uint32_t bench_getbits(const bench_case *c, uint16_t index) {
+  (void)c;
+  uint8_t len = bit_len(index, 32);
+  sink_ += (uint64_t)rtcm_getbits(bit_buff_, bit_pos(index), len);
+  return len;
+}
+
+static uint32_t bench_getbitul(const bench_case *c, uint16_t index) {
+  (void)c;
+  uint8_t len = bit_len(index, 64);
+  sink_ += rtcm_getbitul(bit_buff_, bit_pos(index), len);
+  return len;
+}
+
+static uint32_t bench_getbitsl(const bench_case *c, uint16_t index) {
+  (void)c;
+  uint8_t len = bit_len(index, 64);
+  sink_ += (uint64_t)rtcm_getbitsl(bit_buff_, bit_pos(index), len);
+  return len;
+}
+
+static uint32_t bench_get_sign_magnitude_bit(const bench_case *c,
+                                             uint16_t index) {
+  (void)c;
+  uint8_t len = bit_len(index, 32);
+  sink_ +=
+      (uint64_t)rtcm_get_sign_magnitude_bit(bit_buff_, bit_pos(index), len);
+  return len;
+}
+
+static uint32_t bench_setbitu(const bench_case *c, uint16_t index) {
+  (void)c;
+  uint8_t len = bit_len(index, 32);
+  rtcm_setbitu(scratch_buff_, bit_pos(index), len, index * 2654435761u);
+  return len;
+}
+
+static uint32_t bench_setbits(const bench_case *c, uint16_t index) {
+  (void)c;
+  uint8_t len = bit_len(index, 32);
+  rtcm_setbits(scratch_buff_, bit_pos(index), len, -(int32_t)index);
+  return len;
+}
+
+static uint32_t bench_setbitul(const bench_case *c, uint16_t index) {
+  (void)c;
+  uint8_t len = bit_len(index, 64);
+  rtcm_setbitul(
+      scratch_buff_, bit_pos(index), len, index * 0x9E3779B97F4A7C15ULL);
+  return len;
+}
+
+static uint32_t bench_setbitsl(const bench_case *c, uint16_t index) {
+  (void)c;
+  uint8_t len = bit_len(index, 64);
+  rtcm_setbitsl(scratch_buff_, bit_pos(index), len, -(int64_t)index);
+  return len;
+}
+
+static uint32_t bench_count_mask_values(const bench_case *c, uint16_t index) {
+  (void)c;
+  sink_ += count_mask_values(MSM_SATELLITE_MASK_SIZE,
+                             masks_[index % BENCH_CORPUS_SIZE]);
+  return MSM_SATELLITE_MASK_SIZE;
+}
+
+static uint32_t bench_find_nth_mask_value(const bench_case *c,
+                                          uint16_t index) {
+  (void)c;
+  const bool *mask = masks_[index % BENCH_CORPUS_SIZE];
+  uint8_t count = count_mask_values(MSM_SATELLITE_MASK_SIZE, mask);
+  if (0 == count) {
+    return MSM_SATELLITE_MASK_SIZE;
+  }
+  sink_ += find_nth_mask_value(
+      MSM_SATELLITE_MASK_SIZE, mask, (uint8_t)(1 + index % count));
+  return MSM_SATELLITE_MASK_SIZE;
+}
+
+static uint32_t bench_to_msm_type(const bench_case *c, uint16_t index) {
+  (void)c;
+  sink_ += to_msm_type((uint16_t)(1071 + index % 60));
+  return 12;
+}
+
+static uint32_t bench_to_constellation(const bench_case *c, uint16_t index) {
+  (void)c;
+  sink_ += (uint64_t)to_constellation((uint16_t)(1057 + index % 80));
+  return 12;
+}
+
+/* Case setup */
+
+static void encode_corpus(bench_corpus *corpus,
+                          bench_op encode_op,
+                          const char *name) {
+  for (uint16_t i = 0; i < BENCH_CORPUS_SIZE; i++) {
+    bench_case tmp;
+    memset(&tmp, 0, sizeof(tmp));
+    tmp.corpus = corpus;
+    uint32_t bits = encode_op(&tmp, i);
+    if (0 == bits || bits / 8 > BENCH_MAX_MSG_LEN) {
+      fprintf(stderr, "failed to build the %s corpus\n", name);
+      exit(EXIT_FAILURE);
+    }
+    memcpy(corpus->buff[i], scratch_buff_, bits / 8);
+    corpus->len[i] = (uint16_t)(bits / 8);
+  }
+}
+
+static void add_obs_cases(uint16_t msg_num,
+                          uint8_t num_sats,
+                          bench_op decode_op,
+                          bench_op encode_op) {
+  bench_corpus *corpus = new_corpus();
+  for (uint16_t i = 0; i < BENCH_CORPUS_SIZE; i++) {
+    make_obs(&corpus->msg[i].obs, msg_num, num_sats);
+  }
+  char name[48];
+  snprintf(name, sizeof(name), "%u/%u sats", msg_num, num_sats);
+  encode_corpus(corpus, encode_op, name);
+  add_case("decode", name, num_sats, decode_op, corpus);
+  add_case("encode", name, num_sats, encode_op, corpus);
+}
+
+static void add_msm_cases(uint16_t msg_num,
+                          uint8_t num_sats,
+                          uint8_t num_sigs,
+                          bench_op decode_op,
+                          bench_op encode_op) {
+  bench_corpus *corpus = new_corpus();
+  char name[48];
+  snprintf(name, sizeof(name), "%u/%ux%u", msg_num, num_sats, num_sigs);
+  if (NULL != encode_op) {
+    for (uint16_t i = 0; i < BENCH_CORPUS_SIZE; i++) {
+      make_msm(&corpus->msg[i].msm, msg_num, num_sats, num_sigs);
+    }
+    encode_corpus(corpus, encode_op, name);
+    add_case("encode", name, num_sats * num_sigs, encode_op, corpus);
+  } else {
+    for (uint16_t i = 0; i < BENCH_CORPUS_SIZE; i++) {
+      corpus->len[i] =
+          write_msm67(corpus->buff[i], msg_num, num_sats, num_sigs);
+    }
+  }
+  add_case("decode", name, num_sats * num_sigs, decode_op, corpus);
+}
+
+static void add_station_cases(uint16_t msg_num,
+                              bench_op decode_op,
+                              bench_op encode_op) {
+  bench_corpus *corpus = new_corpus();
+  for (uint16_t i = 0; i < BENCH_CORPUS_SIZE; i++) {
+    make_station(&corpus->msg[i], msg_num);
+  }
+  char name[48];
+  snprintf(name, sizeof(name), "%u", msg_num);
+  encode_corpus(corpus, encode_op, name);
+  add_case("decode", name, 0, decode_op, corpus);
+  add_case("encode", name, 0, encode_op, corpus);
+  if (1029 != msg_num && 4062 != msg_num) {
+    snprintf(name, sizeof(name), "%u registry", msg_num);
+    add_case("decode", name, 0, bench_station_registry_update, corpus);
+  }
+}
+
+static void add_sbp_cases(void) {
+  bench_corpus *corpus = new_corpus();
+  for (uint16_t i = 0; i < BENCH_CORPUS_SIZE; i++) {
+    make_station(&corpus->msg[i], 4062);
+  }
+  encode_corpus(corpus, bench_sbp_wrap, "4062 wrap");
+  add_case("decode", "4062 unwrap", 0, bench_sbp_unwrap, corpus);
+  add_case("encode", "4062 wrap", 0, bench_sbp_wrap, corpus);
+}
+
+/* One ephemeris per satellite, as a caster repeats them between uploads */
+static const bench_corpus *rebroadcast_corpus(const bench_corpus *corpus) {
+  bench_corpus *copy = new_corpus();
+  memcpy(copy, corpus, sizeof(*copy));
+  for (uint16_t i = 0; i < BENCH_CORPUS_SIZE; i++) {
+    copy->msg[i].eph.sat_id = (uint8_t)(1 + i);
+  }
+  return copy;
+}
+
+static void add_kepler_eph_cases(uint16_t msg_num,
+                                 rtcm_constellation_t cons,
+                                 bench_op decode_op,
+                                 bench_op encode_op) {
+  bench_corpus *corpus = new_corpus();
+  for (uint16_t i = 0; i < BENCH_CORPUS_SIZE; i++) {
+    make_kepler_eph(&corpus->msg[i].eph, cons);
+  }
+  char name[48];
+  snprintf(name, sizeof(name), "%u", msg_num);
+  encode_corpus(corpus, encode_op, name);
+  add_case("decode", name, 0, decode_op, corpus);
+  add_case("encode", name, 0, encode_op, corpus);
+  snprintf(name, sizeof(name), "%u store", msg_num);
+  add_case("decode", name, 0, bench_eph_store_update, corpus);
+  snprintf(name, sizeof(name), "%u cached", msg_num);
+  add_case(
+      "encode", name, 0, bench_eph_cache_copy, rebroadcast_corpus(corpus));
+}
+
+static void add_raw_eph_cases(uint16_t msg_num,
+                              bench_op decode_op,
+                              bench_op encode_op) {
+  bench_corpus *corpus = new_corpus();
+  for (uint16_t i = 0; i < BENCH_CORPUS_SIZE; i++) {
+    corpus->len[i] = write_raw_eph(corpus->buff[i], msg_num);
+    /* the encoders start from the decoded random fields */
+    bench_case tmp;
+    memset(&tmp, 0, sizeof(tmp));
+    tmp.corpus = corpus;
+    decode_op(&tmp, i);
+    corpus->msg[i].eph = scratch_msg_.eph;
+  }
+  char name[48];
+  snprintf(name, sizeof(name), "%u", msg_num);
+  add_case("decode", name, 0, decode_op, corpus);
+  add_case("encode", name, 0, encode_op, corpus);
+  snprintf(name, sizeof(name), "%u store", msg_num);
+  add_case("decode", name, 0, bench_eph_store_update, corpus);
+  snprintf(name, sizeof(name), "%u cached", msg_num);
+  add_case(
+      "encode", name, 0, bench_eph_cache_copy, rebroadcast_corpus(corpus));
+}
+
+static void add_ssr_cases(uint16_t msg_num,
+                          uint8_t num_sats,
+                          bench_op decode_op,
+                          bench_op encode_op) {
+  bench_corpus *corpus = new_corpus();
+  for (uint16_t i = 0; i < BENCH_CORPUS_SIZE; i++) {
+    corpus->len[i] = write_ssr(corpus->buff[i], msg_num, num_sats);
+    /* the encoders start from the decoded random fields */
+    bench_case tmp;
+    memset(&tmp, 0, sizeof(tmp));
+    tmp.corpus = corpus;
+    decode_op(&tmp, i);
+    corpus->msg[i] = scratch_msg_;
+  }
+  char name[48];
+  snprintf(name, sizeof(name), "%u/%u sats", msg_num, num_sats);
+  add_case("decode", name, num_sats, decode_op, corpus);
+  add_case("encode", name, num_sats, encode_op, corpus);
+  snprintf(name, sizeof(name), "%u/%u sats visit", msg_num, num_sats);
+  add_case("decode", name, num_sats, bench_ssr_visit, corpus);
+}
+
+static void add_hr_clock_case(uint8_t num_sats) {
+  bench_corpus *corpus = new_corpus();
+  for (uint16_t i = 0; i < BENCH_CORPUS_SIZE; i++) {
+    corpus->len[i] = write_ssr(corpus->buff[i], 1062, num_sats);
+  }
+  char name[48];
+  snprintf(name, sizeof(name), "1062/%u sats", num_sats);
+  add_case("decode", name, num_sats, bench_hr_clock, corpus);
+}
+
+static void add_util_case(const char *group, const char *name, bench_op op) {
+  bench_case *c = add_case(group, name, 0, op, NULL);
+  c->ops_per_pass = BENCH_BIT_OPS;
+}
+
+static void setup_cases(void) {
+  static const uint8_t obs_sats[] = {4, 12};
+  for (uint8_t i = 0; i < sizeof(obs_sats); i++) {
+    uint8_t n = obs_sats[i];
+    add_obs_cases(1001, n, bench_rtcm3_decode_1001, bench_rtcm3_encode_1001);
+    add_obs_cases(1002, n, bench_rtcm3_decode_1002, bench_rtcm3_encode_1002);
+    add_obs_cases(1003, n, bench_rtcm3_decode_1003, bench_rtcm3_encode_1003);
+    add_obs_cases(1004, n, bench_rtcm3_decode_1004, bench_rtcm3_encode_1004);
+    add_obs_cases(1010, n, bench_rtcm3_decode_1010, bench_rtcm3_encode_1010);
+    add_obs_cases(1012, n, bench_rtcm3_decode_1012, bench_rtcm3_encode_1012);
+  }
+
+  /* sats x signals, from a sparse message up to a full cell mask */
+  static const uint8_t msm_shape[][2] = {{2, 2}, {8, 2}, {12, 3}, {16, 4}};
+  for (uint8_t i = 0; i < sizeof(msm_shape) / sizeof(msm_shape[0]); i++) {
+    uint8_t sats = msm_shape[i][0];
+    uint8_t sigs = msm_shape[i][1];
+    add_msm_cases(
+        1074, sats, sigs, bench_rtcm3_decode_msm4, bench_rtcm3_encode_msm4);
+    add_msm_cases(
+        1075, sats, sigs, bench_rtcm3_decode_msm5, bench_rtcm3_encode_msm5);
+    add_msm_cases(1076, sats, sigs, bench_rtcm3_decode_msm6, NULL);
+    add_msm_cases(1077, sats, sigs, bench_rtcm3_decode_msm7, NULL);
+  }
+
+  add_station_cases(1005, bench_rtcm3_decode_1005, bench_rtcm3_encode_1005);
+  add_station_cases(1006, bench_rtcm3_decode_1006, bench_rtcm3_encode_1006);
+  add_station_cases(1007, bench_rtcm3_decode_1007, bench_rtcm3_encode_1007);
+  add_station_cases(1008, bench_rtcm3_decode_1008, bench_rtcm3_encode_1008);
+  add_station_cases(1029, bench_rtcm3_decode_1029, bench_rtcm3_encode_1029);
+  add_station_cases(1033, bench_rtcm3_decode_1033, bench_rtcm3_encode_1033);
+  add_station_cases(1230, bench_rtcm3_decode_1230, bench_rtcm3_encode_1230);
+  add_station_cases(4062, bench_rtcm3_decode_4062, bench_rtcm3_encode_4062);
+  add_sbp_cases();
+
+  add_kepler_eph_cases(1019,
+                       RTCM_CONSTELLATION_GPS,
+                       bench_rtcm3_decode_gps_eph,
+                       bench_rtcm3_encode_gps_eph);
+  add_kepler_eph_cases(1045,
+                       RTCM_CONSTELLATION_GAL,
+                       bench_rtcm3_decode_gal_eph_fnav,
+                       bench_rtcm3_encode_gal_eph_fnav);
+  add_kepler_eph_cases(1046,
+                       RTCM_CONSTELLATION_GAL,
+                       bench_rtcm3_decode_gal_eph,
+                       bench_rtcm3_encode_gal_eph_inav);
+  add_raw_eph_cases(
+      1020, bench_rtcm3_decode_glo_eph, bench_rtcm3_encode_glo_eph);
+  add_raw_eph_cases(
+      1042, bench_rtcm3_decode_bds_eph, bench_rtcm3_encode_bds_eph);
+  add_raw_eph_cases(
+      1044, bench_rtcm3_decode_qzss_eph, bench_rtcm3_encode_qzss_eph);
+
+  static const uint8_t ssr_sats[] = {4, 24};
+  for (uint8_t i = 0; i < sizeof(ssr_sats); i++) {
+    uint8_t n = ssr_sats[i];
+    add_ssr_cases(
+        1057, n, bench_rtcm3_decode_orbit, bench_rtcm3_encode_orbit);
+    add_ssr_cases(
+        1058, n, bench_rtcm3_decode_clock, bench_rtcm3_encode_clock);
+    add_ssr_cases(1060,
+                  n,
+                  bench_rtcm3_decode_orbit_clock,
+                  bench_rtcm3_encode_orbit_clock);
+    add_ssr_cases(
+        1059, n, bench_rtcm3_decode_code_bias, bench_rtcm3_encode_code_bias);
+    add_ssr_cases(1265,
+                  n,
+                  bench_rtcm3_decode_phase_bias,
+                  bench_rtcm3_encode_phase_bias);
+    add_hr_clock_case(n);
+  }
+
+  for (uint16_t i = 0; i < sizeof(bit_buff_); i++) {
+    bit_buff_[i] = (uint8_t)prng_range(256);
+  }
+  add_util_case("bits", "getbitu", bench_getbitu);
+  add_util_case("bits", "getbits", bench_getbits);
+  add_util_case("bits", "getbitul", bench_getbitul);
+  add_util_case("bits", "getbitsl", bench_getbitsl);
+  add_util_case("bits", "get_sign_magnitude_bit", bench_get_sign_magnitude_bit);
+  add_util_case("bits", "setbitu", bench_setbitu);
+  add_util_case("bits", "setbits", bench_setbits);
+  add_util_case("bits", "setbitul", bench_setbitul);
+  add_util_case("bits", "setbitsl", bench_setbitsl);
+
+  for (uint16_t i = 0; i < BENCH_CORPUS_SIZE; i++) {
+    /* masks from almost empty to almost full */
+    uint32_t density = 1 + i * 3;
+    for (uint8_t j = 0; j < MSM_SATELLITE_MASK_SIZE; j++) {
+      masks_[i][j] = prng_range(100) < density;
+    }
+  }
+  add_util_case("msm_utils", "count_mask_values", bench_count_mask_values);
+  add_util_case("msm_utils", "find_nth_mask_value", bench_find_nth_mask_value);
+  add_util_case("msm_utils", "to_msm_type", bench_to_msm_type);
+  add_util_case("msm_utils", "to_constellation", bench_to_constellation);
+}
+
+/* Running and reporting */
+
+typedef struct {
+  uint64_t ops;
+  uint64_t bits;
+  uint64_t ns;
+  uint64_t cycles;
+} bench_result;
+
+static bool run_case(const bench_case *c,
+                     double min_time_s,
+                     bench_result *result) {
+  memset(result, 0, sizeof(*result));
+  /* warm up and check that every operation succeeds */
+  for (uint16_t i = 0; i < c->ops_per_pass; i++) {
+    if (0 == c->op(c, i)) {
+      fprintf(stderr, "%s %s: operation %u failed\n", c->group, c->name, i);
+      return false;
+    }
+  }
+
+  uint64_t min_ns = (uint64_t)(min_time_s * 1e9);
+  uint64_t start_ns = now_ns();
+  uint64_t start_cycles = now_cycles();
+  uint64_t elapsed_ns = 0;
+  do {
+    for (uint16_t i = 0; i < c->ops_per_pass; i++) {
+      result->bits += c->op(c, i);
+    }
+    result->ops += c->ops_per_pass;
+    elapsed_ns = now_ns() - start_ns;
+  } while (elapsed_ns < min_ns);
+  result->cycles = now_cycles() - start_cycles;
+  result->ns = elapsed_ns > 0 ? elapsed_ns : 1;
+  return true;
+}
+
+static void report(const bench_options *options,
+                   const bench_case *c,
+                   const bench_result *result,
+                   bool first) {
+  double seconds = (double)result->ns * 1e-9;
+  double ns_per_op = (double)result->ns / (double)result->ops;
+  double ops_per_s = (double)result->ops / seconds;
+  double bytes_per_s = (double)result->bits / 8.0 / seconds;
+  double cycles_per_bit =
+      BENCH_HAVE_TSC ? (double)result->cycles / (double)result->bits : 0.0;
+
+  if (options->json) {
+    printf("%s  {\"group\": \"%s\", \"name\": \"%s\", \"cells\": %u, "
+           "\"ns_per_op\": %.2f, \"msgs_per_s\": %.0f, \"bytes_per_s\": %.0f, "
+           "\"cycles_per_bit\": %.3f}",
+           first ? "" : ",\n",
+           c->group,
+           c->name,
+           c->cells,
+           ns_per_op,
+           ops_per_s,
+           bytes_per_s,
+           cycles_per_bit);
+  } else {
+    printf("%-10s %-24s %5u %10.1f %12.0f %10.2f %10.3f\n",
+           c->group,
+           c->name,
+           c->cells,
+           ns_per_op,
+           ops_per_s,
+           bytes_per_s / 1e6,
+           cycles_per_bit);
+  }
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "usage: %s [--json] [--filter <substring>] [--min-time <seconds>]\n"
+          "  cycles/bit uses the time stamp counter on x86 and is 0 "
+          "elsewhere\n",
+          argv0);
+}
+
+static bool parse_options(int argc, char *argv[], bench_options *options) {
+  options->json = false;
+  options->filter = NULL;
+  options->min_time_s = BENCH_DEFAULT_MIN_TIME_S;
+  for (int i = 1; i < argc; i++) {
+    if (0 == strcmp(argv[i], "--json")) {
+      options->json = true;
+    } else if (0 == strcmp(argv[i], "--filter") && i + 1 < argc) {
+      options->filter = argv[++i];
+    } else if (0 == strcmp(argv[i], "--min-time") && i + 1 < argc) {
+      options->min_time_s = atof(argv[++i]);
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool matches(const bench_options *options, const bench_case *c) {
+  if (NULL == options->filter) {
+    return true;
+  }
+  char full_name[64];
+  snprintf(full_name, sizeof(full_name), "%s %s", c->group, c->name);
+  return NULL != strstr(full_name, options->filter);
+}
+
+int main(int argc, char *argv[]) {
+  bench_options options;
+  if (!parse_options(argc, argv, &options)) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  setup_cases();
+
+  if (options.json) {
+    printf("[\n");
+  } else {
+    printf("%-10s %-24s %5s %10s %12s %10s %10s\n",
+           "group",
+           "case",
+           "cells",
+           "ns/op",
+           "msgs/s",
+           "MB/s",
+           "cycles/bit");
+  }
+
+  bool ok = true;
+  bool first = true;
+  for (uint16_t i = 0; i < num_cases_; i++) {
+    const bench_case *c = &cases_[i];
+    if (!matches(&options, c)) {
+      continue;
+    }
+    bench_result result;
+    if (!run_case(c, options.min_time_s, &result)) {
+      ok = false;
+      continue;
+    }
+    report(&options, c, &result, first);
+    first = false;
+  }
+
+  if (options.json) {
+    printf("\n]\n");
+  }
+  return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Read only memory mapping of a recorded RTCM stream, walked in place with
+ * rtcm3_frame_scanner. POSIX only. */
+
+#ifndef SWIFTNAV_RTCM3_ARCHIVE_H
+#define SWIFTNAV_RTCM3_ARCHIVE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtcm3/frame.h"
+
+typedef struct {
+  const uint8_t *data;
+  size_t len;
+} rtcm3_archive;
+
+int rtcm3_archive_open(rtcm3_archive *archive, const char *path);
+void rtcm3_archive_scanner_init(const rtcm3_archive *archive,
+                                rtcm3_frame_scanner *scanner);
+void rtcm3_archive_close(rtcm3_archive *archive);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_ARCHIVE_H */
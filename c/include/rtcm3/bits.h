@@ -30,6 +30,18 @@ void rtcm_setbitsl(uint8_t *buff, uint32_t pos, uint32_t len, int64_t data);
 int32_t rtcm_get_sign_magnitude_bit(const uint8_t *buff,
                                     uint32_t pos,
                                     uint8_t len);
+void rtcm_set_sign_magnitude_bit(uint8_t *buff,
+                                 uint32_t pos,
+                                 uint8_t len,
+                                 int32_t data);
+void rtcm_getbytes(const uint8_t *buff,
+                   uint32_t pos,
+                   uint8_t *out,
+                   uint32_t len);
+void rtcm_setbytes(uint8_t *buff,
+                   uint32_t pos,
+                   const uint8_t *data,
+                   uint32_t len);
 #ifdef __cplusplus
 }
 #endif
@@ -30,6 +30,8 @@ rtcm3_rc rtcm3_decode_1008(const uint8_t buff[], rtcm_msg_1008 *msg_1008);
 rtcm3_rc rtcm3_decode_1010(const uint8_t buff[], rtcm_obs_message *msg_1010);
 rtcm3_rc rtcm3_decode_1012(const uint8_t buff[], rtcm_obs_message *msg_1012);
 rtcm3_rc rtcm3_decode_1029(const uint8_t buff[], rtcm_msg_1029 *msg_1029);
+rtcm3_rc rtcm3_decode_1029_view(const uint8_t buff[],
+                                rtcm_msg_1029_view *msg_1029);
 rtcm3_rc rtcm3_decode_1033(const uint8_t buff[], rtcm_msg_1033 *msg_1033);
 rtcm3_rc rtcm3_decode_1230(const uint8_t buff[], rtcm_msg_1230 *msg_1230);
 rtcm3_rc rtcm3_decode_msm4(const uint8_t buff[], rtcm_msm_message *msg);
@@ -38,6 +40,8 @@ rtcm3_rc rtcm3_decode_msm6(const uint8_t buff[], rtcm_msm_message *msg);
 rtcm3_rc rtcm3_decode_msm7(const uint8_t buff[], rtcm_msm_message *msg);
 rtcm3_rc rtcm3_decode_4062(const uint8_t buff[],
                            rtcm_msg_swift_proprietary *msg);
+rtcm3_rc rtcm3_decode_4062_view(const uint8_t buff[],
+                                rtcm_msg_swift_proprietary_view *msg);
 
 double rtcm3_decode_lock_time(uint8_t lock);
 
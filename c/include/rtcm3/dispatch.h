@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Decoding and encoding of any supported message through a tagged union,
+ * for code that handles mixed streams and does not want its own switch over
+ * message numbers. */
+
+#ifndef SWIFTNAV_RTCM3_DISPATCH_H
+#define SWIFTNAV_RTCM3_DISPATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtcm3/frame.h"
+#include "rtcm3/messages.h"
+
+/* frames sorted by type at a time by rtcm3_decode_batch */
+#define RTCM3_DECODE_BATCH_BLOCK 256
+
+typedef enum {
+  RTCM3_MSG_UNSUPPORTED = 0,
+  RTCM3_MSG_OBS,  /* 1001-1004, 1010, 1012 */
+  RTCM3_MSG_1005, /* 1005 */
+  RTCM3_MSG_1006, /* 1006 */
+  RTCM3_MSG_1007, /* 1007 */
+  RTCM3_MSG_1008, /* 1008 */
+  RTCM3_MSG_1029, /* 1029 */
+  RTCM3_MSG_1033, /* 1033 */
+  RTCM3_MSG_1230, /* 1230 */
+  RTCM3_MSG_MSM,  /* MSM4 to MSM7 of all constellations */
+  RTCM3_MSG_EPH,  /* 1019, 1020, 1042, 1044, 1045, 1046 */
+  RTCM3_MSG_SSR_ORBIT,
+  RTCM3_MSG_SSR_CLOCK,
+  RTCM3_MSG_SSR_ORBIT_CLOCK,
+  RTCM3_MSG_SSR_CODE_BIAS,
+  RTCM3_MSG_SSR_PHASE_BIAS,
+  RTCM3_MSG_SWIFT_PROPRIETARY, /* 4062 */
+  RTCM3_MSG_KIND_COUNT
+} rtcm3_msg_kind;
+
+typedef struct {
+  uint16_t msg_num;
+  rtcm3_msg_kind kind;
+  union {
+    rtcm_obs_message obs;
+    rtcm_msg_1005 msg_1005;
+    rtcm_msg_1006 msg_1006;
+    rtcm_msg_1007 msg_1007;
+    rtcm_msg_1008 msg_1008;
+    rtcm_msg_1029 msg_1029;
+    rtcm_msg_1033 msg_1033;
+    rtcm_msg_1230 msg_1230;
+    rtcm_msm_message msm;
+    rtcm_msg_eph eph;
+    rtcm_msg_orbit orbit;
+    rtcm_msg_clock clock;
+    rtcm_msg_orbit_clock orbit_clock;
+    rtcm_msg_code_bias code_bias;
+    rtcm_msg_phase_bias phase_bias;
+    rtcm_msg_swift_proprietary swift_proprietary;
+  };
+} rtcm3_msg;
+
+rtcm3_msg_kind rtcm3_msg_kind_of(uint16_t msg_num);
+rtcm3_rc rtcm3_decode_msg(const uint8_t buff[], rtcm3_msg *msg);
+size_t rtcm3_decode_batch(const rtcm3_frame frames[],
+                          size_t n,
+                          rtcm3_msg msgs[],
+                          rtcm3_rc rcs[]);
+uint16_t rtcm3_encode_msg(const rtcm3_msg *msg, uint8_t buff[]);
+uint16_t rtcm3_encode_msg_frame(const rtcm3_msg *msg, uint8_t frame[]);
+uint16_t rtcm3_encoded_size_msg(const rtcm3_msg *msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_DISPATCH_H */
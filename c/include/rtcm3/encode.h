@@ -22,6 +22,8 @@
 extern "C" {
 #endif
 
+#include <stddef.h>
+
 #include "rtcm3/messages.h"
 
 uint16_t rtcm3_encode_1001(const rtcm_obs_message *msg_1001, uint8_t buff[]);
@@ -39,11 +41,32 @@ uint16_t rtcm3_encode_1033(const rtcm_msg_1033 *msg_1033, uint8_t buff[]);
 uint16_t rtcm3_encode_1230(const rtcm_msg_1230 *msg_1230, uint8_t buff[]);
 uint16_t rtcm3_encode_msm4(const rtcm_msm_message *msg_msm4, uint8_t buff[]);
 uint16_t rtcm3_encode_msm5(const rtcm_msm_message *msg_msm5, uint8_t buff[]);
+uint8_t rtcm3_encode_msm_epoch(const rtcm_msm_epoch *epoch,
+                               uint8_t buff[],
+                               size_t buff_len,
+                               size_t *len);
 uint16_t rtcm3_encode_4062(const rtcm_msg_swift_proprietary *msg,
                            uint8_t buff[]);
 
 uint8_t rtcm3_encode_lock_time(double time);
 
+uint16_t rtcm3_encoded_size_1001(const rtcm_obs_message *msg_1001);
+uint16_t rtcm3_encoded_size_1002(const rtcm_obs_message *msg_1002);
+uint16_t rtcm3_encoded_size_1003(const rtcm_obs_message *msg_1003);
+uint16_t rtcm3_encoded_size_1004(const rtcm_obs_message *msg_1004);
+uint16_t rtcm3_encoded_size_1005(const rtcm_msg_1005 *msg_1005);
+uint16_t rtcm3_encoded_size_1006(const rtcm_msg_1006 *msg_1006);
+uint16_t rtcm3_encoded_size_1007(const rtcm_msg_1007 *msg_1007);
+uint16_t rtcm3_encoded_size_1008(const rtcm_msg_1008 *msg_1008);
+uint16_t rtcm3_encoded_size_1010(const rtcm_obs_message *msg_1010);
+uint16_t rtcm3_encoded_size_1012(const rtcm_obs_message *msg_1012);
+uint16_t rtcm3_encoded_size_1029(const rtcm_msg_1029 *msg_1029);
+uint16_t rtcm3_encoded_size_1033(const rtcm_msg_1033 *msg_1033);
+uint16_t rtcm3_encoded_size_1230(const rtcm_msg_1230 *msg_1230);
+uint16_t rtcm3_encoded_size_msm4(const rtcm_msm_message *msg_msm4);
+uint16_t rtcm3_encoded_size_msm5(const rtcm_msm_message *msg_msm5);
+uint16_t rtcm3_encoded_size_4062(const rtcm_msg_swift_proprietary *msg);
+
 #ifdef __cplusplus
 }
 #endif
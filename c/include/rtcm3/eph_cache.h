@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Pre-encoded ephemeris frames for rebroadcast. A caster repeats the same
+ * ephemeris on every output stream until the satellite uploads a new issue,
+ * so the cache keeps the finished frame, transport header and CRC included,
+ * per message type and satellite. Rebroadcasting is then a copy of the
+ * cached bytes, or the caller writes them out straight from the cache.
+ *
+ * A hit needs the whole ephemeris to match the one the frame was encoded
+ * from, as issues repeat: GLONASS t_b every day, BeiDou toe every week, and
+ * IODEs are reused. Zero an ephemeris before filling it in, so that padding
+ * bytes don't turn a repeat into a miss.
+ *
+ * A returned frame stays valid until the next call for the same message type
+ * and satellite with a different ephemeris. The cache is not locked. */
+
+#ifndef SWIFTNAV_RTCM3_EPH_CACHE_H
+#define SWIFTNAV_RTCM3_EPH_CACHE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rtcm3/eph_store.h"
+#include "rtcm3/frame.h"
+#include "rtcm3/messages.h"
+
+#define RTCM3_EPH_MAX_FRAME_LEN \
+  (RTCM3_EPH_MAX_PAYLOAD_LEN + RTCM3_FRAME_OVERHEAD)
+
+typedef struct {
+  bool valid;
+  rtcm_msg_eph eph; /* the ephemeris the frame was encoded from */
+  uint16_t frame_len;
+  uint8_t frame[RTCM3_EPH_MAX_FRAME_LEN];
+} rtcm3_eph_cache_entry;
+
+typedef struct {
+  rtcm3_eph_cache_entry entries[RTCM3_EPH_STORE_MSG_TYPES]
+                               [RTCM3_EPH_STORE_MAX_SATS];
+  uint32_t encoded; /* frames encoded for a changed ephemeris */
+  uint32_t hits;    /* frames served from the cache */
+} rtcm3_eph_cache;
+
+void rtcm3_eph_cache_init(rtcm3_eph_cache *cache);
+uint16_t rtcm3_eph_cache_frame(rtcm3_eph_cache *cache,
+                               uint16_t msg_num,
+                               const rtcm_msg_eph *eph,
+                               const uint8_t **frame);
+uint16_t rtcm3_eph_cache_copy(rtcm3_eph_cache *cache,
+                              uint16_t msg_num,
+                              const rtcm_msg_eph *eph,
+                              uint8_t buff[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_EPH_CACHE_H */
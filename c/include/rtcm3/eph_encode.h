@@ -17,10 +17,17 @@
 #define BEIDOU_GEOS_MAX_PRN 5
 
 uint16_t rtcm3_encode_gps_eph(const rtcm_msg_eph *msg_1019, uint8_t buff[]);
-// uint16_t rtcm3_encode_glo_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph);
+uint16_t rtcm3_encode_glo_eph(const rtcm_msg_eph *msg_eph, uint8_t buff[]);
 uint16_t rtcm3_encode_gal_eph_inav(const rtcm_msg_eph *msg_eph, uint8_t buff[]);
 uint16_t rtcm3_encode_gal_eph_fnav(const rtcm_msg_eph *msg_eph, uint8_t buff[]);
-// uint16_t rtcm3_encode_bds_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph);
-// uint16_t rtcm3_encode_qzss_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph);
+uint16_t rtcm3_encode_bds_eph(const rtcm_msg_eph *msg_eph, uint8_t buff[]);
+uint16_t rtcm3_encode_qzss_eph(const rtcm_msg_eph *msg_eph, uint8_t buff[]);
+
+uint16_t rtcm3_encoded_size_gps_eph(const rtcm_msg_eph *msg_1019);
+uint16_t rtcm3_encoded_size_gal_eph_inav(const rtcm_msg_eph *msg_eph);
+uint16_t rtcm3_encoded_size_gal_eph_fnav(const rtcm_msg_eph *msg_eph);
+uint16_t rtcm3_encoded_size_glo_eph(const rtcm_msg_eph *msg_eph);
+uint16_t rtcm3_encoded_size_bds_eph(const rtcm_msg_eph *msg_eph);
+uint16_t rtcm3_encoded_size_qzss_eph(const rtcm_msg_eph *msg_eph);
 
 #endif /* SWIFTNAV_RTCM3_EPH_ENCODE_H */
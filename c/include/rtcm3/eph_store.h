@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Latest broadcast ephemerides per satellite. Stations repeat the same
+ * ephemeris every few seconds, so the store keeps the raw payload next to
+ * the decoded copy and only decodes a message whose content has changed.
+ * Per satellite and message type it holds the current and the previous issue,
+ * which covers the switch-over when a new issue is uploaded.
+ *
+ * The store is not locked, readers on other threads need to be serialized
+ * with updates by the caller. */
+
+#ifndef SWIFTNAV_RTCM3_EPH_STORE_H
+#define SWIFTNAV_RTCM3_EPH_STORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rtcm3/messages.h"
+
+/* longest ephemeris payload, message 1042 */
+#define RTCM3_EPH_MAX_PAYLOAD_LEN 64
+/* sat_id is at most 6 bits in all ephemeris messages */
+#define RTCM3_EPH_STORE_MAX_SATS 64
+
+/* 1019, 1020, 1042, 1044, 1045 and 1046 */
+#define RTCM3_EPH_STORE_MSG_TYPES 6
+
+typedef struct {
+  bool valid;
+  uint16_t payload_len;
+  uint64_t hash;
+  uint8_t payload[RTCM3_EPH_MAX_PAYLOAD_LEN];
+  rtcm_msg_eph eph;
+} rtcm3_eph_entry;
+
+typedef struct {
+  rtcm3_eph_entry issues[2];
+  uint8_t current; /* index of the current issue */
+} rtcm3_eph_slot;
+
+typedef struct {
+  rtcm3_eph_slot slots[RTCM3_EPH_STORE_MSG_TYPES][RTCM3_EPH_STORE_MAX_SATS];
+  uint32_t decoded;    /* messages with new content */
+  uint32_t duplicates; /* messages matching a stored payload */
+} rtcm3_eph_store;
+
+void rtcm3_eph_store_init(rtcm3_eph_store *store);
+rtcm3_rc rtcm3_eph_store_update(rtcm3_eph_store *store,
+                                const uint8_t payload[],
+                                uint16_t payload_len,
+                                const rtcm_msg_eph **eph,
+                                bool *is_new);
+const rtcm_msg_eph *rtcm3_eph_store_best(const rtcm3_eph_store *store,
+                                         rtcm_constellation_t constellation,
+                                         uint8_t sat_id,
+                                         uint32_t time_s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_EPH_STORE_H */
@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* RTCM 10403.3 transport layer: preamble, 10 bit payload length, payload and
+ * CRC-24Q parity. The decoders and encoders work on the bare payload, these
+ * helpers add and check the framing around it. */
+
+#ifndef SWIFTNAV_RTCM3_FRAME_H
+#define SWIFTNAV_RTCM3_FRAME_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define RTCM3_PREAMBLE 0xD3
+#define RTCM3_FRAME_HEADER_LEN 3
+#define RTCM3_FRAME_CRC_LEN 3
+#define RTCM3_FRAME_OVERHEAD (RTCM3_FRAME_HEADER_LEN + RTCM3_FRAME_CRC_LEN)
+#define RTCM3_MAX_PAYLOAD_LEN 1023
+#define RTCM3_MAX_FRAME_LEN (RTCM3_MAX_PAYLOAD_LEN + RTCM3_FRAME_OVERHEAD)
+
+/** A validated frame inside a larger buffer. The payload points into that
+ *  buffer and stays valid as long as the buffer does. */
+typedef struct {
+  const uint8_t *payload;
+  uint16_t payload_len;
+  uint16_t msg_num;
+  size_t offset; /* of the preamble from the start of the buffer */
+} rtcm3_frame;
+
+/** Walks the frames of a buffer in place, skipping anything that does not
+ *  frame up or fails the CRC. */
+typedef struct {
+  const uint8_t *data;
+  size_t len;
+  size_t pos;
+  size_t end; /* no preambles are searched for from here on */
+  uint64_t num_frames;
+  uint64_t num_crc_errors;
+  uint64_t skipped_bytes;
+} rtcm3_frame_scanner;
+
+/** Reassembles frames from a byte stream that arrives in arbitrary pieces,
+ *  e.g. from a socket. Frames are returned from the internal buffer. */
+typedef struct {
+  uint8_t buff[RTCM3_MAX_FRAME_LEN];
+  uint16_t len;
+  uint16_t consumed; /* length of the frame returned last, dropped next */
+  uint64_t pos;      /* stream offset of the end of the buffered bytes */
+  uint64_t num_frames;
+  uint64_t num_crc_errors;
+  uint64_t skipped_bytes;
+} rtcm3_stream_framer;
+
+/** Header and parity of a frame whose payload stays in its own buffer, for
+ *  scatter-gather output. */
+typedef struct {
+  uint8_t header[RTCM3_FRAME_HEADER_LEN];
+  uint8_t crc[RTCM3_FRAME_CRC_LEN];
+} rtcm3_frame_envelope;
+
+uint32_t rtcm3_crc24q(const uint8_t buff[], uint32_t len, uint32_t crc);
+uint16_t rtcm3_frame_finalize(uint8_t frame[], uint16_t payload_len);
+uint16_t rtcm3_frame_wrap(const uint8_t payload[],
+                          uint16_t payload_len,
+                          uint8_t frame[]);
+uint16_t rtcm3_frame_envelope_init(rtcm3_frame_envelope *envelope,
+                                   const uint8_t payload[],
+                                   uint16_t payload_len);
+uint16_t rtcm3_frame_check(const uint8_t buff[], size_t len);
+void rtcm3_frame_scanner_init(rtcm3_frame_scanner *scanner,
+                              const uint8_t data[],
+                              size_t len);
+void rtcm3_frame_scanner_init_range(rtcm3_frame_scanner *scanner,
+                                    const uint8_t data[],
+                                    size_t len,
+                                    size_t start,
+                                    size_t end);
+bool rtcm3_frame_scanner_next(rtcm3_frame_scanner *scanner,
+                              rtcm3_frame *frame);
+void rtcm3_stream_framer_init(rtcm3_stream_framer *framer);
+bool rtcm3_stream_framer_feed(rtcm3_stream_framer *framer,
+                              const uint8_t data[],
+                              size_t len,
+                              size_t *consumed,
+                              rtcm3_frame *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_FRAME_H */
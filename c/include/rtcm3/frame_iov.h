@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Scatter-gather output of frames: each frame goes out as its header, its
+ * payload where it was encoded and its CRC, and many frames go out in one
+ * writev or sendmsg call. POSIX only. */
+
+#ifndef SWIFTNAV_RTCM3_FRAME_IOV_H
+#define SWIFTNAV_RTCM3_FRAME_IOV_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/uio.h>
+
+#include "rtcm3/frame.h"
+
+/* iovec entries per frame: header, payload and CRC */
+#define RTCM3_FRAME_IOV_LEN 3
+
+uint16_t rtcm3_frame_iov(const uint8_t payload[],
+                         uint16_t payload_len,
+                         rtcm3_frame_envelope *envelope,
+                         struct iovec iov[]);
+int rtcm3_writev_all(int fd,
+                     struct iovec iov[],
+                     size_t iovcnt,
+                     size_t *written);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_FRAME_IOV_H */
@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* GLONASS frequency channel numbers of a stream, learnt from the messages
+ * that carry them: 1020 ephemerides, 1010/1012 observations and the satellite
+ * info of MSM5/MSM7. MSM4/MSM6 carry no satellite info and are filled in from
+ * the table, so that their carrier phases can be scaled without an
+ * ephemeris at hand.
+ *
+ * FCNs are kept in the MSM coding, channel + MSM_GLO_FCN_OFFSET, with
+ * MSM_GLO_FCN_UNKNOWN for satellites not seen yet. The L1 and L2 wavelengths
+ * of each known satellite are precomputed when its FCN is set. */
+
+#ifndef SWIFTNAV_RTCM3_GLO_FCN_H
+#define SWIFTNAV_RTCM3_GLO_FCN_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rtcm3/constants.h"
+#include "rtcm3/dispatch.h"
+#include "rtcm3/messages.h"
+
+/* satellite IDs 1 to 64, as in the MSM satellite mask */
+#define RTCM3_GLO_FCN_MAX_SATS MSM_SATELLITE_MASK_SIZE
+
+/* Indexed by satellite ID - 1 */
+typedef struct {
+  uint8_t fcn[RTCM3_GLO_FCN_MAX_SATS];
+  double l1_wavelength_m[RTCM3_GLO_FCN_MAX_SATS]; /* 0 if the FCN is unknown */
+  double l2_wavelength_m[RTCM3_GLO_FCN_MAX_SATS];
+} rtcm3_glo_fcn_table;
+
+void rtcm3_glo_fcn_table_init(rtcm3_glo_fcn_table *table);
+bool rtcm3_glo_fcn_set(rtcm3_glo_fcn_table *table, uint8_t sat_id, uint8_t fcn);
+uint8_t rtcm3_glo_fcn_get(const rtcm3_glo_fcn_table *table, uint8_t sat_id);
+void rtcm3_glo_fcn_from_eph(rtcm3_glo_fcn_table *table,
+                            const rtcm_msg_eph *eph);
+void rtcm3_glo_fcn_from_obs(rtcm3_glo_fcn_table *table,
+                            const rtcm_obs_message *obs);
+void rtcm3_glo_fcn_resolve_msm(rtcm3_glo_fcn_table *table,
+                               rtcm_msm_message *msm);
+void rtcm3_glo_fcn_update(rtcm3_glo_fcn_table *table, rtcm3_msg *msg);
+rtcm3_rc rtcm3_glo_fcn_decode_msg(rtcm3_glo_fcn_table *table,
+                                  const uint8_t buff[],
+                                  rtcm3_msg *msg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_GLO_FCN_H */
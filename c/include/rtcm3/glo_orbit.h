@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* GLONASS satellite states from broadcast ephemerides, for many satellites
+ * at once. The ephemeris gives the state at t_b, which is integrated with
+ * the equations of motion of the GLONASS ICD (fourth order Runge-Kutta).
+ * The state of the last query is kept per satellite and the next query
+ * integrates on from there, or from t_b if that is closer, so that regular
+ * queries cost one short step each. */
+
+#ifndef SWIFTNAV_RTCM3_GLO_ORBIT_H
+#define SWIFTNAV_RTCM3_GLO_ORBIT_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rtcm3/kepler.h"
+#include "rtcm3/messages.h"
+
+#define RTCM3_GLO_ORBIT_MAX_SATS 32
+
+/* Ephemerides and integration states in SI units, PZ-90, times in seconds of
+ * the day in Moscow time */
+typedef struct {
+  uint8_t n;
+  uint8_t sat_id[RTCM3_GLO_ORBIT_MAX_SATS];
+  uint8_t iode[RTCM3_GLO_ORBIT_MAX_SATS]; /* t_b, which SSR uses as IODE */
+  double tb[RTCM3_GLO_ORBIT_MAX_SATS];
+  double tau[RTCM3_GLO_ORBIT_MAX_SATS];
+  double gamma[RTCM3_GLO_ORBIT_MAX_SATS];
+  /* state at t_b */
+  double pos0[3][RTCM3_GLO_ORBIT_MAX_SATS];
+  double vel0[3][RTCM3_GLO_ORBIT_MAX_SATS];
+  /* luni-solar acceleration, constant over the ephemeris */
+  double acc[3][RTCM3_GLO_ORBIT_MAX_SATS];
+  /* state at the last query */
+  double t[RTCM3_GLO_ORBIT_MAX_SATS];
+  double pos[3][RTCM3_GLO_ORBIT_MAX_SATS];
+  double vel[3][RTCM3_GLO_ORBIT_MAX_SATS];
+} rtcm3_glo_orbit_set;
+
+void rtcm3_glo_orbit_init(rtcm3_glo_orbit_set *set);
+bool rtcm3_glo_orbit_add(rtcm3_glo_orbit_set *set, const rtcm_msg_eph *eph);
+void rtcm3_glo_orbit_compute(rtcm3_glo_orbit_set *set,
+                             const double t[],
+                             rtcm3_sat_states *states);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_GLO_ORBIT_H */
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Satellite positions, velocities and clock offsets from Kepler ephemerides
+ * (GPS, Galileo, BeiDou MEO/IGSO and QZSS), for many satellites at once.
+ *
+ * The ephemerides are converted to SI units once and kept as a structure of
+ * arrays, so that computing a whole constellation runs the same straight
+ * line code over contiguous arrays, including a fixed number of Newton steps
+ * for Kepler's equation, which the compiler can vectorize. */
+
+#ifndef SWIFTNAV_RTCM3_KEPLER_H
+#define SWIFTNAV_RTCM3_KEPLER_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rtcm3/messages.h"
+
+#define RTCM3_KEPLER_MAX_SATS 256
+
+/* Ephemerides in SI units, angles in radians, times in seconds of the week
+ * of the constellation */
+typedef struct {
+  uint16_t n;
+  uint8_t sat_id[RTCM3_KEPLER_MAX_SATS];
+  rtcm_constellation_t constellation[RTCM3_KEPLER_MAX_SATS];
+  uint16_t iode[RTCM3_KEPLER_MAX_SATS]; /* IODE, IODnav for Galileo */
+  double toe[RTCM3_KEPLER_MAX_SATS];
+  double toc[RTCM3_KEPLER_MAX_SATS];
+  double sqrta[RTCM3_KEPLER_MAX_SATS];
+  double ecc[RTCM3_KEPLER_MAX_SATS];
+  double m0[RTCM3_KEPLER_MAX_SATS];
+  double dn[RTCM3_KEPLER_MAX_SATS];
+  double omega0[RTCM3_KEPLER_MAX_SATS];
+  double omegadot[RTCM3_KEPLER_MAX_SATS];
+  double w[RTCM3_KEPLER_MAX_SATS];
+  double inc[RTCM3_KEPLER_MAX_SATS];
+  double inc_dot[RTCM3_KEPLER_MAX_SATS];
+  double cuc[RTCM3_KEPLER_MAX_SATS];
+  double cus[RTCM3_KEPLER_MAX_SATS];
+  double crc[RTCM3_KEPLER_MAX_SATS];
+  double crs[RTCM3_KEPLER_MAX_SATS];
+  double cic[RTCM3_KEPLER_MAX_SATS];
+  double cis[RTCM3_KEPLER_MAX_SATS];
+  double af0[RTCM3_KEPLER_MAX_SATS];
+  double af1[RTCM3_KEPLER_MAX_SATS];
+  double af2[RTCM3_KEPLER_MAX_SATS];
+  double mu[RTCM3_KEPLER_MAX_SATS];      /* gravitational constant, m^3/s^2 */
+  double omega_e[RTCM3_KEPLER_MAX_SATS]; /* earth rotation rate, rad/s */
+} rtcm3_kepler_set;
+
+/* ECEF position (m), velocity (m/s), satellite clock offset (s) and drift
+ * (s/s), the clock including the relativistic correction but not the group
+ * delay */
+typedef struct {
+  double x[RTCM3_KEPLER_MAX_SATS];
+  double y[RTCM3_KEPLER_MAX_SATS];
+  double z[RTCM3_KEPLER_MAX_SATS];
+  double vx[RTCM3_KEPLER_MAX_SATS];
+  double vy[RTCM3_KEPLER_MAX_SATS];
+  double vz[RTCM3_KEPLER_MAX_SATS];
+  double clock[RTCM3_KEPLER_MAX_SATS];
+  double clock_rate[RTCM3_KEPLER_MAX_SATS];
+} rtcm3_sat_states;
+
+void rtcm3_kepler_set_init(rtcm3_kepler_set *set);
+bool rtcm3_kepler_set_add(rtcm3_kepler_set *set, const rtcm_msg_eph *eph);
+void rtcm3_kepler_compute(const rtcm3_kepler_set *set,
+                          const double t[],
+                          rtcm3_sat_states *states);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_KEPLER_H */
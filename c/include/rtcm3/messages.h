@@ -132,6 +132,27 @@ typedef struct {
   rtcm_msm_signal_data signals[MSM_MAX_CELLS];
 } rtcm_msm_message;
 
+/* One observation of an MSM epoch */
+typedef struct {
+  uint8_t sat; /* Position in the satellite mask */
+  uint8_t sig; /* Position in the signal mask */
+  rtcm_msm_signal_data data;
+} rtcm_msm_cell;
+
+/* All observations of one constellation at one epoch, which may need more
+ * than one MSM */
+typedef struct {
+  /* Shared by all messages, the masks are set by the encoder. Set the
+   * multiple message bit if more messages of the station follow at this
+   * epoch, the encoder sets it on all but the last message regardless */
+  rtcm_msm_header header;
+  /* Satellite data by position in the satellite mask */
+  rtcm_msm_sat_data sats[MSM_SATELLITE_MASK_SIZE];
+  /* Observations ordered by satellite, then signal */
+  const rtcm_msm_cell *cells;
+  uint16_t num_cells;
+} rtcm_msm_epoch;
+
 typedef struct {
   uint16_t stn_id;
   uint8_t ITRF;        /* Reserved for ITRF Realization Year DF021 uint6 6 */
@@ -177,6 +198,16 @@ typedef struct {
   uint8_t utf8_code_units[RTCM_1029_MAX_CODE_UNITS];
 } rtcm_msg_1029;
 
+/* 1029 with the text left in the frame it was decoded from */
+typedef struct {
+  uint16_t stn_id;
+  uint16_t mjd_num;
+  uint32_t utc_sec_of_day;
+  uint8_t unicode_chars;
+  uint8_t utf8_code_units_n;
+  const uint8_t *utf8_code_units;
+} rtcm_msg_1029_view;
+
 typedef struct {
   uint16_t stn_id;                /* Reference Station ID DF003 uint12 12 */
   uint8_t ant_descriptor_counter; /* Antenna Descriptor Counter N DF029 */
@@ -374,4 +405,13 @@ typedef struct {
   uint8_t data[255];
 } rtcm_msg_swift_proprietary;
 
+/* Swift proprietary message with the payload left in the frame it was decoded
+ * from */
+typedef struct {
+  uint16_t msg_type;
+  uint16_t sender_id;
+  uint8_t len;
+  const uint8_t *data;
+} rtcm_msg_swift_proprietary_view;
+
 #endif /* SWIFTNAV_RTCM3_MESSAGES_H */
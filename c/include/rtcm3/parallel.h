@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Parallel frame scanning of a large in memory stream, e.g. an archive mapped
+ * with rtcm3_archive_open. The buffer is cut into chunks which a pool of
+ * worker threads scan independently; each chunk resynchronizes at the first
+ * frame whose preamble, length and CRC-24Q check out and owns every frame
+ * that starts inside it. POSIX only. */
+
+#ifndef SWIFTNAV_RTCM3_PARALLEL_H
+#define SWIFTNAV_RTCM3_PARALLEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtcm3/frame.h"
+
+#define RTCM3_PARALLEL_DEFAULT_CHUNK_SIZE (8 * 1024 * 1024)
+
+/* Number of chunk slots, chunks are assigned slot chunk_index % slots and at
+ * most this many chunks are in flight */
+#define RTCM3_PARALLEL_NUM_SLOTS(TheNumThreads) (2 * (TheNumThreads))
+
+typedef struct {
+  /* worker threads, 0 for one per online CPU */
+  unsigned num_threads;
+  /* bytes per chunk, 0 for RTCM3_PARALLEL_DEFAULT_CHUNK_SIZE */
+  size_t chunk_size;
+  /* call on_chunk in file order, one chunk at a time */
+  bool ordered;
+  /* called on a worker thread for every frame of a chunk, in order within the
+   * chunk. frame->offset is relative to the start of the whole buffer. */
+  void (*on_frame)(const rtcm3_frame *frame, unsigned slot, void *context);
+  /* called once all frames of a chunk were passed to on_frame, after which
+   * the slot is reused. Unordered, it runs on the worker right away and may
+   * run concurrently for different slots. */
+  void (*on_chunk)(size_t chunk_index, unsigned slot, void *context);
+  void *context;
+} rtcm3_parallel_config;
+
+typedef struct {
+  uint64_t num_frames;
+  uint64_t num_crc_errors;
+  uint64_t skipped_bytes;
+  size_t num_chunks;
+  unsigned num_threads;
+} rtcm3_parallel_stats;
+
+unsigned rtcm3_parallel_num_threads(const rtcm3_parallel_config *config);
+int rtcm3_parallel_scan(const uint8_t data[],
+                        size_t len,
+                        const rtcm3_parallel_config *config,
+                        rtcm3_parallel_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_PARALLEL_H */
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* In-place rewriting of header fields of framed messages, e.g. the station
+ * ID on frames relayed from another caster. Only the bits of the field and
+ * the CRC are touched, the payload is neither decoded nor re-encoded. */
+
+#ifndef SWIFTNAV_RTCM3_PATCH_H
+#define SWIFTNAV_RTCM3_PATCH_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+  RTCM3_FIELD_STN_ID = 0,     /* DF003, observations, MSM, station info */
+  RTCM3_FIELD_EPOCH,          /* DF004, DF034, MSM epoch time, DF385/DF386 */
+  RTCM3_FIELD_IODS,           /* DF409 in MSM, DF413 in SSR */
+  RTCM3_FIELD_SSR_PROVIDER_ID, /* DF414 */
+  RTCM3_FIELD_SSR_SOLUTION_ID, /* DF415 */
+  RTCM3_FIELD_COUNT
+} rtcm3_field;
+
+/** Position of a field in a payload */
+typedef struct {
+  uint16_t bit;
+  uint8_t len;
+} rtcm3_field_location;
+
+bool rtcm3_field_locate(uint16_t msg_num,
+                        rtcm3_field field,
+                        rtcm3_field_location *location);
+bool rtcm3_frame_get_field(const uint8_t frame[],
+                           rtcm3_field field,
+                           uint32_t *value);
+bool rtcm3_frame_set_field(uint8_t frame[], rtcm3_field field, uint32_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_PATCH_H */
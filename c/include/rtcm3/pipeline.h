@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Multi threaded decoding of live streams, e.g. the connections of a caster.
+ *
+ *   connection thread           worker pool                 sink
+ *   rtcm3_pipeline_push() --> [MPMC job queue] --> rtcm3_decode_msg() --+
+ *   (framer per stream)                                                 |
+ *                             reorder per stream <----------------------+
+ *                             sink() in stream order
+ *
+ * Each stream is framed by the thread that pushes its bytes, straight into
+ * the stream's reorder window. Any idle worker decodes the next job from the
+ * shared queue, so a busy stream spreads over all workers. Finished frames
+ * are passed to the sink strictly in the order they were received on their
+ * stream; the sink never runs concurrently for the same stream.
+ *
+ * Backpressure: a stream accepts at most `window` frames that have not been
+ * passed to the sink yet. rtcm3_pipeline_push() stops consuming input when
+ * the window is full and returns how many bytes it took. POSIX only. */
+
+#ifndef SWIFTNAV_RTCM3_PIPELINE_H
+#define SWIFTNAV_RTCM3_PIPELINE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtcm3/dispatch.h"
+#include "rtcm3/frame.h"
+
+#define RTCM3_PIPELINE_DEFAULT_WINDOW 16
+/* limit of num_streams * window, the job queue holds them all */
+#define RTCM3_PIPELINE_MAX_JOBS (1u << 31)
+
+typedef struct rtcm3_pipeline rtcm3_pipeline;
+
+/* frame->offset is the position of the frame in its stream, frame->payload
+ * and msg are only valid during the call */
+typedef void (*rtcm3_pipeline_sink)(uint16_t stream,
+                                    const rtcm3_frame *frame,
+                                    const rtcm3_msg *msg,
+                                    rtcm3_rc rc,
+                                    void *context);
+
+typedef struct {
+  /* decoder threads, 0 for one per online CPU */
+  unsigned num_workers;
+  /* streams are numbered 0 to num_streams - 1 */
+  uint16_t num_streams;
+  /* frames in flight per stream, a power of two, 0 for the default */
+  uint32_t window;
+  rtcm3_pipeline_sink sink;
+  void *context;
+} rtcm3_pipeline_config;
+
+typedef struct {
+  uint64_t frames_in;   /* framed and queued for decoding */
+  uint64_t frames_out;  /* passed to the sink, modulo 2^32 */
+  uint64_t decode_errors;
+  uint64_t crc_errors;
+  uint64_t skipped_bytes;
+  uint64_t backpressure; /* pushes cut short by a full window */
+  uint32_t in_flight;    /* frames_in - frames_out */
+} rtcm3_pipeline_stream_metrics;
+
+typedef struct {
+  uint32_t queue_depth; /* jobs waiting for a worker */
+  uint32_t queue_capacity;
+  uint64_t jobs_decoded;
+  uint64_t idle_polls; /* workers finding the queue empty */
+  unsigned num_workers;
+} rtcm3_pipeline_metrics;
+
+rtcm3_pipeline *rtcm3_pipeline_create(const rtcm3_pipeline_config *config);
+size_t rtcm3_pipeline_push(rtcm3_pipeline *pipeline,
+                           uint16_t stream_id,
+                           const uint8_t data[],
+                           size_t len);
+void rtcm3_pipeline_flush(rtcm3_pipeline *pipeline, uint16_t stream_id);
+void rtcm3_pipeline_get_metrics(const rtcm3_pipeline *pipeline,
+                                rtcm3_pipeline_metrics *metrics);
+void rtcm3_pipeline_get_stream_metrics(const rtcm3_pipeline *pipeline,
+                                       uint16_t stream_id,
+                                       rtcm3_pipeline_stream_metrics *metrics);
+void rtcm3_pipeline_destroy(rtcm3_pipeline *pipeline);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_PIPELINE_H */
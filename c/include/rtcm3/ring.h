@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Lock free bounded queue of fixed size elements in caller provided memory.
+ *
+ * rtcm3_mpmc_queue is Dmitry Vyukov's bounded queue, safe for any number of
+ * producers and consumers. It never blocks: a full or empty queue is reported
+ * and the caller decides whether to retry, drop or back off. */
+
+#ifndef SWIFTNAV_RTCM3_RING_H
+#define SWIFTNAV_RTCM3_RING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* keeps the enqueue and dequeue positions on separate cache lines */
+#define RTCM3_RING_CACHE_LINE 64
+
+typedef struct {
+  uint8_t *cells;
+  size_t elem_size;
+  size_t cell_size;
+  uint32_t mask;
+  uint8_t pad0[RTCM3_RING_CACHE_LINE];
+  uint32_t enqueue_pos;
+  uint8_t pad1[RTCM3_RING_CACHE_LINE];
+  uint32_t dequeue_pos;
+  uint8_t pad2[RTCM3_RING_CACHE_LINE];
+} rtcm3_mpmc_queue;
+
+size_t rtcm3_mpmc_buffer_size(size_t elem_size, uint32_t capacity);
+bool rtcm3_mpmc_init(rtcm3_mpmc_queue *queue,
+                     void *buffer,
+                     size_t elem_size,
+                     uint32_t capacity);
+bool rtcm3_mpmc_push(rtcm3_mpmc_queue *queue, const void *elem);
+bool rtcm3_mpmc_pop(rtcm3_mpmc_queue *queue, void *elem);
+uint32_t rtcm3_mpmc_size(const rtcm3_mpmc_queue *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_RING_H */
@@ -0,0 +1,44 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* SBP tunnelled over RTCM in Swift proprietary 4062 messages. Frames are
+ * unwrapped to a view of the SBP payload in place and SBP payloads are
+ * wrapped into frames with a single copy, without going through the 255 byte
+ * rtcm_msg_swift_proprietary. */
+
+#ifndef SWIFTNAV_RTCM3_SBP_TUNNEL_H
+#define SWIFTNAV_RTCM3_SBP_TUNNEL_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#include "rtcm3/frame.h"
+#include "rtcm3/messages.h"
+
+/* message number, reserved bits, SBP message type, sender ID and length */
+#define RTCM3_4062_HEADER_LEN 7
+#define RTCM3_SBP_MAX_FRAME_LEN \
+  (RTCM3_FRAME_OVERHEAD + RTCM3_4062_HEADER_LEN + 255)
+
+rtcm3_rc rtcm3_sbp_unwrap(const rtcm3_frame *frame,
+                          rtcm_msg_swift_proprietary_view *sbp);
+uint16_t rtcm3_sbp_wrap(const rtcm_msg_swift_proprietary_view *sbp,
+                        uint8_t frame[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_SBP_TUNNEL_H */
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* SSR orbit and clock corrections applied to the broadcast states of a whole
+ * ephemeris set in one call.
+ *
+ * The corrections are first gathered from an SSR store into a structure of
+ * arrays lined up with the satellites of a Kepler or GLONASS set, in SI
+ * units, looking each satellite up once and checking its IODE against the
+ * ephemeris. Applying them to the states of rtcm3_kepler_compute or
+ * rtcm3_glo_orbit_compute is then a single branch free pass, satellites
+ * without a matching correction carry zeros and keep their broadcast state.
+ *
+ * The orbit correction is given in the radial, along track and cross track
+ * frame of the broadcast position and velocity and is subtracted from the
+ * broadcast position, the clock correction is added to the broadcast clock,
+ * as in RTCM 10403.3. BeiDou corrections refer to the IODCRC of the
+ * ephemeris, which the ephemeris decoder does not keep, so BeiDou satellites
+ * are left uncorrected. */
+
+#ifndef SWIFTNAV_RTCM3_SSR_APPLY_H
+#define SWIFTNAV_RTCM3_SSR_APPLY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rtcm3/glo_orbit.h"
+#include "rtcm3/kepler.h"
+#include "rtcm3/ssr_store.h"
+
+/* Corrections of the satellites of a set, in the same order. Distances in m,
+ * times in seconds of the week, or of the day for GLONASS. */
+typedef struct {
+  uint16_t n;
+  uint16_t num_corrected;
+  bool corrected[RTCM3_KEPLER_MAX_SATS];
+  double period[RTCM3_KEPLER_MAX_SATS]; /* of the time of the constellation */
+  double orbit_time[RTCM3_KEPLER_MAX_SATS];
+  double radial[RTCM3_KEPLER_MAX_SATS];
+  double along_track[RTCM3_KEPLER_MAX_SATS];
+  double cross_track[RTCM3_KEPLER_MAX_SATS];
+  double dot_radial[RTCM3_KEPLER_MAX_SATS];
+  double dot_along_track[RTCM3_KEPLER_MAX_SATS];
+  double dot_cross_track[RTCM3_KEPLER_MAX_SATS];
+  double clock_time[RTCM3_KEPLER_MAX_SATS];
+  double c0[RTCM3_KEPLER_MAX_SATS]; /* high rate clock included */
+  double c1[RTCM3_KEPLER_MAX_SATS];
+  double c2[RTCM3_KEPLER_MAX_SATS];
+} rtcm3_ssr_batch;
+
+uint16_t rtcm3_ssr_batch_kepler(rtcm3_ssr_batch *batch,
+                                const rtcm3_ssr_store *store,
+                                const rtcm3_kepler_set *set,
+                                uint32_t time_s);
+uint16_t rtcm3_ssr_batch_glo(rtcm3_ssr_batch *batch,
+                             const rtcm3_ssr_store *store,
+                             const rtcm3_glo_orbit_set *set,
+                             uint32_t time_s);
+void rtcm3_ssr_batch_apply(const rtcm3_ssr_batch *batch,
+                           const double t[],
+                           const rtcm3_sat_states *broadcast,
+                           rtcm3_sat_states *precise);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_SSR_APPLY_H */
@@ -24,4 +24,61 @@ rtcm3_rc rtcm3_decode_code_bias(const uint8_t buff[],
 rtcm3_rc rtcm3_decode_phase_bias(const uint8_t buff[],
                                  rtcm_msg_phase_bias *msg_phase_bias);
 
+/* Per satellite part of a bias message, the yaw is only sent with phase
+ * biases */
+typedef struct {
+  uint8_t sat_id;
+  uint8_t num_biases;
+  uint16_t yaw_angle;
+  int8_t yaw_rate;
+} rtcm3_ssr_bias_sat;
+
+/* Callbacks of rtcm3_decode_ssr_visit, any of them may be NULL */
+typedef struct {
+  bool (*header)(void *ctx, const rtcm_msg_ssr_header *header);
+  void (*orbit)(void *ctx, const rtcm_msg_ssr_orbit_corr *orbit);
+  void (*clock)(void *ctx, const rtcm_msg_ssr_clock_corr *clock);
+  void (*bias_sat)(void *ctx, const rtcm3_ssr_bias_sat *sat);
+  void (*code_bias)(void *ctx,
+                    uint8_t sat_id,
+                    const rtcm_msg_ssr_code_bias_sig *sig);
+  void (*phase_bias)(void *ctx,
+                     uint8_t sat_id,
+                     const rtcm_msg_ssr_phase_bias_sig *sig);
+} rtcm3_ssr_visitor;
+
+rtcm3_rc rtcm3_decode_ssr_visit(const uint8_t buff[],
+                                const rtcm3_ssr_visitor *visitor,
+                                void *ctx);
+
+/* sat_id is at most 6 bits in all SSR messages */
+#define RTCM3_SSR_MAX_SAT_ID 64
+
+/* High rate clock correction and URA of one satellite, each with the epoch
+ * time and IOD SSR of the message it was last updated from */
+typedef struct {
+  bool has_hr_clock;
+  uint8_t hr_clock_iod_ssr;
+  uint32_t hr_clock_epoch_time;
+  int32_t high_rate_clock; /* 0.1 mm, added to the clock correction */
+  bool has_ura;
+  uint8_t ura_iod_ssr;
+  uint32_t ura_epoch_time;
+  uint8_t ura; /* class in bits 5-3, value in bits 2-0 */
+} rtcm3_ssr_clock_sat;
+
+/* Target of the high rate clock and URA decoders, indexed by constellation
+ * and satellite ID */
+typedef struct {
+  rtcm3_ssr_clock_sat sats[RTCM_CONSTELLATION_COUNT][RTCM3_SSR_MAX_SAT_ID];
+} rtcm3_ssr_clock_table;
+
+void rtcm3_ssr_clock_table_init(rtcm3_ssr_clock_table *table);
+rtcm3_rc rtcm3_decode_hr_clock(const uint8_t buff[],
+                               rtcm_msg_ssr_header *header,
+                               rtcm3_ssr_clock_table *table);
+rtcm3_rc rtcm3_decode_ura(const uint8_t buff[],
+                          rtcm_msg_ssr_header *header,
+                          rtcm3_ssr_clock_table *table);
+
 #endif /* SWIFTNAV_RTCM3_SSR_DECODE_H */
@@ -0,0 +1,78 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Encoders of the SSR messages, the mirror of ssr_decode.h. The message
+ * number in the header selects the constellation and with it the widths of
+ * the epoch time, satellite ID and IODE fields.
+ *
+ * The *_frames variants write the message as a sequence of complete frames,
+ * split wherever the next satellite would not fit into one payload or the
+ * 6 bit satellite count. All but the last frame carry the multiple message
+ * bit, the last keeps the one of the header. */
+
+#ifndef SWIFTNAV_RTCM3_SSR_ENCODE_H
+#define SWIFTNAV_RTCM3_SSR_ENCODE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "rtcm3/messages.h"
+
+uint16_t rtcm3_encode_orbit(const rtcm_msg_orbit *msg_orbit, uint8_t buff[]);
+uint16_t rtcm3_encode_clock(const rtcm_msg_clock *msg_clock, uint8_t buff[]);
+uint16_t rtcm3_encode_orbit_clock(const rtcm_msg_orbit_clock *msg_orbit_clock,
+                                  uint8_t buff[]);
+uint16_t rtcm3_encode_code_bias(const rtcm_msg_code_bias *msg_code_bias,
+                                uint8_t buff[]);
+uint16_t rtcm3_encode_phase_bias(const rtcm_msg_phase_bias *msg_phase_bias,
+                                 uint8_t buff[]);
+
+uint16_t rtcm3_encoded_size_orbit(const rtcm_msg_orbit *msg_orbit);
+uint16_t rtcm3_encoded_size_clock(const rtcm_msg_clock *msg_clock);
+uint16_t rtcm3_encoded_size_orbit_clock(
+    const rtcm_msg_orbit_clock *msg_orbit_clock);
+uint16_t rtcm3_encoded_size_code_bias(const rtcm_msg_code_bias *msg_code_bias);
+uint16_t rtcm3_encoded_size_phase_bias(
+    const rtcm_msg_phase_bias *msg_phase_bias);
+
+uint8_t rtcm3_encode_orbit_frames(const rtcm_msg_orbit *msg_orbit,
+                                  uint8_t buff[],
+                                  size_t buff_len,
+                                  size_t *len);
+uint8_t rtcm3_encode_clock_frames(const rtcm_msg_clock *msg_clock,
+                                  uint8_t buff[],
+                                  size_t buff_len,
+                                  size_t *len);
+uint8_t rtcm3_encode_orbit_clock_frames(
+    const rtcm_msg_orbit_clock *msg_orbit_clock,
+    uint8_t buff[],
+    size_t buff_len,
+    size_t *len);
+uint8_t rtcm3_encode_code_bias_frames(const rtcm_msg_code_bias *msg_code_bias,
+                                      uint8_t buff[],
+                                      size_t buff_len,
+                                      size_t *len);
+uint8_t rtcm3_encode_phase_bias_frames(
+    const rtcm_msg_phase_bias *msg_phase_bias,
+    uint8_t buff[],
+    size_t buff_len,
+    size_t *len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_SSR_ENCODE_H */
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Latest SSR corrections of one provider and solution, indexed by
+ * constellation, satellite and signal, so that applying them is a table
+ * lookup instead of a search through the decoded messages.
+ *
+ * A provider splits the corrections of one epoch over several messages, the
+ * multiple message bit is set on all of them but the last. The store
+ * assembles each such set per constellation and correction kind and only
+ * serves a set once its last message has arrived. Every satellite keeps two
+ * slots per kind, one for the last complete set and one for the set being
+ * assembled, which makes switching over to a completed set a matter of
+ * bumping its sequence number. Satellites missing from the latest set are
+ * dropped along with it.
+ *
+ * High rate clock and URA messages are not assembled into sets, each
+ * satellite is updated as it arrives.
+ *
+ * Orbit, clock and biases are only combined when their IOD SSR agrees, and
+ * orbit and clock corrections older than max_age_s are not served. The store
+ * is not locked. */
+
+#ifndef SWIFTNAV_RTCM3_SSR_STORE_H
+#define SWIFTNAV_RTCM3_SSR_STORE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rtcm3/messages.h"
+#include "rtcm3/ssr_decode.h"
+
+/* sat_id is at most 6 bits and the signal ID 5 bits in all SSR messages */
+#define RTCM3_SSR_STORE_MAX_SATS 64
+#define RTCM3_SSR_STORE_MAX_SIGNALS 32
+/* default age limit of orbit and clock corrections */
+#define RTCM3_SSR_MAX_AGE_S 90
+
+typedef enum {
+  RTCM3_SSR_ORBIT = 0,
+  RTCM3_SSR_CLOCK,
+  RTCM3_SSR_CODE_BIAS,
+  RTCM3_SSR_PHASE_BIAS,
+  RTCM3_SSR_KIND_COUNT
+} rtcm3_ssr_kind;
+
+/* A set of corrections sharing epoch time and IOD SSR */
+typedef struct {
+  uint32_t seq;          /* set being assembled, 0 before the first message */
+  uint32_t complete_seq; /* last complete set, 0 if there is none */
+  bool assembling;
+  uint32_t epoch_time;
+  uint8_t iod_ssr;
+  uint8_t update_interval;
+  /* slot and header of the last complete set */
+  uint8_t complete_slot;
+  uint32_t complete_epoch_time;
+  uint8_t complete_iod_ssr;
+} rtcm3_ssr_set;
+
+typedef struct {
+  uint32_t orbit_seq[2];
+  rtcm_msg_ssr_orbit_corr orbit[2];
+  uint32_t clock_seq[2];
+  rtcm_msg_ssr_clock_corr clock[2];
+  uint32_t code_bias_seq[2];
+  uint32_t code_bias_mask[2]; /* bit per signal ID */
+  int16_t code_bias[2][RTCM3_SSR_STORE_MAX_SIGNALS];
+  uint32_t phase_bias_seq[2];
+  uint32_t phase_bias_mask[2];
+  uint16_t yaw_angle[2];
+  int8_t yaw_rate[2];
+  rtcm_msg_ssr_phase_bias_sig phase_bias[2][RTCM3_SSR_STORE_MAX_SIGNALS];
+} rtcm3_ssr_sat;
+
+typedef struct {
+  rtcm3_ssr_sat sats[RTCM_CONSTELLATION_COUNT][RTCM3_SSR_STORE_MAX_SATS];
+  rtcm3_ssr_set sets[RTCM_CONSTELLATION_COUNT][RTCM3_SSR_KIND_COUNT];
+  rtcm3_ssr_clock_table clocks;
+  /* provider and solution of the first message, others are rejected */
+  bool locked;
+  uint16_t provider_id;
+  uint8_t solution_id;
+  uint32_t max_age_s;
+  uint32_t rejected; /* messages of another provider or solution */
+} rtcm3_ssr_store;
+
+/* Corrections for one satellite and signal. Pointers are NULL where the
+ * store has no consistent value and stay valid until the next update. */
+typedef struct {
+  uint8_t iod_ssr;
+  uint32_t orbit_epoch_time;
+  uint32_t clock_epoch_time;
+  const rtcm_msg_ssr_orbit_corr *orbit;
+  const rtcm_msg_ssr_clock_corr *clock;
+  const int16_t *code_bias;
+  const rtcm_msg_ssr_phase_bias_sig *phase_bias;
+  uint16_t yaw_angle;
+  int8_t yaw_rate;
+  const int32_t *high_rate_clock; /* 0.1 mm, on top of the clock */
+  const uint8_t *ura;
+} rtcm3_ssr_corrections;
+
+void rtcm3_ssr_store_init(rtcm3_ssr_store *store);
+rtcm3_rc rtcm3_ssr_store_add_orbit(rtcm3_ssr_store *store,
+                                   const rtcm_msg_orbit *msg_orbit);
+rtcm3_rc rtcm3_ssr_store_add_clock(rtcm3_ssr_store *store,
+                                   const rtcm_msg_clock *msg_clock);
+rtcm3_rc rtcm3_ssr_store_add_orbit_clock(
+    rtcm3_ssr_store *store, const rtcm_msg_orbit_clock *msg_orbit_clock);
+rtcm3_rc rtcm3_ssr_store_add_code_bias(
+    rtcm3_ssr_store *store, const rtcm_msg_code_bias *msg_code_bias);
+rtcm3_rc rtcm3_ssr_store_add_phase_bias(
+    rtcm3_ssr_store *store, const rtcm_msg_phase_bias *msg_phase_bias);
+rtcm3_rc rtcm3_ssr_store_update(rtcm3_ssr_store *store,
+                                const uint8_t payload[]);
+bool rtcm3_ssr_store_lookup(const rtcm3_ssr_store *store,
+                            rtcm_constellation_t constellation,
+                            uint8_t sat_id,
+                            uint8_t signal_id,
+                            uint32_t time_s,
+                            rtcm3_ssr_corrections *corr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_SSR_STORE_H */
@@ -0,0 +1,90 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Latest metadata of every reference station, from the 1005, 1006, 1007,
+ * 1008, 1033 and 1230 messages that repeat every few seconds on a stream.
+ * Only messages whose payload differs from the last one of the same type and
+ * station are decoded.
+ *
+ * Updates have to be serialized by the caller, e.g. made from the one thread
+ * that reads the streams. Reads take no lock and may run on any number of
+ * threads alongside the updates: each station is guarded by a sequence
+ * counter and a read retries while it overlaps an update. */
+
+#ifndef SWIFTNAV_RTCM3_STATION_REGISTRY_H
+#define SWIFTNAV_RTCM3_STATION_REGISTRY_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rtcm3/messages.h"
+
+/* DF003 is 12 bits */
+#define RTCM3_STATION_MAX_ID 4095
+
+/* 1005, 1006, 1007, 1008, 1033 and 1230 */
+#define RTCM3_STATION_MSG_TYPES 6
+
+/* last payload of each type, at most 19 + 21 + 36 + 68 + 164 + 12 bytes */
+#define RTCM3_STATION_PAYLOAD_BYTES 320
+
+/* parts of the station info received so far */
+#define RTCM3_STATION_ARP 0x01            /* 1005 or 1006 */
+#define RTCM3_STATION_ARP_HEIGHT 0x02     /* 1006 */
+#define RTCM3_STATION_ANTENNA 0x04        /* 1007 or 1008 */
+#define RTCM3_STATION_ANTENNA_SERIAL 0x08 /* 1008 */
+#define RTCM3_STATION_DESCRIPTORS 0x10    /* 1033 */
+#define RTCM3_STATION_GLO_BIASES 0x20     /* 1230 */
+
+/** Station metadata by what it describes. A 1005 updates the position and
+ *  keeps the height of an earlier 1006, a 1007 the antenna descriptor and
+ *  keeps the serial number of an earlier 1008. */
+typedef struct {
+  uint8_t have; /* RTCM3_STATION_* bits */
+  rtcm_msg_1006 arp;
+  rtcm_msg_1008 antenna;
+  rtcm_msg_1033 descriptors;
+  rtcm_msg_1230 glo_biases;
+} rtcm3_station_info;
+
+typedef struct {
+  uint32_t seq; /* odd while an update is being written */
+  uint16_t payload_len[RTCM3_STATION_MSG_TYPES];
+  uint64_t hash[RTCM3_STATION_MSG_TYPES];
+  uint8_t payloads[RTCM3_STATION_PAYLOAD_BYTES];
+  rtcm3_station_info info;
+} rtcm3_station;
+
+typedef struct {
+  rtcm3_station stations[RTCM3_STATION_MAX_ID + 1];
+  uint32_t decoded;    /* messages with new content */
+  uint32_t duplicates; /* messages matching the last payload */
+} rtcm3_station_registry;
+
+void rtcm3_station_registry_init(rtcm3_station_registry *registry);
+rtcm3_rc rtcm3_station_registry_update(rtcm3_station_registry *registry,
+                                       const uint8_t payload[],
+                                       uint16_t payload_len,
+                                       bool *is_new);
+bool rtcm3_station_registry_get(const rtcm3_station_registry *registry,
+                                uint16_t stn_id,
+                                rtcm3_station_info *info);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_STATION_REGISTRY_H */
@@ -0,0 +1,91 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Per message type latency histograms for the decoder and encoder entry
+ * points. The entry points only record into these histograms when the library
+ * is built with LIBRTCM_ENABLE_TIMING, otherwise the histograms stay empty.
+ *
+ * Histograms are log-linear: values below 2^RTCM_TIMING_SUB_BUCKET_BITS ns
+ * are counted exactly, above that every power of two is split into
+ * RTCM_TIMING_SUB_BUCKETS equal buckets, which keeps the relative error of the
+ * reported percentiles under 1 / RTCM_TIMING_SUB_BUCKETS.
+ */
+
+#ifndef SWIFTNAV_RTCM3_TIMING_H
+#define SWIFTNAV_RTCM3_TIMING_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define RTCM_TIMING_SUB_BUCKET_BITS 4
+#define RTCM_TIMING_SUB_BUCKETS (1 << RTCM_TIMING_SUB_BUCKET_BITS)
+/* durations of 2^RTCM_TIMING_MAX_MAGNITUDE ns or more go to the last bucket */
+#define RTCM_TIMING_MAX_MAGNITUDE 32
+/* one group per magnitude up to RTCM_TIMING_MAX_MAGNITUDE - 1, plus a group
+ * holding the overflow bucket so that it shares no range with the others */
+#define RTCM_TIMING_NUM_BUCKETS                                      \
+  ((RTCM_TIMING_MAX_MAGNITUDE - RTCM_TIMING_SUB_BUCKET_BITS + 2) * \
+   RTCM_TIMING_SUB_BUCKETS)
+/* maximum number of distinct (operation, message number) histograms */
+#define RTCM_TIMING_MAX_HISTOGRAMS 64
+
+typedef enum rtcm_timing_op_e {
+  RTCM_TIMING_DECODE = 0,
+  RTCM_TIMING_ENCODE = 1
+} rtcm_timing_op;
+
+typedef struct {
+  uint32_t key; /* (op << 16 | msg_num) + 1, 0 when the slot is unused */
+  uint64_t count;
+  uint64_t total_ns;
+  uint64_t min_ns;
+  uint64_t max_ns;
+  uint64_t buckets[RTCM_TIMING_NUM_BUCKETS];
+} rtcm_timing_histogram;
+
+typedef struct {
+  uint16_t msg_num;
+  uint8_t op; /* rtcm_timing_op */
+  uint64_t count;
+  uint64_t min_ns;
+  uint64_t max_ns;
+  double mean_ns;
+  uint64_t p50_ns;
+  uint64_t p99_ns;
+  uint64_t p999_ns;
+} rtcm_timing_stats;
+
+typedef void (*rtcm_timing_callback)(const rtcm_timing_stats *stats,
+                                     void *context);
+
+void rtcm_timing_record(rtcm_timing_op op,
+                        uint16_t msg_num,
+                        uint64_t duration_ns);
+const rtcm_timing_histogram *rtcm_timing_get(rtcm_timing_op op,
+                                             uint16_t msg_num);
+uint64_t rtcm_timing_percentile(const rtcm_timing_histogram *hist,
+                                double percentile);
+bool rtcm_timing_get_stats(rtcm_timing_op op,
+                           uint16_t msg_num,
+                           rtcm_timing_stats *stats);
+void rtcm_timing_foreach(rtcm_timing_callback callback, void *context);
+void rtcm_timing_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SWIFTNAV_RTCM3_TIMING_H */
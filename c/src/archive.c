@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/archive.h"
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/** Map an archive file into memory
+ *
+ * The whole file is mapped read only and the kernel is told it will be read
+ * sequentially, so read ahead is aggressive and pages behind the reader are
+ * dropped early. Transparent huge pages are requested where the platform
+ * supports them, which cuts the TLB misses of a multi gigabyte walk.
+ *
+ * \param archive Set to the mapping, empty for an empty file
+ * \param path File to open
+ * \return 0 on success or an errno value
+ */
+int rtcm3_archive_open(rtcm3_archive *archive, const char *path) {
+  assert(archive);
+  assert(path);
+  memset(archive, 0, sizeof(*archive));
+
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    return errno;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    int err = errno;
+    close(fd);
+    return err;
+  }
+  if (0 == st.st_size) {
+    close(fd);
+    return 0;
+  }
+
+  void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  int err = (MAP_FAILED == data) ? errno : 0;
+  /* the mapping keeps its own reference to the file */
+  close(fd);
+  if (0 != err) {
+    return err;
+  }
+
+  /* hints only, failures are harmless */
+  (void)madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+#ifdef MADV_HUGEPAGE
+  (void)madvise(data, (size_t)st.st_size, MADV_HUGEPAGE);
+#endif
+
+  archive->data = data;
+  archive->len = (size_t)st.st_size;
+  return 0;
+}
+
+/** Start scanning the frames of an archive
+ *
+ * \param archive Archive opened with rtcm3_archive_open
+ * \param scanner Scanner over the whole mapping
+ */
+void rtcm3_archive_scanner_init(const rtcm3_archive *archive,
+                                rtcm3_frame_scanner *scanner) {
+  assert(archive);
+  rtcm3_frame_scanner_init(scanner, archive->data, archive->len);
+}
+
+/** Unmap an archive, frame views into it become invalid
+ *
+ * \param archive Archive opened with rtcm3_archive_open
+ */
+void rtcm3_archive_close(rtcm3_archive *archive) {
+  assert(archive);
+  if (NULL != archive->data) {
+    munmap((void *)archive->data, archive->len);
+  }
+  memset(archive, 0, sizeof(*archive));
+}
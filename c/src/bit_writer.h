@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Private sequential bit writer for the encoders. Fields are collected in a
+ * 64 bit accumulator and stored a whole byte at a time, instead of the bit by
+ * bit read-modify-write of rtcm_setbitu. The output is written from its
+ * first byte on, and the padding of the last byte is zero. */
+
+#ifndef SWIFTNAV_RTCM3_BIT_WRITER_H
+#define SWIFTNAV_RTCM3_BIT_WRITER_H
+
+#include <stdint.h>
+
+typedef struct {
+  uint8_t *buff;
+  uint32_t byte;     /* next byte to store */
+  uint64_t acc;      /* bits not stored yet, in the low acc_bits bits */
+  uint32_t acc_bits; /* at most 7 between calls */
+} rtcm_bit_writer;
+
+static inline void rtcm_bit_writer_init(rtcm_bit_writer *writer,
+                                        uint8_t buff[]) {
+  writer->buff = buff;
+  writer->byte = 0;
+  writer->acc = 0;
+  writer->acc_bits = 0;
+}
+
+/* Append the low len bits of value, len <= 32 */
+static inline void rtcm_bit_writer_put(rtcm_bit_writer *writer,
+                                       uint8_t len,
+                                       uint32_t value) {
+  uint64_t mask = (((uint64_t)1) << len) - 1;
+  writer->acc = (writer->acc << len) | (value & mask);
+  writer->acc_bits += len;
+  while (writer->acc_bits >= 8) {
+    writer->acc_bits -= 8;
+    writer->buff[writer->byte++] = (uint8_t)(writer->acc >> writer->acc_bits);
+  }
+}
+
+static inline void rtcm_bit_writer_put_signed(rtcm_bit_writer *writer,
+                                              uint8_t len,
+                                              int32_t value) {
+  rtcm_bit_writer_put(writer, len, (uint32_t)value);
+}
+
+/* Number of bits written so far */
+static inline uint32_t rtcm_bit_writer_bits(const rtcm_bit_writer *writer) {
+  return writer->byte * 8 + writer->acc_bits;
+}
+
+/* Store the last partial byte, returns the number of bytes written */
+static inline uint32_t rtcm_bit_writer_finish(rtcm_bit_writer *writer) {
+  if (writer->acc_bits > 0) {
+    writer->buff[writer->byte++] =
+        (uint8_t)(writer->acc << (8 - writer->acc_bits));
+    writer->acc_bits = 0;
+  }
+  return writer->byte;
+}
+
+#endif /* SWIFTNAV_RTCM3_BIT_WRITER_H */
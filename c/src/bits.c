@@ -10,6 +10,8 @@
  * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
  */
 
+#include <string.h>
+
 #include <rtcm3/bits.h>
 
 /** Get bit field from buffer as an unsigned integer.
@@ -180,3 +182,99 @@ int32_t rtcm_get_sign_magnitude_bit(const uint8_t *buff,
   int32_t value = rtcm_getbitu(buff, pos + 1, len - 1);
   return rtcm_getbitu(buff, pos, 1) ? -value : value;
 }
+
+/* Set sign-magnitude bits, See Note 1, Table 3.3-1, RTCM 3.3
+ * \param buff
+ * \param pos Position in buffer of start of bit field in bits.
+ * \param len Length of bit field in bits.
+ * \param data Signed integer to be packed into bit field.
+ */
+void rtcm_set_sign_magnitude_bit(uint8_t *buff,
+                                 uint32_t pos,
+                                 uint8_t len,
+                                 int32_t data) {
+  rtcm_setbitu(buff, pos, 1, data < 0 ? 1 : 0);
+  uint32_t magnitude = data < 0 ? -(uint32_t)data : (uint32_t)data;
+  rtcm_setbitu(buff, pos + 1, len - 1u, magnitude);
+}
+
+static uint64_t load_be64(const uint8_t *p) {
+  uint64_t word = 0;
+  for (uint8_t i = 0; i < 8; i++) {
+    word = (word << 8) | p[i];
+  }
+  return word;
+}
+
+static void store_be64(uint8_t *p, uint64_t word) {
+  for (uint8_t i = 0; i < 8; i++) {
+    p[i] = (uint8_t)(word >> (56 - 8 * i));
+  }
+}
+
+/** Get a run of whole bytes from a buffer at any bit position.
+ * Unpacks `len` bytes, i.e. `8 * len` bits, at bit position `pos` from the
+ * start of the buffer. Byte aligned runs are a plain memcpy, otherwise eight
+ * bytes at a time are shifted out of a 64 bit word. The output must not
+ * overlap the input.
+ *
+ * \param buff
+ * \param pos Position in buffer of start of the run in bits.
+ * \param out Destination for `len` bytes.
+ * \param len Length of the run in bytes.
+ */
+void rtcm_getbytes(const uint8_t *buff,
+                   uint32_t pos,
+                   uint8_t *out,
+                   uint32_t len) {
+  const uint8_t *src = buff + pos / 8;
+  uint8_t shift = pos % 8;
+
+  if (shift == 0) {
+    memcpy(out, src, len);
+    return;
+  }
+
+  uint32_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    uint64_t word =
+        (load_be64(&src[i]) << shift) | (src[i + 8] >> (8 - shift));
+    store_be64(&out[i], word);
+  }
+  for (; i < len; i++) {
+    out[i] = (uint8_t)((src[i] << shift) | (src[i + 1] >> (8 - shift)));
+  }
+}
+
+/** Set a run of whole bytes in a buffer at any bit position.
+ * Packs `len` bytes, i.e. `8 * len` bits, into bit position `pos` from the
+ * start of the buffer. The bits either side of the run are left untouched,
+ * as with `rtcm_setbitu`. The input must not overlap the output.
+ *
+ * \param buff
+ * \param pos Position in buffer of start of the run in bits.
+ * \param data Source of `len` bytes.
+ * \param len Length of the run in bytes.
+ */
+void rtcm_setbytes(uint8_t *buff,
+                   uint32_t pos,
+                   const uint8_t *data,
+                   uint32_t len) {
+  uint8_t *dst = buff + pos / 8;
+  uint8_t shift = pos % 8;
+
+  if (shift == 0) {
+    memcpy(dst, data, len);
+    return;
+  }
+  if (len == 0) {
+    return;
+  }
+
+  uint8_t keep = (uint8_t)(0xff << (8 - shift));
+  dst[0] = (uint8_t)((dst[0] & keep) | (data[0] >> shift));
+  /* every whole output byte straddles two input bytes, which is the input
+   * read back at the complementary offset */
+  rtcm_getbytes(data, 8u - shift, &dst[1], len - 1);
+  dst[len] = (uint8_t)((data[len - 1] << (8 - shift)) | (dst[len] & ~keep));
+}
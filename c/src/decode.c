@@ -18,6 +18,7 @@
 #include "rtcm3/bits.h"
 #include "rtcm3/eph_decode.h"
 #include "rtcm3/msm_utils.h"
+#include "instrument.h"
 
 /* macros for reading rcv/ant descriptor strings */
 #define GET_STR_LEN(TheBuff, TheIdx, TheOutput)         \
@@ -29,12 +30,10 @@
     (TheIdx) += 8;                                      \
   } while (false);
 
-#define GET_STR(TheBuff, TheIdx, TheLen, TheOutput)          \
-  do {                                                       \
-    for (uint8_t i = 0; i < (TheLen); ++i) {                 \
-      (TheOutput)[i] = rtcm_getbitu((TheBuff), (TheIdx), 8); \
-      (TheIdx) += 8;                                         \
-    }                                                        \
+#define GET_STR(TheBuff, TheIdx, TheLen, TheOutput)                      \
+  do {                                                                   \
+    rtcm_getbytes((TheBuff), (TheIdx), (uint8_t *)(TheOutput), (TheLen)); \
+    (TheIdx) += 8 * (TheLen);                                            \
   } while (false);
 
 static void init_sat_data(rtcm_sat_data *sat_data) {
@@ -363,16 +362,8 @@ static uint8_t get_cnr(rtcm_freq_data *freq_data,
   return 1;
 }
 
-/** Decode an RTCMv3 message type 1001 (L1-Only GPS RTK Observables)
- *
- * \param buff The input data buffer
- * \param RTCM message struct
- * \return  - RC_OK : Success
- *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
- *          - RC_INVALID_MESSAGE : TOW sanity check fail
- */
-rtcm3_rc rtcm3_decode_1001(const uint8_t buff[], rtcm_obs_message *msg_1001) {
-  assert(msg_1001);
+static rtcm3_rc rtcm3_decode_1001_internal(const uint8_t buff[],
+                                           rtcm_obs_message *msg_1001) {
   uint16_t bit = 0;
   bit += rtcm3_read_header(buff, &msg_1001->header);
 
@@ -406,7 +397,7 @@ rtcm3_rc rtcm3_decode_1001(const uint8_t buff[], rtcm_obs_message *msg_1001) {
   return RC_OK;
 }
 
-/** Decode an RTCMv3 message type 1002 (Extended L1-Only GPS RTK Observables)
+/** Decode an RTCMv3 message type 1001 (L1-Only GPS RTK Observables)
  *
  * \param buff The input data buffer
  * \param RTCM message struct
@@ -414,8 +405,14 @@ rtcm3_rc rtcm3_decode_1001(const uint8_t buff[], rtcm_obs_message *msg_1001) {
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
  *          - RC_INVALID_MESSAGE : TOW sanity check fail
  */
-rtcm3_rc rtcm3_decode_1002(const uint8_t buff[], rtcm_obs_message *msg_1002) {
-  assert(msg_1002);
+rtcm3_rc rtcm3_decode_1001(const uint8_t buff[], rtcm_obs_message *msg_1001) {
+  assert(msg_1001);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_1001_internal(buff, msg_1001));
+}
+
+static rtcm3_rc rtcm3_decode_1002_internal(const uint8_t buff[],
+                                           rtcm_obs_message *msg_1002) {
   uint16_t bit = 0;
   bit += rtcm3_read_header(buff, &msg_1002->header);
 
@@ -453,7 +450,7 @@ rtcm3_rc rtcm3_decode_1002(const uint8_t buff[], rtcm_obs_message *msg_1002) {
   return RC_OK;
 }
 
-/** Decode an RTCMv3 message type 1003 (L1/L2 GPS RTK Observables)
+/** Decode an RTCMv3 message type 1002 (Extended L1-Only GPS RTK Observables)
  *
  * \param buff The input data buffer
  * \param RTCM message struct
@@ -461,8 +458,14 @@ rtcm3_rc rtcm3_decode_1002(const uint8_t buff[], rtcm_obs_message *msg_1002) {
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
  *          - RC_INVALID_MESSAGE : TOW sanity check fail
  */
-rtcm3_rc rtcm3_decode_1003(const uint8_t buff[], rtcm_obs_message *msg_1003) {
-  assert(msg_1003);
+rtcm3_rc rtcm3_decode_1002(const uint8_t buff[], rtcm_obs_message *msg_1002) {
+  assert(msg_1002);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_1002_internal(buff, msg_1002));
+}
+
+static rtcm3_rc rtcm3_decode_1003_internal(const uint8_t buff[],
+                                           rtcm_obs_message *msg_1003) {
   uint16_t bit = 0;
   bit += rtcm3_read_header(buff, &msg_1003->header);
 
@@ -507,7 +510,7 @@ rtcm3_rc rtcm3_decode_1003(const uint8_t buff[], rtcm_obs_message *msg_1003) {
   return RC_OK;
 }
 
-/** Decode an RTCMv3 message type 1004 (Extended L1/L2 GPS RTK Observables)
+/** Decode an RTCMv3 message type 1003 (L1/L2 GPS RTK Observables)
  *
  * \param buff The input data buffer
  * \param RTCM message struct
@@ -515,8 +518,14 @@ rtcm3_rc rtcm3_decode_1003(const uint8_t buff[], rtcm_obs_message *msg_1003) {
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
  *          - RC_INVALID_MESSAGE : TOW sanity check fail
  */
-rtcm3_rc rtcm3_decode_1004(const uint8_t buff[], rtcm_obs_message *msg_1004) {
-  assert(msg_1004);
+rtcm3_rc rtcm3_decode_1003(const uint8_t buff[], rtcm_obs_message *msg_1003) {
+  assert(msg_1003);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_1003_internal(buff, msg_1003));
+}
+
+static rtcm3_rc rtcm3_decode_1004_internal(const uint8_t buff[],
+                                           rtcm_obs_message *msg_1004) {
   uint16_t bit = 0;
   bit += rtcm3_read_header(buff, &msg_1004->header);
 
@@ -567,6 +576,20 @@ rtcm3_rc rtcm3_decode_1004(const uint8_t buff[], rtcm_obs_message *msg_1004) {
   return RC_OK;
 }
 
+/** Decode an RTCMv3 message type 1004 (Extended L1/L2 GPS RTK Observables)
+ *
+ * \param buff The input data buffer
+ * \param RTCM message struct
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
+ *          - RC_INVALID_MESSAGE : TOW sanity check fail
+ */
+rtcm3_rc rtcm3_decode_1004(const uint8_t buff[], rtcm_obs_message *msg_1004) {
+  assert(msg_1004);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_1004_internal(buff, msg_1004));
+}
+
 static rtcm3_rc rtcm3_decode_1005_base(const uint8_t buff[],
                                        rtcm_msg_1005 *msg_1005,
                                        uint16_t *bit) {
@@ -598,15 +621,8 @@ static rtcm3_rc rtcm3_decode_1005_base(const uint8_t buff[],
   return RC_OK;
 }
 
-/** Decode an RTCMv3 message type 1005 (Stationary RTK Reference Station ARP)
- *
- * \param buff The input data buffer
- * \param RTCM message struct
- * \return  - RC_OK : Success
- *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
- */
-rtcm3_rc rtcm3_decode_1005(const uint8_t buff[], rtcm_msg_1005 *msg_1005) {
-  assert(msg_1005);
+static rtcm3_rc rtcm3_decode_1005_internal(const uint8_t buff[],
+                                           rtcm_msg_1005 *msg_1005) {
   uint16_t bit = 0;
   uint16_t msg_num = rtcm_getbitu(buff, bit, 12);
   bit += 12;
@@ -618,16 +634,21 @@ rtcm3_rc rtcm3_decode_1005(const uint8_t buff[], rtcm_msg_1005 *msg_1005) {
   return rtcm3_decode_1005_base(buff, msg_1005, &bit);
 }
 
-/** Decode an RTCMv3 message type 1005 (Stationary RTK Reference Station ARP
- * with antenna height)
+/** Decode an RTCMv3 message type 1005 (Stationary RTK Reference Station ARP)
  *
  * \param buff The input data buffer
  * \param RTCM message struct
  * \return  - RC_OK : Success
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
  */
-rtcm3_rc rtcm3_decode_1006(const uint8_t buff[], rtcm_msg_1006 *msg_1006) {
-  assert(msg_1006);
+rtcm3_rc rtcm3_decode_1005(const uint8_t buff[], rtcm_msg_1005 *msg_1005) {
+  assert(msg_1005);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_1005_internal(buff, msg_1005));
+}
+
+static rtcm3_rc rtcm3_decode_1006_internal(const uint8_t buff[],
+                                           rtcm_msg_1006 *msg_1006) {
   uint16_t bit = 0;
   uint16_t msg_num = rtcm_getbitu(buff, bit, 12);
   bit += 12;
@@ -642,6 +663,20 @@ rtcm3_rc rtcm3_decode_1006(const uint8_t buff[], rtcm_msg_1006 *msg_1006) {
   return RC_OK;
 }
 
+/** Decode an RTCMv3 message type 1005 (Stationary RTK Reference Station ARP
+ * with antenna height)
+ *
+ * \param buff The input data buffer
+ * \param RTCM message struct
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
+ */
+rtcm3_rc rtcm3_decode_1006(const uint8_t buff[], rtcm_msg_1006 *msg_1006) {
+  assert(msg_1006);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_1006_internal(buff, msg_1006));
+}
+
 static rtcm3_rc rtcm3_decode_1007_base(const uint8_t buff[],
                                        rtcm_msg_1007 *msg_1007,
                                        uint16_t *bit) {
@@ -656,17 +691,8 @@ static rtcm3_rc rtcm3_decode_1007_base(const uint8_t buff[],
   return RC_OK;
 }
 
-/** Decode an RTCMv3 message type 1007 (Antenna Descriptor)
- *
- * \param buff The input data buffer
- * \param RTCM message struct
- * \return  - RC_OK : Success
- *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
- *          - RC_INVALID_MESSAGE : String length too large
- *
- */
-rtcm3_rc rtcm3_decode_1007(const uint8_t buff[], rtcm_msg_1007 *msg_1007) {
-  assert(msg_1007);
+static rtcm3_rc rtcm3_decode_1007_internal(const uint8_t buff[],
+                                           rtcm_msg_1007 *msg_1007) {
   uint16_t bit = 0;
   uint16_t msg_num = rtcm_getbitu(buff, bit, 12);
   bit += 12;
@@ -678,16 +704,23 @@ rtcm3_rc rtcm3_decode_1007(const uint8_t buff[], rtcm_msg_1007 *msg_1007) {
   return rtcm3_decode_1007_base(buff, msg_1007, &bit);
 }
 
-/** Decode an RTCMv3 message type 1008 (Antenna Descriptor & Serial Number)
+/** Decode an RTCMv3 message type 1007 (Antenna Descriptor)
  *
  * \param buff The input data buffer
  * \param RTCM message struct
  * \return  - RC_OK : Success
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
  *          - RC_INVALID_MESSAGE : String length too large
+ *
  */
-rtcm3_rc rtcm3_decode_1008(const uint8_t buff[], rtcm_msg_1008 *msg_1008) {
-  assert(msg_1008);
+rtcm3_rc rtcm3_decode_1007(const uint8_t buff[], rtcm_msg_1007 *msg_1007) {
+  assert(msg_1007);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_1007_internal(buff, msg_1007));
+}
+
+static rtcm3_rc rtcm3_decode_1008_internal(const uint8_t buff[],
+                                           rtcm_msg_1008 *msg_1008) {
   uint16_t bit = 0;
   uint16_t msg_num = rtcm_getbitu(buff, bit, 12);
   bit += 12;
@@ -708,16 +741,22 @@ rtcm3_rc rtcm3_decode_1008(const uint8_t buff[], rtcm_msg_1008 *msg_1008) {
   return RC_OK;
 }
 
-/** Decode an RTCMv3 message type 1010 (Extended L1-Only GLO RTK Observables)
+/** Decode an RTCMv3 message type 1008 (Antenna Descriptor & Serial Number)
  *
  * \param buff The input data buffer
  * \param RTCM message struct
  * \return  - RC_OK : Success
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
- *          - RC_INVALID_MESSAGE : TOW sanity check fail
+ *          - RC_INVALID_MESSAGE : String length too large
  */
-rtcm3_rc rtcm3_decode_1010(const uint8_t buff[], rtcm_obs_message *msg_1010) {
-  assert(msg_1010);
+rtcm3_rc rtcm3_decode_1008(const uint8_t buff[], rtcm_msg_1008 *msg_1008) {
+  assert(msg_1008);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_1008_internal(buff, msg_1008));
+}
+
+static rtcm3_rc rtcm3_decode_1010_internal(const uint8_t buff[],
+                                           rtcm_obs_message *msg_1010) {
   uint16_t bit = 0;
   bit += rtcm3_read_glo_header(buff, &msg_1010->header);
 
@@ -760,7 +799,7 @@ rtcm3_rc rtcm3_decode_1010(const uint8_t buff[], rtcm_obs_message *msg_1010) {
   return RC_OK;
 }
 
-/** Decode an RTCMv3 message type 1012 (Extended L1/L2 GLO RTK Observables)
+/** Decode an RTCMv3 message type 1010 (Extended L1-Only GLO RTK Observables)
  *
  * \param buff The input data buffer
  * \param RTCM message struct
@@ -768,8 +807,14 @@ rtcm3_rc rtcm3_decode_1010(const uint8_t buff[], rtcm_obs_message *msg_1010) {
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
  *          - RC_INVALID_MESSAGE : TOW sanity check fail
  */
-rtcm3_rc rtcm3_decode_1012(const uint8_t buff[], rtcm_obs_message *msg_1012) {
-  assert(msg_1012);
+rtcm3_rc rtcm3_decode_1010(const uint8_t buff[], rtcm_obs_message *msg_1010) {
+  assert(msg_1010);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_1010_internal(buff, msg_1010));
+}
+
+static rtcm3_rc rtcm3_decode_1012_internal(const uint8_t buff[],
+                                           rtcm_obs_message *msg_1012) {
   uint16_t bit = 0;
   bit += rtcm3_read_glo_header(buff, &msg_1012->header);
 
@@ -826,15 +871,22 @@ rtcm3_rc rtcm3_decode_1012(const uint8_t buff[], rtcm_obs_message *msg_1012) {
   return RC_OK;
 }
 
-/** Decode an RTCMv3 message type 1029 (Unicode Text String Message)
+/** Decode an RTCMv3 message type 1012 (Extended L1/L2 GLO RTK Observables)
  *
  * \param buff The input data buffer
  * \param RTCM message struct
  * \return  - RC_OK : Success
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
+ *          - RC_INVALID_MESSAGE : TOW sanity check fail
  */
-rtcm3_rc rtcm3_decode_1029(const uint8_t buff[], rtcm_msg_1029 *msg_1029) {
-  assert(msg_1029);
+rtcm3_rc rtcm3_decode_1012(const uint8_t buff[], rtcm_obs_message *msg_1012) {
+  assert(msg_1012);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_1012_internal(buff, msg_1012));
+}
+
+static rtcm3_rc rtcm3_decode_1029_view_internal(
+    const uint8_t buff[], rtcm_msg_1029_view *msg_1029) {
   uint16_t bit = 0;
   uint16_t msg_num = rtcm_getbitu(buff, bit, 12);
   bit += 12;
@@ -857,24 +909,65 @@ rtcm3_rc rtcm3_decode_1029(const uint8_t buff[], rtcm_msg_1029 *msg_1029) {
 
   msg_1029->utf8_code_units_n = rtcm_getbitu(buff, bit, 8);
   bit += 8;
-  for (uint8_t i = 0; i < msg_1029->utf8_code_units_n; ++i) {
-    msg_1029->utf8_code_units[i] = rtcm_getbitu(buff, bit, 8);
-    bit += 8;
+
+  /* the string is byte aligned and follows the header */
+  msg_1029->utf8_code_units = &buff[bit / 8];
+
+  return RC_OK;
+}
+
+static rtcm3_rc rtcm3_decode_1029_internal(const uint8_t buff[],
+                                           rtcm_msg_1029 *msg_1029) {
+  rtcm_msg_1029_view view;
+  rtcm3_rc ret = rtcm3_decode_1029_view_internal(buff, &view);
+  if (RC_OK != ret) {
+    return ret;
   }
 
+  msg_1029->stn_id = view.stn_id;
+  msg_1029->mjd_num = view.mjd_num;
+  msg_1029->utc_sec_of_day = view.utc_sec_of_day;
+  msg_1029->unicode_chars = view.unicode_chars;
+  msg_1029->utf8_code_units_n = view.utf8_code_units_n;
+  memcpy(msg_1029->utf8_code_units,
+         view.utf8_code_units,
+         view.utf8_code_units_n);
+
   return RC_OK;
 }
 
-/** Decode an RTCMv3 message type 1033 (Rcv and Ant descriptor)
+/** Decode an RTCMv3 message type 1029 (Unicode Text String Message)
  *
  * \param buff The input data buffer
  * \param RTCM message struct
  * \return  - RC_OK : Success
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
- *          - RC_INVALID_MESSAGE : String length too large
  */
-rtcm3_rc rtcm3_decode_1033(const uint8_t buff[], rtcm_msg_1033 *msg_1033) {
-  assert(msg_1033);
+rtcm3_rc rtcm3_decode_1029(const uint8_t buff[], rtcm_msg_1029 *msg_1029) {
+  assert(msg_1029);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_1029_internal(buff, msg_1029));
+}
+
+/** Decode an RTCMv3 message type 1029 without copying the text
+ *
+ * The text is byte aligned within the frame, so `utf8_code_units` is left
+ * pointing into `buff` and is only valid for as long as `buff` is.
+ *
+ * \param buff The input data buffer
+ * \param msg_1029 RTCM message view
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
+ */
+rtcm3_rc rtcm3_decode_1029_view(const uint8_t buff[],
+                                rtcm_msg_1029_view *msg_1029) {
+  assert(msg_1029);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_1029_view_internal(buff, msg_1029));
+}
+
+static rtcm3_rc rtcm3_decode_1033_internal(const uint8_t buff[],
+                                           rtcm_msg_1033 *msg_1033) {
   uint16_t bit = 0;
   uint16_t msg_num = rtcm_getbitu(buff, bit, 12);
   bit += 12;
@@ -915,15 +1008,22 @@ rtcm3_rc rtcm3_decode_1033(const uint8_t buff[], rtcm_msg_1033 *msg_1033) {
   return RC_OK;
 }
 
-/** Decode an RTCMv3 message type 1230 (Code-Phase Bias Message)
+/** Decode an RTCMv3 message type 1033 (Rcv and Ant descriptor)
  *
  * \param buff The input data buffer
  * \param RTCM message struct
  * \return  - RC_OK : Success
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
+ *          - RC_INVALID_MESSAGE : String length too large
  */
-rtcm3_rc rtcm3_decode_1230(const uint8_t buff[], rtcm_msg_1230 *msg_1230) {
-  assert(msg_1230);
+rtcm3_rc rtcm3_decode_1033(const uint8_t buff[], rtcm_msg_1033 *msg_1033) {
+  assert(msg_1033);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_1033_internal(buff, msg_1033));
+}
+
+static rtcm3_rc rtcm3_decode_1230_internal(const uint8_t buff[],
+                                           rtcm_msg_1230 *msg_1230) {
   uint16_t bit = 0;
   uint16_t msg_num = rtcm_getbitu(buff, bit, 12);
   bit += 12;
@@ -968,6 +1068,19 @@ rtcm3_rc rtcm3_decode_1230(const uint8_t buff[], rtcm_msg_1230 *msg_1230) {
   return RC_OK;
 }
 
+/** Decode an RTCMv3 message type 1230 (Code-Phase Bias Message)
+ *
+ * \param buff The input data buffer
+ * \param RTCM message struct
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
+ */
+rtcm3_rc rtcm3_decode_1230(const uint8_t buff[], rtcm_msg_1230 *msg_1230) {
+  assert(msg_1230);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_1230_internal(buff, msg_1230));
+}
+
 static void decode_msm_sat_data(const uint8_t buff[],
                                 const uint8_t num_sats,
                                 const msm_enum msm_type,
@@ -1336,7 +1449,8 @@ static rtcm3_rc rtcm3_decode_msm_internal(const uint8_t buff[],
  */
 rtcm3_rc rtcm3_decode_msm4(const uint8_t buff[], rtcm_msm_message *msg) {
   assert(msg);
-  return rtcm3_decode_msm_internal(buff, MSM4, msg);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_msm_internal(buff, MSM4, msg));
 }
 
 /** Decode an RTCMv3 Multi System Message 5
@@ -1349,7 +1463,8 @@ rtcm3_rc rtcm3_decode_msm4(const uint8_t buff[], rtcm_msm_message *msg) {
  */
 rtcm3_rc rtcm3_decode_msm5(const uint8_t buff[], rtcm_msm_message *msg) {
   assert(msg);
-  return rtcm3_decode_msm_internal(buff, MSM5, msg);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_msm_internal(buff, MSM5, msg));
 }
 
 /** Decode an RTCMv3 Multi System Message 6
@@ -1362,7 +1477,8 @@ rtcm3_rc rtcm3_decode_msm5(const uint8_t buff[], rtcm_msm_message *msg) {
  */
 rtcm3_rc rtcm3_decode_msm6(const uint8_t buff[], rtcm_msm_message *msg) {
   assert(msg);
-  return rtcm3_decode_msm_internal(buff, MSM6, msg);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_msm_internal(buff, MSM6, msg));
 }
 
 /** Decode an RTCMv3 Multi System Message 7
@@ -1375,20 +1491,12 @@ rtcm3_rc rtcm3_decode_msm6(const uint8_t buff[], rtcm_msm_message *msg) {
  */
 rtcm3_rc rtcm3_decode_msm7(const uint8_t buff[], rtcm_msm_message *msg) {
   assert(msg);
-  return rtcm3_decode_msm_internal(buff, MSM7, msg);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_msm_internal(buff, MSM7, msg));
 }
 
-/** Decode Swift Proprietary Message
- *
- * \param buff The input data buffer
- * \param msg  message struct
- * \return  - RC_OK : Success
- *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
- *          - RC_INVALID_MESSAGE : Nonzero reserved bits (invalid format)
- */
-rtcm3_rc rtcm3_decode_4062(const uint8_t buff[],
-                           rtcm_msg_swift_proprietary *msg) {
-  assert(msg);
+static rtcm3_rc rtcm3_decode_4062_view_internal(
+    const uint8_t buff[], rtcm_msg_swift_proprietary_view *msg) {
   uint16_t bit = 0;
   uint16_t msg_num = rtcm_getbitu(buff, bit, 12);
   bit += 12;
@@ -1413,10 +1521,56 @@ rtcm3_rc rtcm3_decode_4062(const uint8_t buff[],
   msg->len = rtcm_getbitu(buff, bit, 8);
   bit += 8;
 
-  for (uint8_t i = 0; i < msg->len; ++i) {
-    msg->data[i] = rtcm_getbitu(buff, bit, 8);
-    bit += 8;
+  /* the payload is byte aligned and follows the header */
+  msg->data = &buff[bit / 8];
+
+  return RC_OK;
+}
+
+static rtcm3_rc rtcm3_decode_4062_internal(const uint8_t buff[],
+                                           rtcm_msg_swift_proprietary *msg) {
+  rtcm_msg_swift_proprietary_view view;
+  rtcm3_rc ret = rtcm3_decode_4062_view_internal(buff, &view);
+  if (RC_OK != ret) {
+    return ret;
   }
 
+  msg->msg_type = view.msg_type;
+  msg->sender_id = view.sender_id;
+  msg->len = view.len;
+  memcpy(msg->data, view.data, view.len);
+
   return RC_OK;
 }
+
+/** Decode Swift Proprietary Message
+ *
+ * \param buff The input data buffer
+ * \param msg  message struct
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
+ *          - RC_INVALID_MESSAGE : Nonzero reserved bits (invalid format)
+ */
+rtcm3_rc rtcm3_decode_4062(const uint8_t buff[],
+                           rtcm_msg_swift_proprietary *msg) {
+  assert(msg);
+  return RTCM3_INSTRUMENT_DECODE(buff, rtcm3_decode_4062_internal(buff, msg));
+}
+
+/** Decode Swift Proprietary Message without copying the payload
+ *
+ * The payload is byte aligned within the frame, so `data` is left pointing
+ * into `buff` and is only valid for as long as `buff` is.
+ *
+ * \param buff The input data buffer
+ * \param msg  message view
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
+ *          - RC_INVALID_MESSAGE : Nonzero reserved bits (invalid format)
+ */
+rtcm3_rc rtcm3_decode_4062_view(const uint8_t buff[],
+                                rtcm_msg_swift_proprietary_view *msg) {
+  assert(msg);
+  return RTCM3_INSTRUMENT_DECODE(buff,
+                                 rtcm3_decode_4062_view_internal(buff, msg));
+}
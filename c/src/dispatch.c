@@ -0,0 +1,535 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/dispatch.h"
+#include <assert.h>
+#include "rtcm3/bits.h"
+#include "rtcm3/decode.h"
+#include "rtcm3/encode.h"
+#include "rtcm3/eph_decode.h"
+#include "rtcm3/eph_encode.h"
+#include "rtcm3/msm_utils.h"
+#include "rtcm3/ssr_decode.h"
+#include "rtcm3/ssr_encode.h"
+
+/** Find which member of rtcm3_msg a message decodes into
+ *
+ * \param msg_num RTCM message number
+ * \return Kind of the message, RTCM3_MSG_UNSUPPORTED if it has no decoder
+ */
+rtcm3_msg_kind rtcm3_msg_kind_of(uint16_t msg_num) {
+  switch (msg_num) {
+    case 1001:
+    case 1002:
+    case 1003:
+    case 1004:
+    case 1010:
+    case 1012:
+      return RTCM3_MSG_OBS;
+    case 1005:
+      return RTCM3_MSG_1005;
+    case 1006:
+      return RTCM3_MSG_1006;
+    case 1007:
+      return RTCM3_MSG_1007;
+    case 1008:
+      return RTCM3_MSG_1008;
+    case 1029:
+      return RTCM3_MSG_1029;
+    case 1033:
+      return RTCM3_MSG_1033;
+    case 1230:
+      return RTCM3_MSG_1230;
+    case 1019:
+    case 1020:
+    case 1042:
+    case 1044:
+    case 1045:
+    case 1046:
+      return RTCM3_MSG_EPH;
+    case 1057:
+    case 1063:
+    case 1240:
+    case 1246:
+    case 1258:
+      return RTCM3_MSG_SSR_ORBIT;
+    case 1058:
+    case 1064:
+    case 1241:
+    case 1247:
+    case 1259:
+      return RTCM3_MSG_SSR_CLOCK;
+    case 1060:
+    case 1066:
+    case 1243:
+    case 1249:
+    case 1261:
+      return RTCM3_MSG_SSR_ORBIT_CLOCK;
+    case 1059:
+    case 1065:
+    case 1242:
+    case 1248:
+    case 1260:
+      return RTCM3_MSG_SSR_CODE_BIAS;
+    case 1265:
+    case 1266:
+    case 1267:
+    case 1268:
+    case 1269:
+    case 1270:
+      return RTCM3_MSG_SSR_PHASE_BIAS;
+    case 4062:
+      return RTCM3_MSG_SWIFT_PROPRIETARY;
+    default:
+      break;
+  }
+
+  switch (to_msm_type(msg_num)) {
+    case MSM4:
+    case MSM5:
+    case MSM6:
+    case MSM7:
+      return RTCM3_MSG_MSM;
+    case MSM_UNKNOWN:
+    case MSM1:
+    case MSM2:
+    case MSM3:
+    default:
+      return RTCM3_MSG_UNSUPPORTED;
+  }
+}
+
+static rtcm3_rc decode_eph(uint16_t msg_num,
+                           const uint8_t buff[],
+                           rtcm_msg_eph *msg_eph) {
+  switch (msg_num) {
+    case 1019:
+      return rtcm3_decode_gps_eph(buff, msg_eph);
+    case 1020:
+      return rtcm3_decode_glo_eph(buff, msg_eph);
+    case 1042:
+      return rtcm3_decode_bds_eph(buff, msg_eph);
+    case 1044:
+      return rtcm3_decode_qzss_eph(buff, msg_eph);
+    case 1045:
+      return rtcm3_decode_gal_eph_fnav(buff, msg_eph);
+    case 1046:
+      return rtcm3_decode_gal_eph(buff, msg_eph);
+    default:
+      return RC_MESSAGE_TYPE_MISMATCH;
+  }
+}
+
+static rtcm3_rc decode_obs(uint16_t msg_num,
+                           const uint8_t buff[],
+                           rtcm_obs_message *msg_obs) {
+  switch (msg_num) {
+    case 1001:
+      return rtcm3_decode_1001(buff, msg_obs);
+    case 1002:
+      return rtcm3_decode_1002(buff, msg_obs);
+    case 1003:
+      return rtcm3_decode_1003(buff, msg_obs);
+    case 1004:
+      return rtcm3_decode_1004(buff, msg_obs);
+    case 1010:
+      return rtcm3_decode_1010(buff, msg_obs);
+    case 1012:
+      return rtcm3_decode_1012(buff, msg_obs);
+    default:
+      return RC_MESSAGE_TYPE_MISMATCH;
+  }
+}
+
+static rtcm3_rc decode_msm(uint16_t msg_num,
+                           const uint8_t buff[],
+                           rtcm_msm_message *msg_msm) {
+  switch (to_msm_type(msg_num)) {
+    case MSM4:
+      return rtcm3_decode_msm4(buff, msg_msm);
+    case MSM5:
+      return rtcm3_decode_msm5(buff, msg_msm);
+    case MSM6:
+      return rtcm3_decode_msm6(buff, msg_msm);
+    case MSM7:
+      return rtcm3_decode_msm7(buff, msg_msm);
+    case MSM_UNKNOWN:
+    case MSM1:
+    case MSM2:
+    case MSM3:
+    default:
+      return RC_MESSAGE_TYPE_MISMATCH;
+  }
+}
+
+/* Decode into the member selected by msg->kind */
+static rtcm3_rc decode_kind(const uint8_t buff[], rtcm3_msg *msg) {
+  switch (msg->kind) {
+    case RTCM3_MSG_OBS:
+      return decode_obs(msg->msg_num, buff, &msg->obs);
+    case RTCM3_MSG_1005:
+      return rtcm3_decode_1005(buff, &msg->msg_1005);
+    case RTCM3_MSG_1006:
+      return rtcm3_decode_1006(buff, &msg->msg_1006);
+    case RTCM3_MSG_1007:
+      return rtcm3_decode_1007(buff, &msg->msg_1007);
+    case RTCM3_MSG_1008:
+      return rtcm3_decode_1008(buff, &msg->msg_1008);
+    case RTCM3_MSG_1029:
+      return rtcm3_decode_1029(buff, &msg->msg_1029);
+    case RTCM3_MSG_1033:
+      return rtcm3_decode_1033(buff, &msg->msg_1033);
+    case RTCM3_MSG_1230:
+      return rtcm3_decode_1230(buff, &msg->msg_1230);
+    case RTCM3_MSG_MSM:
+      return decode_msm(msg->msg_num, buff, &msg->msm);
+    case RTCM3_MSG_EPH:
+      return decode_eph(msg->msg_num, buff, &msg->eph);
+    case RTCM3_MSG_SSR_ORBIT:
+      return rtcm3_decode_orbit(buff, &msg->orbit);
+    case RTCM3_MSG_SSR_CLOCK:
+      return rtcm3_decode_clock(buff, &msg->clock);
+    case RTCM3_MSG_SSR_ORBIT_CLOCK:
+      return rtcm3_decode_orbit_clock(buff, &msg->orbit_clock);
+    case RTCM3_MSG_SSR_CODE_BIAS:
+      return rtcm3_decode_code_bias(buff, &msg->code_bias);
+    case RTCM3_MSG_SSR_PHASE_BIAS:
+      return rtcm3_decode_phase_bias(buff, &msg->phase_bias);
+    case RTCM3_MSG_SWIFT_PROPRIETARY:
+      return rtcm3_decode_4062(buff, &msg->swift_proprietary);
+    case RTCM3_MSG_UNSUPPORTED:
+    case RTCM3_MSG_KIND_COUNT:
+    default:
+      return RC_MESSAGE_TYPE_MISMATCH;
+  }
+}
+
+/** Decode any supported message
+ *
+ * \param buff The input data buffer, the payload of one frame
+ * \param msg Set to the message number, its kind and the decoded message
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : No decoder for this message number
+ *          - RC_INVALID_MESSAGE : Nonsense in the message
+ */
+rtcm3_rc rtcm3_decode_msg(const uint8_t buff[], rtcm3_msg *msg) {
+  assert(msg);
+  msg->msg_num = (uint16_t)rtcm_getbitu(buff, 0, 12);
+  msg->kind = rtcm3_msg_kind_of(msg->msg_num);
+  return decode_kind(buff, msg);
+}
+
+/* Sort a block of frame indices by message number, keeping the order of
+ * frames of the same type. Blocks are short and mostly hold runs of a few
+ * types, so insertion sort is enough. */
+static void sort_block(const rtcm3_frame frames[],
+                       uint16_t order[],
+                       uint16_t count) {
+  for (uint16_t i = 1; i < count; i++) {
+    uint16_t index = order[i];
+    uint16_t msg_num = frames[index].msg_num;
+    uint16_t j = i;
+    while (j > 0 && frames[order[j - 1]].msg_num > msg_num) {
+      order[j] = order[j - 1];
+      j--;
+    }
+    order[j] = index;
+  }
+}
+
+/** Decode an array of frames
+ *
+ * Frames are decoded grouped by message number, so consecutive calls go to
+ * the same decoder and its code and tables stay in cache, and the payload
+ * and output of the next frame are prefetched while one is decoded. Results
+ * are written at the index of their frame.
+ *
+ * \param frames Frames to decode, e.g. from rtcm3_frame_scanner_next
+ * \param n Number of frames
+ * \param msgs Set to the decoded messages, n entries
+ * \param rcs Set to the return code of each frame as of rtcm3_decode_msg, n
+ *            entries
+ * \return Number of frames decoded with RC_OK
+ */
+size_t rtcm3_decode_batch(const rtcm3_frame frames[],
+                          size_t n,
+                          rtcm3_msg msgs[],
+                          rtcm3_rc rcs[]) {
+  assert(n == 0 || (frames && msgs && rcs));
+  uint16_t order[RTCM3_DECODE_BATCH_BLOCK];
+  size_t num_ok = 0;
+  for (size_t base = 0; base < n; base += RTCM3_DECODE_BATCH_BLOCK) {
+    uint16_t count = (uint16_t)(n - base < RTCM3_DECODE_BATCH_BLOCK
+                                    ? n - base
+                                    : RTCM3_DECODE_BATCH_BLOCK);
+    const rtcm3_frame *block = &frames[base];
+    for (uint16_t i = 0; i < count; i++) {
+      order[i] = i;
+    }
+    sort_block(block, order, count);
+
+    for (uint16_t i = 0; i < count; i++) {
+      if (i + 1 < count) {
+        __builtin_prefetch(block[order[i + 1]].payload);
+        __builtin_prefetch(&msgs[base + order[i + 1]], 1);
+      }
+      const rtcm3_frame *frame = &block[order[i]];
+      rtcm3_msg *msg = &msgs[base + order[i]];
+      rtcm3_rc *rc = &rcs[base + order[i]];
+      msg->msg_num = frame->msg_num;
+      msg->kind = rtcm3_msg_kind_of(frame->msg_num);
+      if (frame->payload_len < 2) {
+        msg->kind = RTCM3_MSG_UNSUPPORTED;
+        *rc = RC_MESSAGE_TYPE_MISMATCH;
+        continue;
+      }
+      *rc = decode_kind(frame->payload, msg);
+      if (RC_OK == *rc) {
+        num_ok++;
+      }
+    }
+  }
+  return num_ok;
+}
+
+static uint16_t encode_obs(uint16_t msg_num,
+                           const rtcm_obs_message *msg_obs,
+                           uint8_t buff[]) {
+  switch (msg_num) {
+    case 1001:
+      return rtcm3_encode_1001(msg_obs, buff);
+    case 1002:
+      return rtcm3_encode_1002(msg_obs, buff);
+    case 1003:
+      return rtcm3_encode_1003(msg_obs, buff);
+    case 1004:
+      return rtcm3_encode_1004(msg_obs, buff);
+    case 1010:
+      return rtcm3_encode_1010(msg_obs, buff);
+    case 1012:
+      return rtcm3_encode_1012(msg_obs, buff);
+    default:
+      return 0;
+  }
+}
+
+static uint16_t encode_eph(uint16_t msg_num,
+                           const rtcm_msg_eph *msg_eph,
+                           uint8_t buff[]) {
+  switch (msg_num) {
+    case 1019:
+      return rtcm3_encode_gps_eph(msg_eph, buff);
+    case 1020:
+      return rtcm3_encode_glo_eph(msg_eph, buff);
+    case 1042:
+      return rtcm3_encode_bds_eph(msg_eph, buff);
+    case 1044:
+      return rtcm3_encode_qzss_eph(msg_eph, buff);
+    case 1045:
+      return rtcm3_encode_gal_eph_fnav(msg_eph, buff);
+    case 1046:
+      return rtcm3_encode_gal_eph_inav(msg_eph, buff);
+    default:
+      return 0;
+  }
+}
+
+static uint16_t encode_msm(const rtcm_msm_message *msg_msm, uint8_t buff[]) {
+  switch (to_msm_type(msg_msm->header.msg_num)) {
+    case MSM4:
+      return rtcm3_encode_msm4(msg_msm, buff);
+    case MSM5:
+      return rtcm3_encode_msm5(msg_msm, buff);
+    case MSM_UNKNOWN:
+    case MSM1:
+    case MSM2:
+    case MSM3:
+    case MSM6:
+    case MSM7:
+    default:
+      return 0;
+  }
+}
+
+/** Encode any message that has an encoder
+ *
+ * \param msg Message to encode, its kind selects the member and msg_num the
+ *            message number where one member holds several. MSM and SSR take
+ *            the message number from their header.
+ * \param buff The output data buffer
+ * \return Number of bytes written, 0 if there is no encoder for the message
+ *         or it failed
+ */
+uint16_t rtcm3_encode_msg(const rtcm3_msg *msg, uint8_t buff[]) {
+  assert(msg);
+  switch (msg->kind) {
+    case RTCM3_MSG_OBS:
+      return encode_obs(msg->msg_num, &msg->obs, buff);
+    case RTCM3_MSG_1005:
+      return rtcm3_encode_1005(&msg->msg_1005, buff);
+    case RTCM3_MSG_1006:
+      return rtcm3_encode_1006(&msg->msg_1006, buff);
+    case RTCM3_MSG_1007:
+      return rtcm3_encode_1007(&msg->msg_1007, buff);
+    case RTCM3_MSG_1008:
+      return rtcm3_encode_1008(&msg->msg_1008, buff);
+    case RTCM3_MSG_1029:
+      return rtcm3_encode_1029(&msg->msg_1029, buff);
+    case RTCM3_MSG_1033:
+      return rtcm3_encode_1033(&msg->msg_1033, buff);
+    case RTCM3_MSG_1230:
+      return rtcm3_encode_1230(&msg->msg_1230, buff);
+    case RTCM3_MSG_MSM:
+      return encode_msm(&msg->msm, buff);
+    case RTCM3_MSG_EPH:
+      return encode_eph(msg->msg_num, &msg->eph, buff);
+    case RTCM3_MSG_SWIFT_PROPRIETARY:
+      return rtcm3_encode_4062(&msg->swift_proprietary, buff);
+    case RTCM3_MSG_SSR_ORBIT:
+      return rtcm3_encode_orbit(&msg->orbit, buff);
+    case RTCM3_MSG_SSR_CLOCK:
+      return rtcm3_encode_clock(&msg->clock, buff);
+    case RTCM3_MSG_SSR_ORBIT_CLOCK:
+      return rtcm3_encode_orbit_clock(&msg->orbit_clock, buff);
+    case RTCM3_MSG_SSR_CODE_BIAS:
+      return rtcm3_encode_code_bias(&msg->code_bias, buff);
+    case RTCM3_MSG_SSR_PHASE_BIAS:
+      return rtcm3_encode_phase_bias(&msg->phase_bias, buff);
+    case RTCM3_MSG_UNSUPPORTED:
+    case RTCM3_MSG_KIND_COUNT:
+    default:
+      return 0;
+  }
+}
+
+static uint16_t encoded_size_obs(uint16_t msg_num,
+                                 const rtcm_obs_message *msg_obs) {
+  switch (msg_num) {
+    case 1001:
+      return rtcm3_encoded_size_1001(msg_obs);
+    case 1002:
+      return rtcm3_encoded_size_1002(msg_obs);
+    case 1003:
+      return rtcm3_encoded_size_1003(msg_obs);
+    case 1004:
+      return rtcm3_encoded_size_1004(msg_obs);
+    case 1010:
+      return rtcm3_encoded_size_1010(msg_obs);
+    case 1012:
+      return rtcm3_encoded_size_1012(msg_obs);
+    default:
+      return 0;
+  }
+}
+
+static uint16_t encoded_size_eph(uint16_t msg_num,
+                                 const rtcm_msg_eph *msg_eph) {
+  switch (msg_num) {
+    case 1019:
+      return rtcm3_encoded_size_gps_eph(msg_eph);
+    case 1020:
+      return rtcm3_encoded_size_glo_eph(msg_eph);
+    case 1042:
+      return rtcm3_encoded_size_bds_eph(msg_eph);
+    case 1044:
+      return rtcm3_encoded_size_qzss_eph(msg_eph);
+    case 1045:
+      return rtcm3_encoded_size_gal_eph_fnav(msg_eph);
+    case 1046:
+      return rtcm3_encoded_size_gal_eph_inav(msg_eph);
+    default:
+      return 0;
+  }
+}
+
+static uint16_t encoded_size_msm(const rtcm_msm_message *msg_msm) {
+  switch (to_msm_type(msg_msm->header.msg_num)) {
+    case MSM4:
+      return rtcm3_encoded_size_msm4(msg_msm);
+    case MSM5:
+      return rtcm3_encoded_size_msm5(msg_msm);
+    case MSM_UNKNOWN:
+    case MSM1:
+    case MSM2:
+    case MSM3:
+    case MSM6:
+    case MSM7:
+    default:
+      return 0;
+  }
+}
+
+/** Size of any message as rtcm3_encode_msg writes it, without encoding it
+ *
+ * \param msg Message, as for rtcm3_encode_msg
+ * \return Number of bytes rtcm3_encode_msg writes, 0 if there is no encoder
+ *         for the message or it would fail
+ */
+uint16_t rtcm3_encoded_size_msg(const rtcm3_msg *msg) {
+  assert(msg);
+  switch (msg->kind) {
+    case RTCM3_MSG_OBS:
+      return encoded_size_obs(msg->msg_num, &msg->obs);
+    case RTCM3_MSG_1005:
+      return rtcm3_encoded_size_1005(&msg->msg_1005);
+    case RTCM3_MSG_1006:
+      return rtcm3_encoded_size_1006(&msg->msg_1006);
+    case RTCM3_MSG_1007:
+      return rtcm3_encoded_size_1007(&msg->msg_1007);
+    case RTCM3_MSG_1008:
+      return rtcm3_encoded_size_1008(&msg->msg_1008);
+    case RTCM3_MSG_1029:
+      return rtcm3_encoded_size_1029(&msg->msg_1029);
+    case RTCM3_MSG_1033:
+      return rtcm3_encoded_size_1033(&msg->msg_1033);
+    case RTCM3_MSG_1230:
+      return rtcm3_encoded_size_1230(&msg->msg_1230);
+    case RTCM3_MSG_MSM:
+      return encoded_size_msm(&msg->msm);
+    case RTCM3_MSG_EPH:
+      return encoded_size_eph(msg->msg_num, &msg->eph);
+    case RTCM3_MSG_SWIFT_PROPRIETARY:
+      return rtcm3_encoded_size_4062(&msg->swift_proprietary);
+    case RTCM3_MSG_SSR_ORBIT:
+      return rtcm3_encoded_size_orbit(&msg->orbit);
+    case RTCM3_MSG_SSR_CLOCK:
+      return rtcm3_encoded_size_clock(&msg->clock);
+    case RTCM3_MSG_SSR_ORBIT_CLOCK:
+      return rtcm3_encoded_size_orbit_clock(&msg->orbit_clock);
+    case RTCM3_MSG_SSR_CODE_BIAS:
+      return rtcm3_encoded_size_code_bias(&msg->code_bias);
+    case RTCM3_MSG_SSR_PHASE_BIAS:
+      return rtcm3_encoded_size_phase_bias(&msg->phase_bias);
+    case RTCM3_MSG_UNSUPPORTED:
+    case RTCM3_MSG_KIND_COUNT:
+    default:
+      return 0;
+  }
+}
+
+/** Encode any message that has an encoder as a complete transport frame
+ *
+ * The payload is encoded straight into the frame behind the header, then
+ * the header and CRC are filled in while the payload is still in cache.
+ *
+ * \param msg Message to encode, as for rtcm3_encode_msg
+ * \param frame Output buffer, RTCM3_MAX_FRAME_LEN bytes cover any message
+ * \return Length of the frame in bytes, 0 if the message could not be
+ *         encoded
+ */
+uint16_t rtcm3_encode_msg_frame(const rtcm3_msg *msg, uint8_t frame[]) {
+  uint16_t payload_len = rtcm3_encode_msg(msg, &frame[RTCM3_FRAME_HEADER_LEN]);
+  if (0 == payload_len) {
+    return 0;
+  }
+  return rtcm3_frame_finalize(frame, payload_len);
+}
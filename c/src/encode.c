@@ -20,7 +20,9 @@
 
 #include "rtcm3/bits.h"
 #include "rtcm3/constants.h"
+#include "rtcm3/frame.h"
 #include "rtcm3/msm_utils.h"
+#include "instrument.h"
 
 /** Convert a lock time in seconds into 7-bit RTCMv3 Lock Time Indicator value.
  * See RTCM 10403.1, Table 3.4-2.
@@ -365,8 +367,8 @@ static uint16_t rtcm3_write_glo_header(const rtcm_obs_header *header,
   return bit;
 }
 
-uint16_t rtcm3_encode_1001(const rtcm_obs_message *msg_1001, uint8_t buff[]) {
-  assert(msg_1001);
+static uint16_t rtcm3_encode_1001_internal(const rtcm_obs_message *msg_1001,
+                                           uint8_t buff[]) {
   uint16_t bit = 64; /* Start at end of header. */
 
   uint8_t num_sats = 0;
@@ -395,20 +397,15 @@ uint16_t rtcm3_encode_1001(const rtcm_obs_message *msg_1001, uint8_t buff[]) {
   return (bit + 7) / 8;
 }
 
-/** Encode an RTCMv3 message type 1002 (Extended L1-Only GPS RTK Observables)
- * Message type 1002 has length `64 + n_sat*74` bits. Returned message length
- * is rounded up to the nearest whole byte.
- *
- * \param buff A pointer to the RTCM data message buffer.
- * \param id Reference station ID (DF003).
- * \param t GPS time of epoch (DF004).
- * \param n_sat Number of GPS satellites included in the message (DF006).
- * \param nm Struct containing the observation.
- * \param sync Synchronous GNSS Flag (DF005).
- * \return The message length in bytes.
- */
-uint16_t rtcm3_encode_1002(const rtcm_obs_message *msg_1002, uint8_t buff[]) {
-  assert(msg_1002);
+uint16_t rtcm3_encode_1001(const rtcm_obs_message *msg_1001, uint8_t buff[]) {
+  assert(msg_1001);
+  return RTCM3_INSTRUMENT_ENCODE(msg_1001->header.msg_num,
+                                 buff,
+                                 rtcm3_encode_1001_internal(msg_1001, buff));
+}
+
+static uint16_t rtcm3_encode_1002_internal(const rtcm_obs_message *msg_1002,
+                                           uint8_t buff[]) {
   uint16_t bit = 64; /* Start at end of header. */
 
   uint8_t num_sats = 0;
@@ -448,8 +445,27 @@ uint16_t rtcm3_encode_1002(const rtcm_obs_message *msg_1002, uint8_t buff[]) {
   return (bit + 7) / 8;
 }
 
-uint16_t rtcm3_encode_1003(const rtcm_obs_message *msg_1003, uint8_t buff[]) {
-  assert(msg_1003);
+/** Encode an RTCMv3 message type 1002 (Extended L1-Only GPS RTK Observables)
+ * Message type 1002 has length `64 + n_sat*74` bits. Returned message length
+ * is rounded up to the nearest whole byte.
+ *
+ * \param buff A pointer to the RTCM data message buffer.
+ * \param id Reference station ID (DF003).
+ * \param t GPS time of epoch (DF004).
+ * \param n_sat Number of GPS satellites included in the message (DF006).
+ * \param nm Struct containing the observation.
+ * \param sync Synchronous GNSS Flag (DF005).
+ * \return The message length in bytes.
+ */
+uint16_t rtcm3_encode_1002(const rtcm_obs_message *msg_1002, uint8_t buff[]) {
+  assert(msg_1002);
+  return RTCM3_INSTRUMENT_ENCODE(msg_1002->header.msg_num,
+                                 buff,
+                                 rtcm3_encode_1002_internal(msg_1002, buff));
+}
+
+static uint16_t rtcm3_encode_1003_internal(const rtcm_obs_message *msg_1003,
+                                           uint8_t buff[]) {
   uint16_t bit = 64; /* Start at end of header. */
 
   uint8_t num_sats = 0;
@@ -484,8 +500,15 @@ uint16_t rtcm3_encode_1003(const rtcm_obs_message *msg_1003, uint8_t buff[]) {
   return (bit + 7) / 8;
 }
 
-uint16_t rtcm3_encode_1004(const rtcm_obs_message *msg_1004, uint8_t buff[]) {
-  assert(msg_1004);
+uint16_t rtcm3_encode_1003(const rtcm_obs_message *msg_1003, uint8_t buff[]) {
+  assert(msg_1003);
+  return RTCM3_INSTRUMENT_ENCODE(msg_1003->header.msg_num,
+                                 buff,
+                                 rtcm3_encode_1003_internal(msg_1003, buff));
+}
+
+static uint16_t rtcm3_encode_1004_internal(const rtcm_obs_message *msg_1004,
+                                           uint8_t buff[]) {
   uint16_t bit = 64; /* Start at end of header. */
 
   uint8_t num_sats = 0;
@@ -536,6 +559,13 @@ uint16_t rtcm3_encode_1004(const rtcm_obs_message *msg_1004, uint8_t buff[]) {
   return (bit + 7) / 8;
 }
 
+uint16_t rtcm3_encode_1004(const rtcm_obs_message *msg_1004, uint8_t buff[]) {
+  assert(msg_1004);
+  return RTCM3_INSTRUMENT_ENCODE(msg_1004->header.msg_num,
+                                 buff,
+                                 rtcm3_encode_1004_internal(msg_1004, buff));
+}
+
 static uint16_t rtcm3_encode_1005_base(const rtcm_msg_1005 *msg_1005,
                                        uint8_t buff[],
                                        uint16_t *bit) {
@@ -568,16 +598,22 @@ static uint16_t rtcm3_encode_1005_base(const rtcm_msg_1005 *msg_1005,
   return (*bit + 7) / 8;
 }
 
-uint16_t rtcm3_encode_1005(const rtcm_msg_1005 *msg_1005, uint8_t buff[]) {
-  assert(msg_1005);
+static uint16_t rtcm3_encode_1005_internal(const rtcm_msg_1005 *msg_1005,
+                                           uint8_t buff[]) {
   uint16_t bit = 0;
   rtcm_setbitu(buff, bit, 12, 1005);
   bit += 12;
   return rtcm3_encode_1005_base(msg_1005, buff, &bit);
 }
 
-uint16_t rtcm3_encode_1006(const rtcm_msg_1006 *msg_1006, uint8_t buff[]) {
-  assert(msg_1006);
+uint16_t rtcm3_encode_1005(const rtcm_msg_1005 *msg_1005, uint8_t buff[]) {
+  assert(msg_1005);
+  return RTCM3_INSTRUMENT_ENCODE(
+      1005, buff, rtcm3_encode_1005_internal(msg_1005, buff));
+}
+
+static uint16_t rtcm3_encode_1006_internal(const rtcm_msg_1006 *msg_1006,
+                                           uint8_t buff[]) {
   uint16_t bit = 0;
   rtcm_setbitu(buff, bit, 12, 1006);
   bit += 12;
@@ -595,6 +631,12 @@ uint16_t rtcm3_encode_1006(const rtcm_msg_1006 *msg_1006, uint8_t buff[]) {
   return (bit + 7) / 8;
 }
 
+uint16_t rtcm3_encode_1006(const rtcm_msg_1006 *msg_1006, uint8_t buff[]) {
+  assert(msg_1006);
+  return RTCM3_INSTRUMENT_ENCODE(
+      1006, buff, rtcm3_encode_1006_internal(msg_1006, buff));
+}
+
 static uint16_t rtcm3_encode_1007_base(const rtcm_msg_1007 *msg_1007,
                                        uint8_t buff[],
                                        uint16_t *bit) {
@@ -602,10 +644,11 @@ static uint16_t rtcm3_encode_1007_base(const rtcm_msg_1007 *msg_1007,
   *bit += 12;
   rtcm_setbitu(buff, *bit, 8, msg_1007->ant_descriptor_counter);
   *bit += 8;
-  for (uint8_t i = 0; i < msg_1007->ant_descriptor_counter; ++i) {
-    rtcm_setbitu(buff, *bit, 8, msg_1007->ant_descriptor[i]);
-    *bit += 8;
-  }
+  rtcm_setbytes(buff,
+                *bit,
+                (const uint8_t *)msg_1007->ant_descriptor,
+                msg_1007->ant_descriptor_counter);
+  *bit += 8 * msg_1007->ant_descriptor_counter;
   rtcm_setbitu(buff, *bit, 8, msg_1007->ant_setup_id);
   *bit += 8;
 
@@ -613,33 +656,46 @@ static uint16_t rtcm3_encode_1007_base(const rtcm_msg_1007 *msg_1007,
   return (*bit + 7) / 8;
 }
 
-uint16_t rtcm3_encode_1007(const rtcm_msg_1007 *msg_1007, uint8_t buff[]) {
-  assert(msg_1007);
+static uint16_t rtcm3_encode_1007_internal(const rtcm_msg_1007 *msg_1007,
+                                           uint8_t buff[]) {
   uint16_t bit = 0;
   rtcm_setbitu(buff, bit, 12, 1007);
   bit += 12;
   return rtcm3_encode_1007_base(msg_1007, buff, &bit);
 }
 
-uint16_t rtcm3_encode_1008(const rtcm_msg_1008 *msg_1008, uint8_t buff[]) {
-  assert(msg_1008);
+uint16_t rtcm3_encode_1007(const rtcm_msg_1007 *msg_1007, uint8_t buff[]) {
+  assert(msg_1007);
+  return RTCM3_INSTRUMENT_ENCODE(
+      1007, buff, rtcm3_encode_1007_internal(msg_1007, buff));
+}
+
+static uint16_t rtcm3_encode_1008_internal(const rtcm_msg_1008 *msg_1008,
+                                           uint8_t buff[]) {
   uint16_t bit = 0;
   rtcm_setbitu(buff, bit, 12, 1008);
   bit += 12;
   rtcm3_encode_1007_base(&msg_1008->msg_1007, buff, &bit);
   rtcm_setbitu(buff, bit, 8, msg_1008->ant_serial_num_counter);
   bit += 8;
-  for (uint8_t i = 0; i < msg_1008->ant_serial_num_counter; ++i) {
-    rtcm_setbitu(buff, bit, 8, msg_1008->ant_serial_num[i]);
-    bit += 8;
-  }
+  rtcm_setbytes(buff,
+                bit,
+                (const uint8_t *)msg_1008->ant_serial_num,
+                msg_1008->ant_serial_num_counter);
+  bit += 8 * msg_1008->ant_serial_num_counter;
 
   /* Round number of bits up to nearest whole byte. */
   return (bit + 7) / 8;
 }
 
-uint16_t rtcm3_encode_1010(const rtcm_obs_message *msg_1010, uint8_t buff[]) {
-  assert(msg_1010);
+uint16_t rtcm3_encode_1008(const rtcm_msg_1008 *msg_1008, uint8_t buff[]) {
+  assert(msg_1008);
+  return RTCM3_INSTRUMENT_ENCODE(
+      1008, buff, rtcm3_encode_1008_internal(msg_1008, buff));
+}
+
+static uint16_t rtcm3_encode_1010_internal(const rtcm_obs_message *msg_1010,
+                                           uint8_t buff[]) {
   uint16_t bit = 61; /* Start at end of header. */
 
   uint8_t num_sats = 0;
@@ -678,8 +734,15 @@ uint16_t rtcm3_encode_1010(const rtcm_obs_message *msg_1010, uint8_t buff[]) {
   return (bit + 7) / 8;
 }
 
-uint16_t rtcm3_encode_1012(const rtcm_obs_message *msg_1012, uint8_t buff[]) {
-  assert(msg_1012);
+uint16_t rtcm3_encode_1010(const rtcm_obs_message *msg_1010, uint8_t buff[]) {
+  assert(msg_1010);
+  return RTCM3_INSTRUMENT_ENCODE(msg_1010->header.msg_num,
+                                 buff,
+                                 rtcm3_encode_1010_internal(msg_1010, buff));
+}
+
+static uint16_t rtcm3_encode_1012_internal(const rtcm_obs_message *msg_1012,
+                                           uint8_t buff[]) {
   uint16_t bit = 61; /* Start at end of header. */
 
   uint8_t num_sats = 0;
@@ -728,8 +791,15 @@ uint16_t rtcm3_encode_1012(const rtcm_obs_message *msg_1012, uint8_t buff[]) {
   return (bit + 7) / 8;
 }
 
-uint16_t rtcm3_encode_1029(const rtcm_msg_1029 *msg_1029, uint8_t buff[]) {
-  assert(msg_1029);
+uint16_t rtcm3_encode_1012(const rtcm_obs_message *msg_1012, uint8_t buff[]) {
+  assert(msg_1012);
+  return RTCM3_INSTRUMENT_ENCODE(msg_1012->header.msg_num,
+                                 buff,
+                                 rtcm3_encode_1012_internal(msg_1012, buff));
+}
+
+static uint16_t rtcm3_encode_1029_internal(const rtcm_msg_1029 *msg_1029,
+                                           uint8_t buff[]) {
   uint16_t bit = 0;
   uint16_t byte = 0;
 
@@ -755,12 +825,18 @@ uint16_t rtcm3_encode_1029(const rtcm_msg_1029 *msg_1029, uint8_t buff[]) {
     buff[byte++] = msg_1029->utf8_code_units[i];
   }
 
-  /* Round number of bits up to nearest whole byte. */
-  return (bit + 7) / 8;
+  /* the string is byte aligned and follows the header */
+  return byte;
 }
 
-uint16_t rtcm3_encode_1033(const rtcm_msg_1033 *msg_1033, uint8_t buff[]) {
-  assert(msg_1033);
+uint16_t rtcm3_encode_1029(const rtcm_msg_1029 *msg_1029, uint8_t buff[]) {
+  assert(msg_1029);
+  return RTCM3_INSTRUMENT_ENCODE(
+      1029, buff, rtcm3_encode_1029_internal(msg_1029, buff));
+}
+
+static uint16_t rtcm3_encode_1033_internal(const rtcm_msg_1033 *msg_1033,
+                                           uint8_t buff[]) {
   uint16_t bit = 0;
   rtcm_setbitu(buff, bit, 12, 1033);
   bit += 12;
@@ -770,47 +846,58 @@ uint16_t rtcm3_encode_1033(const rtcm_msg_1033 *msg_1033, uint8_t buff[]) {
 
   rtcm_setbitu(buff, bit, 8, msg_1033->ant_descriptor_counter);
   bit += 8;
-  for (uint8_t i = 0; i < msg_1033->ant_descriptor_counter; ++i) {
-    rtcm_setbitu(buff, bit, 8, msg_1033->ant_descriptor[i]);
-    bit += 8;
-  }
+  rtcm_setbytes(buff,
+                bit,
+                (const uint8_t *)msg_1033->ant_descriptor,
+                msg_1033->ant_descriptor_counter);
+  bit += 8 * msg_1033->ant_descriptor_counter;
 
   rtcm_setbits(buff, bit, 8, msg_1033->ant_setup_id);
   bit += 8;
 
   rtcm_setbitu(buff, bit, 8, msg_1033->ant_serial_num_counter);
   bit += 8;
-  for (uint8_t i = 0; i < msg_1033->ant_serial_num_counter; ++i) {
-    rtcm_setbitu(buff, bit, 8, msg_1033->ant_serial_num[i]);
-    bit += 8;
-  }
+  rtcm_setbytes(buff,
+                bit,
+                (const uint8_t *)msg_1033->ant_serial_num,
+                msg_1033->ant_serial_num_counter);
+  bit += 8 * msg_1033->ant_serial_num_counter;
 
   rtcm_setbitu(buff, bit, 8, msg_1033->rcv_descriptor_counter);
   bit += 8;
-  for (uint8_t i = 0; i < msg_1033->rcv_descriptor_counter; ++i) {
-    rtcm_setbitu(buff, bit, 8, msg_1033->rcv_descriptor[i]);
-    bit += 8;
-  }
+  rtcm_setbytes(buff,
+                bit,
+                (const uint8_t *)msg_1033->rcv_descriptor,
+                msg_1033->rcv_descriptor_counter);
+  bit += 8 * msg_1033->rcv_descriptor_counter;
 
   rtcm_setbitu(buff, bit, 8, msg_1033->rcv_fw_version_counter);
   bit += 8;
-  for (uint8_t i = 0; i < msg_1033->rcv_fw_version_counter; ++i) {
-    rtcm_setbitu(buff, bit, 8, msg_1033->rcv_fw_version[i]);
-    bit += 8;
-  }
+  rtcm_setbytes(buff,
+                bit,
+                (const uint8_t *)msg_1033->rcv_fw_version,
+                msg_1033->rcv_fw_version_counter);
+  bit += 8 * msg_1033->rcv_fw_version_counter;
 
   rtcm_setbitu(buff, bit, 8, msg_1033->rcv_serial_num_counter);
   bit += 8;
-  for (uint8_t i = 0; i < msg_1033->rcv_serial_num_counter; ++i) {
-    rtcm_setbitu(buff, bit, 8, msg_1033->rcv_serial_num[i]);
-    bit += 8;
-  }
+  rtcm_setbytes(buff,
+                bit,
+                (const uint8_t *)msg_1033->rcv_serial_num,
+                msg_1033->rcv_serial_num_counter);
+  bit += 8 * msg_1033->rcv_serial_num_counter;
   /* Round number of bits up to nearest whole byte. */
   return (bit + 7) / 8;
 }
 
-uint16_t rtcm3_encode_1230(const rtcm_msg_1230 *msg_1230, uint8_t buff[]) {
-  assert(msg_1230);
+uint16_t rtcm3_encode_1033(const rtcm_msg_1033 *msg_1033, uint8_t buff[]) {
+  assert(msg_1033);
+  return RTCM3_INSTRUMENT_ENCODE(
+      1033, buff, rtcm3_encode_1033_internal(msg_1033, buff));
+}
+
+static uint16_t rtcm3_encode_1230_internal(const rtcm_msg_1230 *msg_1230,
+                                           uint8_t buff[]) {
   uint16_t bit = 0;
   rtcm_setbitu(buff, bit, 12, 1230);
   bit += 12;
@@ -848,6 +935,12 @@ uint16_t rtcm3_encode_1230(const rtcm_msg_1230 *msg_1230, uint8_t buff[]) {
   return (bit + 7) / 8;
 }
 
+uint16_t rtcm3_encode_1230(const rtcm_msg_1230 *msg_1230, uint8_t buff[]) {
+  assert(msg_1230);
+  return RTCM3_INSTRUMENT_ENCODE(
+      1230, buff, rtcm3_encode_1230_internal(msg_1230, buff));
+}
+
 static uint16_t rtcm3_encode_msm_header(const rtcm_msm_header *header,
                                         const rtcm_constellation_t cons,
                                         uint8_t buff[]) {
@@ -1160,7 +1253,9 @@ uint16_t rtcm3_encode_msm4(const rtcm_msm_message *msg_msm4, uint8_t buff[]) {
     return 0;
   }
 
-  return rtcm3_encode_msm_internal(msg_msm4, buff);
+  return RTCM3_INSTRUMENT_ENCODE(msg_msm4->header.msg_num,
+                                 buff,
+                                 rtcm3_encode_msm_internal(msg_msm4, buff));
 }
 
 /** MSM5 encoder
@@ -1177,19 +1272,13 @@ uint16_t rtcm3_encode_msm5(const rtcm_msm_message *msg_msm5, uint8_t buff[]) {
     return 0;
   }
 
-  return rtcm3_encode_msm_internal(msg_msm5, buff);
+  return RTCM3_INSTRUMENT_ENCODE(msg_msm5->header.msg_num,
+                                 buff,
+                                 rtcm3_encode_msm_internal(msg_msm5, buff));
 }
 
-/** Encode the Swift Proprietary Message
- *
- * \param msg The input RTCM message struct
- * \param buff Data buffer large enough to hold the message
- * \return Number of bytes written or 0 on failure
- */
-
-uint16_t rtcm3_encode_4062(const rtcm_msg_swift_proprietary *msg,
-                           uint8_t buff[]) {
-  assert(msg);
+static uint16_t rtcm3_encode_4062_internal(
+    const rtcm_msg_swift_proprietary *msg, uint8_t buff[]) {
   uint16_t bit = 0;
   rtcm_setbitu(buff, bit, 12, 4062);
   bit += 12;
@@ -1203,11 +1292,348 @@ uint16_t rtcm3_encode_4062(const rtcm_msg_swift_proprietary *msg,
   rtcm_setbitu(buff, bit, 8, msg->len);
   bit += 8;
 
-  for (uint8_t i = 0; i < msg->len; ++i) {
-    rtcm_setbitu(buff, bit, 8, msg->data[i]);
-    bit += 8;
-  }
+  rtcm_setbytes(buff, bit, msg->data, msg->len);
+  bit += 8 * msg->len;
 
   /* Round number of bits up to nearest whole byte. */
   return (bit + 7) / 8;
 }
+
+/** Encode the Swift Proprietary Message
+ *
+ * \param msg The input RTCM message struct
+ * \param buff Data buffer large enough to hold the message
+ * \return Number of bytes written or 0 on failure
+ */
+
+uint16_t rtcm3_encode_4062(const rtcm_msg_swift_proprietary *msg,
+                           uint8_t buff[]) {
+  assert(msg);
+  return RTCM3_INSTRUMENT_ENCODE(
+      4062, buff, rtcm3_encode_4062_internal(msg, buff));
+}
+
+/* Message lengths in bits, see RTCM 10403.3 Tables 3.5-2 to 3.5-11 */
+#define OBS_HEADER_BITS 64
+#define GLO_OBS_HEADER_BITS 61
+#define SAT_1001_BITS 58
+#define SAT_1002_BITS 74
+#define SAT_1003_BITS 101
+#define SAT_1004_BITS 125
+#define SAT_1010_BITS 79
+#define SAT_1012_BITS 130
+#define MSG_1005_BITS 152
+#define MSG_1006_BITS 168
+#define MSG_1007_BITS 40
+#define MSG_1008_BITS 48
+#define MSG_1029_BITS 72
+#define MSG_1033_BITS 72
+#define MSG_1230_BITS 32
+#define MSG_4062_BITS 56
+/* header up to and including the signal mask, DF002 to DF395 */
+#define MSM_HEADER_BITS 169
+#define MSM4_SAT_BITS 18
+#define MSM5_SAT_BITS 36
+#define MSM4_SIGNAL_BITS 48
+#define MSM5_SIGNAL_BITS 63
+
+static uint16_t bits_to_bytes(uint32_t bits) {
+  return (uint16_t)((bits + 7) / 8);
+}
+
+/* Number of satellites the observation encoders write: those with a valid
+ * L1, and L2 if the message needs it, at most RTCM_MAX_SATS */
+static uint8_t count_obs_sats(const rtcm_obs_message *msg, bool need_l2) {
+  uint8_t num_sats = 0;
+  for (uint8_t i = 0; i < msg->header.n_sat && num_sats < RTCM_MAX_SATS;
+       i++) {
+    flag_bf l1_flags = msg->sats[i].obs[L1_FREQ].flags;
+    flag_bf l2_flags = msg->sats[i].obs[L2_FREQ].flags;
+    if (l1_flags.valid_pr && l1_flags.valid_cp &&
+        (!need_l2 || (l2_flags.valid_pr && l2_flags.valid_cp))) {
+      num_sats++;
+    }
+  }
+  return num_sats;
+}
+
+/** Size of a message type 1001 as rtcm3_encode_1001 writes it
+ *
+ * The encoded sizes are computed from the message struct alone, without
+ * encoding anything, so that a buffer of exactly the right size can be
+ * reserved first.
+ *
+ * \param msg_1001 The input RTCM message struct
+ * \return Number of bytes the encoder writes
+ */
+uint16_t rtcm3_encoded_size_1001(const rtcm_obs_message *msg_1001) {
+  assert(msg_1001);
+  return bits_to_bytes(OBS_HEADER_BITS +
+                       SAT_1001_BITS * count_obs_sats(msg_1001, false));
+}
+
+uint16_t rtcm3_encoded_size_1002(const rtcm_obs_message *msg_1002) {
+  assert(msg_1002);
+  return bits_to_bytes(OBS_HEADER_BITS +
+                       SAT_1002_BITS * count_obs_sats(msg_1002, false));
+}
+
+uint16_t rtcm3_encoded_size_1003(const rtcm_obs_message *msg_1003) {
+  assert(msg_1003);
+  return bits_to_bytes(OBS_HEADER_BITS +
+                       SAT_1003_BITS * count_obs_sats(msg_1003, true));
+}
+
+uint16_t rtcm3_encoded_size_1004(const rtcm_obs_message *msg_1004) {
+  assert(msg_1004);
+  return bits_to_bytes(OBS_HEADER_BITS +
+                       SAT_1004_BITS * count_obs_sats(msg_1004, false));
+}
+
+uint16_t rtcm3_encoded_size_1005(const rtcm_msg_1005 *msg_1005) {
+  assert(msg_1005);
+  return bits_to_bytes(MSG_1005_BITS);
+}
+
+uint16_t rtcm3_encoded_size_1006(const rtcm_msg_1006 *msg_1006) {
+  assert(msg_1006);
+  return bits_to_bytes(MSG_1006_BITS);
+}
+
+uint16_t rtcm3_encoded_size_1007(const rtcm_msg_1007 *msg_1007) {
+  assert(msg_1007);
+  return bits_to_bytes(MSG_1007_BITS +
+                       8 * (uint32_t)msg_1007->ant_descriptor_counter);
+}
+
+uint16_t rtcm3_encoded_size_1008(const rtcm_msg_1008 *msg_1008) {
+  assert(msg_1008);
+  return bits_to_bytes(
+      MSG_1008_BITS + 8 * (uint32_t)msg_1008->msg_1007.ant_descriptor_counter +
+      8 * (uint32_t)msg_1008->ant_serial_num_counter);
+}
+
+uint16_t rtcm3_encoded_size_1010(const rtcm_obs_message *msg_1010) {
+  assert(msg_1010);
+  return bits_to_bytes(GLO_OBS_HEADER_BITS +
+                       SAT_1010_BITS * count_obs_sats(msg_1010, false));
+}
+
+uint16_t rtcm3_encoded_size_1012(const rtcm_obs_message *msg_1012) {
+  assert(msg_1012);
+  return bits_to_bytes(GLO_OBS_HEADER_BITS +
+                       SAT_1012_BITS * count_obs_sats(msg_1012, false));
+}
+
+uint16_t rtcm3_encoded_size_1029(const rtcm_msg_1029 *msg_1029) {
+  assert(msg_1029);
+  return bits_to_bytes(MSG_1029_BITS +
+                       8 * (uint32_t)msg_1029->utf8_code_units_n);
+}
+
+uint16_t rtcm3_encoded_size_1033(const rtcm_msg_1033 *msg_1033) {
+  assert(msg_1033);
+  uint32_t num_chars = (uint32_t)msg_1033->ant_descriptor_counter +
+                       msg_1033->ant_serial_num_counter +
+                       msg_1033->rcv_descriptor_counter +
+                       msg_1033->rcv_fw_version_counter +
+                       msg_1033->rcv_serial_num_counter;
+  return bits_to_bytes(MSG_1033_BITS + 8 * num_chars);
+}
+
+uint16_t rtcm3_encoded_size_1230(const rtcm_msg_1230 *msg_1230) {
+  assert(msg_1230);
+  uint32_t num_biases = 0;
+  for (uint8_t signal = 0; signal < 4; signal++) {
+    num_biases += (msg_1230->fdma_signal_mask >> signal) & 1u;
+  }
+  return bits_to_bytes(MSG_1230_BITS + 16 * num_biases);
+}
+
+/* Size of an MSM4 or MSM5, 0 where rtcm3_encode_msm_internal fails */
+static uint16_t encoded_size_msm(const rtcm_msm_message *msg,
+                                 msm_enum msm_type) {
+  const rtcm_msm_header *header = &msg->header;
+  if (msm_type != to_msm_type(header->msg_num) ||
+      RTCM_CONSTELLATION_INVALID == to_constellation(header->msg_num)) {
+    return 0;
+  }
+  uint8_t num_sats =
+      count_mask_values(MSM_SATELLITE_MASK_SIZE, header->satellite_mask);
+  uint8_t num_sigs =
+      count_mask_values(MSM_SIGNAL_MASK_SIZE, header->signal_mask);
+  if (num_sats * num_sigs > MSM_MAX_CELLS) {
+    return 0;
+  }
+  uint8_t cell_mask_size = num_sats * num_sigs;
+  uint8_t num_cells = count_mask_values(cell_mask_size, header->cell_mask);
+  uint32_t sat_bits = MSM5 == msm_type ? MSM5_SAT_BITS : MSM4_SAT_BITS;
+  uint32_t signal_bits = MSM5 == msm_type ? MSM5_SIGNAL_BITS : MSM4_SIGNAL_BITS;
+  return bits_to_bytes(MSM_HEADER_BITS + cell_mask_size + sat_bits * num_sats +
+                       signal_bits * num_cells);
+}
+
+/** Size of an MSM4 as rtcm3_encode_msm4 writes it
+ *
+ * \param msg_msm4 The input RTCM message struct
+ * \return Number of bytes the encoder writes, 0 if it would fail
+ */
+uint16_t rtcm3_encoded_size_msm4(const rtcm_msm_message *msg_msm4) {
+  assert(msg_msm4);
+  return encoded_size_msm(msg_msm4, MSM4);
+}
+
+uint16_t rtcm3_encoded_size_msm5(const rtcm_msm_message *msg_msm5) {
+  assert(msg_msm5);
+  return encoded_size_msm(msg_msm5, MSM5);
+}
+
+uint16_t rtcm3_encoded_size_4062(const rtcm_msg_swift_proprietary *msg) {
+  assert(msg);
+  return bits_to_bytes(MSG_4062_BITS + 8 * (uint32_t)msg->len);
+}
+
+/* Satellites of an epoch which go into one message */
+typedef struct {
+  uint16_t first_cell;
+  uint16_t end_cell;
+  uint32_t signal_mask;
+} msm_split;
+
+static uint8_t count_bits(uint32_t mask) {
+  uint8_t count = 0;
+  for (; mask != 0; mask &= mask - 1) {
+    count++;
+  }
+  return count;
+}
+
+/* Group the satellites of an epoch, in mask order, into as few messages as
+ * the cell mask and the satellite array allow. Returns the number of
+ * messages, 0 if the cells are out of range or out of order. */
+static uint8_t plan_msm_splits(const rtcm_msm_epoch *epoch,
+                               msm_split splits[MSM_SATELLITE_MASK_SIZE]) {
+  const rtcm_msm_cell *cells = epoch->cells;
+  uint8_t num_splits = 0;
+  msm_split current = {0, 0, 0};
+  uint8_t current_sats = 0;
+  uint16_t i = 0;
+  while (i < epoch->num_cells) {
+    uint8_t sat = cells[i].sat;
+    if (sat >= MSM_SATELLITE_MASK_SIZE || (i > 0 && sat <= cells[i - 1].sat)) {
+      return 0;
+    }
+    uint32_t sat_signals = 0;
+    uint16_t end = i;
+    for (; end < epoch->num_cells && cells[end].sat == sat; end++) {
+      if (cells[end].sig >= MSM_SIGNAL_MASK_SIZE ||
+          (end > i && cells[end].sig <= cells[end - 1].sig)) {
+        return 0;
+      }
+      sat_signals |= 1u << cells[end].sig;
+    }
+    uint32_t signal_mask = current.signal_mask | sat_signals;
+    if (current_sats > 0 &&
+        (current_sats == RTCM_MAX_SATS ||
+         (current_sats + 1) * count_bits(signal_mask) > MSM_MAX_CELLS)) {
+      current.end_cell = i;
+      splits[num_splits++] = current;
+      current.first_cell = i;
+      current_sats = 0;
+      signal_mask = sat_signals;
+    }
+    current.signal_mask = signal_mask;
+    current_sats++;
+    i = end;
+  }
+  if (current_sats > 0) {
+    current.end_cell = i;
+    splits[num_splits++] = current;
+  }
+  return num_splits;
+}
+
+/* Fill in the masks and data of one message from its share of the epoch */
+static void fill_msm_split(const rtcm_msm_epoch *epoch,
+                           const msm_split *split,
+                           rtcm_msm_message *msg) {
+  rtcm_msm_header *header = &msg->header;
+  memset(header->satellite_mask, 0, sizeof(header->satellite_mask));
+  memset(header->signal_mask, 0, sizeof(header->signal_mask));
+  memset(header->cell_mask, 0, sizeof(header->cell_mask));
+
+  uint8_t signal_column[MSM_SIGNAL_MASK_SIZE];
+  uint8_t num_sigs = 0;
+  for (uint8_t sig = 0; sig < MSM_SIGNAL_MASK_SIZE; sig++) {
+    if ((split->signal_mask >> sig) & 1u) {
+      header->signal_mask[sig] = true;
+      signal_column[sig] = num_sigs++;
+    }
+  }
+
+  uint8_t num_sats = 0;
+  for (uint16_t i = split->first_cell; i < split->end_cell; i++) {
+    const rtcm_msm_cell *cell = &epoch->cells[i];
+    if (!header->satellite_mask[cell->sat]) {
+      header->satellite_mask[cell->sat] = true;
+      msg->sats[num_sats++] = epoch->sats[cell->sat];
+    }
+    header->cell_mask[(num_sats - 1) * num_sigs + signal_column[cell->sig]] =
+        true;
+    msg->signals[i - split->first_cell] = cell->data;
+  }
+}
+
+/** Encode all observations of one constellation at one epoch as MSM frames
+ *
+ * The observations are split by satellite into the fewest messages that keep
+ * the cell mask within 64 cells, each message sharing the header of the
+ * epoch. The multiple message bit is set on all but the last message, which
+ * keeps the bit of the header so that the caller can mark further messages
+ * of other constellations at the same epoch. With at most 64 cells an MSM4
+ * or MSM5 stays well below the frame size limit.
+ *
+ * \param epoch The observations, an MSM4 or MSM5 message number in the header
+ * \param buff Output buffer for the frames, back to back
+ * \param buff_len Size of buff in bytes
+ * \param len Set to the number of bytes written
+ * \return Number of frames written, 0 on failure or if there are no cells
+ */
+uint8_t rtcm3_encode_msm_epoch(const rtcm_msm_epoch *epoch,
+                               uint8_t buff[],
+                               size_t buff_len,
+                               size_t *len) {
+  assert(epoch);
+  assert(len);
+  *len = 0;
+  msm_enum msm_type = to_msm_type(epoch->header.msg_num);
+  if (MSM4 != msm_type && MSM5 != msm_type) {
+    return 0;
+  }
+
+  msm_split splits[MSM_SATELLITE_MASK_SIZE];
+  uint8_t num_splits = plan_msm_splits(epoch, splits);
+
+  rtcm_msm_message msg;
+  msg.header = epoch->header;
+  size_t pos = 0;
+  for (uint8_t i = 0; i < num_splits; i++) {
+    fill_msm_split(epoch, &splits[i], &msg);
+    msg.header.multiple = i + 1 < num_splits || epoch->header.multiple;
+    uint16_t payload_len = encoded_size_msm(&msg, msm_type);
+    if (0 == payload_len || payload_len > RTCM3_MAX_PAYLOAD_LEN ||
+        pos + payload_len + RTCM3_FRAME_OVERHEAD > buff_len) {
+      return 0;
+    }
+    uint8_t *payload = &buff[pos + RTCM3_FRAME_HEADER_LEN];
+    memset(payload, 0, payload_len);
+    if (MSM4 == msm_type) {
+      rtcm3_encode_msm4(&msg, payload);
+    } else {
+      rtcm3_encode_msm5(&msg, payload);
+    }
+    pos += rtcm3_frame_finalize(&buff[pos], payload_len);
+  }
+  *len = pos;
+  return num_splits;
+}
@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/eph_cache.h"
+#include <assert.h>
+#include <string.h>
+#include "rtcm3/eph_encode.h"
+
+typedef struct {
+  uint16_t msg_num;
+  uint16_t (*encode)(const rtcm_msg_eph *msg_eph, uint8_t buff[]);
+} eph_encoder;
+
+/* the message types of the ephemeris store */
+static const eph_encoder eph_encoders[RTCM3_EPH_STORE_MSG_TYPES] = {
+    {1019, rtcm3_encode_gps_eph},
+    {1020, rtcm3_encode_glo_eph},
+    {1042, rtcm3_encode_bds_eph},
+    {1044, rtcm3_encode_qzss_eph},
+    {1045, rtcm3_encode_gal_eph_fnav},
+    {1046, rtcm3_encode_gal_eph_inav},
+};
+
+static int8_t find_encoder(uint16_t msg_num) {
+  for (uint8_t i = 0; i < RTCM3_EPH_STORE_MSG_TYPES; i++) {
+    if (eph_encoders[i].msg_num == msg_num) {
+      return (int8_t)i;
+    }
+  }
+  return -1;
+}
+
+/** Reset the cache to empty
+ *
+ * \param cache The cache to initialize
+ */
+void rtcm3_eph_cache_init(rtcm3_eph_cache *cache) {
+  assert(cache);
+  memset(cache, 0, sizeof(*cache));
+}
+
+/** Get the framed message of an ephemeris, encoding it only if it changed
+ *
+ * \param cache The cache
+ * \param msg_num Ephemeris message type to broadcast it as, 1019, 1020, 1042,
+ *                1044, 1045 or 1046
+ * \param eph The ephemeris
+ * \param frame Set to the cached frame, valid until the satellite's entry is
+ *              replaced by a different ephemeris
+ * \return Length of the frame in bytes or 0 if the message type or satellite
+ *         ID is not supported
+ */
+uint16_t rtcm3_eph_cache_frame(rtcm3_eph_cache *cache,
+                               uint16_t msg_num,
+                               const rtcm_msg_eph *eph,
+                               const uint8_t **frame) {
+  assert(cache);
+  assert(eph);
+  assert(frame);
+  int8_t type_index = find_encoder(msg_num);
+  if (type_index < 0 || eph->sat_id >= RTCM3_EPH_STORE_MAX_SATS) {
+    return 0;
+  }
+  rtcm3_eph_cache_entry *entry = &cache->entries[type_index][eph->sat_id];
+  if (entry->valid && 0 == memcmp(&entry->eph, eph, sizeof(*eph))) {
+    cache->hits++;
+    *frame = entry->frame;
+    return entry->frame_len;
+  }
+
+  /* the encoders leave padding bits untouched */
+  memset(entry->frame, 0, sizeof(entry->frame));
+  uint16_t payload_len = eph_encoders[type_index].encode(
+      eph, &entry->frame[RTCM3_FRAME_HEADER_LEN]);
+  entry->frame_len = rtcm3_frame_finalize(entry->frame, payload_len);
+  entry->valid = (entry->frame_len > 0);
+  memcpy(&entry->eph, eph, sizeof(entry->eph));
+  cache->encoded++;
+  *frame = entry->frame;
+  return entry->frame_len;
+}
+
+/** Copy the framed message of an ephemeris into a buffer
+ *
+ * \param cache The cache
+ * \param msg_num Ephemeris message type to broadcast it as
+ * \param eph The ephemeris
+ * \param buff Output buffer, at least RTCM3_EPH_MAX_FRAME_LEN bytes
+ * \return Length of the frame in bytes or 0 if the message type or satellite
+ *         ID is not supported
+ */
+uint16_t rtcm3_eph_cache_copy(rtcm3_eph_cache *cache,
+                              uint16_t msg_num,
+                              const rtcm_msg_eph *eph,
+                              uint8_t buff[]) {
+  const uint8_t *frame = NULL;
+  uint16_t frame_len = rtcm3_eph_cache_frame(cache, msg_num, eph, &frame);
+  if (frame_len > 0) {
+    memcpy(buff, frame, frame_len);
+  }
+  return frame_len;
+}
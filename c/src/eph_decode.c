@@ -14,16 +14,10 @@
 #include <assert.h>
 #include <string.h>
 #include "rtcm3/bits.h"
+#include "instrument.h"
 
-/** Decode an RTCMv3 GPS Ephemeris Message
- *
- * \param buff The input data buffer
- * \param RTCM message struct
- * \return  - RC_OK : Success
- *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
- */
-rtcm3_rc rtcm3_decode_gps_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
-  assert(msg_eph);
+static rtcm3_rc rtcm3_decode_gps_eph_internal(const uint8_t buff[],
+                                              rtcm_msg_eph *msg_eph) {
   memset(msg_eph, 0, sizeof(*msg_eph));
   msg_eph->constellation = RTCM_CONSTELLATION_GPS;
   uint16_t bit = 0;
@@ -96,15 +90,21 @@ rtcm3_rc rtcm3_decode_gps_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
   return RC_OK;
 }
 
-/** Decode an RTCMv3 QZSS Ephemeris Message
+/** Decode an RTCMv3 GPS Ephemeris Message
  *
  * \param buff The input data buffer
  * \param RTCM message struct
  * \return  - RC_OK : Success
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
  */
-rtcm3_rc rtcm3_decode_qzss_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
+rtcm3_rc rtcm3_decode_gps_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
   assert(msg_eph);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_gps_eph_internal(buff, msg_eph));
+}
+
+static rtcm3_rc rtcm3_decode_qzss_eph_internal(const uint8_t buff[],
+                                               rtcm_msg_eph *msg_eph) {
   memset(msg_eph, 0, sizeof(*msg_eph));
   msg_eph->constellation = RTCM_CONSTELLATION_QZS;
   uint16_t bit = 0;
@@ -174,15 +174,21 @@ rtcm3_rc rtcm3_decode_qzss_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
   return RC_OK;
 }
 
-/** Decode an RTCMv3 GLO Ephemeris Message
+/** Decode an RTCMv3 QZSS Ephemeris Message
  *
  * \param buff The input data buffer
  * \param RTCM message struct
  * \return  - RC_OK : Success
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
  */
-rtcm3_rc rtcm3_decode_glo_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
+rtcm3_rc rtcm3_decode_qzss_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
   assert(msg_eph);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_qzss_eph_internal(buff, msg_eph));
+}
+
+static rtcm3_rc rtcm3_decode_glo_eph_internal(const uint8_t buff[],
+                                              rtcm_msg_eph *msg_eph) {
   memset(msg_eph, 0, sizeof(*msg_eph));
   msg_eph->constellation = RTCM_CONSTELLATION_GLO;
   uint16_t bit = 0;
@@ -273,16 +279,21 @@ rtcm3_rc rtcm3_decode_glo_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
   return RC_OK;
 }
 
-/** Decode an RTCMv3 BDS Ephemeris Message
+/** Decode an RTCMv3 GLO Ephemeris Message
  *
  * \param buff The input data buffer
  * \param RTCM message struct
  * \return  - RC_OK : Success
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
- *          - RC_INVALID_MESSAGE : Satellite is geostationary
  */
-rtcm3_rc rtcm3_decode_bds_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
+rtcm3_rc rtcm3_decode_glo_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
   assert(msg_eph);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_glo_eph_internal(buff, msg_eph));
+}
+
+static rtcm3_rc rtcm3_decode_bds_eph_internal(const uint8_t buff[],
+                                              rtcm_msg_eph *msg_eph) {
   memset(msg_eph, 0, sizeof(*msg_eph));
   msg_eph->constellation = RTCM_CONSTELLATION_BDS;
   uint16_t bit = 0;
@@ -354,6 +365,20 @@ rtcm3_rc rtcm3_decode_bds_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
   return RC_OK;
 }
 
+/** Decode an RTCMv3 BDS Ephemeris Message
+ *
+ * \param buff The input data buffer
+ * \param RTCM message struct
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
+ *          - RC_INVALID_MESSAGE : Satellite is geostationary
+ */
+rtcm3_rc rtcm3_decode_bds_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
+  assert(msg_eph);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_bds_eph_internal(buff, msg_eph));
+}
+
 /** Decode an RTCMv3 GAL (common part) Ephemeris Message
  *
  * \param buff The input data buffer
@@ -415,15 +440,8 @@ static uint16_t rtcm3_decode_gal_eph_common(const uint8_t buff[],
   return bit;
 }
 
-/** Decode an RTCMv3 GAL (I/NAV message) Ephemeris Message
- *
- * \param buff The input data buffer
- * \param RTCM message struct
- * \return  - RC_OK : Success
- *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
- */
-rtcm3_rc rtcm3_decode_gal_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
-  assert(msg_eph);
+static rtcm3_rc rtcm3_decode_gal_eph_internal(const uint8_t buff[],
+                                              rtcm_msg_eph *msg_eph) {
   memset(msg_eph, 0, sizeof(*msg_eph));
   msg_eph->constellation = RTCM_CONSTELLATION_GAL;
   uint16_t bit = 0;
@@ -447,16 +465,21 @@ rtcm3_rc rtcm3_decode_gal_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
   return RC_OK;
 }
 
-/** Decode an RTCMv3 GAL (F/NAV message) Ephemeris Message
+/** Decode an RTCMv3 GAL (I/NAV message) Ephemeris Message
  *
  * \param buff The input data buffer
  * \param RTCM message struct
  * \return  - RC_OK : Success
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
  */
-rtcm3_rc rtcm3_decode_gal_eph_fnav(const uint8_t buff[],
-                                   rtcm_msg_eph *msg_eph) {
+rtcm3_rc rtcm3_decode_gal_eph(const uint8_t buff[], rtcm_msg_eph *msg_eph) {
   assert(msg_eph);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_gal_eph_internal(buff, msg_eph));
+}
+
+static rtcm3_rc rtcm3_decode_gal_eph_fnav_internal(const uint8_t buff[],
+                                                   rtcm_msg_eph *msg_eph) {
   memset(msg_eph, 0, sizeof(*msg_eph));
   msg_eph->constellation = RTCM_CONSTELLATION_GAL;
   uint16_t bit = 0;
@@ -478,3 +501,17 @@ rtcm3_rc rtcm3_decode_gal_eph_fnav(const uint8_t buff[],
 
   return RC_OK;
 }
+
+/** Decode an RTCMv3 GAL (F/NAV message) Ephemeris Message
+ *
+ * \param buff The input data buffer
+ * \param RTCM message struct
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
+ */
+rtcm3_rc rtcm3_decode_gal_eph_fnav(const uint8_t buff[],
+                                   rtcm_msg_eph *msg_eph) {
+  assert(msg_eph);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_gal_eph_fnav_internal(buff, msg_eph));
+}
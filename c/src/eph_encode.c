@@ -14,9 +14,10 @@
 #include <assert.h>
 #include <string.h>
 #include "rtcm3/bits.h"
+#include "instrument.h"
 
-uint16_t rtcm3_encode_gps_eph(const rtcm_msg_eph *msg_1019, uint8_t buff[]) {
-  assert(msg_1019);
+static uint16_t rtcm3_encode_gps_eph_internal(const rtcm_msg_eph *msg_1019,
+                                              uint8_t buff[]) {
   uint16_t bit = 0;
   rtcm_setbitu(buff, bit, 12, 1019);
   bit += 12;
@@ -85,6 +86,12 @@ uint16_t rtcm3_encode_gps_eph(const rtcm_msg_eph *msg_1019, uint8_t buff[]) {
   return (bit + 7) / 8;
 }
 
+uint16_t rtcm3_encode_gps_eph(const rtcm_msg_eph *msg_1019, uint8_t buff[]) {
+  assert(msg_1019);
+  return RTCM3_INSTRUMENT_ENCODE(
+      1019, buff, rtcm3_encode_gps_eph_internal(msg_1019, buff));
+}
+
 /** Decode an RTCMv3 GAL (common part) Ephemeris Message
  *
  * \param buff The input data buffer
@@ -145,15 +152,8 @@ static void rtcm3_encode_gal_eph_common(const rtcm_msg_eph *msg_eph,
   *bit += 24;
 }
 
-/** Decode an RTCMv3 GAL (I/NAV message) Ephemeris Message
- *
- * \param buff The input data buffer
- * \param RTCM message struct
- * \return  - RC_OK : Success
- *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
- */
-uint16_t rtcm3_encode_gal_eph_inav(const rtcm_msg_eph *msg_eph, uint8_t buff[]) {
-  assert(msg_eph);
+static uint16_t rtcm3_encode_gal_eph_inav_internal(const rtcm_msg_eph *msg_eph,
+                                                   uint8_t buff[]) {
 
   uint16_t bit = 0;
   rtcm_setbitu(buff, bit, 12, 1046);
@@ -176,16 +176,21 @@ uint16_t rtcm3_encode_gal_eph_inav(const rtcm_msg_eph *msg_eph, uint8_t buff[])
   return (bit + 7) / 8;
 }
 
-/** Decode an RTCMv3 GAL (F/NAV message) Ephemeris Message
+/** Decode an RTCMv3 GAL (I/NAV message) Ephemeris Message
  *
  * \param buff The input data buffer
  * \param RTCM message struct
  * \return  - RC_OK : Success
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
  */
-uint16_t rtcm3_encode_gal_eph_fnav(const rtcm_msg_eph *msg_eph,
-                                   uint8_t buff[]) {
+uint16_t rtcm3_encode_gal_eph_inav(const rtcm_msg_eph *msg_eph, uint8_t buff[]) {
   assert(msg_eph);
+  return RTCM3_INSTRUMENT_ENCODE(
+      1046, buff, rtcm3_encode_gal_eph_inav_internal(msg_eph, buff));
+}
+
+static uint16_t rtcm3_encode_gal_eph_fnav_internal(const rtcm_msg_eph *msg_eph,
+                                                   uint8_t buff[]) {
 
   uint16_t bit = 0;
   rtcm_setbitu(buff, bit, 12, 1045);
@@ -205,3 +210,293 @@ uint16_t rtcm3_encode_gal_eph_fnav(const rtcm_msg_eph *msg_eph,
   /* Round number of bits up to nearest whole byte. */
   return (bit + 7) / 8;
 }
+
+/** Decode an RTCMv3 GAL (F/NAV message) Ephemeris Message
+ *
+ * \param buff The input data buffer
+ * \param RTCM message struct
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
+ */
+uint16_t rtcm3_encode_gal_eph_fnav(const rtcm_msg_eph *msg_eph,
+                                   uint8_t buff[]) {
+  assert(msg_eph);
+  return RTCM3_INSTRUMENT_ENCODE(
+      1045, buff, rtcm3_encode_gal_eph_fnav_internal(msg_eph, buff));
+}
+
+static uint16_t rtcm3_encode_qzss_eph_internal(const rtcm_msg_eph *msg_eph,
+                                               uint8_t buff[]) {
+  uint16_t bit = 0;
+  rtcm_setbitu(buff, bit, 12, 1044);
+  bit += 12;
+  rtcm_setbitu(buff, bit, 4, msg_eph->sat_id);
+  bit += 4;
+  rtcm_setbitu(buff, bit, 16, msg_eph->kepler.toc);
+  bit += 16;
+  rtcm_setbits(buff, bit, 8, msg_eph->kepler.af2);
+  bit += 8;
+  rtcm_setbits(buff, bit, 16, msg_eph->kepler.af1);
+  bit += 16;
+  rtcm_setbits(buff, bit, 22, msg_eph->kepler.af0);
+  bit += 22;
+  rtcm_setbitu(buff, bit, 8, msg_eph->kepler.iode);
+  bit += 8;
+  rtcm_setbits(buff, bit, 16, msg_eph->kepler.crs);
+  bit += 16;
+  rtcm_setbits(buff, bit, 16, msg_eph->kepler.dn);
+  bit += 16;
+  rtcm_setbits(buff, bit, 32, msg_eph->kepler.m0);
+  bit += 32;
+  rtcm_setbits(buff, bit, 16, msg_eph->kepler.cuc);
+  bit += 16;
+  rtcm_setbitu(buff, bit, 32, msg_eph->kepler.ecc);
+  bit += 32;
+  rtcm_setbits(buff, bit, 16, msg_eph->kepler.cus);
+  bit += 16;
+  rtcm_setbitu(buff, bit, 32, msg_eph->kepler.sqrta);
+  bit += 32;
+  rtcm_setbitu(buff, bit, 16, msg_eph->toe);
+  bit += 16;
+  rtcm_setbits(buff, bit, 16, msg_eph->kepler.cic);
+  bit += 16;
+  rtcm_setbits(buff, bit, 32, msg_eph->kepler.omega0);
+  bit += 32;
+  rtcm_setbits(buff, bit, 16, msg_eph->kepler.cis);
+  bit += 16;
+  rtcm_setbits(buff, bit, 32, msg_eph->kepler.inc);
+  bit += 32;
+  rtcm_setbits(buff, bit, 16, msg_eph->kepler.crc);
+  bit += 16;
+  rtcm_setbits(buff, bit, 32, msg_eph->kepler.w);
+  bit += 32;
+  rtcm_setbits(buff, bit, 24, msg_eph->kepler.omegadot);
+  bit += 24;
+  rtcm_setbits(buff, bit, 14, msg_eph->kepler.inc_dot);
+  bit += 14;
+  rtcm_setbitu(buff, bit, 2, msg_eph->kepler.codeL2);
+  bit += 2;
+  rtcm_setbitu(buff, bit, 10, msg_eph->wn);
+  bit += 10;
+  rtcm_setbitu(buff, bit, 4, msg_eph->ura);
+  bit += 4;
+  rtcm_setbitu(buff, bit, 6, msg_eph->health_bits);
+  bit += 6;
+  rtcm_setbits(buff, bit, 8, msg_eph->kepler.tgd_gps_s);
+  bit += 8;
+  rtcm_setbitu(buff, bit, 10, msg_eph->kepler.iodc);
+  bit += 10;
+  rtcm_setbitu(buff, bit, 1, msg_eph->fit_interval);
+  bit += 1;
+
+  /* Round number of bits up to nearest whole byte. */
+  return (bit + 7) / 8;
+}
+
+uint16_t rtcm3_encode_qzss_eph(const rtcm_msg_eph *msg_eph, uint8_t buff[]) {
+  assert(msg_eph);
+  return RTCM3_INSTRUMENT_ENCODE(
+      1044, buff, rtcm3_encode_qzss_eph_internal(msg_eph, buff));
+}
+
+static uint16_t rtcm3_encode_glo_eph_internal(const rtcm_msg_eph *msg_eph,
+                                              uint8_t buff[]) {
+  /* the decoder folds Bn, ln of string 3 and ln of string 5 into one flag */
+  uint8_t unhealthy = msg_eph->health_bits ? 1 : 0;
+
+  uint16_t bit = 0;
+  rtcm_setbitu(buff, bit, 12, 1020);
+  bit += 12;
+  rtcm_setbitu(buff, bit, 6, msg_eph->sat_id);
+  bit += 6;
+  rtcm_setbitu(buff, bit, 5, msg_eph->glo.fcn);
+  bit += 5;
+  /* alm health ind, alm health ind valid */
+  rtcm_setbitu(buff, bit, 2, 0);
+  bit += 2;
+  rtcm_setbitu(buff, bit, 2, msg_eph->fit_interval);
+  bit += 2;
+  /* tk */
+  rtcm_setbitu(buff, bit, 12, 0);
+  bit += 12;
+  /* most significant bit of Bn */
+  rtcm_setbitu(buff, bit, 1, unhealthy);
+  bit += 1;
+  /* P2, oddness of t_b */
+  rtcm_setbitu(buff, bit, 1, msg_eph->glo.t_b & 1);
+  bit += 1;
+  rtcm_setbitu(buff, bit, 7, msg_eph->glo.t_b);
+  bit += 7;
+  for (uint8_t i = 0; i < 3; i++) {
+    rtcm_set_sign_magnitude_bit(buff, bit, 24, msg_eph->glo.vel[i]);
+    bit += 24;
+    rtcm_set_sign_magnitude_bit(buff, bit, 27, msg_eph->glo.pos[i]);
+    bit += 27;
+    rtcm_set_sign_magnitude_bit(buff, bit, 5, msg_eph->glo.acc[i]);
+    bit += 5;
+  }
+  /* P3 */
+  rtcm_setbitu(buff, bit, 1, 0);
+  bit += 1;
+  rtcm_set_sign_magnitude_bit(buff, bit, 11, msg_eph->glo.gamma);
+  bit += 11;
+  /* P */
+  rtcm_setbitu(buff, bit, 2, 0);
+  bit += 2;
+  /* health flag in string 3 */
+  rtcm_setbitu(buff, bit, 1, unhealthy);
+  bit += 1;
+  rtcm_set_sign_magnitude_bit(buff, bit, 22, msg_eph->glo.tau);
+  bit += 22;
+  rtcm_set_sign_magnitude_bit(buff, bit, 5, msg_eph->glo.d_tau);
+  bit += 5;
+  /* EN, P4 */
+  rtcm_setbitu(buff, bit, 6, 0);
+  bit += 6;
+  rtcm_setbitu(buff, bit, 4, msg_eph->ura);
+  bit += 4;
+  /* NT, M */
+  rtcm_setbitu(buff, bit, 13, 0);
+  bit += 13;
+  /* the almanac parameters of strings 4 and 5 are not kept, the fields are
+   * zero and flagged as not available */
+  rtcm_setbitu(buff, bit, 1, 0);
+  bit += 1;
+  /* NA, Tc */
+  rtcm_setbitu(buff, bit, 11, 0);
+  bit += 11;
+  rtcm_setbitu(buff, bit, 32, 0);
+  bit += 32;
+  /* N4, Tgps */
+  rtcm_setbitu(buff, bit, 5, 0);
+  bit += 5;
+  rtcm_setbitu(buff, bit, 22, 0);
+  bit += 22;
+  /* health flag in string 5, reserved */
+  rtcm_setbitu(buff, bit, 8, 0);
+  bit += 8;
+
+  /* Round number of bits up to nearest whole byte. */
+  return (bit + 7) / 8;
+}
+
+uint16_t rtcm3_encode_glo_eph(const rtcm_msg_eph *msg_eph, uint8_t buff[]) {
+  assert(msg_eph);
+  return RTCM3_INSTRUMENT_ENCODE(
+      1020, buff, rtcm3_encode_glo_eph_internal(msg_eph, buff));
+}
+
+static uint16_t rtcm3_encode_bds_eph_internal(const rtcm_msg_eph *msg_eph,
+                                              uint8_t buff[]) {
+  uint16_t bit = 0;
+  rtcm_setbitu(buff, bit, 12, 1042);
+  bit += 12;
+  rtcm_setbitu(buff, bit, 6, msg_eph->sat_id);
+  bit += 6;
+  rtcm_setbitu(buff, bit, 13, msg_eph->wn);
+  bit += 13;
+  rtcm_setbitu(buff, bit, 4, msg_eph->ura);
+  bit += 4;
+  rtcm_setbits(buff, bit, 14, msg_eph->kepler.inc_dot);
+  bit += 14;
+  rtcm_setbitu(buff, bit, 5, msg_eph->kepler.iode);
+  bit += 5;
+  rtcm_setbitu(buff, bit, 17, msg_eph->kepler.toc);
+  bit += 17;
+  rtcm_setbits(buff, bit, 11, msg_eph->kepler.af2);
+  bit += 11;
+  rtcm_setbits(buff, bit, 22, msg_eph->kepler.af1);
+  bit += 22;
+  rtcm_setbits(buff, bit, 24, msg_eph->kepler.af0);
+  bit += 24;
+  rtcm_setbitu(buff, bit, 5, msg_eph->kepler.iodc);
+  bit += 5;
+  rtcm_setbits(buff, bit, 18, msg_eph->kepler.crs);
+  bit += 18;
+  rtcm_setbits(buff, bit, 16, msg_eph->kepler.dn);
+  bit += 16;
+  rtcm_setbits(buff, bit, 32, msg_eph->kepler.m0);
+  bit += 32;
+  rtcm_setbits(buff, bit, 18, msg_eph->kepler.cuc);
+  bit += 18;
+  rtcm_setbitu(buff, bit, 32, msg_eph->kepler.ecc);
+  bit += 32;
+  rtcm_setbits(buff, bit, 18, msg_eph->kepler.cus);
+  bit += 18;
+  rtcm_setbitu(buff, bit, 32, msg_eph->kepler.sqrta);
+  bit += 32;
+  rtcm_setbitu(buff, bit, 17, msg_eph->toe);
+  bit += 17;
+  rtcm_setbits(buff, bit, 18, msg_eph->kepler.cic);
+  bit += 18;
+  rtcm_setbits(buff, bit, 32, msg_eph->kepler.omega0);
+  bit += 32;
+  rtcm_setbits(buff, bit, 18, msg_eph->kepler.cis);
+  bit += 18;
+  rtcm_setbits(buff, bit, 32, msg_eph->kepler.inc);
+  bit += 32;
+  rtcm_setbits(buff, bit, 18, msg_eph->kepler.crc);
+  bit += 18;
+  rtcm_setbits(buff, bit, 32, msg_eph->kepler.w);
+  bit += 32;
+  rtcm_setbits(buff, bit, 24, msg_eph->kepler.omegadot);
+  bit += 24;
+  rtcm_setbits(buff, bit, 10, msg_eph->kepler.tgd_bds_s[0]);
+  bit += 10;
+  rtcm_setbits(buff, bit, 10, msg_eph->kepler.tgd_bds_s[1]);
+  bit += 10;
+  rtcm_setbitu(buff, bit, 1, msg_eph->health_bits);
+  bit += 1;
+
+  /* Round number of bits up to nearest whole byte. */
+  return (bit + 7) / 8;
+}
+
+uint16_t rtcm3_encode_bds_eph(const rtcm_msg_eph *msg_eph, uint8_t buff[]) {
+  assert(msg_eph);
+  return RTCM3_INSTRUMENT_ENCODE(
+      1042, buff, rtcm3_encode_bds_eph_internal(msg_eph, buff));
+}
+
+/* Ephemeris lengths in bits, the messages have no variable parts */
+#define GPS_EPH_BITS 488
+#define GAL_EPH_INAV_BITS 504
+#define GAL_EPH_FNAV_BITS 496
+#define QZSS_EPH_BITS 485
+#define GLO_EPH_BITS 360
+#define BDS_EPH_BITS 511
+
+/** Size of a GPS ephemeris as rtcm3_encode_gps_eph writes it
+ *
+ * \param msg_1019 The input RTCM message struct
+ * \return Number of bytes the encoder writes
+ */
+uint16_t rtcm3_encoded_size_gps_eph(const rtcm_msg_eph *msg_1019) {
+  assert(msg_1019);
+  return (GPS_EPH_BITS + 7) / 8;
+}
+
+uint16_t rtcm3_encoded_size_gal_eph_inav(const rtcm_msg_eph *msg_eph) {
+  assert(msg_eph);
+  return (GAL_EPH_INAV_BITS + 7) / 8;
+}
+
+uint16_t rtcm3_encoded_size_gal_eph_fnav(const rtcm_msg_eph *msg_eph) {
+  assert(msg_eph);
+  return (GAL_EPH_FNAV_BITS + 7) / 8;
+}
+
+uint16_t rtcm3_encoded_size_qzss_eph(const rtcm_msg_eph *msg_eph) {
+  assert(msg_eph);
+  return (QZSS_EPH_BITS + 7) / 8;
+}
+
+uint16_t rtcm3_encoded_size_glo_eph(const rtcm_msg_eph *msg_eph) {
+  assert(msg_eph);
+  return (GLO_EPH_BITS + 7) / 8;
+}
+
+uint16_t rtcm3_encoded_size_bds_eph(const rtcm_msg_eph *msg_eph) {
+  assert(msg_eph);
+  return (BDS_EPH_BITS + 7) / 8;
+}
@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/eph_store.h"
+#include <assert.h>
+#include <string.h>
+#include "rtcm3/bits.h"
+#include "rtcm3/eph_decode.h"
+
+#define SECONDS_PER_WEEK 604800
+#define SECONDS_PER_DAY 86400
+
+/* Per message type: constellation, width of the satellite ID, scale of the
+ * reference time to seconds, the period it wraps at and how far from it an
+ * ephemeris is still used */
+typedef struct {
+  uint16_t msg_num;
+  rtcm_constellation_t constellation;
+  uint8_t sat_id_bits;
+  uint32_t time_scale_s;
+  uint32_t period_s;
+  uint32_t max_age_s;
+  rtcm3_rc (*decode)(const uint8_t buff[], rtcm_msg_eph *msg_eph);
+} eph_type;
+
+static const eph_type eph_types[RTCM3_EPH_STORE_MSG_TYPES] = {
+    {1019,
+     RTCM_CONSTELLATION_GPS,
+     6,
+     16,
+     SECONDS_PER_WEEK,
+     2 * 3600,
+     rtcm3_decode_gps_eph},
+    /* t_b counts 15 minute intervals of the Moscow day */
+    {1020,
+     RTCM_CONSTELLATION_GLO,
+     6,
+     15 * 60,
+     SECONDS_PER_DAY,
+     30 * 60,
+     rtcm3_decode_glo_eph},
+    {1042,
+     RTCM_CONSTELLATION_BDS,
+     6,
+     8,
+     SECONDS_PER_WEEK,
+     3600,
+     rtcm3_decode_bds_eph},
+    {1044,
+     RTCM_CONSTELLATION_QZS,
+     4,
+     16,
+     SECONDS_PER_WEEK,
+     2 * 3600,
+     rtcm3_decode_qzss_eph},
+    {1045,
+     RTCM_CONSTELLATION_GAL,
+     6,
+     60,
+     SECONDS_PER_WEEK,
+     4 * 3600,
+     rtcm3_decode_gal_eph_fnav},
+    {1046,
+     RTCM_CONSTELLATION_GAL,
+     6,
+     60,
+     SECONDS_PER_WEEK,
+     4 * 3600,
+     rtcm3_decode_gal_eph},
+};
+
+static int8_t find_eph_type(uint16_t msg_num) {
+  for (uint8_t i = 0; i < RTCM3_EPH_STORE_MSG_TYPES; i++) {
+    if (eph_types[i].msg_num == msg_num) {
+      return (int8_t)i;
+    }
+  }
+  return -1;
+}
+
+/* FNV-1a */
+static uint64_t hash_payload(const uint8_t payload[], uint16_t len) {
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (uint16_t i = 0; i < len; i++) {
+    hash ^= payload[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+/* Reference time of an ephemeris in seconds of the week, or of the day for
+ * GLONASS */
+static uint32_t reference_time_s(const eph_type *type,
+                                 const rtcm_msg_eph *eph) {
+  if (RTCM_CONSTELLATION_GLO == eph->constellation) {
+    return eph->glo.t_b * type->time_scale_s;
+  }
+  return eph->toe * type->time_scale_s;
+}
+
+static bool same_issue(const eph_type *type,
+                       const rtcm_msg_eph *a,
+                       const rtcm_msg_eph *b) {
+  if (reference_time_s(type, a) != reference_time_s(type, b)) {
+    return false;
+  }
+  return RTCM_CONSTELLATION_GLO == a->constellation ||
+         a->kepler.iode == b->kepler.iode;
+}
+
+/** Empty an ephemeris store
+ *
+ * \param store The store, typically static as it holds every satellite
+ */
+void rtcm3_eph_store_init(rtcm3_eph_store *store) {
+  assert(store);
+  memset(store, 0, sizeof(*store));
+}
+
+/** Add a broadcast ephemeris message to the store
+ *
+ * The payload is hashed and compared with the issues already stored for the
+ * satellite, only a message with new content is decoded. New content with
+ * the reference time and IODE of the current issue replaces it, e.g. for a
+ * change of health, anything else becomes the current issue and the old
+ * current one is kept as the previous.
+ *
+ * \param store The store
+ * \param payload The message, without the frame header
+ * \param payload_len Length of the payload in bytes
+ * \param eph Set to the stored ephemeris on success, valid until the next
+ *            update of the store
+ * \param is_new Set to whether the content was not in the store before
+ * \return - RC_OK : Success
+ *         - RC_MESSAGE_TYPE_MISMATCH : Not an ephemeris message
+ *         - RC_INVALID_MESSAGE : Too short or too long, or as the decoder
+ *           reports
+ */
+rtcm3_rc rtcm3_eph_store_update(rtcm3_eph_store *store,
+                                const uint8_t payload[],
+                                uint16_t payload_len,
+                                const rtcm_msg_eph **eph,
+                                bool *is_new) {
+  assert(store);
+  assert(eph);
+  assert(is_new);
+  if (payload_len < 3) {
+    return RC_INVALID_MESSAGE;
+  }
+  int8_t type_index = find_eph_type((uint16_t)rtcm_getbitu(payload, 0, 12));
+  if (type_index < 0) {
+    return RC_MESSAGE_TYPE_MISMATCH;
+  }
+  if (payload_len > RTCM3_EPH_MAX_PAYLOAD_LEN) {
+    return RC_INVALID_MESSAGE;
+  }
+  const eph_type *type = &eph_types[type_index];
+  uint8_t sat_id = (uint8_t)rtcm_getbitu(payload, 12, type->sat_id_bits);
+  rtcm3_eph_slot *slot = &store->slots[type_index][sat_id];
+
+  uint64_t hash = hash_payload(payload, payload_len);
+  for (uint8_t i = 0; i < 2; i++) {
+    const rtcm3_eph_entry *entry = &slot->issues[i];
+    if (entry->valid && entry->hash == hash &&
+        entry->payload_len == payload_len &&
+        memcmp(entry->payload, payload, payload_len) == 0) {
+      store->duplicates++;
+      *eph = &entry->eph;
+      *is_new = false;
+      return RC_OK;
+    }
+  }
+
+  rtcm_msg_eph decoded;
+  rtcm3_rc ret = type->decode(payload, &decoded);
+  if (RC_OK != ret) {
+    return ret;
+  }
+  rtcm3_eph_entry *current = &slot->issues[slot->current];
+  if (!current->valid || !same_issue(type, &current->eph, &decoded)) {
+    slot->current ^= 1;
+    current = &slot->issues[slot->current];
+  }
+  current->valid = true;
+  current->payload_len = payload_len;
+  current->hash = hash;
+  memcpy(current->payload, payload, payload_len);
+  current->eph = decoded;
+  store->decoded++;
+  *eph = &current->eph;
+  *is_new = true;
+  return RC_OK;
+}
+
+/** Ephemeris of a satellite to use at a given time
+ *
+ * Of the stored issues, across the I/NAV and F/NAV messages for Galileo, the
+ * one with the reference time closest to time_s is returned, as long as it is
+ * within the validity of the constellation.
+ *
+ * \param store The store
+ * \param constellation Constellation of the satellite
+ * \param sat_id Satellite ID as in the ephemeris message
+ * \param time_s Seconds of the week in the time scale of the constellation,
+ *               for GLONASS seconds of the Moscow day
+ * \return The ephemeris or NULL if there is none valid at time_s
+ */
+const rtcm_msg_eph *rtcm3_eph_store_best(const rtcm3_eph_store *store,
+                                         rtcm_constellation_t constellation,
+                                         uint8_t sat_id,
+                                         uint32_t time_s) {
+  assert(store);
+  if (sat_id >= RTCM3_EPH_STORE_MAX_SATS) {
+    return NULL;
+  }
+  const rtcm_msg_eph *best = NULL;
+  uint32_t best_age_s = 0;
+  for (uint8_t t = 0; t < RTCM3_EPH_STORE_MSG_TYPES; t++) {
+    const eph_type *type = &eph_types[t];
+    if (type->constellation != constellation) {
+      continue;
+    }
+    for (uint8_t i = 0; i < 2; i++) {
+      const rtcm3_eph_entry *entry = &store->slots[t][sat_id].issues[i];
+      if (!entry->valid) {
+        continue;
+      }
+      uint32_t ref_s = reference_time_s(type, &entry->eph) % type->period_s;
+      uint32_t age_s =
+          (time_s % type->period_s + type->period_s - ref_s) % type->period_s;
+      if (age_s > type->period_s / 2) {
+        age_s = type->period_s - age_s;
+      }
+      if (age_s <= type->max_age_s && (NULL == best || age_s < best_age_s)) {
+        best = &entry->eph;
+        best_age_s = age_s;
+      }
+    }
+  }
+  return best;
+}
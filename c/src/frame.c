@@ -0,0 +1,383 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/frame.h"
+#include <assert.h>
+#include <string.h>
+#include "crc24q_table.h"
+#include "instrument.h"
+#include "rtcm3/bits.h"
+
+/** Calculate the Qualcomm 24-bit CRC used by RTCM v3
+ *
+ * \param buff Data to checksum
+ * \param len Number of bytes in `buff`
+ * \param crc Initial value, 0 for a new checksum or the result of a previous
+ *            call to continue it
+ * \return CRC-24Q value
+ */
+uint32_t rtcm3_crc24q(const uint8_t buff[], uint32_t len, uint32_t crc) {
+  const uint32_t(*table)[256] = crc24q_table;
+  const uint8_t *p = buff;
+  uint32_t c = crc << 8;
+  /* slicing by 8, the first 4 bytes overlap the running CRC */
+  while (len >= 8) {
+    uint32_t word = ((uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 |
+                     (uint32_t)p[2] << 8 | (uint32_t)p[3]) ^
+                    c;
+    c = table[7][word >> 24] ^ table[6][(word >> 16) & 0xFF] ^
+        table[5][(word >> 8) & 0xFF] ^ table[4][word & 0xFF] ^
+        table[3][p[4]] ^ table[2][p[5]] ^ table[1][p[6]] ^ table[0][p[7]];
+    p += 8;
+    len -= 8;
+  }
+  while (len-- > 0) {
+    c = (c << 8) ^ table[0][(c >> 24) ^ *p++];
+  }
+  return c >> 8;
+}
+
+/** Add the transport header and CRC around a payload encoded in place
+ *
+ * The payload must already be written at frame + RTCM3_FRAME_HEADER_LEN, which
+ * lets an encoder write straight into the output frame.
+ *
+ * \param frame Frame buffer, at least payload_len + RTCM3_FRAME_OVERHEAD bytes
+ * \param payload_len Length of the payload in bytes
+ * \return Length of the frame in bytes or 0 if the payload is too long
+ */
+uint16_t rtcm3_frame_finalize(uint8_t frame[], uint16_t payload_len) {
+  if (payload_len > RTCM3_MAX_PAYLOAD_LEN) {
+    return 0;
+  }
+  frame[0] = RTCM3_PREAMBLE;
+  /* 6 reserved bits followed by the 10 bit length */
+  frame[1] = (uint8_t)(payload_len >> 8);
+  frame[2] = (uint8_t)(payload_len & 0xFF);
+  uint16_t crc_pos = RTCM3_FRAME_HEADER_LEN + payload_len;
+  uint32_t crc = rtcm3_crc24q(frame, crc_pos, 0);
+  frame[crc_pos] = (uint8_t)(crc >> 16);
+  frame[crc_pos + 1] = (uint8_t)(crc >> 8);
+  frame[crc_pos + 2] = (uint8_t)crc;
+  return payload_len + RTCM3_FRAME_OVERHEAD;
+}
+
+/** Frame a payload that lives in a separate buffer
+ *
+ * \param payload The encoded message
+ * \param payload_len Length of the payload in bytes
+ * \param frame Output buffer, at least payload_len + RTCM3_FRAME_OVERHEAD
+ *              bytes
+ * \return Length of the frame in bytes or 0 if the payload is too long
+ */
+uint16_t rtcm3_frame_wrap(const uint8_t payload[],
+                          uint16_t payload_len,
+                          uint8_t frame[]) {
+  if (payload_len > RTCM3_MAX_PAYLOAD_LEN) {
+    return 0;
+  }
+  memmove(&frame[RTCM3_FRAME_HEADER_LEN], payload, payload_len);
+  return rtcm3_frame_finalize(frame, payload_len);
+}
+
+/** Build the header and CRC of a frame without copying its payload
+ *
+ * The CRC runs over the header and then continues over the payload in place.
+ * The frame on the wire is header, payload and crc in that order.
+ *
+ * \param envelope Set to the header and CRC
+ * \param payload The encoded message
+ * \param payload_len Length of the payload in bytes
+ * \return Length of the frame in bytes or 0 if the payload is too long
+ */
+uint16_t rtcm3_frame_envelope_init(rtcm3_frame_envelope *envelope,
+                                   const uint8_t payload[],
+                                   uint16_t payload_len) {
+  assert(envelope);
+  if (payload_len > RTCM3_MAX_PAYLOAD_LEN) {
+    return 0;
+  }
+  envelope->header[0] = RTCM3_PREAMBLE;
+  envelope->header[1] = (uint8_t)(payload_len >> 8);
+  envelope->header[2] = (uint8_t)(payload_len & 0xFF);
+  uint32_t crc = rtcm3_crc24q(envelope->header, RTCM3_FRAME_HEADER_LEN, 0);
+  crc = rtcm3_crc24q(payload, payload_len, crc);
+  envelope->crc[0] = (uint8_t)(crc >> 16);
+  envelope->crc[1] = (uint8_t)(crc >> 8);
+  envelope->crc[2] = (uint8_t)crc;
+  return payload_len + RTCM3_FRAME_OVERHEAD;
+}
+
+static uint16_t frame_payload_len(const uint8_t buff[]) {
+  return (uint16_t)(((buff[1] & 0x03) << 8) | buff[2]);
+}
+
+/* The 6 bits between the preamble and the length are reserved and zero,
+ * which weeds out most 0xD3 bytes inside payloads before they are taken for a
+ * frame of up to 1 kB */
+static bool frame_reserved_bits_clear(const uint8_t buff[]) {
+  return 0 == (buff[1] & 0xFC);
+}
+
+/** Check whether a valid frame starts at the beginning of a buffer
+ *
+ * \param buff Candidate frame, starting with the preamble
+ * \param len Number of bytes available from buff
+ * \return Length of the frame in bytes, or 0 if there is no preamble, the
+ *         reserved bits are set, the frame does not fit in len bytes or its
+ *         CRC does not match
+ */
+uint16_t rtcm3_frame_check(const uint8_t buff[], size_t len) {
+  if (len < RTCM3_FRAME_OVERHEAD || RTCM3_PREAMBLE != buff[0] ||
+      !frame_reserved_bits_clear(buff)) {
+    return 0;
+  }
+  uint16_t frame_len = frame_payload_len(buff) + RTCM3_FRAME_OVERHEAD;
+  if (frame_len > len) {
+    return 0;
+  }
+  /* the CRC over the whole frame, parity included, is zero */
+  if (0 != rtcm3_crc24q(buff, frame_len, 0)) {
+    RTCM3_PROBE1(crc_fail, frame_len);
+    return 0;
+  }
+  return frame_len;
+}
+
+/** Start scanning a buffer, e.g. a memory mapped archive
+ *
+ * \param scanner Scanner state
+ * \param data Buffer holding the framed stream, it is never copied
+ * \param len Length of the buffer in bytes
+ */
+void rtcm3_frame_scanner_init(rtcm3_frame_scanner *scanner,
+                              const uint8_t data[],
+                              size_t len) {
+  rtcm3_frame_scanner_init_range(scanner, data, len, 0, len);
+}
+
+/** Start scanning part of a buffer
+ *
+ * Only frames whose preamble lies in [start, end) are returned, but they may
+ * extend past end up to the end of the buffer. Adjacent ranges therefore
+ * split a stream without losing the frames across their boundaries.
+ *
+ * \param scanner Scanner state
+ * \param data Buffer holding the framed stream, it is never copied
+ * \param len Length of the buffer in bytes
+ * \param start Offset to start searching for a preamble
+ * \param end Offset to stop searching for a preamble, at most len
+ */
+void rtcm3_frame_scanner_init_range(rtcm3_frame_scanner *scanner,
+                                    const uint8_t data[],
+                                    size_t len,
+                                    size_t start,
+                                    size_t end) {
+  assert(scanner);
+  assert(start <= end && end <= len);
+  memset(scanner, 0, sizeof(*scanner));
+  scanner->data = data;
+  scanner->len = len;
+  scanner->pos = start;
+  scanner->end = end;
+}
+
+/** Find the next valid frame
+ *
+ * Bytes before a preamble, frames with a bad CRC and a truncated frame at the
+ * end of the buffer are skipped and counted. After a CRC failure the search
+ * restarts at the byte following the false preamble.
+ *
+ * \param scanner Scanner state
+ * \param frame Set to a view of the frame that was found
+ * \return true if a frame was found, false at the end of the buffer
+ */
+bool rtcm3_frame_scanner_next(rtcm3_frame_scanner *scanner,
+                              rtcm3_frame *frame) {
+  assert(scanner);
+  assert(frame);
+  while (scanner->pos < scanner->end) {
+    const uint8_t *start = &scanner->data[scanner->pos];
+    const uint8_t *preamble =
+        memchr(start, RTCM3_PREAMBLE, scanner->end - scanner->pos);
+    if (NULL == preamble) {
+      break;
+    }
+    size_t skipped = (size_t)(preamble - start);
+    scanner->skipped_bytes += skipped;
+    scanner->pos += skipped;
+    size_t remaining = scanner->len - scanner->pos;
+
+    uint16_t frame_len = 0;
+    if (remaining >= RTCM3_FRAME_OVERHEAD &&
+        frame_reserved_bits_clear(preamble) &&
+        (size_t)frame_payload_len(preamble) + RTCM3_FRAME_OVERHEAD <=
+            remaining) {
+      frame_len = rtcm3_frame_check(preamble, remaining);
+      if (0 == frame_len) {
+        scanner->num_crc_errors++;
+      }
+    }
+    /* a false preamble, or one whose frame would run past the end of the
+     * buffer, real frames may still follow it */
+    if (0 == frame_len) {
+      scanner->skipped_bytes++;
+      scanner->pos++;
+      continue;
+    }
+
+    frame->payload = &preamble[RTCM3_FRAME_HEADER_LEN];
+    frame->payload_len = frame_len - RTCM3_FRAME_OVERHEAD;
+    frame->msg_num = frame->payload_len >= 2
+                         ? (uint16_t)rtcm_getbitu(frame->payload, 0, 12)
+                         : 0;
+    frame->offset = scanner->pos;
+    RTCM3_PROBE3(frame_accept,
+                 frame->msg_num,
+                 rtcm_getbitu(frame->payload, 12, 12),
+                 frame_len);
+    scanner->pos += frame_len;
+    scanner->num_frames++;
+    return true;
+  }
+  if (scanner->pos < scanner->end) {
+    scanner->skipped_bytes += scanner->end - scanner->pos;
+    scanner->pos = scanner->end;
+  }
+  return false;
+}
+
+/** Start reassembling a new stream
+ *
+ * \param framer Framer state
+ */
+void rtcm3_stream_framer_init(rtcm3_stream_framer *framer) {
+  assert(framer);
+  memset(framer, 0, sizeof(*framer));
+}
+
+/* Drop buffered bytes up to the first preamble at or after from */
+static void framer_resync(rtcm3_stream_framer *framer, uint16_t from) {
+  const uint8_t *next =
+      from < framer->len
+          ? memchr(&framer->buff[from], RTCM3_PREAMBLE, framer->len - from)
+          : NULL;
+  uint16_t skip = NULL == next ? framer->len : (uint16_t)(next - framer->buff);
+  memmove(framer->buff, &framer->buff[skip], framer->len - skip);
+  framer->len -= skip;
+}
+
+/** Feed received bytes until the next frame is complete
+ *
+ * Bytes are only buffered while a frame is incomplete, the search for a
+ * preamble runs over the input. After a CRC failure the bytes following the
+ * false preamble are searched again.
+ *
+ * \param framer Framer state
+ * \param data Received bytes
+ * \param len Number of received bytes
+ * \param consumed Set to the number of bytes taken from data. If a frame was
+ *                 completed the rest must be fed again.
+ * \param frame Set to the completed frame, valid until the next call. Its
+ *              offset is the position of the preamble in the stream.
+ * \return true if a frame was completed. More complete frames may be left in
+ *         the buffer, so call again, with no data if need be, until this
+ *         returns false; by then all of data has been consumed.
+ */
+bool rtcm3_stream_framer_feed(rtcm3_stream_framer *framer,
+                              const uint8_t data[],
+                              size_t len,
+                              size_t *consumed,
+                              rtcm3_frame *frame) {
+  assert(framer);
+  assert(consumed);
+  assert(frame);
+  if (framer->consumed > 0) {
+    /* anything buffered after the last frame up to a preamble is garbage */
+    uint16_t len_before = framer->len;
+    framer_resync(framer, framer->consumed);
+    framer->skipped_bytes += len_before - framer->consumed - framer->len;
+    framer->consumed = 0;
+  }
+
+  size_t pos = 0;
+  while (true) {
+    if (0 == framer->len) {
+      const uint8_t *preamble =
+          pos < len ? memchr(&data[pos], RTCM3_PREAMBLE, len - pos) : NULL;
+      if (NULL == preamble) {
+        framer->skipped_bytes += len - pos;
+        pos = len;
+        break;
+      }
+      framer->skipped_bytes += (size_t)(preamble - &data[pos]);
+      pos = (size_t)(preamble - data);
+    }
+
+    if (framer->len >= RTCM3_FRAME_HEADER_LEN &&
+        !frame_reserved_bits_clear(framer->buff)) {
+      /* not a header, don't wait for up to 1 kB behind a false preamble */
+      uint16_t len_before = framer->len;
+      framer_resync(framer, 1);
+      framer->skipped_bytes += len_before - framer->len;
+      continue;
+    }
+
+    uint16_t need = framer->len < RTCM3_FRAME_HEADER_LEN
+                        ? RTCM3_FRAME_HEADER_LEN
+                        : frame_payload_len(framer->buff) +
+                              RTCM3_FRAME_OVERHEAD;
+    if (framer->len < need) {
+      size_t n = need - framer->len;
+      if (n > len - pos) {
+        n = len - pos;
+      }
+      memcpy(&framer->buff[framer->len], &data[pos], n);
+      framer->len += (uint16_t)n;
+      pos += n;
+      if (framer->len < need) {
+        break;
+      }
+      if (RTCM3_FRAME_HEADER_LEN == need) {
+        /* the header is complete, now the length is known */
+        continue;
+      }
+    }
+
+    if (rtcm3_frame_check(framer->buff, need) > 0) {
+      frame->payload = &framer->buff[RTCM3_FRAME_HEADER_LEN];
+      frame->payload_len = need - RTCM3_FRAME_OVERHEAD;
+      frame->msg_num = frame->payload_len >= 2
+                           ? (uint16_t)rtcm_getbitu(frame->payload, 0, 12)
+                           : 0;
+      frame->offset = framer->pos + pos - framer->len;
+      RTCM3_PROBE3(frame_accept,
+                   frame->msg_num,
+                   rtcm_getbitu(frame->payload, 12, 12),
+                   need);
+      framer->consumed = need;
+      framer->num_frames++;
+      framer->pos += pos;
+      *consumed = pos;
+      return true;
+    }
+
+    /* resynchronize on the buffered bytes after the false preamble */
+    framer->num_crc_errors++;
+    uint16_t len_before = framer->len;
+    framer_resync(framer, 1);
+    framer->skipped_bytes += len_before - framer->len;
+  }
+  framer->pos += pos;
+  *consumed = pos;
+  return false;
+}
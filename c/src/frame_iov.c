@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/frame_iov.h"
+#include <assert.h>
+#include <errno.h>
+#include <limits.h>
+#include <unistd.h>
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+/** Describe a frame as header, payload and CRC for writev or sendmsg
+ *
+ * The payload is not copied, it must stay in place until the frame has been
+ * written, as must the envelope.
+ *
+ * \param payload The encoded message
+ * \param payload_len Length of the payload in bytes
+ * \param envelope Set to the header and CRC of the frame
+ * \param iov Set to RTCM3_FRAME_IOV_LEN entries covering the frame
+ * \return Length of the frame in bytes or 0 if the payload is too long
+ */
+uint16_t rtcm3_frame_iov(const uint8_t payload[],
+                         uint16_t payload_len,
+                         rtcm3_frame_envelope *envelope,
+                         struct iovec iov[]) {
+  assert(iov);
+  uint16_t frame_len =
+      rtcm3_frame_envelope_init(envelope, payload, payload_len);
+  if (0 == frame_len) {
+    return 0;
+  }
+  iov[0].iov_base = envelope->header;
+  iov[0].iov_len = RTCM3_FRAME_HEADER_LEN;
+  /* writev does not write through iov_base */
+  iov[1].iov_base = (void *)payload;
+  iov[1].iov_len = payload_len;
+  iov[2].iov_base = envelope->crc;
+  iov[2].iov_len = RTCM3_FRAME_CRC_LEN;
+  return frame_len;
+}
+
+/** Write all of a gather list, as few writev calls as the system allows
+ *
+ * Short writes are resumed and lists longer than IOV_MAX are split. The
+ * entries of iov are adjusted as they go out. A non-blocking descriptor that
+ * fills up is not waited on: EAGAIN comes back as an error like any other,
+ * with written telling how far the list got. A writev that makes no progress
+ * is reported as EIO rather than retried.
+ *
+ * \param fd Descriptor to write to
+ * \param iov Gather list, modified
+ * \param iovcnt Number of entries in iov
+ * \param written Set to the number of bytes written, may be NULL
+ * \return 0 on success or an errno value
+ */
+int rtcm3_writev_all(int fd,
+                     struct iovec iov[],
+                     size_t iovcnt,
+                     size_t *written) {
+  size_t total = 0;
+  int err = 0;
+  while (iovcnt > 0) {
+    if (0 == iov->iov_len) {
+      iov++;
+      iovcnt--;
+      continue;
+    }
+    int count = iovcnt < IOV_MAX ? (int)iovcnt : IOV_MAX;
+    ssize_t n = writev(fd, iov, count);
+    if (n < 0) {
+      if (EINTR == errno) {
+        continue;
+      }
+      err = errno;
+      break;
+    }
+    if (0 == n) {
+      /* nothing went out of a non-empty list, retrying would spin */
+      err = EIO;
+      break;
+    }
+    total += (size_t)n;
+    /* skip what went out, the first entry left may be partly written */
+    size_t left = (size_t)n;
+    while (iovcnt > 0 && left >= iov->iov_len) {
+      left -= iov->iov_len;
+      iov++;
+      iovcnt--;
+    }
+    if (left > 0) {
+      iov->iov_base = (uint8_t *)iov->iov_base + left;
+      iov->iov_len -= left;
+    }
+  }
+  if (NULL != written) {
+    *written = total;
+  }
+  return err;
+}
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/glo_fcn.h"
+#include <assert.h>
+#include "rtcm3/msm_utils.h"
+
+/** Forget all FCNs
+ *
+ * \param table The table, one per stream
+ */
+void rtcm3_glo_fcn_table_init(rtcm3_glo_fcn_table *table) {
+  assert(table);
+  for (uint8_t i = 0; i < RTCM3_GLO_FCN_MAX_SATS; i++) {
+    table->fcn[i] = MSM_GLO_FCN_UNKNOWN;
+    table->l1_wavelength_m[i] = 0;
+    table->l2_wavelength_m[i] = 0;
+  }
+}
+
+/** Set the FCN of a satellite and its wavelengths
+ *
+ * \param table The table
+ * \param sat_id Satellite ID, 1 to RTCM3_GLO_FCN_MAX_SATS
+ * \param fcn FCN in the MSM coding, 0 to MSM_GLO_MAX_FCN
+ * \return Whether the satellite ID and the FCN were in range
+ */
+bool rtcm3_glo_fcn_set(rtcm3_glo_fcn_table *table,
+                       uint8_t sat_id,
+                       uint8_t fcn) {
+  assert(table);
+  if (0 == sat_id || sat_id > RTCM3_GLO_FCN_MAX_SATS || fcn > MSM_GLO_MAX_FCN) {
+    return false;
+  }
+  uint8_t i = sat_id - 1;
+  if (table->fcn[i] != fcn) {
+    int8_t channel = (int8_t)(fcn - MSM_GLO_FCN_OFFSET);
+    table->fcn[i] = fcn;
+    table->l1_wavelength_m[i] = GPS_C / (GLO_L1_HZ + channel * GLO_L1_DELTA_HZ);
+    table->l2_wavelength_m[i] = GPS_C / (GLO_L2_HZ + channel * GLO_L2_DELTA_HZ);
+  }
+  return true;
+}
+
+/** FCN of a satellite
+ *
+ * \param table The table
+ * \param sat_id Satellite ID
+ * \return FCN in the MSM coding or MSM_GLO_FCN_UNKNOWN
+ */
+uint8_t rtcm3_glo_fcn_get(const rtcm3_glo_fcn_table *table, uint8_t sat_id) {
+  assert(table);
+  if (0 == sat_id || sat_id > RTCM3_GLO_FCN_MAX_SATS) {
+    return MSM_GLO_FCN_UNKNOWN;
+  }
+  return table->fcn[sat_id - 1];
+}
+
+/** Learn the FCN of a GLONASS ephemeris, other constellations are ignored
+ *
+ * \param table The table
+ * \param eph A decoded ephemeris
+ */
+void rtcm3_glo_fcn_from_eph(rtcm3_glo_fcn_table *table,
+                            const rtcm_msg_eph *eph) {
+  assert(eph);
+  if (RTCM_CONSTELLATION_GLO == eph->constellation) {
+    rtcm3_glo_fcn_set(table, eph->sat_id, eph->glo.fcn);
+  }
+}
+
+/** Learn the FCNs of 1010/1012 observations, other messages are ignored
+ *
+ * \param table The table
+ * \param obs A decoded observation message
+ */
+void rtcm3_glo_fcn_from_obs(rtcm3_glo_fcn_table *table,
+                            const rtcm_obs_message *obs) {
+  assert(obs);
+  if (1010 != obs->header.msg_num && 1012 != obs->header.msg_num) {
+    return;
+  }
+  for (uint8_t i = 0; i < obs->header.n_sat && i < RTCM_MAX_SATS; i++) {
+    /* DF040 has the same offset as the MSM satellite info but a wider range,
+     * channels above +6 are not in use and are skipped by the range check */
+    rtcm3_glo_fcn_set(table, obs->sats[i].svId, obs->sats[i].fcn);
+  }
+}
+
+/** Learn the FCNs of a GLONASS MSM and fill in the ones it lacks
+ *
+ * Satellites with a valid FCN, from the satellite info of MSM5/MSM7, update
+ * the table. The others, all of them in MSM4/MSM6, get the FCN of the table
+ * or MSM_GLO_FCN_UNKNOWN if it has none. Other constellations are left
+ * alone.
+ *
+ * \param table The table
+ * \param msm A decoded MSM
+ */
+void rtcm3_glo_fcn_resolve_msm(rtcm3_glo_fcn_table *table,
+                               rtcm_msm_message *msm) {
+  assert(table);
+  assert(msm);
+  if (RTCM_CONSTELLATION_GLO != to_constellation(msm->header.msg_num)) {
+    return;
+  }
+  uint8_t sat = 0;
+  for (uint8_t i = 0; i < MSM_SATELLITE_MASK_SIZE; i++) {
+    if (!msm->header.satellite_mask[i]) {
+      continue;
+    }
+    rtcm_msm_sat_data *sat_data = &msm->sats[sat++];
+    if (sat_data->glo_fcn <= MSM_GLO_MAX_FCN) {
+      rtcm3_glo_fcn_set(table, i + 1, sat_data->glo_fcn);
+    } else {
+      sat_data->glo_fcn = table->fcn[i];
+    }
+  }
+}
+
+/** Learn from or resolve the FCNs of any decoded message
+ *
+ * \param table The table
+ * \param msg A message decoded by rtcm3_decode_msg
+ */
+void rtcm3_glo_fcn_update(rtcm3_glo_fcn_table *table, rtcm3_msg *msg) {
+  assert(msg);
+  if (RTCM3_MSG_EPH == msg->kind) {
+    rtcm3_glo_fcn_from_eph(table, &msg->eph);
+  } else if (RTCM3_MSG_OBS == msg->kind) {
+    rtcm3_glo_fcn_from_obs(table, &msg->obs);
+  } else if (RTCM3_MSG_MSM == msg->kind) {
+    rtcm3_glo_fcn_resolve_msm(table, &msg->msm);
+  }
+}
+
+/** Decode any supported message and resolve its GLONASS FCNs
+ *
+ * As rtcm3_decode_msg followed by rtcm3_glo_fcn_update, with one table per
+ * stream, a GLONASS MSM4/MSM6 comes out with the FCNs learnt from the
+ * ephemerides and observations earlier on the stream.
+ *
+ * \param table The FCN table of the stream
+ * \param buff The input data buffer
+ * \param msg Set to the decoded message
+ * \return As rtcm3_decode_msg
+ */
+rtcm3_rc rtcm3_glo_fcn_decode_msg(rtcm3_glo_fcn_table *table,
+                                  const uint8_t buff[],
+                                  rtcm3_msg *msg) {
+  rtcm3_rc ret = rtcm3_decode_msg(buff, msg);
+  if (RC_OK == ret) {
+    rtcm3_glo_fcn_update(table, msg);
+  }
+  return ret;
+}
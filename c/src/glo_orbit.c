@@ -0,0 +1,204 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/glo_orbit.h"
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+
+#define SECONDS_PER_DAY 86400.0
+/* longest integration step, as recommended by the ICD */
+#define GLO_MAX_STEP_S 60.0
+
+/* PZ-90 constants, GLONASS ICD edition 5.1 */
+#define GLO_MU 3.9860044e14         /* m^3/s^2 */
+#define GLO_AE 6378136.0            /* m */
+#define GLO_J2 1.0826257e-3         /* second zonal harmonic */
+#define GLO_OMEGA_E 7.292115e-5     /* rad/s */
+
+/* time difference wrapped into +-half a day */
+static double day_diff(double t, double ref) {
+  double dt = t - ref;
+  dt -= SECONDS_PER_DAY * round(dt / SECONDS_PER_DAY);
+  return dt;
+}
+
+/* Acceleration of the equations of motion, in the rotating frame */
+static inline void glo_accel(const double p[3],
+                             const double v[3],
+                             const double acc[3],
+                             double a[3]) {
+  double r2 = p[0] * p[0] + p[1] * p[1] + p[2] * p[2];
+  double r = sqrt(r2);
+  double mu_r3 = GLO_MU / (r2 * r);
+  double j2_term = 1.5 * GLO_J2 * mu_r3 * GLO_AE * GLO_AE / r2;
+  double z2_r2 = 5 * p[2] * p[2] / r2;
+  double omega2 = GLO_OMEGA_E * GLO_OMEGA_E;
+  a[0] = (-mu_r3 - j2_term * (1 - z2_r2) + omega2) * p[0] +
+         2 * GLO_OMEGA_E * v[1] + acc[0];
+  a[1] = (-mu_r3 - j2_term * (1 - z2_r2) + omega2) * p[1] -
+         2 * GLO_OMEGA_E * v[0] + acc[1];
+  a[2] = (-mu_r3 - j2_term * (3 - z2_r2)) * p[2] + acc[2];
+}
+
+/* One Runge-Kutta step of h seconds, h may be 0 */
+static inline void glo_rk4_step(double p[3],
+                                double v[3],
+                                const double acc[3],
+                                double h) {
+  double k1p[3], k1v[3], k2p[3], k2v[3], k3p[3], k3v[3], k4p[3], k4v[3];
+  double tp[3], tv[3];
+  for (uint8_t j = 0; j < 3; j++) {
+    k1p[j] = v[j];
+  }
+  glo_accel(p, v, acc, k1v);
+  for (uint8_t j = 0; j < 3; j++) {
+    tp[j] = p[j] + 0.5 * h * k1p[j];
+    tv[j] = v[j] + 0.5 * h * k1v[j];
+    k2p[j] = tv[j];
+  }
+  glo_accel(tp, tv, acc, k2v);
+  for (uint8_t j = 0; j < 3; j++) {
+    tp[j] = p[j] + 0.5 * h * k2p[j];
+    tv[j] = v[j] + 0.5 * h * k2v[j];
+    k3p[j] = tv[j];
+  }
+  glo_accel(tp, tv, acc, k3v);
+  for (uint8_t j = 0; j < 3; j++) {
+    tp[j] = p[j] + h * k3p[j];
+    tv[j] = v[j] + h * k3v[j];
+    k4p[j] = tv[j];
+  }
+  glo_accel(tp, tv, acc, k4v);
+  for (uint8_t j = 0; j < 3; j++) {
+    p[j] += h / 6 * (k1p[j] + 2 * k2p[j] + 2 * k3p[j] + k4p[j]);
+    v[j] += h / 6 * (k1v[j] + 2 * k2v[j] + 2 * k3v[j] + k4v[j]);
+  }
+}
+
+/** Empty a set of GLONASS ephemerides
+ *
+ * \param set The set
+ */
+void rtcm3_glo_orbit_init(rtcm3_glo_orbit_set *set) {
+  assert(set);
+  set->n = 0;
+}
+
+/** Add a decoded GLONASS ephemeris to a set
+ *
+ * An ephemeris for a satellite already in the set replaces it, along with
+ * the cached integration state.
+ *
+ * \param set The set
+ * \param eph GLONASS ephemeris as decoded from message 1020
+ * \return false if the set is full or the ephemeris is not a GLONASS one
+ */
+bool rtcm3_glo_orbit_add(rtcm3_glo_orbit_set *set, const rtcm_msg_eph *eph) {
+  assert(set);
+  assert(eph);
+  if (RTCM_CONSTELLATION_GLO != eph->constellation) {
+    return false;
+  }
+  uint8_t i = 0;
+  while (i < set->n && set->sat_id[i] != eph->sat_id) {
+    i++;
+  }
+  if (i == set->n) {
+    if (set->n >= RTCM3_GLO_ORBIT_MAX_SATS) {
+      return false;
+    }
+    set->n++;
+  }
+  const ephemeris_glo_raw_rtcm_t *glo = &eph->glo;
+  set->sat_id[i] = eph->sat_id;
+  set->iode[i] = glo->t_b;
+  set->tb[i] = glo->t_b * 15 * 60.0;
+  set->tau[i] = glo->tau * 0x1p-30;
+  set->gamma[i] = glo->gamma * 0x1p-40;
+  for (uint8_t j = 0; j < 3; j++) {
+    /* km, km/s and km/s^2 in the message */
+    set->pos0[j][i] = glo->pos[j] * 0x1p-11 * 1e3;
+    set->vel0[j][i] = glo->vel[j] * 0x1p-20 * 1e3;
+    set->acc[j][i] = glo->acc[j] * 0x1p-30 * 1e3;
+    set->pos[j][i] = set->pos0[j][i];
+    set->vel[j][i] = set->vel0[j][i];
+  }
+  set->t[i] = set->tb[i];
+  return true;
+}
+
+/** Satellite states for every ephemeris of a set
+ *
+ * Each satellite is integrated from its cached state or from t_b, whichever
+ * is closer to the requested time, in equal steps of at most a minute. The
+ * result becomes the new cached state. The clock is -tau + gamma (t - t_b),
+ * clock_rate is gamma.
+ *
+ * All satellites advance together, one step at a time, with a zero step for
+ * those that have arrived, so that the loop over the satellites is branch
+ * free and vectorizes.
+ *
+ * \param set The ephemerides, the cached states are updated
+ * \param t Time of each satellite in seconds of the day in Moscow time
+ * \param states Output, the first set->n elements of each array are written
+ */
+void rtcm3_glo_orbit_compute(rtcm3_glo_orbit_set *set,
+                             const double t[],
+                             rtcm3_sat_states *states) {
+  assert(set);
+  assert(t);
+  assert(states);
+  const uint8_t count = set->n;
+  uint32_t steps[RTCM3_GLO_ORBIT_MAX_SATS];
+  double h[RTCM3_GLO_ORBIT_MAX_SATS];
+  uint32_t max_steps = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    double dt = day_diff(t[i], set->t[i]);
+    double from_tb = day_diff(t[i], set->tb[i]);
+    if (fabs(from_tb) < fabs(dt)) {
+      dt = from_tb;
+      for (uint8_t j = 0; j < 3; j++) {
+        set->pos[j][i] = set->pos0[j][i];
+        set->vel[j][i] = set->vel0[j][i];
+      }
+    }
+    steps[i] = (uint32_t)ceil(fabs(dt) / GLO_MAX_STEP_S);
+    h[i] = steps[i] > 0 ? dt / steps[i] : 0;
+    max_steps = steps[i] > max_steps ? steps[i] : max_steps;
+    set->t[i] = t[i];
+    states->clock[i] = -set->tau[i] + set->gamma[i] * from_tb;
+    states->clock_rate[i] = set->gamma[i];
+  }
+
+  for (uint32_t s = 0; s < max_steps; s++) {
+    for (uint8_t i = 0; i < count; i++) {
+      double p[3] = {set->pos[0][i], set->pos[1][i], set->pos[2][i]};
+      double v[3] = {set->vel[0][i], set->vel[1][i], set->vel[2][i]};
+      double acc[3] = {set->acc[0][i], set->acc[1][i], set->acc[2][i]};
+      glo_rk4_step(p, v, acc, s < steps[i] ? h[i] : 0);
+      for (uint8_t j = 0; j < 3; j++) {
+        set->pos[j][i] = p[j];
+        set->vel[j][i] = v[j];
+      }
+    }
+  }
+
+  for (uint8_t i = 0; i < count; i++) {
+    states->x[i] = set->pos[0][i];
+    states->y[i] = set->pos[1][i];
+    states->z[i] = set->pos[2][i];
+    states->vx[i] = set->vel[0][i];
+    states->vy[i] = set->vel[1][i];
+    states->vz[i] = set->vel[2][i];
+  }
+}
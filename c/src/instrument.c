@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "instrument.h"
+
+#ifdef LIBRTCM_ENABLE_USDT
+
+/* Probe semaphores, the tracer finds these through the .note.stapsdt entries
+ * and increments them while it is attached */
+#define RTCM3_PROBE_SEMAPHORE(TheName)                  \
+  volatile unsigned short librtcm_##TheName##_semaphore \
+      __attribute__((section(".probes"), used)) = 0
+
+RTCM3_PROBE_SEMAPHORE(decode_start);
+RTCM3_PROBE_SEMAPHORE(decode_end);
+RTCM3_PROBE_SEMAPHORE(encode_start);
+RTCM3_PROBE_SEMAPHORE(encode_end);
+RTCM3_PROBE_SEMAPHORE(frame_accept);
+RTCM3_PROBE_SEMAPHORE(crc_fail);
+
+#endif /* LIBRTCM_ENABLE_USDT */
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Private instrumentation hooks wrapped around every public decoder and
+ * encoder entry point. Without LIBRTCM_ENABLE_TIMING and LIBRTCM_ENABLE_USDT
+ * they expand to the bare call.
+ *
+ * With LIBRTCM_ENABLE_USDT the library carries systemtap style static probes
+ * under the provider "librtcm":
+ *
+ *   decode_start(msg_num, stn_id)
+ *   decode_end(msg_num, stn_id, rc)
+ *   encode_start(msg_num)
+ *   encode_end(msg_num, stn_id, len)
+ *   frame_accept(msg_num, stn_id, len)
+ *   crc_fail(len)
+ *
+ * stn_id is the 12 bit field following the message number, which is the
+ * reference station ID for the observation and station messages. Each probe
+ * is guarded by its semaphore, so the arguments are only computed while a
+ * tracer is attached, e.g.
+ *
+ *   bpftrace -e 'usdt:./librtcm.so:librtcm:decode_end { @[arg0] = count(); }'
+ */
+
+#ifndef SWIFTNAV_RTCM3_INSTRUMENT_H
+#define SWIFTNAV_RTCM3_INSTRUMENT_H
+
+#include <stdint.h>
+
+#include "rtcm3/bits.h"
+#include "rtcm3/messages.h"
+
+#ifdef LIBRTCM_ENABLE_USDT
+
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+/* incremented by the tracer when it attaches to the probe of the same name */
+extern volatile unsigned short librtcm_decode_start_semaphore;
+extern volatile unsigned short librtcm_decode_end_semaphore;
+extern volatile unsigned short librtcm_encode_start_semaphore;
+extern volatile unsigned short librtcm_encode_end_semaphore;
+extern volatile unsigned short librtcm_frame_accept_semaphore;
+extern volatile unsigned short librtcm_crc_fail_semaphore;
+
+#define RTCM3_PROBE_ENABLED(TheName) \
+  __builtin_expect(librtcm_##TheName##_semaphore != 0, 0)
+
+#define RTCM3_PROBE1(TheName, TheArg1)          \
+  do {                                          \
+    if (RTCM3_PROBE_ENABLED(TheName)) {         \
+      STAP_PROBE1(librtcm, TheName, (TheArg1)); \
+    }                                           \
+  } while (0)
+
+#define RTCM3_PROBE2(TheName, TheArg1, TheArg2)            \
+  do {                                                     \
+    if (RTCM3_PROBE_ENABLED(TheName)) {                    \
+      STAP_PROBE2(librtcm, TheName, (TheArg1), (TheArg2)); \
+    }                                                      \
+  } while (0)
+
+#define RTCM3_PROBE3(TheName, TheArg1, TheArg2, TheArg3)      \
+  do {                                                        \
+    if (RTCM3_PROBE_ENABLED(TheName)) {                       \
+      STAP_PROBE3(                                            \
+          librtcm, TheName, (TheArg1), (TheArg2), (TheArg3)); \
+    }                                                         \
+  } while (0)
+
+#else /* LIBRTCM_ENABLE_USDT */
+
+#define RTCM3_PROBE1(TheName, TheArg1) \
+  do {                                 \
+  } while (0)
+#define RTCM3_PROBE2(TheName, TheArg1, TheArg2) \
+  do {                                          \
+  } while (0)
+#define RTCM3_PROBE3(TheName, TheArg1, TheArg2, TheArg3) \
+  do {                                                   \
+  } while (0)
+
+#endif /* LIBRTCM_ENABLE_USDT */
+
+#ifdef LIBRTCM_ENABLE_TIMING
+
+#include <time.h>
+
+#include "rtcm3/timing.h"
+
+static inline uint64_t rtcm_instrument_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+#define RTCM3_TIMING_RECORD(TheOp, TheMsgNum, TheStart) \
+  rtcm_timing_record(                                   \
+      (TheOp), (TheMsgNum), rtcm_instrument_now_ns() - (TheStart))
+
+#else /* LIBRTCM_ENABLE_TIMING */
+
+static inline uint64_t rtcm_instrument_now_ns(void) { return 0; }
+
+#define RTCM3_TIMING_RECORD(TheOp, TheMsgNum, TheStart) (void)(TheStart)
+
+#endif /* LIBRTCM_ENABLE_TIMING */
+
+#if defined(LIBRTCM_ENABLE_TIMING) || defined(LIBRTCM_ENABLE_USDT)
+
+/* Instrument a decoder call, the message number and station ID are taken from
+ * the input buffer */
+#define RTCM3_INSTRUMENT_DECODE(TheBuff, TheCall)                 \
+  ({                                                              \
+    RTCM3_PROBE2(decode_start,                                    \
+                 rtcm_getbitu((TheBuff), 0, 12),                  \
+                 rtcm_getbitu((TheBuff), 12, 12));                \
+    uint64_t start_ns_ = rtcm_instrument_now_ns();                \
+    rtcm3_rc ret_ = (TheCall);                                    \
+    RTCM3_TIMING_RECORD(RTCM_TIMING_DECODE,                       \
+                        (uint16_t)rtcm_getbitu((TheBuff), 0, 12), \
+                        start_ns_);                               \
+    RTCM3_PROBE3(decode_end,                                      \
+                 rtcm_getbitu((TheBuff), 0, 12),                  \
+                 rtcm_getbitu((TheBuff), 12, 12),                 \
+                 (int)ret_);                                      \
+    ret_;                                                         \
+  })
+
+/* Instrument an encoder call, the station ID is taken from the output buffer
+ * once the message has been written */
+#define RTCM3_INSTRUMENT_ENCODE(TheMsgNum, TheBuff, TheCall)         \
+  ({                                                                 \
+    RTCM3_PROBE1(encode_start, (TheMsgNum));                         \
+    uint64_t start_ns_ = rtcm_instrument_now_ns();                   \
+    uint16_t ret_ = (TheCall);                                       \
+    RTCM3_TIMING_RECORD(RTCM_TIMING_ENCODE, (TheMsgNum), start_ns_); \
+    RTCM3_PROBE3(encode_end,                                         \
+                 (TheMsgNum),                                        \
+                 ret_ > 0 ? rtcm_getbitu((TheBuff), 12, 12) : 0,     \
+                 ret_);                                              \
+    ret_;                                                            \
+  })
+
+#else /* LIBRTCM_ENABLE_TIMING || LIBRTCM_ENABLE_USDT */
+
+#define RTCM3_INSTRUMENT_DECODE(TheBuff, TheCall) (TheCall)
+#define RTCM3_INSTRUMENT_ENCODE(TheMsgNum, TheBuff, TheCall) (TheCall)
+
+#endif /* LIBRTCM_ENABLE_TIMING || LIBRTCM_ENABLE_USDT */
+
+#endif /* SWIFTNAV_RTCM3_INSTRUMENT_H */
@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/kepler.h"
+#include <assert.h>
+#include <math.h>
+#include <string.h>
+#include "rtcm3/constants.h"
+
+#define SECONDS_PER_WEEK 604800.0
+/* Newton steps for Kepler's equation, from a second order start these reach
+ * double precision for the eccentricities of navigation satellites */
+#define KEPLER_ITERATIONS 3
+
+/* Scale factors from the raw ephemeris fields, and the constants of the
+ * reference frame, where they differ between constellations */
+typedef struct {
+  double time;
+  double harmonic_r;
+  double harmonic_angle;
+  double af0;
+  double af1;
+  double af2;
+  double mu;
+  double omega_e;
+} kepler_scales;
+
+/* IS-GPS-200, also for QZSS */
+static const kepler_scales gps_scales = {
+    16, 0x1p-5, 0x1p-29, 0x1p-31, 0x1p-43, 0x1p-55, 3.986005e14,
+    7.2921151467e-5};
+/* Galileo OS SIS ICD */
+static const kepler_scales gal_scales = {
+    60, 0x1p-5, 0x1p-29, 0x1p-34, 0x1p-46, 0x1p-59, 3.986004418e14,
+    7.2921151467e-5};
+/* BDS-SIS-ICD */
+static const kepler_scales bds_scales = {
+    8, 0x1p-6, 0x1p-31, 0x1p-33, 0x1p-50, 0x1p-66, 3.986004418e14,
+    7.292115e-5};
+
+static const kepler_scales *constellation_scales(rtcm_constellation_t cons) {
+  switch (cons) {
+    case RTCM_CONSTELLATION_GPS:
+    case RTCM_CONSTELLATION_QZS:
+      return &gps_scales;
+    case RTCM_CONSTELLATION_GAL:
+      return &gal_scales;
+    case RTCM_CONSTELLATION_BDS:
+      return &bds_scales;
+    case RTCM_CONSTELLATION_SBAS:
+    case RTCM_CONSTELLATION_GLO:
+    case RTCM_CONSTELLATION_INVALID:
+    case RTCM_CONSTELLATION_COUNT:
+    default:
+      return NULL;
+  }
+}
+
+/* cos as a shifted sin: GCC merges sin and cos of the same angle into one
+ * sincos call, which has no vector variant and keeps the loops scalar */
+static inline double cos_shifted(double x) { return sin(x + M_PI_2); }
+
+/* time difference wrapped into +-half a week */
+static double week_diff(double t, double ref) {
+  double dt = t - ref;
+  dt -= SECONDS_PER_WEEK * round(dt / SECONDS_PER_WEEK);
+  return dt;
+}
+
+/** Empty a set of Kepler ephemerides
+ *
+ * \param set The set
+ */
+void rtcm3_kepler_set_init(rtcm3_kepler_set *set) {
+  assert(set);
+  set->n = 0;
+}
+
+/** Append a decoded ephemeris to a set
+ *
+ * \param set The set
+ * \param eph Ephemeris of a GPS, Galileo, BeiDou or QZSS satellite
+ * \return false if the set is full or the ephemeris is not a Kepler one
+ */
+bool rtcm3_kepler_set_add(rtcm3_kepler_set *set, const rtcm_msg_eph *eph) {
+  assert(set);
+  assert(eph);
+  const kepler_scales *scales = constellation_scales(eph->constellation);
+  if (NULL == scales || set->n >= RTCM3_KEPLER_MAX_SATS) {
+    return false;
+  }
+  const ephemeris_kepler_raw_rtcm_t *k = &eph->kepler;
+  uint16_t i = set->n++;
+  set->sat_id[i] = eph->sat_id;
+  set->constellation[i] = eph->constellation;
+  set->iode[i] = k->iode;
+  set->toe[i] = eph->toe * scales->time;
+  set->toc[i] = k->toc * scales->time;
+  set->sqrta[i] = k->sqrta * 0x1p-19;
+  set->ecc[i] = k->ecc * 0x1p-33;
+  /* angles are broadcast in semi-circles */
+  set->m0[i] = k->m0 * 0x1p-31 * M_PI;
+  set->dn[i] = k->dn * 0x1p-43 * M_PI;
+  set->omega0[i] = k->omega0 * 0x1p-31 * M_PI;
+  set->omegadot[i] = k->omegadot * 0x1p-43 * M_PI;
+  set->w[i] = k->w * 0x1p-31 * M_PI;
+  set->inc[i] = k->inc * 0x1p-31 * M_PI;
+  set->inc_dot[i] = k->inc_dot * 0x1p-43 * M_PI;
+  set->cuc[i] = k->cuc * scales->harmonic_angle;
+  set->cus[i] = k->cus * scales->harmonic_angle;
+  set->cic[i] = k->cic * scales->harmonic_angle;
+  set->cis[i] = k->cis * scales->harmonic_angle;
+  set->crc[i] = k->crc * scales->harmonic_r;
+  set->crs[i] = k->crs * scales->harmonic_r;
+  set->af0[i] = k->af0 * scales->af0;
+  set->af1[i] = k->af1 * scales->af1;
+  set->af2[i] = k->af2 * scales->af2;
+  set->mu[i] = scales->mu;
+  set->omega_e[i] = scales->omega_e;
+  return true;
+}
+
+/** Satellite states for every ephemeris of a set
+ *
+ * Follows the user algorithm of IS-GPS-200 table 20-IV, with the constants
+ * of each constellation. BeiDou GEO satellites need a different rotation and
+ * are not supported, which matches the ephemeris decoder rejecting them.
+ *
+ * The work is done in four passes over the set, each a branch free loop over
+ * plain arrays. Built with -O3 -ffast-math against glibc, GCC vectorizes all
+ * of them, the trigonometry included, with libmvec.
+ *
+ * \param set The ephemerides
+ * \param t Time of each satellite, e.g. its signal transmission time, in
+ *          seconds of the week of its constellation
+ * \param states Output, the first set->n elements of each array are written
+ */
+void rtcm3_kepler_compute(const rtcm3_kepler_set *set,
+                          const double t[],
+                          rtcm3_sat_states *states) {
+  assert(set);
+  assert(t);
+  assert(states);
+  const uint16_t count = set->n;
+  double tk[RTCM3_KEPLER_MAX_SATS];
+  double ecc_anomaly[RTCM3_KEPLER_MAX_SATS];
+  double mean_motion[RTCM3_KEPLER_MAX_SATS];
+
+  /* Kepler's equation */
+  for (uint16_t i = 0; i < count; i++) {
+    double a = set->sqrta[i] * set->sqrta[i];
+    double e = set->ecc[i];
+    tk[i] = week_diff(t[i], set->toe[i]);
+    mean_motion[i] = sqrt(set->mu[i] / (a * a * a)) + set->dn[i];
+    double m = set->m0[i] + mean_motion[i] * tk[i];
+    double ecc = m + e * sin(m) * (1 + e * cos_shifted(m));
+    for (uint8_t k = 0; k < KEPLER_ITERATIONS; k++) {
+      ecc -= (ecc - e * sin(ecc) - m) / (1 - e * cos_shifted(ecc));
+    }
+    ecc_anomaly[i] = ecc;
+  }
+
+  /* clock, with the relativistic correction F e sqrt(A) sin(E) */
+  for (uint16_t i = 0; i < count; i++) {
+    double e = set->ecc[i];
+    double sin_e = sin(ecc_anomaly[i]);
+    double cos_e = cos_shifted(ecc_anomaly[i]);
+    double e_dot = mean_motion[i] / (1 - e * cos_e);
+    /* F = -2 sqrt(mu) / c^2 */
+    double rel_f = -2 * sqrt(set->mu[i]) / (GPS_C * GPS_C);
+    double tc = week_diff(t[i], set->toc[i]);
+    states->clock[i] = set->af0[i] + set->af1[i] * tc +
+                       set->af2[i] * tc * tc +
+                       rel_f * e * set->sqrta[i] * sin_e;
+    states->clock_rate[i] = set->af1[i] + 2 * set->af2[i] * tc +
+                            rel_f * e * set->sqrta[i] * cos_e * e_dot;
+  }
+
+  /* corrected orbit in the orbital plane */
+  double u[RTCM3_KEPLER_MAX_SATS];
+  double r[RTCM3_KEPLER_MAX_SATS];
+  double inc[RTCM3_KEPLER_MAX_SATS];
+  double u_dot[RTCM3_KEPLER_MAX_SATS];
+  double r_dot[RTCM3_KEPLER_MAX_SATS];
+  double inc_dot[RTCM3_KEPLER_MAX_SATS];
+  for (uint16_t i = 0; i < count; i++) {
+    double a = set->sqrta[i] * set->sqrta[i];
+    double e = set->ecc[i];
+    double sin_e = sin(ecc_anomaly[i]);
+    double cos_e = cos_shifted(ecc_anomaly[i]);
+    double one_minus_ecos = 1 - e * cos_e;
+    double e_dot = mean_motion[i] / one_minus_ecos;
+    double sqrt_1_e2 = sqrt(1 - e * e);
+
+    double nu = atan2(sqrt_1_e2 * sin_e, cos_e - e);
+    double nu_dot = e_dot * sqrt_1_e2 / one_minus_ecos;
+    double phi = nu + set->w[i];
+    double sin_2phi = sin(2 * phi);
+    double cos_2phi = cos_shifted(2 * phi);
+
+    u[i] = phi + set->cus[i] * sin_2phi + set->cuc[i] * cos_2phi;
+    r[i] = a * one_minus_ecos + set->crs[i] * sin_2phi +
+           set->crc[i] * cos_2phi;
+    inc[i] = set->inc[i] + set->inc_dot[i] * tk[i] +
+             set->cis[i] * sin_2phi + set->cic[i] * cos_2phi;
+    u_dot[i] = nu_dot *
+               (1 + 2 * (set->cus[i] * cos_2phi - set->cuc[i] * sin_2phi));
+    r_dot[i] = a * e * sin_e * e_dot +
+               2 * nu_dot * (set->crs[i] * cos_2phi - set->crc[i] * sin_2phi);
+    inc_dot[i] =
+        set->inc_dot[i] +
+        2 * nu_dot * (set->cis[i] * cos_2phi - set->cic[i] * sin_2phi);
+  }
+
+  /* rotation into ECEF */
+  for (uint16_t i = 0; i < count; i++) {
+    double omega_dot = set->omegadot[i] - set->omega_e[i];
+    double omega =
+        set->omega0[i] + omega_dot * tk[i] - set->omega_e[i] * set->toe[i];
+    double sin_u = sin(u[i]);
+    double cos_u = cos_shifted(u[i]);
+    double xp = r[i] * cos_u;
+    double yp = r[i] * sin_u;
+    double xp_dot = r_dot[i] * cos_u - yp * u_dot[i];
+    double yp_dot = r_dot[i] * sin_u + xp * u_dot[i];
+
+    double sin_o = sin(omega);
+    double cos_o = cos_shifted(omega);
+    double sin_i = sin(inc[i]);
+    double cos_i = cos_shifted(inc[i]);
+    double x = xp * cos_o - yp * cos_i * sin_o;
+    double y = xp * sin_o + yp * cos_i * cos_o;
+    double tmp = yp_dot * cos_i - yp * sin_i * inc_dot[i];
+    states->x[i] = x;
+    states->y[i] = y;
+    states->z[i] = yp * sin_i;
+    states->vx[i] = -omega_dot * y + xp_dot * cos_o - tmp * sin_o;
+    states->vy[i] = omega_dot * x + xp_dot * sin_o + tmp * cos_o;
+    states->vz[i] = yp_dot * sin_i + yp * cos_i * inc_dot[i];
+  }
+}
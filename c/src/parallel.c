@@ -0,0 +1,213 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/parallel.h"
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef enum { SLOT_FREE, SLOT_SCANNING, SLOT_SCANNED } slot_state;
+
+typedef struct {
+  const uint8_t *data;
+  size_t len;
+  const rtcm3_parallel_config *config;
+  size_t chunk_size;
+  size_t num_chunks;
+  unsigned num_slots;
+
+  pthread_mutex_t lock;
+  pthread_cond_t slot_freed;
+  size_t next_chunk;     /* next chunk to hand to a worker */
+  size_t next_delivery;  /* next chunk to pass to on_chunk when ordered */
+  bool delivering;       /* a worker is running on_chunk in ordered mode */
+  slot_state *slots;
+  uint64_t num_frames;
+  uint64_t frame_bytes;
+  uint64_t num_crc_errors;
+} parallel_state;
+
+/** Number of worker threads a scan with this configuration uses
+ *
+ * \param config Scan configuration
+ * \return Number of threads, at least 1
+ */
+unsigned rtcm3_parallel_num_threads(const rtcm3_parallel_config *config) {
+  assert(config);
+  if (config->num_threads > 0) {
+    return config->num_threads;
+  }
+  long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  return cpus > 0 ? (unsigned)cpus : 1;
+}
+
+static void scan_chunk(parallel_state *state, size_t chunk, unsigned slot) {
+  size_t start = chunk * state->chunk_size;
+  size_t end = state->len - start > state->chunk_size
+                   ? start + state->chunk_size
+                   : state->len;
+  rtcm3_frame_scanner scanner;
+  rtcm3_frame_scanner_init_range(
+      &scanner, state->data, state->len, start, end);
+  rtcm3_frame frame;
+  uint64_t frame_bytes = 0;
+  while (rtcm3_frame_scanner_next(&scanner, &frame)) {
+    frame_bytes += frame.payload_len + RTCM3_FRAME_OVERHEAD;
+    state->config->on_frame(&frame, slot, state->config->context);
+  }
+
+  pthread_mutex_lock(&state->lock);
+  state->num_frames += scanner.num_frames;
+  state->frame_bytes += frame_bytes;
+  state->num_crc_errors += scanner.num_crc_errors;
+  pthread_mutex_unlock(&state->lock);
+}
+
+/* Called with the lock held, returns with it held */
+static void finish_chunk(parallel_state *state, size_t chunk, unsigned slot) {
+  const rtcm3_parallel_config *config = state->config;
+  if (!config->ordered) {
+    pthread_mutex_unlock(&state->lock);
+    if (NULL != config->on_chunk) {
+      config->on_chunk(chunk, slot, config->context);
+    }
+    pthread_mutex_lock(&state->lock);
+    state->slots[slot] = SLOT_FREE;
+    pthread_cond_broadcast(&state->slot_freed);
+    return;
+  }
+
+  /* whoever finds the next chunk in line scanned delivers it, along with any
+   * chunks behind it that finished out of order in the meantime */
+  state->slots[slot] = SLOT_SCANNED;
+  if (state->delivering) {
+    return;
+  }
+  state->delivering = true;
+  while (state->next_delivery < state->num_chunks) {
+    unsigned next_slot = state->next_delivery % state->num_slots;
+    if (SLOT_SCANNED != state->slots[next_slot]) {
+      break;
+    }
+    pthread_mutex_unlock(&state->lock);
+    if (NULL != config->on_chunk) {
+      config->on_chunk(state->next_delivery, next_slot, config->context);
+    }
+    pthread_mutex_lock(&state->lock);
+    state->slots[next_slot] = SLOT_FREE;
+    state->next_delivery++;
+    pthread_cond_broadcast(&state->slot_freed);
+  }
+  state->delivering = false;
+}
+
+static void *worker(void *arg) {
+  parallel_state *state = arg;
+  pthread_mutex_lock(&state->lock);
+  while (state->next_chunk < state->num_chunks) {
+    size_t chunk = state->next_chunk;
+    unsigned slot = chunk % state->num_slots;
+    /* the slot still holds the chunk num_slots before this one */
+    if (SLOT_FREE != state->slots[slot]) {
+      pthread_cond_wait(&state->slot_freed, &state->lock);
+      continue;
+    }
+    state->slots[slot] = SLOT_SCANNING;
+    state->next_chunk++;
+    pthread_mutex_unlock(&state->lock);
+
+    scan_chunk(state, chunk, slot);
+
+    pthread_mutex_lock(&state->lock);
+    finish_chunk(state, chunk, slot);
+  }
+  pthread_mutex_unlock(&state->lock);
+  return NULL;
+}
+
+/** Scan a buffer for frames on a pool of worker threads
+ *
+ * Each chunk is scanned as with rtcm3_frame_scanner_init_range, so every
+ * frame is passed to on_frame exactly once and the frames of a chunk arrive
+ * in file order. A false preamble inside the frame that straddles a chunk
+ * boundary is only accepted if its CRC happens to match (1 in 2^24), the
+ * same risk as after any corruption in a sequential scan. Rejected ones do
+ * show up in num_crc_errors, which can therefore exceed the sequential count.
+ *
+ * The callbacks run on the workers. on_frame typically decodes into per slot
+ * storage, which on_chunk then hands on, e.g. to an in order writer when
+ * config->ordered is set. At most RTCM3_PARALLEL_NUM_SLOTS(num_threads)
+ * chunks are in flight, which bounds that storage.
+ *
+ * \param data Buffer holding the framed stream
+ * \param len Length of the buffer in bytes
+ * \param config Scan configuration, on_frame is required
+ * \param stats Set to the scan totals, may be NULL
+ * \return 0 on success or ENOMEM
+ */
+int rtcm3_parallel_scan(const uint8_t data[],
+                        size_t len,
+                        const rtcm3_parallel_config *config,
+                        rtcm3_parallel_stats *stats) {
+  assert(config);
+  assert(config->on_frame);
+
+  parallel_state state;
+  memset(&state, 0, sizeof(state));
+  state.data = data;
+  state.len = len;
+  state.config = config;
+  state.chunk_size = config->chunk_size > 0 ? config->chunk_size
+                                            : RTCM3_PARALLEL_DEFAULT_CHUNK_SIZE;
+  state.num_chunks = (len + state.chunk_size - 1) / state.chunk_size;
+  unsigned num_threads = rtcm3_parallel_num_threads(config);
+  state.num_slots = RTCM3_PARALLEL_NUM_SLOTS(num_threads);
+  state.slots = calloc(state.num_slots, sizeof(*state.slots));
+  pthread_t *threads = calloc(num_threads, sizeof(*threads));
+  if (NULL == state.slots || NULL == threads) {
+    free(state.slots);
+    free(threads);
+    return ENOMEM;
+  }
+  pthread_mutex_init(&state.lock, NULL);
+  pthread_cond_init(&state.slot_freed, NULL);
+
+  /* the calling thread is one of the workers, so the scan completes even if
+   * no extra thread can be started */
+  unsigned started = 0;
+  for (; started + 1 < num_threads; started++) {
+    if (0 != pthread_create(&threads[started], NULL, worker, &state)) {
+      break;
+    }
+  }
+  worker(&state);
+  for (unsigned i = 0; i < started; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  if (NULL != stats) {
+    stats->num_frames = state.num_frames;
+    stats->num_crc_errors = state.num_crc_errors;
+    stats->skipped_bytes = len - state.frame_bytes;
+    stats->num_chunks = state.num_chunks;
+    stats->num_threads = started + 1;
+  }
+
+  pthread_cond_destroy(&state.slot_freed);
+  pthread_mutex_destroy(&state.lock);
+  free(threads);
+  free(state.slots);
+  return 0;
+}
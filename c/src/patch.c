@@ -0,0 +1,236 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/patch.h"
+#include <assert.h>
+#include "rtcm3/bits.h"
+#include "rtcm3/frame.h"
+#include "rtcm3/msm_utils.h"
+
+/* x^(8 * 2^k) mod the CRC-24Q polynomial, to move a CRC over runs of zero
+ * bytes in O(log n) */
+static const uint32_t crc24q_zero_bytes_powers[] = {0x000100,
+                                                    0x010000,
+                                                    0x668F48,
+                                                    0x36EB3D,
+                                                    0x6243DA,
+                                                    0xCB800E,
+                                                    0x7DB43E,
+                                                    0xDEF23C,
+                                                    0x3D145A,
+                                                    0xC5BF56};
+
+/* a * b mod the CRC-24Q polynomial */
+static uint32_t crc24q_mulmod(uint32_t a, uint32_t b) {
+  uint32_t r = 0;
+  for (int i = 23; i >= 0; i--) {
+    r <<= 1;
+    if (r & 0x1000000) {
+      r ^= 0x1864CFB;
+    }
+    if ((b >> i) & 1) {
+      r ^= a;
+    }
+  }
+  return r;
+}
+
+/* The CRC of data followed by len zero bytes, from the CRC of data */
+static uint32_t crc24q_append_zeros(uint32_t crc, uint16_t len) {
+  for (uint8_t k = 0; len > 0; k++, len >>= 1) {
+    assert(k < sizeof(crc24q_zero_bytes_powers) / sizeof(uint32_t));
+    if (len & 1) {
+      crc = crc24q_mulmod(crc, crc24q_zero_bytes_powers[k]);
+    }
+  }
+  return crc;
+}
+
+/* Bits of the SSR epoch time, 0 if msg_num is no SSR message */
+static uint8_t ssr_epoch_bits(uint16_t msg_num) {
+  bool ssr = (msg_num >= 1057 && msg_num <= 1068) ||
+             (msg_num >= 1240 && msg_num <= 1251) ||
+             (msg_num >= 1258 && msg_num <= 1263) ||
+             (msg_num >= 1265 && msg_num <= 1270);
+  if (!ssr) {
+    return 0;
+  }
+  switch (to_constellation(msg_num)) {
+    case RTCM_CONSTELLATION_GLO:
+      return 17;
+    case RTCM_CONSTELLATION_GPS:
+    case RTCM_CONSTELLATION_GAL:
+    case RTCM_CONSTELLATION_QZS:
+    case RTCM_CONSTELLATION_BDS:
+    case RTCM_CONSTELLATION_SBAS:
+      return 20;
+    case RTCM_CONSTELLATION_INVALID:
+    case RTCM_CONSTELLATION_COUNT:
+    default:
+      return 0;
+  }
+}
+
+/* Orbit and combined orbit and clock corrections carry the satellite
+ * reference datum bit before the IOD SSR */
+static bool ssr_has_ref_datum(uint16_t msg_num) {
+  static const uint16_t orbit_msgs[] = {1057, 1063, 1240, 1246, 1258};
+  for (uint8_t i = 0; i < sizeof(orbit_msgs) / sizeof(orbit_msgs[0]); i++) {
+    if (msg_num == orbit_msgs[i] || msg_num == orbit_msgs[i] + 3) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static bool has_stn_id(uint16_t msg_num) {
+  return (msg_num >= 1001 && msg_num <= 1012) || msg_num == 1029 ||
+         msg_num == 1033 || msg_num == 1230 ||
+         MSM_UNKNOWN != to_msm_type(msg_num);
+}
+
+static bool set_location(rtcm3_field_location *location,
+                         uint16_t bit,
+                         uint8_t len) {
+  location->bit = bit;
+  location->len = len;
+  return true;
+}
+
+/** Find where a header field sits in the payload of a message type
+ *
+ * \param msg_num RTCM message number
+ * \param field Field to look for
+ * \param location Set to the bit offset and length of the field
+ * \return true if the message type has the field
+ */
+bool rtcm3_field_locate(uint16_t msg_num,
+                        rtcm3_field field,
+                        rtcm3_field_location *location) {
+  assert(location);
+  bool msm = MSM_UNKNOWN != to_msm_type(msg_num);
+  uint8_t epoch_bits = ssr_epoch_bits(msg_num);
+  /* the SSR header up to the IOD SSR */
+  uint16_t ssr_iods_bit =
+      12 + epoch_bits + 4 + 1 + (ssr_has_ref_datum(msg_num) ? 1 : 0);
+  switch (field) {
+    case RTCM3_FIELD_STN_ID:
+      return has_stn_id(msg_num) && set_location(location, 12, 12);
+    case RTCM3_FIELD_EPOCH:
+      if ((msg_num >= 1001 && msg_num <= 1004) || msm) {
+        /* GLONASS MSM hold the day of week and time of day in these bits */
+        return set_location(location, 24, 30);
+      }
+      if (msg_num >= 1009 && msg_num <= 1012) {
+        return set_location(location, 24, 27);
+      }
+      return epoch_bits > 0 && set_location(location, 12, epoch_bits);
+    case RTCM3_FIELD_IODS:
+      if (msm) {
+        return set_location(location, 55, 3);
+      }
+      return epoch_bits > 0 && set_location(location, ssr_iods_bit, 4);
+    case RTCM3_FIELD_SSR_PROVIDER_ID:
+      return epoch_bits > 0 && set_location(location, ssr_iods_bit + 4, 16);
+    case RTCM3_FIELD_SSR_SOLUTION_ID:
+      return epoch_bits > 0 && set_location(location, ssr_iods_bit + 20, 4);
+    case RTCM3_FIELD_COUNT:
+    default:
+      return false;
+  }
+}
+
+/* Locate a field in a frame, false if the frame is too short to hold it */
+static bool locate_in_frame(const uint8_t frame[],
+                            rtcm3_field field,
+                            rtcm3_field_location *location,
+                            uint16_t *payload_len) {
+  if (RTCM3_PREAMBLE != frame[0]) {
+    return false;
+  }
+  *payload_len = (uint16_t)(((frame[1] & 0x03) << 8) | frame[2]);
+  if (*payload_len < 2) {
+    return false;
+  }
+  const uint8_t *payload = &frame[RTCM3_FRAME_HEADER_LEN];
+  uint16_t msg_num = (uint16_t)rtcm_getbitu(payload, 0, 12);
+  return rtcm3_field_locate(msg_num, field, location) &&
+         location->bit + location->len <= *payload_len * 8u;
+}
+
+/** Read a header field of a framed message
+ *
+ * \param frame Frame, starting with the preamble
+ * \param field Field to read
+ * \param value Set to the raw value of the field
+ * \return true if the message has the field
+ */
+bool rtcm3_frame_get_field(const uint8_t frame[],
+                           rtcm3_field field,
+                           uint32_t *value) {
+  assert(frame);
+  assert(value);
+  rtcm3_field_location location;
+  uint16_t payload_len;
+  if (!locate_in_frame(frame, field, &location, &payload_len)) {
+    return false;
+  }
+  *value = rtcm_getbitu(
+      &frame[RTCM3_FRAME_HEADER_LEN], location.bit, location.len);
+  return true;
+}
+
+/** Overwrite a header field of a framed message in place
+ *
+ * The CRC is updated from the changed bytes alone: CRC-24Q is linear, so the
+ * CRC of the difference between old and new payload, moved past the bytes
+ * that follow it, is the difference between old and new CRC. The cost does
+ * not depend on the length of the message. A frame whose CRC was wrong
+ * before is still wrong afterwards, so patching never validates a corrupt
+ * frame.
+ *
+ * \param frame Frame, starting with the preamble
+ * \param field Field to write
+ * \param value Raw value of the field as transmitted
+ * \return true if the field was written, false if the message has no such
+ *         field or the value does not fit, in which case the frame is left
+ *         as it was
+ */
+bool rtcm3_frame_set_field(uint8_t frame[], rtcm3_field field, uint32_t value) {
+  assert(frame);
+  rtcm3_field_location location;
+  uint16_t payload_len;
+  if (!locate_in_frame(frame, field, &location, &payload_len) ||
+      (location.len < 32 && value >> location.len != 0)) {
+    return false;
+  }
+
+  uint8_t *payload = &frame[RTCM3_FRAME_HEADER_LEN];
+  uint16_t first = location.bit / 8;
+  uint16_t last = (location.bit + location.len - 1) / 8;
+  uint8_t delta[5];
+  for (uint16_t i = first; i <= last; i++) {
+    delta[i - first] = payload[i];
+  }
+  rtcm_setbitu(payload, location.bit, location.len, value);
+  for (uint16_t i = first; i <= last; i++) {
+    delta[i - first] ^= payload[i];
+  }
+
+  uint32_t crc_delta = rtcm3_crc24q(delta, last - first + 1u, 0);
+  crc_delta = crc24q_append_zeros(crc_delta, payload_len - last - 1);
+  uint8_t *crc = &payload[payload_len];
+  crc[0] ^= (uint8_t)(crc_delta >> 16);
+  crc[1] ^= (uint8_t)(crc_delta >> 8);
+  crc[2] ^= (uint8_t)crc_delta;
+  return true;
+}
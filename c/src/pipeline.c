@@ -0,0 +1,380 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/pipeline.h"
+#include <assert.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "rtcm3/ring.h"
+
+/* idle workers spin, then yield, then sleep */
+#define PIPELINE_SPIN_POLLS 16
+#define PIPELINE_YIELD_POLLS 64
+#define PIPELINE_IDLE_SLEEP_NS 100000
+
+typedef struct {
+  /* the decoders may read a few bytes past the payload, like the CRC of a
+   * frame in a receive buffer */
+  uint8_t payload[RTCM3_MAX_PAYLOAD_LEN + RTCM3_FRAME_CRC_LEN];
+  uint16_t payload_len;
+  uint64_t offset;
+  uint32_t ready; /* sequence number + 1 once decoded */
+  rtcm3_rc rc;
+  rtcm3_msg msg;
+} pipeline_slot;
+
+typedef struct {
+  /* producer side, only touched by the thread pushing the stream */
+  rtcm3_stream_framer framer;
+  uint32_t next_seq;
+  pipeline_slot *slots;
+  /* reorder side */
+  uint32_t delivered; /* frames passed to the sink */
+  int delivering;     /* a worker is running the sink for this stream */
+  /* metrics */
+  uint64_t frames_in;
+  uint64_t decode_errors;
+  uint64_t crc_errors;
+  uint64_t skipped_bytes;
+  uint64_t backpressure;
+} pipeline_stream;
+
+typedef struct {
+  uint16_t stream;
+  uint32_t seq;
+} pipeline_job;
+
+struct rtcm3_pipeline {
+  rtcm3_pipeline_config config;
+  uint32_t window;
+  pipeline_stream *streams;
+  rtcm3_mpmc_queue queue;
+  void *queue_buffer;
+  pthread_t *threads;
+  unsigned num_workers;
+  int stop;
+  uint64_t jobs_decoded;
+  uint64_t idle_polls;
+};
+
+static void idle_wait(unsigned polls) {
+  if (polls < PIPELINE_SPIN_POLLS) {
+    return;
+  }
+  if (polls < PIPELINE_YIELD_POLLS) {
+    sched_yield();
+    return;
+  }
+  struct timespec ts = {0, PIPELINE_IDLE_SLEEP_NS};
+  nanosleep(&ts, NULL);
+}
+
+static pipeline_slot *stream_slot(const rtcm3_pipeline *pipeline,
+                                  const pipeline_stream *stream,
+                                  uint32_t seq) {
+  return &stream->slots[seq & (pipeline->window - 1)];
+}
+
+/* Pass every decoded frame that is next in line on to the sink. Whichever
+ * worker finds the stream's delivering flag clear does this for all. */
+static void deliver(rtcm3_pipeline *pipeline, uint16_t stream_id) {
+  pipeline_stream *stream = &pipeline->streams[stream_id];
+  while (!__atomic_exchange_n(&stream->delivering, 1, __ATOMIC_SEQ_CST)) {
+    uint32_t next = __atomic_load_n(&stream->delivered, __ATOMIC_RELAXED);
+    pipeline_slot *slot = stream_slot(pipeline, stream, next);
+    while (__atomic_load_n(&slot->ready, __ATOMIC_ACQUIRE) == next + 1) {
+      rtcm3_frame frame;
+      frame.payload = slot->payload;
+      frame.payload_len = slot->payload_len;
+      frame.msg_num = slot->msg.msg_num;
+      frame.offset = slot->offset;
+      pipeline->config.sink(
+          stream_id, &frame, &slot->msg, slot->rc, pipeline->config.context);
+      if (RC_OK != slot->rc) {
+        __atomic_fetch_add(&stream->decode_errors, 1, __ATOMIC_RELAXED);
+      }
+      /* hands the slot back to the producer */
+      next++;
+      __atomic_store_n(&stream->delivered, next, __ATOMIC_RELEASE);
+      slot = stream_slot(pipeline, stream, next);
+    }
+    __atomic_store_n(&stream->delivering, 0, __ATOMIC_SEQ_CST);
+    /* a frame finished while we held the flag, its worker left it to us */
+    if (__atomic_load_n(&slot->ready, __ATOMIC_SEQ_CST) != next + 1) {
+      return;
+    }
+  }
+}
+
+static void *worker(void *arg) {
+  rtcm3_pipeline *pipeline = arg;
+  unsigned idle = 0;
+  while (true) {
+    pipeline_job job;
+    if (rtcm3_mpmc_pop(&pipeline->queue, &job)) {
+      pipeline_stream *stream = &pipeline->streams[job.stream];
+      pipeline_slot *slot = stream_slot(pipeline, stream, job.seq);
+      slot->rc = rtcm3_decode_msg(slot->payload, &slot->msg);
+      __atomic_store_n(&slot->ready, job.seq + 1, __ATOMIC_SEQ_CST);
+      deliver(pipeline, job.stream);
+      __atomic_fetch_add(&pipeline->jobs_decoded, 1, __ATOMIC_RELAXED);
+      idle = 0;
+      continue;
+    }
+    /* only stop once the queue is drained */
+    if (__atomic_load_n(&pipeline->stop, __ATOMIC_ACQUIRE)) {
+      break;
+    }
+    __atomic_fetch_add(&pipeline->idle_polls, 1, __ATOMIC_RELAXED);
+    idle_wait(idle++);
+  }
+  return NULL;
+}
+
+static uint32_t round_up_power_of_two(uint32_t n) {
+  uint32_t power = 1;
+  while (power < n) {
+    power <<= 1;
+  }
+  return power;
+}
+
+/** Start a pipeline and its worker threads
+ *
+ * \param config Pipeline configuration, sink and num_streams are required
+ * \return The pipeline, or NULL if the configuration is invalid, including
+ *         num_streams * window above RTCM3_PIPELINE_MAX_JOBS, or memory or
+ *         threads ran out
+ */
+rtcm3_pipeline *rtcm3_pipeline_create(const rtcm3_pipeline_config *config) {
+  assert(config);
+  uint32_t window =
+      config->window > 0 ? config->window : RTCM3_PIPELINE_DEFAULT_WINDOW;
+  if (NULL == config->sink || 0 == config->num_streams ||
+      0 != (window & (window - 1)) ||
+      (uint64_t)config->num_streams * window > RTCM3_PIPELINE_MAX_JOBS) {
+    return NULL;
+  }
+
+  rtcm3_pipeline *pipeline = calloc(1, sizeof(*pipeline));
+  if (NULL == pipeline) {
+    return NULL;
+  }
+  pipeline->config = *config;
+  pipeline->window = window;
+  pipeline->num_workers = config->num_workers;
+  if (0 == pipeline->num_workers) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    pipeline->num_workers = cpus > 0 ? (unsigned)cpus : 1;
+  }
+
+  /* room for every frame of every window, so a push never finds it full */
+  uint32_t capacity = round_up_power_of_two(config->num_streams * window);
+  pipeline->queue_buffer =
+      malloc(rtcm3_mpmc_buffer_size(sizeof(pipeline_job), capacity));
+  pipeline->streams = calloc(config->num_streams, sizeof(pipeline_stream));
+  pipeline->threads = calloc(pipeline->num_workers, sizeof(pthread_t));
+  bool ok = NULL != pipeline->queue_buffer && NULL != pipeline->streams &&
+            NULL != pipeline->threads;
+  for (uint16_t i = 0; ok && i < config->num_streams; i++) {
+    pipeline_stream *stream = &pipeline->streams[i];
+    rtcm3_stream_framer_init(&stream->framer);
+    stream->slots = calloc(window, sizeof(pipeline_slot));
+    ok = NULL != stream->slots;
+  }
+  if (!ok) {
+    pipeline->num_workers = 0;
+    rtcm3_pipeline_destroy(pipeline);
+    return NULL;
+  }
+  rtcm3_mpmc_init(
+      &pipeline->queue, pipeline->queue_buffer, sizeof(pipeline_job), capacity);
+
+  for (unsigned i = 0; i < pipeline->num_workers; i++) {
+    if (0 != pthread_create(&pipeline->threads[i], NULL, worker, pipeline)) {
+      pipeline->num_workers = i;
+      rtcm3_pipeline_destroy(pipeline);
+      return NULL;
+    }
+  }
+  return pipeline;
+}
+
+/* Frame as much of data as the stream's window allows, blocked is set if it
+ * filled up */
+static size_t push_stream(rtcm3_pipeline *pipeline,
+                          uint16_t stream_id,
+                          const uint8_t data[],
+                          size_t len,
+                          bool *blocked) {
+  pipeline_stream *stream = &pipeline->streams[stream_id];
+  size_t taken = 0;
+  *blocked = false;
+  while (true) {
+    uint32_t delivered = __atomic_load_n(&stream->delivered, __ATOMIC_ACQUIRE);
+    if (stream->next_seq - delivered >= pipeline->window) {
+      *blocked = true;
+      break;
+    }
+    size_t consumed;
+    rtcm3_frame frame;
+    bool found = rtcm3_stream_framer_feed(
+        &stream->framer, &data[taken], len - taken, &consumed, &frame);
+    taken += consumed;
+    if (!found) {
+      break;
+    }
+
+    pipeline_slot *slot = stream_slot(pipeline, stream, stream->next_seq);
+    memcpy(slot->payload, frame.payload, frame.payload_len);
+    memset(&slot->payload[frame.payload_len], 0, RTCM3_FRAME_CRC_LEN);
+    slot->payload_len = frame.payload_len;
+    slot->offset = frame.offset;
+    pipeline_job job = {stream_id, stream->next_seq};
+    while (!rtcm3_mpmc_push(&pipeline->queue, &job)) {
+      sched_yield();
+    }
+    stream->next_seq++;
+    __atomic_fetch_add(&stream->frames_in, 1, __ATOMIC_RELAXED);
+  }
+
+  __atomic_store_n(
+      &stream->crc_errors, stream->framer.num_crc_errors, __ATOMIC_RELAXED);
+  __atomic_store_n(
+      &stream->skipped_bytes, stream->framer.skipped_bytes, __ATOMIC_RELAXED);
+  return taken;
+}
+
+/** Frame received bytes of a stream and queue the frames for decoding
+ *
+ * Only one thread at a time may push a given stream, different streams may
+ * be pushed concurrently.
+ *
+ * \param pipeline Pipeline
+ * \param stream_id Stream the bytes were received on
+ * \param data Received bytes
+ * \param len Number of received bytes
+ * \return Number of bytes taken, less than len if the stream's window is
+ *         full. The rest must be pushed again later.
+ */
+size_t rtcm3_pipeline_push(rtcm3_pipeline *pipeline,
+                           uint16_t stream_id,
+                           const uint8_t data[],
+                           size_t len) {
+  assert(pipeline);
+  assert(stream_id < pipeline->config.num_streams);
+  bool blocked;
+  size_t taken = push_stream(pipeline, stream_id, data, len, &blocked);
+  if (blocked) {
+    __atomic_fetch_add(
+        &pipeline->streams[stream_id].backpressure, 1, __ATOMIC_RELAXED);
+  }
+  return taken;
+}
+
+/** Wait until every frame pushed on a stream has been passed to the sink
+ *
+ * Frames still buffered in the framer, because the window was full when
+ * their bytes were pushed, are queued first.
+ *
+ * \param pipeline Pipeline
+ * \param stream_id Stream to wait for, pushed by the calling thread
+ */
+void rtcm3_pipeline_flush(rtcm3_pipeline *pipeline, uint16_t stream_id) {
+  assert(pipeline);
+  assert(stream_id < pipeline->config.num_streams);
+  pipeline_stream *stream = &pipeline->streams[stream_id];
+  const uint8_t none[1] = {0};
+  unsigned polls = 0;
+  bool blocked;
+  do {
+    push_stream(pipeline, stream_id, none, 0, &blocked);
+    idle_wait(polls++);
+  } while (blocked);
+  while (__atomic_load_n(&stream->delivered, __ATOMIC_ACQUIRE) !=
+         stream->next_seq) {
+    idle_wait(polls++);
+  }
+}
+
+/** Read the pool wide metrics
+ *
+ * \param pipeline Pipeline
+ * \param metrics Set to a snapshot of the metrics
+ */
+void rtcm3_pipeline_get_metrics(const rtcm3_pipeline *pipeline,
+                                rtcm3_pipeline_metrics *metrics) {
+  assert(pipeline);
+  assert(metrics);
+  metrics->queue_depth = rtcm3_mpmc_size(&pipeline->queue);
+  metrics->queue_capacity = pipeline->queue.mask + 1;
+  metrics->jobs_decoded =
+      __atomic_load_n(&pipeline->jobs_decoded, __ATOMIC_RELAXED);
+  metrics->idle_polls =
+      __atomic_load_n(&pipeline->idle_polls, __ATOMIC_RELAXED);
+  metrics->num_workers = pipeline->num_workers;
+}
+
+/** Read the metrics of one stream, from any thread
+ *
+ * \param pipeline Pipeline
+ * \param stream_id Stream
+ * \param metrics Set to a snapshot of the metrics
+ */
+void rtcm3_pipeline_get_stream_metrics(const rtcm3_pipeline *pipeline,
+                                       uint16_t stream_id,
+                                       rtcm3_pipeline_stream_metrics *metrics) {
+  assert(pipeline);
+  assert(stream_id < pipeline->config.num_streams);
+  assert(metrics);
+  const pipeline_stream *stream = &pipeline->streams[stream_id];
+  metrics->frames_in = __atomic_load_n(&stream->frames_in, __ATOMIC_RELAXED);
+  metrics->frames_out = __atomic_load_n(&stream->delivered, __ATOMIC_RELAXED);
+  metrics->decode_errors =
+      __atomic_load_n(&stream->decode_errors, __ATOMIC_RELAXED);
+  metrics->crc_errors = __atomic_load_n(&stream->crc_errors, __ATOMIC_RELAXED);
+  metrics->skipped_bytes =
+      __atomic_load_n(&stream->skipped_bytes, __ATOMIC_RELAXED);
+  metrics->backpressure =
+      __atomic_load_n(&stream->backpressure, __ATOMIC_RELAXED);
+  metrics->in_flight =
+      (uint32_t)metrics->frames_in - (uint32_t)metrics->frames_out;
+}
+
+/** Decode everything still queued, stop the workers and free the pipeline
+ *
+ * No push may be in progress or follow.
+ *
+ * \param pipeline Pipeline, may be NULL
+ */
+void rtcm3_pipeline_destroy(rtcm3_pipeline *pipeline) {
+  if (NULL == pipeline) {
+    return;
+  }
+  __atomic_store_n(&pipeline->stop, 1, __ATOMIC_RELEASE);
+  for (unsigned i = 0; i < pipeline->num_workers; i++) {
+    pthread_join(pipeline->threads[i], NULL);
+  }
+  if (NULL != pipeline->streams) {
+    for (uint16_t i = 0; i < pipeline->config.num_streams; i++) {
+      free(pipeline->streams[i].slots);
+    }
+  }
+  free(pipeline->streams);
+  free(pipeline->threads);
+  free(pipeline->queue_buffer);
+  free(pipeline);
+}
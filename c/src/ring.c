@@ -0,0 +1,143 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/ring.h"
+#include <assert.h>
+#include <string.h>
+
+/* sequence number at the start of every MPMC cell, the element follows */
+#define MPMC_SEQ_SIZE 8
+
+static bool is_power_of_two(uint32_t n) { return n > 0 && 0 == (n & (n - 1)); }
+
+static size_t mpmc_cell_size(size_t elem_size) {
+  return (MPMC_SEQ_SIZE + elem_size + MPMC_SEQ_SIZE - 1) &
+         ~(size_t)(MPMC_SEQ_SIZE - 1);
+}
+
+static uint32_t *mpmc_seq(const rtcm3_mpmc_queue *queue, uint32_t pos) {
+  uint8_t *cell = &queue->cells[(pos & queue->mask) * queue->cell_size];
+  return (uint32_t *)(void *)cell;
+}
+
+/** Bytes of storage an MPMC queue needs
+ *
+ * \param elem_size Size of one element in bytes
+ * \param capacity Number of elements
+ * \return Buffer size in bytes
+ */
+size_t rtcm3_mpmc_buffer_size(size_t elem_size, uint32_t capacity) {
+  return mpmc_cell_size(elem_size) * capacity;
+}
+
+/** Set up a multi producer, multi consumer queue
+ *
+ * \param queue Queue state
+ * \param buffer Storage of rtcm3_mpmc_buffer_size bytes, 8 byte aligned
+ * \param elem_size Size of one element in bytes
+ * \param capacity Number of elements, a power of two
+ * \return false if capacity is not a power of two
+ */
+bool rtcm3_mpmc_init(rtcm3_mpmc_queue *queue,
+                     void *buffer,
+                     size_t elem_size,
+                     uint32_t capacity) {
+  assert(queue);
+  if (!is_power_of_two(capacity)) {
+    return false;
+  }
+  memset(queue, 0, sizeof(*queue));
+  queue->cells = buffer;
+  queue->elem_size = elem_size;
+  queue->cell_size = mpmc_cell_size(elem_size);
+  queue->mask = capacity - 1;
+  for (uint32_t i = 0; i < capacity; i++) {
+    *mpmc_seq(queue, i) = i;
+  }
+  return true;
+}
+
+/** Copy an element in, from any thread
+ *
+ * \param queue Queue state
+ * \param elem Element of elem_size bytes
+ * \return false if the queue is full
+ */
+bool rtcm3_mpmc_push(rtcm3_mpmc_queue *queue, const void *elem) {
+  uint32_t pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+  while (true) {
+    uint32_t *seq = mpmc_seq(queue, pos);
+    int32_t diff = (int32_t)(__atomic_load_n(seq, __ATOMIC_ACQUIRE) - pos);
+    if (0 == diff) {
+      /* the cell is free for this lap, try to claim it */
+      if (__atomic_compare_exchange_n(&queue->enqueue_pos,
+                                      &pos,
+                                      pos + 1,
+                                      true,
+                                      __ATOMIC_RELAXED,
+                                      __ATOMIC_RELAXED)) {
+        memcpy((uint8_t *)seq + MPMC_SEQ_SIZE, elem, queue->elem_size);
+        __atomic_store_n(seq, pos + 1, __ATOMIC_RELEASE);
+        return true;
+      }
+    } else if (diff < 0) {
+      /* the consumer of the previous lap has not freed the cell */
+      return false;
+    } else {
+      pos = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+/** Copy the oldest element out, from any thread
+ *
+ * \param queue Queue state
+ * \param elem Set to the element
+ * \return false if the queue is empty
+ */
+bool rtcm3_mpmc_pop(rtcm3_mpmc_queue *queue, void *elem) {
+  uint32_t pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_RELAXED);
+  while (true) {
+    uint32_t *seq = mpmc_seq(queue, pos);
+    int32_t diff =
+        (int32_t)(__atomic_load_n(seq, __ATOMIC_ACQUIRE) - (pos + 1));
+    if (0 == diff) {
+      if (__atomic_compare_exchange_n(&queue->dequeue_pos,
+                                      &pos,
+                                      pos + 1,
+                                      true,
+                                      __ATOMIC_RELAXED,
+                                      __ATOMIC_RELAXED)) {
+        memcpy(elem, (uint8_t *)seq + MPMC_SEQ_SIZE, queue->elem_size);
+        /* free the cell for the producers of the next lap */
+        __atomic_store_n(seq, pos + queue->mask + 1, __ATOMIC_RELEASE);
+        return true;
+      }
+    } else if (diff < 0) {
+      return false;
+    } else {
+      pos = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_RELAXED);
+    }
+  }
+}
+
+/** Approximate number of elements in the queue
+ *
+ * \param queue Queue state
+ * \return Number of elements, exact when no push or pop is in progress
+ */
+uint32_t rtcm3_mpmc_size(const rtcm3_mpmc_queue *queue) {
+  uint32_t dequeue = __atomic_load_n(&queue->dequeue_pos, __ATOMIC_ACQUIRE);
+  uint32_t enqueue = __atomic_load_n(&queue->enqueue_pos, __ATOMIC_ACQUIRE);
+  int32_t size = (int32_t)(enqueue - dequeue);
+  return size > 0 ? (uint32_t)size : 0;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/sbp_tunnel.h"
+#include <assert.h>
+#include <string.h>
+#include "rtcm3/decode.h"
+
+/** Validate a 4062 frame and point at its SBP payload
+ *
+ * The frame is expected from rtcm3_frame_scanner_next or
+ * rtcm3_stream_framer_feed, which have checked the CRC. On success `sbp->data`
+ * points into the frame's payload and is valid for as long as that is.
+ *
+ * \param frame A frame with a valid CRC
+ * \param sbp Set to the SBP header fields and payload
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : Not a 4062 frame
+ *          - RC_INVALID_MESSAGE : Nonzero reserved bits or an SBP length that
+ *                                 does not match the frame
+ */
+rtcm3_rc rtcm3_sbp_unwrap(const rtcm3_frame *frame,
+                          rtcm_msg_swift_proprietary_view *sbp) {
+  assert(frame);
+  assert(sbp);
+  if (4062 != frame->msg_num) {
+    return RC_MESSAGE_TYPE_MISMATCH;
+  }
+  if (frame->payload_len < RTCM3_4062_HEADER_LEN) {
+    return RC_INVALID_MESSAGE;
+  }
+  rtcm3_rc ret = rtcm3_decode_4062_view(frame->payload, sbp);
+  if (RC_OK != ret) {
+    return ret;
+  }
+  /* the encoder pads nothing, so anything else is a truncated or corrupted
+   * SBP message */
+  if (RTCM3_4062_HEADER_LEN + sbp->len != frame->payload_len) {
+    return RC_INVALID_MESSAGE;
+  }
+  return RC_OK;
+}
+
+/** Wrap an SBP payload into a 4062 frame
+ *
+ * The payload is copied once, straight to its place in the frame. It may
+ * already sit at frame + RTCM3_FRAME_HEADER_LEN + RTCM3_4062_HEADER_LEN, in
+ * which case it is not moved at all.
+ *
+ * \param sbp SBP header fields and payload
+ * \param frame Output buffer, at least sbp->len + RTCM3_FRAME_OVERHEAD +
+ *              RTCM3_4062_HEADER_LEN bytes
+ * \return Length of the frame in bytes
+ */
+uint16_t rtcm3_sbp_wrap(const rtcm_msg_swift_proprietary_view *sbp,
+                        uint8_t frame[]) {
+  assert(sbp);
+  assert(sbp->data || 0 == sbp->len);
+  uint8_t *payload = &frame[RTCM3_FRAME_HEADER_LEN];
+  if (sbp->len > 0) {
+    memmove(&payload[RTCM3_4062_HEADER_LEN], sbp->data, sbp->len);
+  }
+  /* 12 bit message number and 4 reserved bits, which are 0 */
+  payload[0] = (uint8_t)(4062 >> 4);
+  payload[1] = (uint8_t)((4062 & 0xF) << 4);
+  payload[2] = (uint8_t)(sbp->msg_type >> 8);
+  payload[3] = (uint8_t)sbp->msg_type;
+  payload[4] = (uint8_t)(sbp->sender_id >> 8);
+  payload[5] = (uint8_t)sbp->sender_id;
+  payload[6] = sbp->len;
+  return rtcm3_frame_finalize(frame, RTCM3_4062_HEADER_LEN + sbp->len);
+}
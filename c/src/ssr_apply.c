@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/ssr_apply.h"
+#include <assert.h>
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include "rtcm3/constants.h"
+
+#define SECONDS_PER_WEEK 604800
+#define SECONDS_PER_DAY 86400
+
+/* Look one satellite up and store its corrections in SI units, or zeros if
+ * there is none for the IODE of the ephemeris */
+static bool gather_sat(rtcm3_ssr_batch *batch,
+                       uint16_t i,
+                       const rtcm3_ssr_store *store,
+                       rtcm_constellation_t constellation,
+                       uint8_t sat_id,
+                       uint16_t iode,
+                       uint32_t time_s) {
+  rtcm3_ssr_corrections corr;
+  bool found =
+      RTCM_CONSTELLATION_BDS != constellation &&
+      rtcm3_ssr_store_lookup(store, constellation, sat_id, 0, time_s, &corr) &&
+      corr.orbit->iode == iode;
+  batch->corrected[i] = found;
+  batch->period[i] = RTCM_CONSTELLATION_GLO == constellation
+                         ? SECONDS_PER_DAY
+                         : SECONDS_PER_WEEK;
+  if (!found) {
+    batch->orbit_time[i] = 0;
+    batch->radial[i] = 0;
+    batch->along_track[i] = 0;
+    batch->cross_track[i] = 0;
+    batch->dot_radial[i] = 0;
+    batch->dot_along_track[i] = 0;
+    batch->dot_cross_track[i] = 0;
+    batch->clock_time[i] = 0;
+    batch->c0[i] = 0;
+    batch->c1[i] = 0;
+    batch->c2[i] = 0;
+    return false;
+  }
+  const rtcm_msg_ssr_orbit_corr *orbit = corr.orbit;
+  const rtcm_msg_ssr_clock_corr *clock = corr.clock;
+  batch->orbit_time[i] = corr.orbit_epoch_time;
+  batch->radial[i] = orbit->radial * 1e-4;
+  batch->along_track[i] = orbit->along_track * 4e-4;
+  batch->cross_track[i] = orbit->cross_track * 4e-4;
+  batch->dot_radial[i] = orbit->dot_radial * 1e-6;
+  batch->dot_along_track[i] = orbit->dot_along_track * 4e-6;
+  batch->dot_cross_track[i] = orbit->dot_cross_track * 4e-6;
+  batch->clock_time[i] = corr.clock_epoch_time;
+  batch->c0[i] = clock->c0 * 1e-4;
+  if (NULL != corr.high_rate_clock) {
+    batch->c0[i] += *corr.high_rate_clock * 1e-4;
+  }
+  batch->c1[i] = clock->c1 * 1e-6;
+  batch->c2[i] = clock->c2 * 2e-8;
+  return true;
+}
+
+/** Gather the SSR corrections of every satellite of a Kepler set
+ *
+ * Each satellite is looked up once, the corrections are taken if their IODE
+ * matches the one of the ephemeris.
+ *
+ * \param batch Output, lined up with the satellites of the set
+ * \param store The SSR store
+ * \param set The ephemerides
+ * \param time_s Time of the lookup in seconds of the week
+ * \return Number of satellites with corrections
+ */
+uint16_t rtcm3_ssr_batch_kepler(rtcm3_ssr_batch *batch,
+                                const rtcm3_ssr_store *store,
+                                const rtcm3_kepler_set *set,
+                                uint32_t time_s) {
+  assert(batch);
+  assert(store);
+  assert(set);
+  batch->n = set->n;
+  batch->num_corrected = 0;
+  for (uint16_t i = 0; i < set->n; i++) {
+    batch->num_corrected += gather_sat(batch,
+                                       i,
+                                       store,
+                                       set->constellation[i],
+                                       set->sat_id[i],
+                                       set->iode[i],
+                                       time_s);
+  }
+  return batch->num_corrected;
+}
+
+/** Gather the SSR corrections of every satellite of a GLONASS set
+ *
+ * \param batch Output, lined up with the satellites of the set
+ * \param store The SSR store
+ * \param set The ephemerides
+ * \param time_s Time of the lookup in seconds of the GLONASS day
+ * \return Number of satellites with corrections
+ */
+uint16_t rtcm3_ssr_batch_glo(rtcm3_ssr_batch *batch,
+                             const rtcm3_ssr_store *store,
+                             const rtcm3_glo_orbit_set *set,
+                             uint32_t time_s) {
+  assert(batch);
+  assert(store);
+  assert(set);
+  batch->n = set->n;
+  batch->num_corrected = 0;
+  for (uint8_t i = 0; i < set->n; i++) {
+    batch->num_corrected += gather_sat(batch,
+                                       i,
+                                       store,
+                                       RTCM_CONSTELLATION_GLO,
+                                       set->sat_id[i],
+                                       set->iode[i],
+                                       time_s);
+  }
+  return batch->num_corrected;
+}
+
+/* difference of two times of the week or day, across the rollover */
+static inline double period_diff(double t, double t0, double period) {
+  double dt = t - t0;
+  return dt - period * rint(dt / period);
+}
+
+/** Apply gathered corrections to the broadcast states of a set
+ *
+ * Each satellite costs the same straight line code, satellites without
+ * corrections are run with zeros. The work is done in three branch free
+ * passes over the arrays, few enough for the compiler to vectorize each of
+ * them behind a runtime aliasing check.
+ *
+ * \param batch Corrections gathered for the set the states belong to
+ * \param t Time of each satellite, as passed to the orbit computation
+ * \param broadcast States computed from the broadcast ephemerides
+ * \param precise Output, the first batch->n elements of each array are
+ *                written. May be the same as broadcast.
+ */
+void rtcm3_ssr_batch_apply(const rtcm3_ssr_batch *batch,
+                           const double t[],
+                           const rtcm3_sat_states *broadcast,
+                           rtcm3_sat_states *precise) {
+  assert(batch);
+  assert(t);
+  assert(broadcast);
+  assert(precise);
+  const uint16_t count = batch->n;
+  const rtcm3_sat_states *b = broadcast;
+  /* unit vectors of the radial, along track and cross track directions */
+  double e_r[3][RTCM3_KEPLER_MAX_SATS];
+  double e_a[3][RTCM3_KEPLER_MAX_SATS];
+  double e_c[3][RTCM3_KEPLER_MAX_SATS];
+
+  /* along track along the velocity, cross track along r x v */
+  for (uint16_t i = 0; i < count; i++) {
+    double x = b->x[i], y = b->y[i], z = b->z[i];
+    double vx = b->vx[i], vy = b->vy[i], vz = b->vz[i];
+    double inv_v = 1 / sqrt(fmax(vx * vx + vy * vy + vz * vz, DBL_MIN));
+    double ax = vx * inv_v, ay = vy * inv_v, az = vz * inv_v;
+    double cx = y * vz - z * vy;
+    double cy = z * vx - x * vz;
+    double cz = x * vy - y * vx;
+    double inv_c = 1 / sqrt(fmax(cx * cx + cy * cy + cz * cz, DBL_MIN));
+    cx *= inv_c;
+    cy *= inv_c;
+    cz *= inv_c;
+    e_a[0][i] = ax;
+    e_a[1][i] = ay;
+    e_a[2][i] = az;
+    e_c[0][i] = cx;
+    e_c[1][i] = cy;
+    e_c[2][i] = cz;
+    e_r[0][i] = ay * cz - az * cy;
+    e_r[1][i] = az * cx - ax * cz;
+    e_r[2][i] = ax * cy - ay * cx;
+  }
+
+  /* orbit, subtracted from the broadcast one */
+  for (uint16_t i = 0; i < count; i++) {
+    double dt = period_diff(t[i], batch->orbit_time[i], batch->period[i]);
+    double dr_dot = batch->dot_radial[i];
+    double da_dot = batch->dot_along_track[i];
+    double dc_dot = batch->dot_cross_track[i];
+    double dr = batch->radial[i] + dr_dot * dt;
+    double da = batch->along_track[i] + da_dot * dt;
+    double dc = batch->cross_track[i] + dc_dot * dt;
+    precise->x[i] =
+        b->x[i] - (e_r[0][i] * dr + e_a[0][i] * da + e_c[0][i] * dc);
+    precise->y[i] =
+        b->y[i] - (e_r[1][i] * dr + e_a[1][i] * da + e_c[1][i] * dc);
+    precise->z[i] =
+        b->z[i] - (e_r[2][i] * dr + e_a[2][i] * da + e_c[2][i] * dc);
+    precise->vx[i] = b->vx[i] - (e_r[0][i] * dr_dot + e_a[0][i] * da_dot +
+                                 e_c[0][i] * dc_dot);
+    precise->vy[i] = b->vy[i] - (e_r[1][i] * dr_dot + e_a[1][i] * da_dot +
+                                 e_c[1][i] * dc_dot);
+    precise->vz[i] = b->vz[i] - (e_r[2][i] * dr_dot + e_a[2][i] * da_dot +
+                                 e_c[2][i] * dc_dot);
+  }
+
+  /* clock, added to the broadcast one */
+  for (uint16_t i = 0; i < count; i++) {
+    double dt = period_diff(t[i], batch->clock_time[i], batch->period[i]);
+    double c1 = batch->c1[i], c2 = batch->c2[i];
+    precise->clock[i] =
+        b->clock[i] + (batch->c0[i] + c1 * dt + c2 * dt * dt) / GPS_C;
+    precise->clock_rate[i] = b->clock_rate[i] + (c1 + 2 * c2 * dt) / GPS_C;
+  }
+}
@@ -13,8 +13,11 @@
 #include "rtcm3/ssr_decode.h"
 #include <assert.h>
 #include <stdio.h>
+#include <string.h>
 #include "rtcm3/bits.h"
 #include "rtcm3/msm_utils.h"
+#include "instrument.h"
+#include "ssr_fields.h"
 
 /** Get the numbers of bits for the  Epoch Time 1s field
  * \param constellation Message constellation
@@ -140,6 +143,16 @@ bool is_ssr_phase_biases_message(const uint16_t message_num) {
   return message_num >= 1265 && message_num <= 1270;
 }
 
+bool is_ssr_ura_message(const uint16_t message_num) {
+  return message_num == 1061 || message_num == 1067 || message_num == 1244 ||
+         message_num == 1250 || message_num == 1262;
+}
+
+bool is_ssr_hr_clock_message(const uint16_t message_num) {
+  return message_num == 1062 || message_num == 1068 || message_num == 1245 ||
+         message_num == 1251 || message_num == 1263;
+}
+
 enum rtcm3_rc_e decode_ssr_header(const uint8_t buff[],
                                   uint16_t *bit,
                                   rtcm_msg_ssr_header *msg_header) {
@@ -227,6 +240,30 @@ static void decode_ssr_clock(const uint8_t buff[],
   *bit += 27;
 }
 
+static void decode_code_bias_sig(const uint8_t buff[],
+                                 uint16_t *bit,
+                                 rtcm_msg_ssr_code_bias_sig *sig) {
+  sig->signal_id = rtcm_getbitu(buff, *bit, 5);
+  *bit += 5;
+  sig->code_bias = rtcm_getbits(buff, *bit, 14);
+  *bit += 14;
+}
+
+static void decode_phase_bias_sig(const uint8_t buff[],
+                                  uint16_t *bit,
+                                  rtcm_msg_ssr_phase_bias_sig *sig) {
+  sig->signal_id = rtcm_getbitu(buff, *bit, 5);
+  *bit += 5;
+  sig->integer_indicator = rtcm_getbitu(buff, *bit, 1);
+  *bit += 1;
+  sig->widelane_indicator = rtcm_getbitu(buff, *bit, 2);
+  *bit += 2;
+  sig->discontinuity_indicator = rtcm_getbitu(buff, *bit, 4);
+  *bit += 4;
+  sig->phase_bias = rtcm_getbits(buff, *bit, 20);
+  *bit += 20;
+}
+
 static rtcm3_rc decode_satellite_id(const uint8_t buff[],
                                     uint16_t *bit,
                                     uint8_t constellation,
@@ -243,8 +280,8 @@ static rtcm3_rc decode_satellite_id(const uint8_t buff[],
   return RC_OK;
 }
 
-rtcm3_rc rtcm3_decode_orbit(const uint8_t buff[], rtcm_msg_orbit *msg_orbit) {
-  assert(msg_orbit);
+static rtcm3_rc rtcm3_decode_orbit_internal(const uint8_t buff[],
+                                            rtcm_msg_orbit *msg_orbit) {
   uint16_t bit = 0;
   if (!(RC_OK == decode_ssr_header(buff, &bit, &msg_orbit->header))) {
     return RC_INVALID_MESSAGE;
@@ -273,8 +310,14 @@ rtcm3_rc rtcm3_decode_orbit(const uint8_t buff[], rtcm_msg_orbit *msg_orbit) {
   return RC_OK;
 }
 
-rtcm3_rc rtcm3_decode_clock(const uint8_t buff[], rtcm_msg_clock *msg_clock) {
-  assert(msg_clock);
+rtcm3_rc rtcm3_decode_orbit(const uint8_t buff[], rtcm_msg_orbit *msg_orbit) {
+  assert(msg_orbit);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_orbit_internal(buff, msg_orbit));
+}
+
+static rtcm3_rc rtcm3_decode_clock_internal(const uint8_t buff[],
+                                            rtcm_msg_clock *msg_clock) {
   uint16_t bit = 0;
   if (!(RC_OK == decode_ssr_header(buff, &bit, &msg_clock->header))) {
     return RC_INVALID_MESSAGE;
@@ -299,17 +342,14 @@ rtcm3_rc rtcm3_decode_clock(const uint8_t buff[], rtcm_msg_clock *msg_clock) {
   return RC_OK;
 }
 
-/** Decode an RTCMv3 Combined SSR Orbit and Clock message
- *
- * \param buff The input data buffer
- * \param RTCM message struct
- * \return  - RC_OK : Success
- *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
- *          - RC_INVALID_MESSAGE : Unknown constellation
- */
-rtcm3_rc rtcm3_decode_orbit_clock(const uint8_t buff[],
-                                  rtcm_msg_orbit_clock *msg_orbit_clock) {
-  assert(msg_orbit_clock);
+rtcm3_rc rtcm3_decode_clock(const uint8_t buff[], rtcm_msg_clock *msg_clock) {
+  assert(msg_clock);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_clock_internal(buff, msg_clock));
+}
+
+static rtcm3_rc rtcm3_decode_orbit_clock_internal(
+    const uint8_t buff[], rtcm_msg_orbit_clock *msg_orbit_clock) {
   uint16_t bit = 0;
   if (!(RC_OK == decode_ssr_header(buff, &bit, &msg_orbit_clock->header))) {
     return RC_INVALID_MESSAGE;
@@ -344,7 +384,7 @@ rtcm3_rc rtcm3_decode_orbit_clock(const uint8_t buff[],
   return RC_OK;
 }
 
-/** Decode an RTCMv3 Code bias message
+/** Decode an RTCMv3 Combined SSR Orbit and Clock message
  *
  * \param buff The input data buffer
  * \param RTCM message struct
@@ -352,9 +392,15 @@ rtcm3_rc rtcm3_decode_orbit_clock(const uint8_t buff[],
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
  *          - RC_INVALID_MESSAGE : Unknown constellation
  */
-rtcm3_rc rtcm3_decode_code_bias(const uint8_t buff[],
-                                rtcm_msg_code_bias *msg_code_bias) {
-  assert(msg_code_bias);
+rtcm3_rc rtcm3_decode_orbit_clock(const uint8_t buff[],
+                                  rtcm_msg_orbit_clock *msg_orbit_clock) {
+  assert(msg_orbit_clock);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_orbit_clock_internal(buff, msg_orbit_clock));
+}
+
+static rtcm3_rc rtcm3_decode_code_bias_internal(
+    const uint8_t buff[], rtcm_msg_code_bias *msg_code_bias) {
   uint16_t bit = 0;
   if (!(RC_OK == decode_ssr_header(buff, &bit, &msg_code_bias->header))) {
     return RC_INVALID_MESSAGE;
@@ -381,16 +427,13 @@ rtcm3_rc rtcm3_decode_code_bias(const uint8_t buff[],
     bit += 5;
 
     for (int j = 0; j < sat->num_code_biases; j++) {
-      sat->signals[j].signal_id = rtcm_getbitu(buff, bit, 5);
-      bit += 5;
-      sat->signals[j].code_bias = rtcm_getbits(buff, bit, 14);
-      bit += 14;
+      decode_code_bias_sig(buff, &bit, &sat->signals[j]);
     }
   }
   return RC_OK;
 }
 
-/** Decode an RTCMv3 Phase bias message
+/** Decode an RTCMv3 Code bias message
  *
  * \param buff The input data buffer
  * \param RTCM message struct
@@ -398,9 +441,15 @@ rtcm3_rc rtcm3_decode_code_bias(const uint8_t buff[],
  *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
  *          - RC_INVALID_MESSAGE : Unknown constellation
  */
-rtcm3_rc rtcm3_decode_phase_bias(const uint8_t buff[],
-                                 rtcm_msg_phase_bias *msg_phase_bias) {
-  assert(msg_phase_bias);
+rtcm3_rc rtcm3_decode_code_bias(const uint8_t buff[],
+                                rtcm_msg_code_bias *msg_code_bias) {
+  assert(msg_code_bias);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_code_bias_internal(buff, msg_code_bias));
+}
+
+static rtcm3_rc rtcm3_decode_phase_bias_internal(
+    const uint8_t buff[], rtcm_msg_phase_bias *msg_phase_bias) {
   uint16_t bit = 0;
   if (!(RC_OK == decode_ssr_header(buff, &bit, &msg_phase_bias->header))) {
     return RC_INVALID_MESSAGE;
@@ -431,17 +480,238 @@ rtcm3_rc rtcm3_decode_phase_bias(const uint8_t buff[],
     bit += 8;
 
     for (int j = 0; j < sat->num_phase_biases; j++) {
-      sat->signals[j].signal_id = rtcm_getbitu(buff, bit, 5);
-      bit += 5;
-      sat->signals[j].integer_indicator = rtcm_getbitu(buff, bit, 1);
-      bit += 1;
-      sat->signals[j].widelane_indicator = rtcm_getbitu(buff, bit, 2);
-      bit += 2;
-      sat->signals[j].discontinuity_indicator = rtcm_getbitu(buff, bit, 4);
-      bit += 4;
-      sat->signals[j].phase_bias = rtcm_getbits(buff, bit, 20);
-      bit += 20;
+      decode_phase_bias_sig(buff, &bit, &sat->signals[j]);
     }
   }
   return RC_OK;
 }
+
+/** Decode an RTCMv3 Phase bias message
+ *
+ * \param buff The input data buffer
+ * \param RTCM message struct
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
+ *          - RC_INVALID_MESSAGE : Unknown constellation
+ */
+rtcm3_rc rtcm3_decode_phase_bias(const uint8_t buff[],
+                                 rtcm_msg_phase_bias *msg_phase_bias) {
+  assert(msg_phase_bias);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_phase_bias_internal(buff, msg_phase_bias));
+}
+
+static rtcm3_rc rtcm3_decode_ssr_visit_internal(
+    const uint8_t buff[], const rtcm3_ssr_visitor *visitor, void *ctx) {
+  uint16_t msg_num = rtcm_getbitu(buff, 0, 12);
+  /* is_ssr_orbit_clock_message covers the orbit messages as well */
+  bool combined =
+      is_ssr_orbit_clock_message(msg_num) && !is_ssr_orbit_message(msg_num);
+  bool has_orbit = combined || is_ssr_orbit_message(msg_num);
+  bool has_clock = combined || is_ssr_clock_message(msg_num);
+  bool code_bias = is_ssr_code_biases_message(msg_num);
+  bool phase_bias = is_ssr_phase_biases_message(msg_num);
+  if (!(has_orbit || has_clock || code_bias || phase_bias)) {
+    return RC_MESSAGE_TYPE_MISMATCH;
+  }
+
+  uint16_t bit = 0;
+  rtcm_msg_ssr_header header;
+  memset(&header, 0, sizeof(header));
+  if (!(RC_OK == decode_ssr_header(buff, &bit, &header))) {
+    return RC_INVALID_MESSAGE;
+  }
+  if (NULL != visitor->header && !visitor->header(ctx, &header)) {
+    return RC_OK;
+  }
+
+  for (uint8_t i = 0; i < header.num_sats; i++) {
+    uint8_t sat_id;
+    if (!(RC_OK ==
+          decode_satellite_id(buff, &bit, header.constellation, &sat_id))) {
+      return RC_INVALID_MESSAGE;
+    }
+
+    if (has_orbit || has_clock) {
+      rtcm_msg_ssr_orbit_corr orbit;
+      rtcm_msg_ssr_clock_corr clock;
+      memset(&orbit, 0, sizeof(orbit));
+      memset(&clock, 0, sizeof(clock));
+      orbit.sat_id = sat_id;
+      clock.sat_id = sat_id;
+      if (has_orbit) {
+        if (!(RC_OK ==
+              decode_ssr_orbit(buff, &bit, header.constellation, &orbit))) {
+          return RC_INVALID_MESSAGE;
+        }
+        if (NULL != visitor->orbit) {
+          visitor->orbit(ctx, &orbit);
+        }
+      }
+      if (has_clock) {
+        decode_ssr_clock(buff, &bit, &clock);
+        if (NULL != visitor->clock) {
+          visitor->clock(ctx, &clock);
+        }
+      }
+      continue;
+    }
+
+    rtcm3_ssr_bias_sat sat;
+    memset(&sat, 0, sizeof(sat));
+    sat.sat_id = sat_id;
+    sat.num_biases = rtcm_getbitu(buff, bit, 5);
+    bit += 5;
+    if (phase_bias) {
+      sat.yaw_angle = rtcm_getbitu(buff, bit, 9);
+      bit += 9;
+      sat.yaw_rate = rtcm_getbits(buff, bit, 8);
+      bit += 8;
+    }
+    if (NULL != visitor->bias_sat) {
+      visitor->bias_sat(ctx, &sat);
+    }
+    for (uint8_t j = 0; j < sat.num_biases; j++) {
+      if (code_bias) {
+        rtcm_msg_ssr_code_bias_sig sig;
+        decode_code_bias_sig(buff, &bit, &sig);
+        if (NULL != visitor->code_bias) {
+          visitor->code_bias(ctx, sat_id, &sig);
+        }
+      } else {
+        rtcm_msg_ssr_phase_bias_sig sig;
+        decode_phase_bias_sig(buff, &bit, &sig);
+        if (NULL != visitor->phase_bias) {
+          visitor->phase_bias(ctx, sat_id, &sig);
+        }
+      }
+    }
+  }
+  return RC_OK;
+}
+
+/** Walk an RTCMv3 SSR message and hand its contents to callbacks
+ *
+ * Takes all SSR orbit, clock, combined orbit and clock, code bias and phase
+ * bias messages. Corrections are passed one satellite or one signal at a
+ * time as they are read, so no per-message output struct is needed. NULL
+ * callbacks are skipped. The callbacks run in message order: header, then
+ * per satellite the orbit and clock, or bias_sat followed by the biases of
+ * its signals.
+ *
+ * \param buff The input data buffer
+ * \param visitor Callbacks, the header callback may return false to skip
+ *                the rest of the message
+ * \param ctx Passed to the callbacks
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : Not an SSR message of these types
+ *          - RC_INVALID_MESSAGE : Unknown constellation
+ */
+rtcm3_rc rtcm3_decode_ssr_visit(const uint8_t buff[],
+                                const rtcm3_ssr_visitor *visitor,
+                                void *ctx) {
+  assert(visitor);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_ssr_visit_internal(buff, visitor, ctx));
+}
+
+/** Reset a high rate clock and URA table
+ *
+ * \param table The table to initialize
+ */
+void rtcm3_ssr_clock_table_init(rtcm3_ssr_clock_table *table) {
+  assert(table);
+  memset(table, 0, sizeof(*table));
+}
+
+static rtcm3_rc rtcm3_decode_hr_clock_internal(const uint8_t buff[],
+                                               rtcm_msg_ssr_header *header,
+                                               rtcm3_ssr_clock_table *table) {
+  uint16_t bit = 0;
+  if (!(RC_OK == decode_ssr_header(buff, &bit, header))) {
+    return RC_INVALID_MESSAGE;
+  }
+
+  if (!is_ssr_hr_clock_message(header->message_num)) {
+    return RC_MESSAGE_TYPE_MISMATCH;
+  }
+
+  uint8_t number_of_bits_for_sat_id;
+  if (!(RC_OK == get_number_of_bits_for_sat_id(header->constellation,
+                                               &number_of_bits_for_sat_id))) {
+    return RC_INVALID_MESSAGE;
+  }
+  rtcm3_ssr_clock_sat *sats = table->sats[header->constellation];
+  for (uint8_t i = 0; i < header->num_sats; i++) {
+    rtcm3_ssr_clock_sat *sat =
+        &sats[rtcm_getbitu(buff, bit, number_of_bits_for_sat_id)];
+    bit += number_of_bits_for_sat_id;
+    sat->high_rate_clock = rtcm_getbits(buff, bit, 22);
+    bit += 22;
+    sat->hr_clock_epoch_time = header->epoch_time;
+    sat->hr_clock_iod_ssr = header->iod_ssr;
+    sat->has_hr_clock = true;
+  }
+  return RC_OK;
+}
+
+/** Decode an RTCMv3 SSR High Rate Clock Correction message into a table
+ *
+ * Each satellite of the message is written straight into its entry of the
+ * table, entries of satellites not in the message are left as they are.
+ *
+ * \param buff The input data buffer
+ * \param header Set to the message header
+ * \param table The table to update
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : Message type mismatch
+ *          - RC_INVALID_MESSAGE : Unknown constellation
+ */
+rtcm3_rc rtcm3_decode_hr_clock(const uint8_t buff[],
+                               rtcm_msg_ssr_header *header,
+                               rtcm3_ssr_clock_table *table) {
+  assert(header);
+  assert(table);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_hr_clock_internal(buff, header, table));
+}
+
+static rtcm3_rc rtcm3_decode_ura_internal(const uint8_t buff[],
+                                          rtcm_msg_ssr_header *header,
+                                          rtcm3_ssr_clock_table *table) {
+  uint16_t bit = 0;
+  if (!(RC_OK == decode_ssr_header(buff, &bit, header))) {
+    return RC_INVALID_MESSAGE;
+  }
+
+  if (!is_ssr_ura_message(header->message_num)) {
+    return RC_MESSAGE_TYPE_MISMATCH;
+  }
+
+  uint8_t number_of_bits_for_sat_id;
+  if (!(RC_OK == get_number_of_bits_for_sat_id(header->constellation,
+                                               &number_of_bits_for_sat_id))) {
+    return RC_INVALID_MESSAGE;
+  }
+  rtcm3_ssr_clock_sat *sats = table->sats[header->constellation];
+  for (uint8_t i = 0; i < header->num_sats; i++) {
+    rtcm3_ssr_clock_sat *sat =
+        &sats[rtcm_getbitu(buff, bit, number_of_bits_for_sat_id)];
+    bit += number_of_bits_for_sat_id;
+    sat->ura = rtcm_getbitu(buff, bit, 6);
+    bit += 6;
+    sat->ura_epoch_time = header->epoch_time;
+    sat->ura_iod_ssr = header->iod_ssr;
+    sat->has_ura = true;
+  }
+  return RC_OK;
+}
+
+rtcm3_rc rtcm3_decode_ura(const uint8_t buff[],
+                          rtcm_msg_ssr_header *header,
+                          rtcm3_ssr_clock_table *table) {
+  assert(header);
+  assert(table);
+  return RTCM3_INSTRUMENT_DECODE(
+      buff, rtcm3_decode_ura_internal(buff, header, table));
+}
@@ -0,0 +1,526 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/ssr_encode.h"
+#include <assert.h>
+#include <string.h>
+#include "rtcm3/frame.h"
+#include "rtcm3/msm_utils.h"
+#include "bit_writer.h"
+#include "instrument.h"
+#include "ssr_fields.h"
+
+/* the satellite count is 6 bits and the number of biases 5 bits */
+#define SSR_MAX_SATS_PER_MSG 63
+#define SSR_MAX_BIASES 31
+
+/* The satellite arrays of one message, those the message type does not
+ * carry are NULL */
+typedef struct {
+  const rtcm_msg_ssr_header *header;
+  const rtcm_msg_ssr_orbit_corr *orbit;
+  const rtcm_msg_ssr_clock_corr *clock;
+  const rtcm_msg_ssr_code_bias_sat *code_bias;
+  const rtcm_msg_ssr_phase_bias_sat *phase_bias;
+} ssr_source;
+
+/* Constellation dependent field widths */
+typedef struct {
+  rtcm_constellation_t constellation;
+  uint8_t epoch_time;
+  uint8_t sat_id;
+  uint8_t iode;
+  bool iodcrc;
+} ssr_widths;
+
+static bool get_ssr_widths(uint16_t msg_num, ssr_widths *widths) {
+  widths->constellation = to_constellation(msg_num);
+  widths->iodcrc = RTCM_CONSTELLATION_BDS == widths->constellation ||
+                   RTCM_CONSTELLATION_SBAS == widths->constellation;
+  return RC_OK == get_number_of_bits_for_epoch_time(widths->constellation,
+                                                    &widths->epoch_time) &&
+         RC_OK == get_number_of_bits_for_sat_id(widths->constellation,
+                                                &widths->sat_id) &&
+         RC_OK ==
+             get_number_of_bits_for_iode(widths->constellation, &widths->iode);
+}
+
+static uint16_t ssr_header_bits(const ssr_source *src,
+                                const ssr_widths *widths) {
+  uint16_t msg_num = src->header->message_num;
+  uint16_t bits = 12 + widths->epoch_time + 4 + 1 + 4 + 16 + 4 + 6;
+  if (is_ssr_orbit_clock_message(msg_num)) {
+    /* satellite reference datum */
+    bits += 1;
+  }
+  if (is_ssr_phase_biases_message(msg_num)) {
+    /* dispersive bias and Melbourne-Wubbena consistency */
+    bits += 2;
+  }
+  return bits;
+}
+
+static uint16_t ssr_sat_bits(const ssr_source *src,
+                             const ssr_widths *widths,
+                             uint8_t i) {
+  uint16_t bits = widths->sat_id;
+  if (NULL != src->orbit) {
+    bits += widths->iode + (widths->iodcrc ? 24 : 0) + 22 + 20 + 20 + 21 +
+            19 + 19;
+  }
+  if (NULL != src->clock) {
+    bits += 22 + 21 + 27;
+  }
+  if (NULL != src->code_bias) {
+    bits += 5 + src->code_bias[i].num_code_biases * (5 + 14);
+  }
+  if (NULL != src->phase_bias) {
+    bits += 5 + 9 + 8 +
+            src->phase_bias[i].num_phase_biases * (5 + 1 + 2 + 4 + 20);
+  }
+  return bits;
+}
+
+static bool ssr_sat_valid(const ssr_source *src, uint8_t i) {
+  return (NULL == src->code_bias ||
+          src->code_bias[i].num_code_biases <= SSR_MAX_BIASES) &&
+         (NULL == src->phase_bias ||
+          src->phase_bias[i].num_phase_biases <= SSR_MAX_BIASES);
+}
+
+static void write_ssr_header(rtcm_bit_writer *writer,
+                             const ssr_source *src,
+                             const ssr_widths *widths,
+                             uint8_t num_sats,
+                             bool multi_message) {
+  const rtcm_msg_ssr_header *header = src->header;
+  rtcm_bit_writer_put(writer, 12, header->message_num);
+  rtcm_bit_writer_put(writer, widths->epoch_time, header->epoch_time);
+  rtcm_bit_writer_put(writer, 4, header->update_interval);
+  rtcm_bit_writer_put(writer, 1, multi_message);
+  if (is_ssr_orbit_clock_message(header->message_num)) {
+    rtcm_bit_writer_put(writer, 1, header->sat_ref_datum);
+  }
+  rtcm_bit_writer_put(writer, 4, header->iod_ssr);
+  rtcm_bit_writer_put(writer, 16, header->ssr_provider_id);
+  rtcm_bit_writer_put(writer, 4, header->ssr_solution_id);
+  if (is_ssr_phase_biases_message(header->message_num)) {
+    rtcm_bit_writer_put(writer, 1, header->dispersive_bias_consistency);
+    rtcm_bit_writer_put(writer, 1, header->melbourne_wubbena_consistency);
+  }
+  rtcm_bit_writer_put(writer, 6, num_sats);
+}
+
+static void write_ssr_orbit(rtcm_bit_writer *writer,
+                            const ssr_widths *widths,
+                            const rtcm_msg_ssr_orbit_corr *orbit) {
+  rtcm_bit_writer_put(writer, widths->iode, orbit->iode);
+  if (widths->iodcrc) {
+    rtcm_bit_writer_put(writer, 24, orbit->iodcrc);
+  }
+  rtcm_bit_writer_put_signed(writer, 22, orbit->radial);
+  rtcm_bit_writer_put_signed(writer, 20, orbit->along_track);
+  rtcm_bit_writer_put_signed(writer, 20, orbit->cross_track);
+  rtcm_bit_writer_put_signed(writer, 21, orbit->dot_radial);
+  rtcm_bit_writer_put_signed(writer, 19, orbit->dot_along_track);
+  rtcm_bit_writer_put_signed(writer, 19, orbit->dot_cross_track);
+}
+
+static void write_ssr_clock(rtcm_bit_writer *writer,
+                            const rtcm_msg_ssr_clock_corr *clock) {
+  rtcm_bit_writer_put_signed(writer, 22, clock->c0);
+  rtcm_bit_writer_put_signed(writer, 21, clock->c1);
+  rtcm_bit_writer_put_signed(writer, 27, clock->c2);
+}
+
+static void write_ssr_sat(rtcm_bit_writer *writer,
+                          const ssr_source *src,
+                          const ssr_widths *widths,
+                          uint8_t i) {
+  if (NULL != src->orbit) {
+    rtcm_bit_writer_put(writer, widths->sat_id, src->orbit[i].sat_id);
+    write_ssr_orbit(writer, widths, &src->orbit[i]);
+    if (NULL != src->clock) {
+      write_ssr_clock(writer, &src->clock[i]);
+    }
+  } else if (NULL != src->clock) {
+    rtcm_bit_writer_put(writer, widths->sat_id, src->clock[i].sat_id);
+    write_ssr_clock(writer, &src->clock[i]);
+  } else if (NULL != src->code_bias) {
+    const rtcm_msg_ssr_code_bias_sat *sat = &src->code_bias[i];
+    rtcm_bit_writer_put(writer, widths->sat_id, sat->sat_id);
+    rtcm_bit_writer_put(writer, 5, sat->num_code_biases);
+    for (uint8_t j = 0; j < sat->num_code_biases; j++) {
+      rtcm_bit_writer_put(writer, 5, sat->signals[j].signal_id);
+      rtcm_bit_writer_put_signed(writer, 14, sat->signals[j].code_bias);
+    }
+  } else {
+    const rtcm_msg_ssr_phase_bias_sat *sat = &src->phase_bias[i];
+    rtcm_bit_writer_put(writer, widths->sat_id, sat->sat_id);
+    rtcm_bit_writer_put(writer, 5, sat->num_phase_biases);
+    rtcm_bit_writer_put(writer, 9, sat->yaw_angle);
+    rtcm_bit_writer_put_signed(writer, 8, sat->yaw_rate);
+    for (uint8_t j = 0; j < sat->num_phase_biases; j++) {
+      const rtcm_msg_ssr_phase_bias_sig *sig = &sat->signals[j];
+      rtcm_bit_writer_put(writer, 5, sig->signal_id);
+      rtcm_bit_writer_put(writer, 1, sig->integer_indicator);
+      rtcm_bit_writer_put(writer, 2, sig->widelane_indicator);
+      rtcm_bit_writer_put(writer, 4, sig->discontinuity_indicator);
+      rtcm_bit_writer_put_signed(writer, 20, sig->phase_bias);
+    }
+  }
+}
+
+/* Encode the satellites [first, end) as one message */
+static uint16_t write_ssr_message(const ssr_source *src,
+                                  const ssr_widths *widths,
+                                  uint8_t first,
+                                  uint8_t end,
+                                  bool multi_message,
+                                  uint8_t buff[]) {
+  rtcm_bit_writer writer;
+  rtcm_bit_writer_init(&writer, buff);
+  write_ssr_header(&writer, src, widths, end - first, multi_message);
+  for (uint8_t i = first; i < end; i++) {
+    write_ssr_sat(&writer, src, widths, i);
+  }
+  return (uint16_t)rtcm_bit_writer_finish(&writer);
+}
+
+/* Length of the message in bytes, 0 if it cannot be encoded as one */
+static uint16_t ssr_encoded_size(const ssr_source *src) {
+  ssr_widths widths;
+  const rtcm_msg_ssr_header *header = src->header;
+  if (!get_ssr_widths(header->message_num, &widths) ||
+      header->num_sats > SSR_MAX_SATS_PER_MSG) {
+    return 0;
+  }
+  uint32_t bits = ssr_header_bits(src, &widths);
+  for (uint8_t i = 0; i < header->num_sats; i++) {
+    if (!ssr_sat_valid(src, i)) {
+      return 0;
+    }
+    bits += ssr_sat_bits(src, &widths, i);
+  }
+  uint32_t bytes = (bits + 7) / 8;
+  return bytes > RTCM3_MAX_PAYLOAD_LEN ? 0 : (uint16_t)bytes;
+}
+
+static uint16_t ssr_encode(const ssr_source *src, uint8_t buff[]) {
+  if (0 == ssr_encoded_size(src)) {
+    return 0;
+  }
+  ssr_widths widths;
+  get_ssr_widths(src->header->message_num, &widths);
+  return write_ssr_message(src,
+                           &widths,
+                           0,
+                           src->header->num_sats,
+                           src->header->multi_message,
+                           buff);
+}
+
+/* Split the satellites over as few frames as they fit in */
+static uint8_t ssr_encode_frames(const ssr_source *src,
+                                 uint8_t buff[],
+                                 size_t buff_len,
+                                 size_t *len) {
+  *len = 0;
+  ssr_widths widths;
+  const rtcm_msg_ssr_header *header = src->header;
+  if (!get_ssr_widths(header->message_num, &widths) ||
+      header->num_sats > MAX_SSR_SATELLITES) {
+    return 0;
+  }
+  const uint32_t max_bits = RTCM3_MAX_PAYLOAD_LEN * 8;
+  uint32_t header_bits = ssr_header_bits(src, &widths);
+  size_t pos = 0;
+  uint8_t num_frames = 0;
+  uint8_t first = 0;
+  do {
+    uint32_t bits = header_bits;
+    uint8_t end = first;
+    while (end < header->num_sats && end - first < SSR_MAX_SATS_PER_MSG) {
+      if (!ssr_sat_valid(src, end)) {
+        return 0;
+      }
+      uint16_t sat_bits = ssr_sat_bits(src, &widths, end);
+      if (bits + sat_bits > max_bits) {
+        break;
+      }
+      bits += sat_bits;
+      end++;
+    }
+    if (end == first && first < header->num_sats) {
+      /* a single satellite does not fit */
+      return 0;
+    }
+    uint16_t payload_len = (uint16_t)((bits + 7) / 8);
+    if (pos + payload_len + RTCM3_FRAME_OVERHEAD > buff_len) {
+      return 0;
+    }
+    bool multi_message = end < header->num_sats || header->multi_message;
+    write_ssr_message(src,
+                      &widths,
+                      first,
+                      end,
+                      multi_message,
+                      &buff[pos + RTCM3_FRAME_HEADER_LEN]);
+    pos += rtcm3_frame_finalize(&buff[pos], payload_len);
+    num_frames++;
+    first = end;
+  } while (first < header->num_sats);
+  *len = pos;
+  return num_frames;
+}
+
+static bool ssr_source_orbit(const rtcm_msg_orbit *msg_orbit,
+                             ssr_source *src) {
+  *src = (ssr_source){.header = &msg_orbit->header,
+                      .orbit = msg_orbit->orbit};
+  return is_ssr_orbit_message(msg_orbit->header.message_num);
+}
+
+static bool ssr_source_clock(const rtcm_msg_clock *msg_clock,
+                             ssr_source *src) {
+  *src = (ssr_source){.header = &msg_clock->header,
+                      .clock = msg_clock->clock};
+  return is_ssr_clock_message(msg_clock->header.message_num);
+}
+
+static bool ssr_source_orbit_clock(const rtcm_msg_orbit_clock *msg_orbit_clock,
+                                   ssr_source *src) {
+  uint16_t msg_num = msg_orbit_clock->header.message_num;
+  *src = (ssr_source){.header = &msg_orbit_clock->header,
+                      .orbit = msg_orbit_clock->orbit,
+                      .clock = msg_orbit_clock->clock};
+  return is_ssr_orbit_clock_message(msg_num) && !is_ssr_orbit_message(msg_num);
+}
+
+static bool ssr_source_code_bias(const rtcm_msg_code_bias *msg_code_bias,
+                                 ssr_source *src) {
+  *src = (ssr_source){.header = &msg_code_bias->header,
+                      .code_bias = msg_code_bias->sats};
+  return is_ssr_code_biases_message(msg_code_bias->header.message_num);
+}
+
+static bool ssr_source_phase_bias(const rtcm_msg_phase_bias *msg_phase_bias,
+                                  ssr_source *src) {
+  *src = (ssr_source){.header = &msg_phase_bias->header,
+                      .phase_bias = msg_phase_bias->sats};
+  return is_ssr_phase_biases_message(msg_phase_bias->header.message_num);
+}
+
+static uint16_t rtcm3_encode_orbit_internal(const rtcm_msg_orbit *msg_orbit,
+                                            uint8_t buff[]) {
+  ssr_source src;
+  return ssr_source_orbit(msg_orbit, &src) ? ssr_encode(&src, buff) : 0;
+}
+
+/** Encode an RTCMv3 SSR Orbit Correction message
+ *
+ * The constellation and the field widths follow from the message number in
+ * the header, the satellite ID and IODE of each satellite are written as they
+ * are.
+ *
+ * \param msg_orbit The input RTCM message struct
+ * \param buff The output data buffer
+ * \return Number of bytes written, 0 if the message type is not an orbit
+ *         correction or the message does not fit into one frame
+ */
+uint16_t rtcm3_encode_orbit(const rtcm_msg_orbit *msg_orbit, uint8_t buff[]) {
+  assert(msg_orbit);
+  return RTCM3_INSTRUMENT_ENCODE(msg_orbit->header.message_num,
+                                 buff,
+                                 rtcm3_encode_orbit_internal(msg_orbit, buff));
+}
+
+static uint16_t rtcm3_encode_clock_internal(const rtcm_msg_clock *msg_clock,
+                                            uint8_t buff[]) {
+  ssr_source src;
+  return ssr_source_clock(msg_clock, &src) ? ssr_encode(&src, buff) : 0;
+}
+
+uint16_t rtcm3_encode_clock(const rtcm_msg_clock *msg_clock, uint8_t buff[]) {
+  assert(msg_clock);
+  return RTCM3_INSTRUMENT_ENCODE(msg_clock->header.message_num,
+                                 buff,
+                                 rtcm3_encode_clock_internal(msg_clock, buff));
+}
+
+static uint16_t rtcm3_encode_orbit_clock_internal(
+    const rtcm_msg_orbit_clock *msg_orbit_clock, uint8_t buff[]) {
+  ssr_source src;
+  return ssr_source_orbit_clock(msg_orbit_clock, &src) ? ssr_encode(&src, buff)
+                                                       : 0;
+}
+
+uint16_t rtcm3_encode_orbit_clock(const rtcm_msg_orbit_clock *msg_orbit_clock,
+                                  uint8_t buff[]) {
+  assert(msg_orbit_clock);
+  return RTCM3_INSTRUMENT_ENCODE(
+      msg_orbit_clock->header.message_num,
+      buff,
+      rtcm3_encode_orbit_clock_internal(msg_orbit_clock, buff));
+}
+
+static uint16_t rtcm3_encode_code_bias_internal(
+    const rtcm_msg_code_bias *msg_code_bias, uint8_t buff[]) {
+  ssr_source src;
+  return ssr_source_code_bias(msg_code_bias, &src) ? ssr_encode(&src, buff)
+                                                   : 0;
+}
+
+uint16_t rtcm3_encode_code_bias(const rtcm_msg_code_bias *msg_code_bias,
+                                uint8_t buff[]) {
+  assert(msg_code_bias);
+  return RTCM3_INSTRUMENT_ENCODE(
+      msg_code_bias->header.message_num,
+      buff,
+      rtcm3_encode_code_bias_internal(msg_code_bias, buff));
+}
+
+static uint16_t rtcm3_encode_phase_bias_internal(
+    const rtcm_msg_phase_bias *msg_phase_bias, uint8_t buff[]) {
+  ssr_source src;
+  return ssr_source_phase_bias(msg_phase_bias, &src) ? ssr_encode(&src, buff)
+                                                     : 0;
+}
+
+uint16_t rtcm3_encode_phase_bias(const rtcm_msg_phase_bias *msg_phase_bias,
+                                 uint8_t buff[]) {
+  assert(msg_phase_bias);
+  return RTCM3_INSTRUMENT_ENCODE(
+      msg_phase_bias->header.message_num,
+      buff,
+      rtcm3_encode_phase_bias_internal(msg_phase_bias, buff));
+}
+
+/** Size of an SSR Orbit Correction as rtcm3_encode_orbit writes it
+ *
+ * \param msg_orbit The input RTCM message struct
+ * \return Number of bytes the encoder writes, 0 if it rejects the message
+ */
+uint16_t rtcm3_encoded_size_orbit(const rtcm_msg_orbit *msg_orbit) {
+  assert(msg_orbit);
+  ssr_source src;
+  return ssr_source_orbit(msg_orbit, &src) ? ssr_encoded_size(&src) : 0;
+}
+
+uint16_t rtcm3_encoded_size_clock(const rtcm_msg_clock *msg_clock) {
+  assert(msg_clock);
+  ssr_source src;
+  return ssr_source_clock(msg_clock, &src) ? ssr_encoded_size(&src) : 0;
+}
+
+uint16_t rtcm3_encoded_size_orbit_clock(
+    const rtcm_msg_orbit_clock *msg_orbit_clock) {
+  assert(msg_orbit_clock);
+  ssr_source src;
+  return ssr_source_orbit_clock(msg_orbit_clock, &src) ? ssr_encoded_size(&src)
+                                                       : 0;
+}
+
+uint16_t rtcm3_encoded_size_code_bias(const rtcm_msg_code_bias *msg_code_bias) {
+  assert(msg_code_bias);
+  ssr_source src;
+  return ssr_source_code_bias(msg_code_bias, &src) ? ssr_encoded_size(&src)
+                                                   : 0;
+}
+
+uint16_t rtcm3_encoded_size_phase_bias(
+    const rtcm_msg_phase_bias *msg_phase_bias) {
+  assert(msg_phase_bias);
+  ssr_source src;
+  return ssr_source_phase_bias(msg_phase_bias, &src) ? ssr_encoded_size(&src)
+                                                     : 0;
+}
+
+/** Encode an SSR Orbit Correction as one or more complete frames
+ *
+ * The satellites are split in order over as few messages as hold them, each
+ * with at most 63 satellites and RTCM3_MAX_PAYLOAD_LEN bytes of payload. The
+ * frames are written back to back.
+ *
+ * \param msg_orbit The input RTCM message struct
+ * \param buff The output buffer
+ * \param buff_len Size of the output buffer
+ * \param len Set to the number of bytes written
+ * \return Number of frames written, 0 if the message is rejected or does not
+ *         fit into the buffer
+ */
+uint8_t rtcm3_encode_orbit_frames(const rtcm_msg_orbit *msg_orbit,
+                                  uint8_t buff[],
+                                  size_t buff_len,
+                                  size_t *len) {
+  assert(msg_orbit);
+  assert(len);
+  *len = 0;
+  ssr_source src;
+  return ssr_source_orbit(msg_orbit, &src)
+             ? ssr_encode_frames(&src, buff, buff_len, len)
+             : 0;
+}
+
+uint8_t rtcm3_encode_clock_frames(const rtcm_msg_clock *msg_clock,
+                                  uint8_t buff[],
+                                  size_t buff_len,
+                                  size_t *len) {
+  assert(msg_clock);
+  assert(len);
+  *len = 0;
+  ssr_source src;
+  return ssr_source_clock(msg_clock, &src)
+             ? ssr_encode_frames(&src, buff, buff_len, len)
+             : 0;
+}
+
+uint8_t rtcm3_encode_orbit_clock_frames(
+    const rtcm_msg_orbit_clock *msg_orbit_clock,
+    uint8_t buff[],
+    size_t buff_len,
+    size_t *len) {
+  assert(msg_orbit_clock);
+  assert(len);
+  *len = 0;
+  ssr_source src;
+  return ssr_source_orbit_clock(msg_orbit_clock, &src)
+             ? ssr_encode_frames(&src, buff, buff_len, len)
+             : 0;
+}
+
+uint8_t rtcm3_encode_code_bias_frames(const rtcm_msg_code_bias *msg_code_bias,
+                                      uint8_t buff[],
+                                      size_t buff_len,
+                                      size_t *len) {
+  assert(msg_code_bias);
+  assert(len);
+  *len = 0;
+  ssr_source src;
+  return ssr_source_code_bias(msg_code_bias, &src)
+             ? ssr_encode_frames(&src, buff, buff_len, len)
+             : 0;
+}
+
+uint8_t rtcm3_encode_phase_bias_frames(
+    const rtcm_msg_phase_bias *msg_phase_bias,
+    uint8_t buff[],
+    size_t buff_len,
+    size_t *len) {
+  assert(msg_phase_bias);
+  assert(len);
+  *len = 0;
+  ssr_source src;
+  return ssr_source_phase_bias(msg_phase_bias, &src)
+             ? ssr_encode_frames(&src, buff, buff_len, len)
+             : 0;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Private declarations of the SSR field helpers in ssr_decode.c, shared
+ * with the SSR encoders so both sides agree on the field widths. */
+
+#ifndef SWIFTNAV_RTCM3_SSR_FIELDS_H
+#define SWIFTNAV_RTCM3_SSR_FIELDS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "rtcm3/messages.h"
+
+rtcm3_rc get_number_of_bits_for_epoch_time(rtcm_constellation_t constellation,
+                                           uint8_t *num_bit);
+rtcm3_rc get_number_of_bits_for_sat_id(rtcm_constellation_t constellation,
+                                       uint8_t *num_bit);
+rtcm3_rc get_number_of_bits_for_iode(const rtcm_constellation_t constellation,
+                                     uint8_t *num_bit);
+bool is_ssr_orbit_clock_message(const uint16_t message_num);
+bool is_ssr_orbit_message(const uint16_t message_num);
+bool is_ssr_clock_message(const uint16_t message_num);
+bool is_ssr_code_biases_message(const uint16_t message_num);
+bool is_ssr_phase_biases_message(const uint16_t message_num);
+bool is_ssr_ura_message(const uint16_t message_num);
+bool is_ssr_hr_clock_message(const uint16_t message_num);
+rtcm3_rc decode_ssr_header(const uint8_t buff[],
+                           uint16_t *bit,
+                           rtcm_msg_ssr_header *msg_header);
+
+#endif /* SWIFTNAV_RTCM3_SSR_FIELDS_H */
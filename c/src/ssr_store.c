@@ -0,0 +1,507 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/ssr_store.h"
+#include <assert.h>
+#include <string.h>
+#include "rtcm3/bits.h"
+#include "rtcm3/dispatch.h"
+#include "rtcm3/ssr_decode.h"
+#include "ssr_fields.h"
+
+#define SECONDS_PER_WEEK 604800
+#define SECONDS_PER_DAY 86400
+
+/** Reset the store, it follows the provider of the next message
+ *
+ * \param store The store to initialize
+ */
+void rtcm3_ssr_store_init(rtcm3_ssr_store *store) {
+  assert(store);
+  memset(store, 0, sizeof(*store));
+  store->max_age_s = RTCM3_SSR_MAX_AGE_S;
+}
+
+/* follow the provider of the first message, false for any other provider */
+static bool follow_provider(rtcm3_ssr_store *store,
+                            const rtcm_msg_ssr_header *header) {
+  if (header->constellation >= RTCM_CONSTELLATION_COUNT) {
+    return false;
+  }
+  if (!store->locked) {
+    store->locked = true;
+    store->provider_id = header->ssr_provider_id;
+    store->solution_id = (uint8_t)header->ssr_solution_id;
+  } else if (header->ssr_provider_id != store->provider_id ||
+             header->ssr_solution_id != store->solution_id) {
+    store->rejected++;
+    return false;
+  }
+  return true;
+}
+
+/* Check the header against the provider the store follows and join the set
+ * of its epoch, starting a new one if need be. Returns the set or NULL if
+ * the message is not taken. */
+static rtcm3_ssr_set *join_set(rtcm3_ssr_store *store,
+                               const rtcm_msg_ssr_header *header,
+                               rtcm3_ssr_kind kind) {
+  if (!follow_provider(store, header)) {
+    return NULL;
+  }
+
+  rtcm3_ssr_set *set = &store->sets[header->constellation][kind];
+  if (!set->assembling || set->epoch_time != header->epoch_time ||
+      set->iod_ssr != header->iod_ssr) {
+    /* an incomplete set left behind is dropped, its slots are reused */
+    set->seq++;
+    set->assembling = true;
+    set->epoch_time = header->epoch_time;
+    set->iod_ssr = header->iod_ssr;
+    set->update_interval = header->update_interval;
+  }
+  return set;
+}
+
+/* slot the set being assembled is written to */
+static uint8_t assembly_slot(const rtcm3_ssr_set *set) {
+  return set->complete_slot ^ 1;
+}
+
+static void close_set(rtcm3_ssr_set *set, const rtcm_msg_ssr_header *header) {
+  if (header->multi_message) {
+    return;
+  }
+  set->assembling = false;
+  set->complete_slot = assembly_slot(set);
+  set->complete_seq = set->seq;
+  set->complete_epoch_time = set->epoch_time;
+  set->complete_iod_ssr = set->iod_ssr;
+}
+
+/** Add the corrections of a decoded SSR orbit message
+ *
+ * \param store The store
+ * \param msg_orbit The decoded message
+ * \return  - RC_OK : Success
+ *          - RC_INVALID_MESSAGE : Unknown constellation or the message is
+ *            from another provider or solution
+ */
+rtcm3_rc rtcm3_ssr_store_add_orbit(rtcm3_ssr_store *store,
+                                   const rtcm_msg_orbit *msg_orbit) {
+  assert(store);
+  assert(msg_orbit);
+  const rtcm_msg_ssr_header *header = &msg_orbit->header;
+  rtcm3_ssr_set *set = join_set(store, header, RTCM3_SSR_ORBIT);
+  if (NULL == set) {
+    return RC_INVALID_MESSAGE;
+  }
+  uint8_t slot = assembly_slot(set);
+  for (uint8_t i = 0; i < header->num_sats; i++) {
+    const rtcm_msg_ssr_orbit_corr *orbit = &msg_orbit->orbit[i];
+    rtcm3_ssr_sat *sat = &store->sats[header->constellation][orbit->sat_id];
+    sat->orbit[slot] = *orbit;
+    sat->orbit_seq[slot] = set->seq;
+  }
+  close_set(set, header);
+  return RC_OK;
+}
+
+rtcm3_rc rtcm3_ssr_store_add_clock(rtcm3_ssr_store *store,
+                                   const rtcm_msg_clock *msg_clock) {
+  assert(store);
+  assert(msg_clock);
+  const rtcm_msg_ssr_header *header = &msg_clock->header;
+  rtcm3_ssr_set *set = join_set(store, header, RTCM3_SSR_CLOCK);
+  if (NULL == set) {
+    return RC_INVALID_MESSAGE;
+  }
+  uint8_t slot = assembly_slot(set);
+  for (uint8_t i = 0; i < header->num_sats; i++) {
+    const rtcm_msg_ssr_clock_corr *clock = &msg_clock->clock[i];
+    rtcm3_ssr_sat *sat = &store->sats[header->constellation][clock->sat_id];
+    sat->clock[slot] = *clock;
+    sat->clock_seq[slot] = set->seq;
+  }
+  close_set(set, header);
+  return RC_OK;
+}
+
+/* The combined message feeds the orbit and the clock sets */
+rtcm3_rc rtcm3_ssr_store_add_orbit_clock(
+    rtcm3_ssr_store *store, const rtcm_msg_orbit_clock *msg_orbit_clock) {
+  assert(store);
+  assert(msg_orbit_clock);
+  const rtcm_msg_ssr_header *header = &msg_orbit_clock->header;
+  rtcm3_ssr_set *orbit_set = join_set(store, header, RTCM3_SSR_ORBIT);
+  if (NULL == orbit_set) {
+    return RC_INVALID_MESSAGE;
+  }
+  rtcm3_ssr_set *clock_set = join_set(store, header, RTCM3_SSR_CLOCK);
+  assert(clock_set);
+  uint8_t orbit_slot = assembly_slot(orbit_set);
+  uint8_t clock_slot = assembly_slot(clock_set);
+  for (uint8_t i = 0; i < header->num_sats; i++) {
+    const rtcm_msg_ssr_orbit_corr *orbit = &msg_orbit_clock->orbit[i];
+    rtcm3_ssr_sat *sat = &store->sats[header->constellation][orbit->sat_id];
+    sat->orbit[orbit_slot] = *orbit;
+    sat->orbit_seq[orbit_slot] = orbit_set->seq;
+    sat->clock[clock_slot] = msg_orbit_clock->clock[i];
+    sat->clock[clock_slot].sat_id = orbit->sat_id;
+    sat->clock_seq[clock_slot] = clock_set->seq;
+  }
+  close_set(orbit_set, header);
+  close_set(clock_set, header);
+  return RC_OK;
+}
+
+rtcm3_rc rtcm3_ssr_store_add_code_bias(
+    rtcm3_ssr_store *store, const rtcm_msg_code_bias *msg_code_bias) {
+  assert(store);
+  assert(msg_code_bias);
+  const rtcm_msg_ssr_header *header = &msg_code_bias->header;
+  rtcm3_ssr_set *set = join_set(store, header, RTCM3_SSR_CODE_BIAS);
+  if (NULL == set) {
+    return RC_INVALID_MESSAGE;
+  }
+  uint8_t slot = assembly_slot(set);
+  for (uint8_t i = 0; i < header->num_sats; i++) {
+    const rtcm_msg_ssr_code_bias_sat *bias_sat = &msg_code_bias->sats[i];
+    rtcm3_ssr_sat *sat = &store->sats[header->constellation][bias_sat->sat_id];
+    uint32_t mask = 0;
+    for (uint8_t j = 0; j < bias_sat->num_code_biases; j++) {
+      const rtcm_msg_ssr_code_bias_sig *sig = &bias_sat->signals[j];
+      sat->code_bias[slot][sig->signal_id] = sig->code_bias;
+      mask |= 1u << sig->signal_id;
+    }
+    sat->code_bias_mask[slot] = mask;
+    sat->code_bias_seq[slot] = set->seq;
+  }
+  close_set(set, header);
+  return RC_OK;
+}
+
+rtcm3_rc rtcm3_ssr_store_add_phase_bias(
+    rtcm3_ssr_store *store, const rtcm_msg_phase_bias *msg_phase_bias) {
+  assert(store);
+  assert(msg_phase_bias);
+  const rtcm_msg_ssr_header *header = &msg_phase_bias->header;
+  rtcm3_ssr_set *set = join_set(store, header, RTCM3_SSR_PHASE_BIAS);
+  if (NULL == set) {
+    return RC_INVALID_MESSAGE;
+  }
+  uint8_t slot = assembly_slot(set);
+  for (uint8_t i = 0; i < header->num_sats; i++) {
+    const rtcm_msg_ssr_phase_bias_sat *bias_sat = &msg_phase_bias->sats[i];
+    rtcm3_ssr_sat *sat = &store->sats[header->constellation][bias_sat->sat_id];
+    uint32_t mask = 0;
+    for (uint8_t j = 0; j < bias_sat->num_phase_biases; j++) {
+      const rtcm_msg_ssr_phase_bias_sig *sig = &bias_sat->signals[j];
+      sat->phase_bias[slot][sig->signal_id] = *sig;
+      mask |= 1u << sig->signal_id;
+    }
+    sat->phase_bias_mask[slot] = mask;
+    sat->yaw_angle[slot] = bias_sat->yaw_angle;
+    sat->yaw_rate[slot] = bias_sat->yaw_rate;
+    sat->phase_bias_seq[slot] = set->seq;
+  }
+  close_set(set, header);
+  return RC_OK;
+}
+
+/* State of a raw message walked into the store */
+typedef struct {
+  rtcm3_ssr_store *store;
+  rtcm_msg_ssr_header header;
+  rtcm3_ssr_set *sets[RTCM3_SSR_KIND_COUNT];
+  bool taken;
+} ssr_update;
+
+static bool update_header(void *ctx, const rtcm_msg_ssr_header *header) {
+  ssr_update *update = ctx;
+  update->header = *header;
+  rtcm3_ssr_kind first = RTCM3_SSR_KIND_COUNT;
+  rtcm3_ssr_kind second = RTCM3_SSR_KIND_COUNT;
+  switch (rtcm3_msg_kind_of(header->message_num)) {
+    case RTCM3_MSG_SSR_ORBIT:
+      first = RTCM3_SSR_ORBIT;
+      break;
+    case RTCM3_MSG_SSR_CLOCK:
+      first = RTCM3_SSR_CLOCK;
+      break;
+    case RTCM3_MSG_SSR_ORBIT_CLOCK:
+      first = RTCM3_SSR_ORBIT;
+      second = RTCM3_SSR_CLOCK;
+      break;
+    case RTCM3_MSG_SSR_CODE_BIAS:
+      first = RTCM3_SSR_CODE_BIAS;
+      break;
+    case RTCM3_MSG_SSR_PHASE_BIAS:
+      first = RTCM3_SSR_PHASE_BIAS;
+      break;
+    case RTCM3_MSG_UNSUPPORTED:
+    case RTCM3_MSG_OBS:
+    case RTCM3_MSG_1005:
+    case RTCM3_MSG_1006:
+    case RTCM3_MSG_1007:
+    case RTCM3_MSG_1008:
+    case RTCM3_MSG_1029:
+    case RTCM3_MSG_1033:
+    case RTCM3_MSG_1230:
+    case RTCM3_MSG_MSM:
+    case RTCM3_MSG_EPH:
+    case RTCM3_MSG_SWIFT_PROPRIETARY:
+    case RTCM3_MSG_KIND_COUNT:
+    default:
+      return false;
+  }
+  update->sets[first] = join_set(update->store, header, first);
+  if (NULL == update->sets[first]) {
+    return false;
+  }
+  if (second != RTCM3_SSR_KIND_COUNT) {
+    update->sets[second] = join_set(update->store, header, second);
+  }
+  update->taken = true;
+  return true;
+}
+
+static rtcm3_ssr_sat *update_sat(ssr_update *update, uint8_t sat_id) {
+  return &update->store->sats[update->header.constellation][sat_id];
+}
+
+static void update_orbit(void *ctx, const rtcm_msg_ssr_orbit_corr *orbit) {
+  ssr_update *update = ctx;
+  const rtcm3_ssr_set *set = update->sets[RTCM3_SSR_ORBIT];
+  rtcm3_ssr_sat *sat = update_sat(update, orbit->sat_id);
+  uint8_t slot = assembly_slot(set);
+  sat->orbit[slot] = *orbit;
+  sat->orbit_seq[slot] = set->seq;
+}
+
+static void update_clock(void *ctx, const rtcm_msg_ssr_clock_corr *clock) {
+  ssr_update *update = ctx;
+  const rtcm3_ssr_set *set = update->sets[RTCM3_SSR_CLOCK];
+  rtcm3_ssr_sat *sat = update_sat(update, clock->sat_id);
+  uint8_t slot = assembly_slot(set);
+  sat->clock[slot] = *clock;
+  sat->clock_seq[slot] = set->seq;
+}
+
+static void update_bias_sat(void *ctx, const rtcm3_ssr_bias_sat *bias_sat) {
+  ssr_update *update = ctx;
+  rtcm3_ssr_sat *sat = update_sat(update, bias_sat->sat_id);
+  const rtcm3_ssr_set *set = update->sets[RTCM3_SSR_CODE_BIAS];
+  if (NULL != set) {
+    uint8_t slot = assembly_slot(set);
+    sat->code_bias_mask[slot] = 0;
+    sat->code_bias_seq[slot] = set->seq;
+    return;
+  }
+  set = update->sets[RTCM3_SSR_PHASE_BIAS];
+  uint8_t slot = assembly_slot(set);
+  sat->phase_bias_mask[slot] = 0;
+  sat->yaw_angle[slot] = bias_sat->yaw_angle;
+  sat->yaw_rate[slot] = bias_sat->yaw_rate;
+  sat->phase_bias_seq[slot] = set->seq;
+}
+
+static void update_code_bias(void *ctx,
+                             uint8_t sat_id,
+                             const rtcm_msg_ssr_code_bias_sig *sig) {
+  ssr_update *update = ctx;
+  rtcm3_ssr_sat *sat = update_sat(update, sat_id);
+  uint8_t slot = assembly_slot(update->sets[RTCM3_SSR_CODE_BIAS]);
+  sat->code_bias[slot][sig->signal_id] = sig->code_bias;
+  sat->code_bias_mask[slot] |= 1u << sig->signal_id;
+}
+
+static void update_phase_bias(void *ctx,
+                              uint8_t sat_id,
+                              const rtcm_msg_ssr_phase_bias_sig *sig) {
+  ssr_update *update = ctx;
+  rtcm3_ssr_sat *sat = update_sat(update, sat_id);
+  uint8_t slot = assembly_slot(update->sets[RTCM3_SSR_PHASE_BIAS]);
+  sat->phase_bias[slot][sig->signal_id] = *sig;
+  sat->phase_bias_mask[slot] |= 1u << sig->signal_id;
+}
+
+static const rtcm3_ssr_visitor ssr_update_visitor = {
+    update_header,
+    update_orbit,
+    update_clock,
+    update_bias_sat,
+    update_code_bias,
+    update_phase_bias,
+};
+
+/* High rate clocks and URA are decoded straight into the clock table once
+ * the header shows the provider the store follows */
+static rtcm3_rc update_clock_table(rtcm3_ssr_store *store,
+                                   const uint8_t payload[],
+                                   uint16_t msg_num) {
+  rtcm_msg_ssr_header header;
+  uint16_t bit = 0;
+  if (RC_OK != decode_ssr_header(payload, &bit, &header)) {
+    return RC_INVALID_MESSAGE;
+  }
+  if (!follow_provider(store, &header)) {
+    return RC_INVALID_MESSAGE;
+  }
+  if (is_ssr_hr_clock_message(msg_num)) {
+    return rtcm3_decode_hr_clock(payload, &header, &store->clocks);
+  }
+  return rtcm3_decode_ura(payload, &header, &store->clocks);
+}
+
+/** Decode a raw SSR message into the store
+ *
+ * The message is walked straight into the satellite table, without a
+ * decoded message struct in between.
+ *
+ * \param store The store
+ * \param payload The message, starting with the message number
+ * \return  - RC_OK : Success
+ *          - RC_MESSAGE_TYPE_MISMATCH : Not an SSR message the store takes
+ *          - RC_INVALID_MESSAGE : Decoding failed, or the message is from
+ *            another provider or solution
+ */
+rtcm3_rc rtcm3_ssr_store_update(rtcm3_ssr_store *store,
+                                const uint8_t payload[]) {
+  assert(store);
+  uint16_t msg_num = rtcm_getbitu(payload, 0, 12);
+  if (is_ssr_hr_clock_message(msg_num) || is_ssr_ura_message(msg_num)) {
+    return update_clock_table(store, payload, msg_num);
+  }
+  ssr_update update;
+  memset(&update, 0, sizeof(update));
+  update.store = store;
+  rtcm3_rc ret = rtcm3_decode_ssr_visit(payload, &ssr_update_visitor, &update);
+  if (RC_OK != ret) {
+    /* a set with a message missing is never closed */
+    return ret;
+  }
+  if (!update.taken) {
+    return RC_INVALID_MESSAGE;
+  }
+  for (uint8_t kind = 0; kind < RTCM3_SSR_KIND_COUNT; kind++) {
+    if (NULL != update.sets[kind]) {
+      close_set(update.sets[kind], &update.header);
+    }
+  }
+  return RC_OK;
+}
+
+/* slot of the complete set the satellite is part of, or -1 */
+static int8_t served_slot(const rtcm3_ssr_set *set, const uint32_t seq[2]) {
+  if (0 == set->complete_seq || seq[set->complete_slot] != set->complete_seq) {
+    return -1;
+  }
+  return (int8_t)set->complete_slot;
+}
+
+static uint32_t age(rtcm_constellation_t constellation,
+                    uint32_t epoch_time,
+                    uint32_t time_s) {
+  uint32_t period_s = RTCM_CONSTELLATION_GLO == constellation
+                          ? SECONDS_PER_DAY
+                          : SECONDS_PER_WEEK;
+  return (time_s % period_s + period_s - epoch_time % period_s) % period_s;
+}
+
+static bool fresh(const rtcm3_ssr_store *store,
+                  rtcm_constellation_t constellation,
+                  uint32_t epoch_time,
+                  uint32_t time_s) {
+  return age(constellation, epoch_time, time_s) <= store->max_age_s;
+}
+
+/** Look up the corrections of one satellite and signal
+ *
+ * Orbit and clock come from the last complete sets of their kind and are
+ * served when they share the IOD SSR and are at most max_age_s old. The
+ * biases, the URA and a high rate clock no older than the clock are added
+ * when their IOD SSR matches as well.
+ *
+ * \param store The store
+ * \param constellation Constellation of the satellite
+ * \param sat_id Satellite ID as in the SSR messages
+ * \param signal_id Signal ID of the biases
+ * \param time_s Time in seconds of the week, or of the day for GLONASS
+ * \param corr Set to the corrections
+ * \return true if an orbit and a clock correction are available
+ */
+bool rtcm3_ssr_store_lookup(const rtcm3_ssr_store *store,
+                            rtcm_constellation_t constellation,
+                            uint8_t sat_id,
+                            uint8_t signal_id,
+                            uint32_t time_s,
+                            rtcm3_ssr_corrections *corr) {
+  assert(store);
+  assert(corr);
+  memset(corr, 0, sizeof(*corr));
+  if (constellation < 0 || constellation >= RTCM_CONSTELLATION_COUNT ||
+      sat_id >= RTCM3_SSR_STORE_MAX_SATS ||
+      signal_id >= RTCM3_SSR_STORE_MAX_SIGNALS) {
+    return false;
+  }
+  const rtcm3_ssr_sat *sat = &store->sats[constellation][sat_id];
+  const rtcm3_ssr_set *sets = store->sets[constellation];
+
+  const rtcm3_ssr_set *orbit_set = &sets[RTCM3_SSR_ORBIT];
+  const rtcm3_ssr_set *clock_set = &sets[RTCM3_SSR_CLOCK];
+  int8_t orbit_slot = served_slot(orbit_set, sat->orbit_seq);
+  int8_t clock_slot = served_slot(clock_set, sat->clock_seq);
+  if (orbit_slot < 0 || clock_slot < 0 ||
+      orbit_set->complete_iod_ssr != clock_set->complete_iod_ssr ||
+      !fresh(store, constellation, orbit_set->complete_epoch_time, time_s) ||
+      !fresh(store, constellation, clock_set->complete_epoch_time, time_s)) {
+    return false;
+  }
+  uint8_t iod_ssr = orbit_set->complete_iod_ssr;
+  corr->iod_ssr = iod_ssr;
+  corr->orbit_epoch_time = orbit_set->complete_epoch_time;
+  corr->clock_epoch_time = clock_set->complete_epoch_time;
+  corr->orbit = &sat->orbit[orbit_slot];
+  corr->clock = &sat->clock[clock_slot];
+
+  uint32_t signal_bit = 1u << signal_id;
+  const rtcm3_ssr_set *code_set = &sets[RTCM3_SSR_CODE_BIAS];
+  int8_t slot = served_slot(code_set, sat->code_bias_seq);
+  if (slot >= 0 && code_set->complete_iod_ssr == iod_ssr &&
+      (sat->code_bias_mask[slot] & signal_bit)) {
+    corr->code_bias = &sat->code_bias[slot][signal_id];
+  }
+  const rtcm3_ssr_set *phase_set = &sets[RTCM3_SSR_PHASE_BIAS];
+  slot = served_slot(phase_set, sat->phase_bias_seq);
+  if (slot >= 0 && phase_set->complete_iod_ssr == iod_ssr) {
+    if (sat->phase_bias_mask[slot] & signal_bit) {
+      corr->phase_bias = &sat->phase_bias[slot][signal_id];
+    }
+    corr->yaw_angle = sat->yaw_angle[slot];
+    corr->yaw_rate = sat->yaw_rate[slot];
+  }
+
+  const rtcm3_ssr_clock_sat *clock_sat =
+      &store->clocks.sats[constellation][sat_id];
+  /* a high rate clock older than the clock it refines is left out */
+  if (clock_sat->has_hr_clock && clock_sat->hr_clock_iod_ssr == iod_ssr &&
+      age(constellation, clock_sat->hr_clock_epoch_time, time_s) <=
+          age(constellation, corr->clock_epoch_time, time_s)) {
+    corr->high_rate_clock = &clock_sat->high_rate_clock;
+  }
+  if (clock_sat->has_ura && clock_sat->ura_iod_ssr == iod_ssr &&
+      fresh(store, constellation, clock_sat->ura_epoch_time, time_s)) {
+    corr->ura = &clock_sat->ura;
+  }
+  return true;
+}
@@ -0,0 +1,238 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include "rtcm3/station_registry.h"
+#include <assert.h>
+#include <string.h>
+#include "rtcm3/bits.h"
+#include "rtcm3/decode.h"
+
+/* index into the payload hashes of a station */
+typedef enum {
+  STATION_MSG_1005 = 0,
+  STATION_MSG_1006,
+  STATION_MSG_1007,
+  STATION_MSG_1008,
+  STATION_MSG_1033,
+  STATION_MSG_1230,
+} station_msg;
+
+static int8_t find_station_msg(uint16_t msg_num) {
+  switch (msg_num) {
+    case 1005:
+      return STATION_MSG_1005;
+    case 1006:
+      return STATION_MSG_1006;
+    case 1007:
+      return STATION_MSG_1007;
+    case 1008:
+      return STATION_MSG_1008;
+    case 1033:
+      return STATION_MSG_1033;
+    case 1230:
+      return STATION_MSG_1230;
+    default:
+      return -1;
+  }
+}
+
+/* Longest payload of each message type, with every string at its maximum of
+ * 31 characters, and where the last one is kept in rtcm3_station.payloads */
+static const struct {
+  uint16_t max_len;
+  uint16_t offset;
+} payload_slots[RTCM3_STATION_MSG_TYPES] = {
+    {19, 0},    /* 1005 */
+    {21, 19},   /* 1006 */
+    {36, 40},   /* 1007 */
+    {68, 76},   /* 1008 */
+    {164, 144}, /* 1033 */
+    {12, 308},  /* 1230 */
+};
+
+/* Multiply and fold over 64 bit words, the tail zero padded. The metadata
+ * payloads are up to a few hundred bytes and are hashed on every repeat, a
+ * byte at a time would cost more than decoding them. */
+static uint64_t hash_payload(const uint8_t payload[], uint16_t len) {
+  uint64_t hash = len;
+  uint16_t i = 0;
+  for (; i + 8 <= len; i += 8) {
+    uint64_t word;
+    memcpy(&word, &payload[i], sizeof(word));
+    hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+    hash ^= hash >> 32;
+  }
+  uint64_t tail = 0;
+  memcpy(&tail, &payload[i], len - i);
+  hash = (hash ^ tail) * 0x9e3779b97f4a7c15ULL;
+  return hash ^ (hash >> 32);
+}
+
+/* Decode a payload into a copy of the station info. 1005 and 1006, and 1007
+ * and 1008, write the same fields, so new content of one of them forgets the
+ * hash of the other, which then no longer matches what is stored. */
+static rtcm3_rc decode_station_msg(station_msg type,
+                                   const uint8_t payload[],
+                                   rtcm3_station *station,
+                                   rtcm3_station_info *info) {
+  rtcm3_rc ret = RC_INVALID_MESSAGE;
+  uint8_t have = 0;
+  int8_t sibling = -1;
+  switch (type) {
+    case STATION_MSG_1005:
+      ret = rtcm3_decode_1005(payload, &info->arp.msg_1005);
+      have = RTCM3_STATION_ARP;
+      sibling = STATION_MSG_1006;
+      break;
+    case STATION_MSG_1006:
+      ret = rtcm3_decode_1006(payload, &info->arp);
+      have = RTCM3_STATION_ARP | RTCM3_STATION_ARP_HEIGHT;
+      sibling = STATION_MSG_1005;
+      break;
+    case STATION_MSG_1007:
+      ret = rtcm3_decode_1007(payload, &info->antenna.msg_1007);
+      have = RTCM3_STATION_ANTENNA;
+      sibling = STATION_MSG_1008;
+      break;
+    case STATION_MSG_1008:
+      ret = rtcm3_decode_1008(payload, &info->antenna);
+      have = RTCM3_STATION_ANTENNA | RTCM3_STATION_ANTENNA_SERIAL;
+      sibling = STATION_MSG_1007;
+      break;
+    case STATION_MSG_1033:
+      ret = rtcm3_decode_1033(payload, &info->descriptors);
+      have = RTCM3_STATION_DESCRIPTORS;
+      break;
+    case STATION_MSG_1230:
+      ret = rtcm3_decode_1230(payload, &info->glo_biases);
+      have = RTCM3_STATION_GLO_BIASES;
+      break;
+    default:
+      break;
+  }
+  if (RC_OK == ret) {
+    info->have |= have;
+    if (sibling >= 0) {
+      station->payload_len[sibling] = 0;
+    }
+  }
+  return ret;
+}
+
+/** Empty a station registry
+ *
+ * \param registry The registry, typically static as it holds every station
+ */
+void rtcm3_station_registry_init(rtcm3_station_registry *registry) {
+  assert(registry);
+  memset(registry, 0, sizeof(*registry));
+}
+
+/** Add a station metadata message to the registry
+ *
+ * The payload is hashed and compared with the last payload of the same type
+ * from the station, only a message with new content is decoded and published
+ * to the readers.
+ *
+ * \param registry The registry
+ * \param payload The message, without the frame header
+ * \param payload_len Length of the payload in bytes
+ * \param is_new Set to whether the content differs from the last message
+ * \return - RC_OK : Success
+ *         - RC_MESSAGE_TYPE_MISMATCH : Not a station metadata message
+ *         - RC_INVALID_MESSAGE : Too short or too long, or as the decoder
+ *           reports
+ */
+rtcm3_rc rtcm3_station_registry_update(rtcm3_station_registry *registry,
+                                       const uint8_t payload[],
+                                       uint16_t payload_len,
+                                       bool *is_new) {
+  assert(registry);
+  assert(is_new);
+  if (payload_len < 3) {
+    return RC_INVALID_MESSAGE;
+  }
+  int8_t type = find_station_msg((uint16_t)rtcm_getbitu(payload, 0, 12));
+  if (type < 0) {
+    return RC_MESSAGE_TYPE_MISMATCH;
+  }
+  if (payload_len > payload_slots[type].max_len) {
+    return RC_INVALID_MESSAGE;
+  }
+  uint16_t stn_id = (uint16_t)rtcm_getbitu(payload, 12, 12);
+  rtcm3_station *station = &registry->stations[stn_id];
+  uint8_t *last = &station->payloads[payload_slots[type].offset];
+
+  /* the hash is cheap to forge, a hit is confirmed on the payload itself */
+  uint64_t hash = hash_payload(payload, payload_len);
+  if (station->payload_len[type] == payload_len &&
+      station->hash[type] == hash &&
+      memcmp(last, payload, payload_len) == 0) {
+    registry->duplicates++;
+    *is_new = false;
+    return RC_OK;
+  }
+
+  /* the payloads and the info are only written here, so the writer reads them
+   * without the sequence counter */
+  rtcm3_station_info info = station->info;
+  rtcm3_rc ret = decode_station_msg((station_msg)type, payload, station, &info);
+  if (RC_OK != ret) {
+    return ret;
+  }
+  station->payload_len[type] = payload_len;
+  station->hash[type] = hash;
+  memcpy(last, payload, payload_len);
+
+  uint32_t seq = station->seq;
+  __atomic_store_n(&station->seq, seq + 1, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+  memcpy(&station->info, &info, sizeof(info));
+  __atomic_store_n(&station->seq, seq + 2, __ATOMIC_RELEASE);
+
+  registry->decoded++;
+  *is_new = true;
+  return RC_OK;
+}
+
+/** Current metadata of a station
+ *
+ * Safe to call from any thread while another updates the registry. The copy
+ * is retried until it did not overlap an update of the station.
+ *
+ * \param registry The registry
+ * \param stn_id Reference station ID
+ * \param info Set to a consistent copy of the station metadata
+ * \return Whether any metadata of the station has been received
+ */
+bool rtcm3_station_registry_get(const rtcm3_station_registry *registry,
+                                uint16_t stn_id,
+                                rtcm3_station_info *info) {
+  assert(registry);
+  assert(info);
+  if (stn_id > RTCM3_STATION_MAX_ID) {
+    return false;
+  }
+  const rtcm3_station *station = &registry->stations[stn_id];
+  for (;;) {
+    uint32_t seq = __atomic_load_n(&station->seq, __ATOMIC_ACQUIRE);
+    if (seq & 1) {
+      continue;
+    }
+    memcpy(info, &station->info, sizeof(*info));
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    if (__atomic_load_n(&station->seq, __ATOMIC_RELAXED) == seq) {
+      break;
+    }
+  }
+  return 0 != info->have;
+}
@@ -0,0 +1,241 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+#include <rtcm3/timing.h>
+#include <string.h>
+
+/* The histograms can be updated from several decoding threads at once, so all
+ * the counters are updated with relaxed atomics and a slot is claimed with a
+ * compare-and-swap on its key. */
+static rtcm_timing_histogram histograms_[RTCM_TIMING_MAX_HISTOGRAMS];
+
+static uint32_t make_key(rtcm_timing_op op, uint16_t msg_num) {
+  /* offset by one so that zero marks an unused slot */
+  return (((uint32_t)op << 16) | msg_num) + 1;
+}
+
+/** Map a duration onto its log-linear bucket
+ *
+ * \param value Duration in ns
+ * \return Bucket index in range [0, RTCM_TIMING_NUM_BUCKETS)
+ */
+static uint16_t bucket_index(uint64_t value) {
+  if (value < RTCM_TIMING_SUB_BUCKETS) {
+    return (uint16_t)value;
+  }
+  if (value >> RTCM_TIMING_MAX_MAGNITUDE) {
+    return RTCM_TIMING_NUM_BUCKETS - 1;
+  }
+  /* position of the most significant bit */
+  uint8_t magnitude = (uint8_t)(63 - __builtin_clzll(value));
+  uint8_t shift = magnitude - RTCM_TIMING_SUB_BUCKET_BITS;
+  uint16_t sub_bucket = (uint16_t)(value >> shift) - RTCM_TIMING_SUB_BUCKETS;
+  return (uint16_t)((shift + 1) * RTCM_TIMING_SUB_BUCKETS + sub_bucket);
+}
+
+/** Highest duration that maps onto the given bucket */
+static uint64_t bucket_upper_bound(uint16_t index) {
+  uint16_t group = index / RTCM_TIMING_SUB_BUCKETS;
+  uint64_t sub_bucket = index % RTCM_TIMING_SUB_BUCKETS;
+  if (0 == group) {
+    return sub_bucket;
+  }
+  uint8_t shift = group - 1;
+  uint64_t lowest = (RTCM_TIMING_SUB_BUCKETS + sub_bucket) << shift;
+  return lowest + (((uint64_t)1) << shift) - 1;
+}
+
+static rtcm_timing_histogram *find_slot(uint32_t key, bool create) {
+  uint32_t start = key % RTCM_TIMING_MAX_HISTOGRAMS;
+  for (uint32_t i = 0; i < RTCM_TIMING_MAX_HISTOGRAMS; i++) {
+    rtcm_timing_histogram *hist =
+        &histograms_[(start + i) % RTCM_TIMING_MAX_HISTOGRAMS];
+    uint32_t slot_key = __atomic_load_n(&hist->key, __ATOMIC_ACQUIRE);
+    if (slot_key == key) {
+      return hist;
+    }
+    if (0 != slot_key) {
+      continue;
+    }
+    if (!create) {
+      return NULL;
+    }
+    uint32_t expected = 0;
+    if (__atomic_compare_exchange_n(&hist->key,
+                                    &expected,
+                                    key,
+                                    false,
+                                    __ATOMIC_ACQ_REL,
+                                    __ATOMIC_ACQUIRE) ||
+        expected == key) {
+      return hist;
+    }
+  }
+  /* table full */
+  return NULL;
+}
+
+/** Add one duration sample to the histogram of a message type
+ *
+ * Durations are clamped to at least 1 ns so that a zero minimum can mark an
+ * empty histogram. Samples are dropped silently once more than
+ * RTCM_TIMING_MAX_HISTOGRAMS distinct message types have been seen.
+ *
+ * \param op Decode or encode
+ * \param msg_num RTCM message number
+ * \param duration_ns Duration of the call in ns
+ */
+void rtcm_timing_record(rtcm_timing_op op,
+                        uint16_t msg_num,
+                        uint64_t duration_ns) {
+  rtcm_timing_histogram *hist = find_slot(make_key(op, msg_num), true);
+  if (NULL == hist) {
+    return;
+  }
+  if (0 == duration_ns) {
+    duration_ns = 1;
+  }
+
+  __atomic_fetch_add(
+      &hist->buckets[bucket_index(duration_ns)], 1, __ATOMIC_RELAXED);
+  __atomic_fetch_add(&hist->total_ns, duration_ns, __ATOMIC_RELAXED);
+
+  uint64_t cur = __atomic_load_n(&hist->min_ns, __ATOMIC_RELAXED);
+  while ((0 == cur || duration_ns < cur) &&
+         !__atomic_compare_exchange_n(&hist->min_ns,
+                                      &cur,
+                                      duration_ns,
+                                      true,
+                                      __ATOMIC_RELAXED,
+                                      __ATOMIC_RELAXED)) {
+  }
+  cur = __atomic_load_n(&hist->max_ns, __ATOMIC_RELAXED);
+  while (duration_ns > cur &&
+         !__atomic_compare_exchange_n(&hist->max_ns,
+                                      &cur,
+                                      duration_ns,
+                                      true,
+                                      __ATOMIC_RELAXED,
+                                      __ATOMIC_RELAXED)) {
+  }
+
+  /* count last, readers use it as the total of the buckets */
+  __atomic_fetch_add(&hist->count, 1, __ATOMIC_RELEASE);
+}
+
+/** Look up the histogram of a message type
+ *
+ * \param op Decode or encode
+ * \param msg_num RTCM message number
+ * \return The histogram, or NULL if nothing has been recorded for it
+ */
+const rtcm_timing_histogram *rtcm_timing_get(rtcm_timing_op op,
+                                             uint16_t msg_num) {
+  return find_slot(make_key(op, msg_num), false);
+}
+
+/** Get a percentile of the recorded durations
+ *
+ * The result is the highest duration that falls into the same bucket as the
+ * requested percentile, so it never under-reports the latency.
+ *
+ * \param hist The histogram
+ * \param percentile Percentile in range [0, 100]
+ * \return Duration in ns, 0 for an empty histogram
+ */
+uint64_t rtcm_timing_percentile(const rtcm_timing_histogram *hist,
+                                double percentile) {
+  uint64_t count = __atomic_load_n(&hist->count, __ATOMIC_ACQUIRE);
+  if (0 == count) {
+    return 0;
+  }
+  if (percentile > 100.0) {
+    percentile = 100.0;
+  }
+  /* rank of the sample at the requested percentile, at least 1 */
+  uint64_t rank = (uint64_t)(percentile / 100.0 * (double)count + 0.5);
+  if (rank < 1) {
+    rank = 1;
+  }
+
+  uint64_t max_ns = __atomic_load_n(&hist->max_ns, __ATOMIC_RELAXED);
+  uint64_t seen = 0;
+  for (uint16_t i = 0; i < RTCM_TIMING_NUM_BUCKETS; i++) {
+    seen += __atomic_load_n(&hist->buckets[i], __ATOMIC_RELAXED);
+    if (seen >= rank) {
+      if (RTCM_TIMING_NUM_BUCKETS - 1 == i) {
+        /* the overflow bucket has no upper bound of its own */
+        return max_ns;
+      }
+      uint64_t value = bucket_upper_bound(i);
+      return value < max_ns ? value : max_ns;
+    }
+  }
+  return max_ns;
+}
+
+static void fill_stats(const rtcm_timing_histogram *hist,
+                       rtcm_timing_stats *stats) {
+  uint32_t key = __atomic_load_n(&hist->key, __ATOMIC_ACQUIRE) - 1;
+  stats->msg_num = (uint16_t)(key & 0xFFFF);
+  stats->op = (uint8_t)(key >> 16);
+  stats->count = __atomic_load_n(&hist->count, __ATOMIC_ACQUIRE);
+  stats->min_ns = __atomic_load_n(&hist->min_ns, __ATOMIC_RELAXED);
+  stats->max_ns = __atomic_load_n(&hist->max_ns, __ATOMIC_RELAXED);
+  stats->mean_ns =
+      stats->count > 0
+          ? (double)__atomic_load_n(&hist->total_ns, __ATOMIC_RELAXED) /
+                (double)stats->count
+          : 0.0;
+  stats->p50_ns = rtcm_timing_percentile(hist, 50.0);
+  stats->p99_ns = rtcm_timing_percentile(hist, 99.0);
+  stats->p999_ns = rtcm_timing_percentile(hist, 99.9);
+}
+
+/** Export the summary statistics of a message type
+ *
+ * \param op Decode or encode
+ * \param msg_num RTCM message number
+ * \param stats Output statistics
+ * \return true if anything has been recorded for the message type
+ */
+bool rtcm_timing_get_stats(rtcm_timing_op op,
+                           uint16_t msg_num,
+                           rtcm_timing_stats *stats) {
+  const rtcm_timing_histogram *hist = rtcm_timing_get(op, msg_num);
+  if (NULL == hist) {
+    return false;
+  }
+  fill_stats(hist, stats);
+  return true;
+}
+
+/** Call `callback` with the statistics of every non-empty histogram
+ *
+ * \param callback Function to call
+ * \param context Passed through to the callback
+ */
+void rtcm_timing_foreach(rtcm_timing_callback callback, void *context) {
+  for (uint16_t i = 0; i < RTCM_TIMING_MAX_HISTOGRAMS; i++) {
+    const rtcm_timing_histogram *hist = &histograms_[i];
+    if (0 == __atomic_load_n(&hist->key, __ATOMIC_ACQUIRE) ||
+        0 == __atomic_load_n(&hist->count, __ATOMIC_ACQUIRE)) {
+      continue;
+    }
+    rtcm_timing_stats stats;
+    fill_stats(hist, &stats);
+    callback(&stats, context);
+  }
+}
+
+/** Clear all the histograms. Must not run concurrently with recording. */
+void rtcm_timing_reset(void) { memset(histograms_, 0, sizeof(histograms_)); }
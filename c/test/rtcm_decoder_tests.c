@@ -12,15 +12,42 @@
 
 #include "rtcm_decoder_tests.h"
 #include <assert.h>
+#include <errno.h>
 #include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include "rtcm3/archive.h"
 #include "rtcm3/bits.h"
 #include "rtcm3/decode.h"
+#include "rtcm3/dispatch.h"
 #include "rtcm3/encode.h"
+#include "rtcm3/eph_cache.h"
+#include "rtcm3/eph_decode.h"
+#include "rtcm3/eph_encode.h"
+#include "rtcm3/eph_store.h"
+#include "rtcm3/frame.h"
+#include "rtcm3/frame_iov.h"
+#include "rtcm3/glo_fcn.h"
+#include "rtcm3/glo_orbit.h"
+#include "rtcm3/kepler.h"
 #include "rtcm3/messages.h"
 #include "rtcm3/msm_utils.h"
+#include "rtcm3/parallel.h"
+#include "rtcm3/patch.h"
+#include "rtcm3/pipeline.h"
+#include "rtcm3/ring.h"
+#include "rtcm3/sbp_tunnel.h"
+#include "rtcm3/ssr_apply.h"
+#include "rtcm3/ssr_decode.h"
+#include "rtcm3/ssr_encode.h"
+#include "rtcm3/ssr_store.h"
+#include "rtcm3/station_registry.h"
+#include "rtcm3/timing.h"
 
 #define LIBRTCM_LOG_INTERNAL
 #include "rtcm3/logging.h"
@@ -48,6 +75,33 @@ int main(void) {
   test_rtcm_4062();
   test_rtcm_random_bits();
   test_logging();
+  test_timing();
+  test_frame();
+  test_frame_scanner();
+  test_archive();
+  test_parallel_scan();
+  test_stream_framer();
+  test_rings();
+  test_pipeline();
+  test_decode_batch();
+  test_frame_iov();
+  test_encoded_size();
+  test_patch();
+  test_msm_epoch();
+  test_eph_store();
+  test_eph_encode();
+  test_eph_cache();
+  test_kepler();
+  test_glo_orbit();
+  test_ssr_store();
+  test_ssr_visit();
+  test_ssr_encode();
+  test_ssr_hr_clock();
+  test_ssr_apply();
+  test_bytes();
+  test_sbp_tunnel();
+  test_station_registry();
+  test_glo_fcn();
 }
 
 void test_rtcm_1001(void) {
@@ -92,7 +146,8 @@ void test_rtcm_1001(void) {
 
   uint8_t buff[1024];
   memset(buff, 0, 1024);
-  rtcm3_encode_1001(&msg1001, buff);
+  uint16_t num_bytes = rtcm3_encode_1001(&msg1001, buff);
+  assert(num_bytes == rtcm3_encoded_size_1001(&msg1001));
 
   rtcm_obs_message msg1001_out;
   int8_t ret = rtcm3_decode_1001(buff, &msg1001_out);
@@ -148,7 +203,8 @@ void test_rtcm_1002(void) {
 
   uint8_t buff[1024];
   memset(buff, 0, 1024);
-  rtcm3_encode_1002(&msg1002, buff);
+  uint16_t num_bytes = rtcm3_encode_1002(&msg1002, buff);
+  assert(num_bytes == rtcm3_encoded_size_1002(&msg1002));
 
   rtcm_obs_message msg1002_out;
   int8_t ret = rtcm3_decode_1002(buff, &msg1002_out);
@@ -208,7 +264,8 @@ void test_rtcm_1003(void) {
 
   uint8_t buff[1024];
   memset(buff, 0, 1024);
-  rtcm3_encode_1003(&msg1003, buff);
+  uint16_t num_bytes = rtcm3_encode_1003(&msg1003, buff);
+  assert(num_bytes == rtcm3_encoded_size_1003(&msg1003));
 
   rtcm_obs_message msg1003_out;
   int8_t ret = rtcm3_decode_1003(buff, &msg1003_out);
@@ -310,7 +367,8 @@ void test_rtcm_1004(void) {
 
   uint8_t buff[1024];
   memset(buff, 0, 1024);
-  rtcm3_encode_1004(&msg1004, buff);
+  uint16_t num_bytes = rtcm3_encode_1004(&msg1004, buff);
+  assert(num_bytes == rtcm3_encoded_size_1004(&msg1004));
 
   rtcm_obs_message msg1004_out;
   int8_t ret = rtcm3_decode_1004(buff, &msg1004_out);
@@ -335,7 +393,8 @@ void test_rtcm_1005(void) {
 
   uint8_t buff[1024];
   memset(buff, 0, 1024);
-  rtcm3_encode_1005(&msg1005, buff);
+  uint16_t num_bytes = rtcm3_encode_1005(&msg1005, buff);
+  assert(num_bytes == rtcm3_encoded_size_1005(&msg1005));
 
   rtcm_msg_1005 msg1005_out;
   int8_t ret = rtcm3_decode_1005(buff, &msg1005_out);
@@ -361,7 +420,8 @@ void test_rtcm_1006(void) {
 
   uint8_t buff[1024];
   memset(buff, 0, 1024);
-  rtcm3_encode_1006(&msg1006, buff);
+  uint16_t num_bytes = rtcm3_encode_1006(&msg1006, buff);
+  assert(num_bytes == rtcm3_encoded_size_1006(&msg1006));
 
   rtcm_msg_1006 msg1006_out;
   int8_t ret = rtcm3_decode_1006(buff, &msg1006_out);
@@ -379,7 +439,8 @@ void test_rtcm_1007(void) {
 
   uint8_t buff[1024];
   memset(buff, 0, 1024);
-  rtcm3_encode_1007(&msg1007, buff);
+  uint16_t num_bytes = rtcm3_encode_1007(&msg1007, buff);
+  assert(num_bytes == rtcm3_encoded_size_1007(&msg1007));
 
   rtcm_msg_1007 msg1007_out;
   int8_t ret = rtcm3_decode_1007(buff, &msg1007_out);
@@ -399,7 +460,8 @@ void test_rtcm_1008(void) {
 
   uint8_t buff[1024];
   memset(buff, 0, 1024);
-  rtcm3_encode_1008(&msg1008, buff);
+  uint16_t num_bytes = rtcm3_encode_1008(&msg1008, buff);
+  assert(num_bytes == rtcm3_encoded_size_1008(&msg1008));
 
   rtcm_msg_1008 msg1008_out;
   int8_t ret = rtcm3_decode_1008(buff, &msg1008_out);
@@ -458,7 +520,8 @@ void test_rtcm_1010(void) {
 
   uint8_t buff[1024];
   memset(buff, 0, 1024);
-  rtcm3_encode_1010(&msg1010, buff);
+  uint16_t num_bytes = rtcm3_encode_1010(&msg1010, buff);
+  assert(num_bytes == rtcm3_encoded_size_1010(&msg1010));
 
   rtcm_obs_message msg1010_out;
   int8_t ret = rtcm3_decode_1010(buff, &msg1010_out);
@@ -545,7 +608,8 @@ void test_rtcm_1012(void) {
 
   uint8_t buff[1024];
   memset(buff, 0, 1024);
-  rtcm3_encode_1012(&msg1012, buff);
+  uint16_t num_bytes = rtcm3_encode_1012(&msg1012, buff);
+  assert(num_bytes == rtcm3_encoded_size_1012(&msg1012));
 
   rtcm_obs_message msg1012_out;
   int8_t ret = rtcm3_decode_1012(buff, &msg1012_out);
@@ -613,7 +677,9 @@ void test_rtcm_1029(void) {
 
   uint8_t buff[1024];
   memset(buff, 0, 1024);
-  rtcm3_encode_1029(&msg1029, buff);
+  uint16_t num_bytes = rtcm3_encode_1029(&msg1029, buff);
+  assert(num_bytes == rtcm3_encoded_size_1029(&msg1029));
+  assert(num_bytes == sizeof(sample_1029_raw));
 
   for (uint16_t i = 0; i < sizeof(sample_1029_raw); i++) {
     assert(buff[i] == sample_1029_raw[i]);
@@ -623,6 +689,17 @@ void test_rtcm_1029(void) {
   int8_t ret = rtcm3_decode_1029(buff, &msg1029_out);
 
   assert(RC_OK == ret && msg1029_equals(&msg1029, &msg1029_out));
+
+  /* the view leaves the text in the frame */
+  rtcm_msg_1029_view view;
+  assert(RC_OK == rtcm3_decode_1029_view(buff, &view));
+  assert(view.stn_id == msg1029.stn_id && view.mjd_num == msg1029.mjd_num &&
+         view.utc_sec_of_day == msg1029.utc_sec_of_day &&
+         view.unicode_chars == msg1029.unicode_chars &&
+         view.utf8_code_units_n == msg1029.utf8_code_units_n);
+  assert(view.utf8_code_units == &buff[9]);
+  assert(RC_MESSAGE_TYPE_MISMATCH ==
+         rtcm3_decode_1029_view(sample_1029_raw + 1, &view));
 }
 
 void test_rtcm_1033(void) {
@@ -642,7 +719,8 @@ void test_rtcm_1033(void) {
 
   uint8_t buff[1024];
   memset(buff, 0, 1024);
-  rtcm3_encode_1033(&msg1033, buff);
+  uint16_t num_bytes = rtcm3_encode_1033(&msg1033, buff);
+  assert(num_bytes == rtcm3_encoded_size_1033(&msg1033));
 
   rtcm_msg_1033 msg1033_out;
   int8_t ret = rtcm3_decode_1033(buff, &msg1033_out);
@@ -663,7 +741,8 @@ void test_rtcm_1230(void) {
 
   uint8_t buff[1024];
   memset(buff, 0, 1024);
-  rtcm3_encode_1230(&msg1230, buff);
+  uint16_t num_bytes = rtcm3_encode_1230(&msg1230, buff);
+  assert(num_bytes == rtcm3_encoded_size_1230(&msg1230));
 
   rtcm_msg_1230 msg1230_out_1;
   int8_t ret = rtcm3_decode_1230(buff, &msg1230_out_1);
@@ -672,7 +751,8 @@ void test_rtcm_1230(void) {
 
   msg1230.fdma_signal_mask = 0x0D;
   memset(buff, 0, 1024);
-  rtcm3_encode_1230(&msg1230, buff);
+  num_bytes = rtcm3_encode_1230(&msg1230, buff);
+  assert(num_bytes == rtcm3_encoded_size_1230(&msg1230));
 
   rtcm_msg_1230 msg1230_out_2;
   ret = rtcm3_decode_1230(buff, &msg1230_out_2);
@@ -1468,6 +1548,7 @@ void test_rtcm_msm4(void) {
   memset(buff, 0, 1024);
   uint16_t num_bytes = rtcm3_encode_msm4(&msg_msm4, buff);
   assert(num_bytes > 0 && num_bytes < 1024);
+  assert(num_bytes == rtcm3_encoded_size_msm4(&msg_msm4));
 
   rtcm_msm_message msg_msm4_out;
   int8_t ret = rtcm3_decode_msm4(buff, &msg_msm4_out);
@@ -1569,6 +1650,7 @@ void test_rtcm_msm5(void) {
   memset(buff, 0, 1024);
   uint16_t num_bytes = rtcm3_encode_msm5(&msg_msm5, buff);
   assert(num_bytes > 0 && num_bytes < 1024);
+  assert(num_bytes == rtcm3_encoded_size_msm5(&msg_msm5));
 
   rtcm_msm_message msg_msm5_out;
   int8_t ret = rtcm3_decode_msm5(buff, &msg_msm5_out);
@@ -1673,6 +1755,7 @@ void test_rtcm_msm5_glo(void) {
   memset(buff, 0, 1024);
   uint16_t num_bytes = rtcm3_encode_msm5(&msg_msm5, buff);
   assert(num_bytes > 0 && num_bytes < 1024);
+  assert(num_bytes == rtcm3_encoded_size_msm5(&msg_msm5));
 
   rtcm_msm_message msg_msm5_out;
   int8_t ret = rtcm3_decode_msm5(buff, &msg_msm5_out);
@@ -1710,6 +1793,7 @@ void test_rtcm_4062(void) {
 
   assert(num_bytes == (msg_in.len + 7));  // RTCM msg type + SBP msg type +
                                           // SBP sender id + SBP len
+  assert(num_bytes == rtcm3_encoded_size_4062(&msg_in));
 
   rtcm_msg_swift_proprietary msg_out;
   uint8_t ret = rtcm3_decode_4062(buff, &msg_out);
@@ -1720,6 +1804,15 @@ void test_rtcm_4062(void) {
   for (uint8_t i = 0; i < msg_in.len; ++i) {
     assert(msg_in.data[i] == msg_out.data[i]);
   }
+
+  /* the view leaves the payload in the frame */
+  rtcm_msg_swift_proprietary_view view;
+  assert(RC_OK == rtcm3_decode_4062_view(buff, &view));
+  assert(view.msg_type == msg_in.msg_type &&
+         view.sender_id == msg_in.sender_id && view.len == msg_in.len);
+  assert(view.data == &buff[7]);
+  rtcm_setbitu(buff, 12, 4, 1);
+  assert(RC_INVALID_MESSAGE == rtcm3_decode_4062_view(buff, &view));
 }
 
 void test_rtcm_random_bits(void) {
@@ -1752,6 +1845,7 @@ void test_rtcm_random_bits(void) {
       memset(out_buff, 0, sizeof(out_buff));
       uint16_t len = rtcm3_encode_msm4(&msg_msm, out_buff);
       assert(len > 0 && len < 1024);
+      assert(len == rtcm3_encoded_size_msm4(&msg_msm));
       rtcm_msm_message msg_msm_out;
       assert(RC_OK == rtcm3_decode_msm4(out_buff, &msg_msm_out) &&
              msg_msm_equals(&msg_msm, &msg_msm_out));
@@ -1762,6 +1856,7 @@ void test_rtcm_random_bits(void) {
       memset(out_buff, 0, sizeof(out_buff));
       uint16_t len = rtcm3_encode_msm5(&msg_msm, out_buff);
       assert(len > 0 && len < 1024);
+      assert(len == rtcm3_encoded_size_msm5(&msg_msm));
       rtcm_msm_message msg_msm_out;
       assert(RC_OK == rtcm3_decode_msm5(out_buff, &msg_msm_out) &&
              msg_msm_equals(&msg_msm, &msg_msm_out));
@@ -1875,3 +1970,2484 @@ void test_logging(void) {
 #undef TEST_LOG_LEVEL
 #undef TEST_LOG_MSG
 #undef TEST_LOG_LEN
+
+static void test_timing_callback(const rtcm_timing_stats *stats,
+                                 void *context) {
+  int *callback_count = (int *)context;
+  assert(stats->msg_num == 1004);
+  assert(stats->op == RTCM_TIMING_DECODE);
+  (*callback_count)++;
+}
+
+void test_timing(void) {
+  rtcm_timing_reset();
+  assert(NULL == rtcm_timing_get(RTCM_TIMING_DECODE, 1004));
+
+  for (uint64_t duration_ns = 1; duration_ns <= 100; duration_ns++) {
+    rtcm_timing_record(RTCM_TIMING_DECODE, 1004, duration_ns);
+  }
+
+  rtcm_timing_stats stats;
+  assert(!rtcm_timing_get_stats(RTCM_TIMING_ENCODE, 1004, &stats));
+  assert(rtcm_timing_get_stats(RTCM_TIMING_DECODE, 1004, &stats));
+  assert(stats.msg_num == 1004);
+  assert(stats.op == RTCM_TIMING_DECODE);
+  assert(stats.count == 100);
+  assert(stats.min_ns == 1);
+  assert(stats.max_ns == 100);
+  assert(fabs(stats.mean_ns - 50.5) < 1e-9);
+  /* percentiles are reported as the upper bound of their bucket */
+  assert(stats.p50_ns == 51);
+  assert(stats.p99_ns == 99);
+  assert(stats.p999_ns == 100);
+
+  const rtcm_timing_histogram *hist =
+      rtcm_timing_get(RTCM_TIMING_DECODE, 1004);
+  assert(NULL != hist);
+  assert(rtcm_timing_percentile(hist, 0.0) == 1);
+  assert(rtcm_timing_percentile(hist, 100.0) == 100);
+
+  /* values above the histogram range report the recorded maximum */
+  rtcm_timing_record(RTCM_TIMING_DECODE, 1004, ((uint64_t)1) << 40);
+  assert(rtcm_timing_percentile(hist, 100.0) == ((uint64_t)1) << 40);
+
+  int callback_count = 0;
+  rtcm_timing_foreach(test_timing_callback, &callback_count);
+  assert(callback_count == 1);
+
+  /* the top of the range has a bucket of its own, apart from the overflow */
+  rtcm_timing_reset();
+  rtcm_timing_record(RTCM_TIMING_DECODE, 1004, (((uint64_t)31) << 27) + 1);
+  rtcm_timing_record(RTCM_TIMING_DECODE, 1004, ((uint64_t)1) << 40);
+  hist = rtcm_timing_get(RTCM_TIMING_DECODE, 1004);
+  assert(NULL != hist);
+  assert(rtcm_timing_percentile(hist, 50.0) == (((uint64_t)1) << 32) - 1);
+  assert(rtcm_timing_percentile(hist, 100.0) == ((uint64_t)1) << 40);
+
+  rtcm_timing_reset();
+  assert(NULL == rtcm_timing_get(RTCM_TIMING_DECODE, 1004));
+}
+
+void test_frame(void) {
+  const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+  assert(rtcm3_crc24q(check, sizeof(check), 0) == 0xCDE703);
+  /* the checksum can be continued over several calls */
+  assert(rtcm3_crc24q(&check[4], 5, rtcm3_crc24q(check, 4, 0)) == 0xCDE703);
+
+  rtcm_msg_1005 msg_1005;
+  memset(&msg_1005, 0, sizeof(msg_1005));
+  msg_1005.stn_id = 7;
+  msg_1005.arp_x = 3573346.6;
+
+  uint8_t frame[RTCM3_MAX_FRAME_LEN];
+  uint16_t payload_len =
+      rtcm3_encode_1005(&msg_1005, &frame[RTCM3_FRAME_HEADER_LEN]);
+  uint16_t frame_len = rtcm3_frame_finalize(frame, payload_len);
+  assert(frame_len == payload_len + RTCM3_FRAME_OVERHEAD);
+  assert(frame[0] == RTCM3_PREAMBLE);
+  assert(((frame[1] & 0x3) << 8 | frame[2]) == payload_len);
+  /* the CRC over the whole frame including its parity is zero */
+  assert(rtcm3_crc24q(frame, frame_len, 0) == 0);
+
+  uint8_t payload[RTCM3_MAX_PAYLOAD_LEN];
+  memcpy(payload, &frame[RTCM3_FRAME_HEADER_LEN], payload_len);
+  uint8_t wrapped[RTCM3_MAX_FRAME_LEN];
+  assert(rtcm3_frame_wrap(payload, payload_len, wrapped) == frame_len);
+  assert(memcmp(wrapped, frame, frame_len) == 0);
+
+  rtcm_msg_1005 msg_1005_out;
+  assert(RC_OK ==
+         rtcm3_decode_1005(&frame[RTCM3_FRAME_HEADER_LEN], &msg_1005_out));
+  assert(msg_1005_out.stn_id == 7);
+
+  assert(rtcm3_frame_finalize(frame, RTCM3_MAX_PAYLOAD_LEN + 1) == 0);
+}
+
+/* Garbage, a 1005, a 1005 with a bad CRC, a 1033 and a truncated frame */
+static size_t make_frame_stream(uint8_t stream[], size_t offsets[2]) {
+  size_t len = 0;
+  const uint8_t garbage[] = {0x00, 0xD3, 0x00, 0x01, 0x55, 0xD3};
+  memcpy(stream, garbage, sizeof(garbage));
+  len += sizeof(garbage);
+
+  rtcm_msg_1005 msg_1005;
+  memset(&msg_1005, 0, sizeof(msg_1005));
+  msg_1005.stn_id = 11;
+  offsets[0] = len;
+  uint16_t payload_len =
+      rtcm3_encode_1005(&msg_1005, &stream[len + RTCM3_FRAME_HEADER_LEN]);
+  uint16_t frame_len = rtcm3_frame_finalize(&stream[len], payload_len);
+  len += frame_len;
+
+  memcpy(&stream[len], &stream[offsets[0]], frame_len);
+  stream[len + RTCM3_FRAME_HEADER_LEN + 4] ^= 0x10;
+  len += frame_len;
+
+  rtcm_msg_1033 msg_1033;
+  memset(&msg_1033, 0, sizeof(msg_1033));
+  msg_1033.stn_id = 12;
+  offsets[1] = len;
+  payload_len =
+      rtcm3_encode_1033(&msg_1033, &stream[len + RTCM3_FRAME_HEADER_LEN]);
+  len += rtcm3_frame_finalize(&stream[len], payload_len);
+
+  memcpy(&stream[len], &stream[offsets[0]], 10);
+  len += 10;
+  return len;
+}
+
+void test_frame_scanner(void) {
+  uint8_t stream[4 * RTCM3_MAX_FRAME_LEN];
+  size_t offsets[2];
+  size_t len = make_frame_stream(stream, offsets);
+
+  uint8_t single[RTCM3_MAX_FRAME_LEN];
+  memcpy(single, &stream[offsets[1]], len - offsets[1]);
+  uint16_t frame_len = rtcm3_frame_check(single, offsets[1] - offsets[0]);
+  assert(frame_len > 0);
+  assert(rtcm3_frame_check(single, frame_len - 1) == 0);
+  single[0] = 0;
+  assert(rtcm3_frame_check(single, frame_len) == 0);
+
+  rtcm3_frame_scanner scanner;
+  rtcm3_frame frame;
+  rtcm3_frame_scanner_init(&scanner, stream, len);
+
+  assert(rtcm3_frame_scanner_next(&scanner, &frame));
+  assert(frame.msg_num == 1005);
+  assert(frame.offset == offsets[0]);
+  /* the payload is a view into the scanned buffer */
+  assert(frame.payload == &stream[offsets[0] + RTCM3_FRAME_HEADER_LEN]);
+  rtcm_msg_1005 msg_1005;
+  assert(RC_OK == rtcm3_decode_1005(frame.payload, &msg_1005));
+  assert(msg_1005.stn_id == 11);
+
+  assert(rtcm3_frame_scanner_next(&scanner, &frame));
+  assert(frame.msg_num == 1033);
+  assert(frame.offset == offsets[1]);
+  rtcm_msg_1033 msg_1033;
+  assert(RC_OK == rtcm3_decode_1033(frame.payload, &msg_1033));
+  assert(msg_1033.stn_id == 12);
+
+  assert(!rtcm3_frame_scanner_next(&scanner, &frame));
+  assert(!rtcm3_frame_scanner_next(&scanner, &frame));
+  assert(scanner.num_frames == 2);
+  assert(scanner.num_crc_errors >= 1);
+  assert(scanner.pos == len);
+}
+
+void test_archive(void) {
+  uint8_t stream[4 * RTCM3_MAX_FRAME_LEN];
+  size_t offsets[2];
+  size_t len = make_frame_stream(stream, offsets);
+
+  char path[] = "/tmp/librtcm_archive_XXXXXX";
+  int fd = mkstemp(path);
+  assert(fd >= 0);
+  assert(write(fd, stream, len) == (ssize_t)len);
+  close(fd);
+
+  rtcm3_archive archive;
+  assert(rtcm3_archive_open(&archive, path) == 0);
+  assert(archive.len == len);
+  assert(memcmp(archive.data, stream, len) == 0);
+
+  rtcm3_frame_scanner scanner;
+  rtcm3_frame frame;
+  rtcm3_archive_scanner_init(&archive, &scanner);
+  assert(rtcm3_frame_scanner_next(&scanner, &frame));
+  assert(frame.msg_num == 1005);
+  assert(frame.payload >= archive.data &&
+         frame.payload < archive.data + archive.len);
+  assert(rtcm3_frame_scanner_next(&scanner, &frame));
+  assert(frame.msg_num == 1033);
+  assert(!rtcm3_frame_scanner_next(&scanner, &frame));
+  rtcm3_archive_close(&archive);
+  assert(archive.data == NULL);
+
+  /* an empty file maps to an empty archive */
+  fd = open(path, O_WRONLY | O_TRUNC);
+  assert(fd >= 0);
+  close(fd);
+  assert(rtcm3_archive_open(&archive, path) == 0);
+  assert(archive.len == 0);
+  rtcm3_archive_close(&archive);
+
+  unlink(path);
+  assert(rtcm3_archive_open(&archive, path) != 0);
+}
+
+#define PARALLEL_TEST_THREADS 4
+#define PARALLEL_TEST_MAX_FRAMES 2048
+
+typedef struct {
+  size_t slot_offsets[RTCM3_PARALLEL_NUM_SLOTS(PARALLEL_TEST_THREADS)]
+                     [PARALLEL_TEST_MAX_FRAMES];
+  size_t slot_counts[RTCM3_PARALLEL_NUM_SLOTS(PARALLEL_TEST_THREADS)];
+  size_t offsets[PARALLEL_TEST_MAX_FRAMES];
+  size_t num_frames;
+  size_t next_chunk;
+} parallel_test_context;
+
+static void parallel_test_frame(const rtcm3_frame *frame,
+                                unsigned slot,
+                                void *context) {
+  parallel_test_context *ctx = context;
+  rtcm_msg_1005 msg_1005;
+  assert(RC_OK == rtcm3_decode_1005(frame->payload, &msg_1005));
+  assert(msg_1005.stn_id == frame->offset % 4096);
+  ctx->slot_offsets[slot][ctx->slot_counts[slot]++] = frame->offset;
+}
+
+static void parallel_test_count(const rtcm3_frame *frame,
+                                unsigned slot,
+                                void *context) {
+  (void)frame;
+  (void)slot;
+  __atomic_fetch_add((size_t *)context, 1, __ATOMIC_RELAXED);
+}
+
+static void parallel_test_chunk(size_t chunk, unsigned slot, void *context) {
+  parallel_test_context *ctx = context;
+  assert(chunk == ctx->next_chunk++);
+  for (size_t i = 0; i < ctx->slot_counts[slot]; i++) {
+    ctx->offsets[ctx->num_frames++] = ctx->slot_offsets[slot][i];
+  }
+  ctx->slot_counts[slot] = 0;
+}
+
+void test_parallel_scan(void) {
+  /* 1005 frames tagged with their own offset, with garbage and corrupted
+   * frames mixed in */
+  static uint8_t stream[PARALLEL_TEST_MAX_FRAMES * 16];
+  size_t len = 0;
+  size_t num_frames = 0;
+  while (len + RTCM3_MAX_FRAME_LEN < sizeof(stream)) {
+    rtcm_msg_1005 msg_1005;
+    memset(&msg_1005, 0, sizeof(msg_1005));
+    msg_1005.stn_id = len % 4096;
+    uint16_t payload_len =
+        rtcm3_encode_1005(&msg_1005, &stream[len + RTCM3_FRAME_HEADER_LEN]);
+    uint16_t frame_len = rtcm3_frame_finalize(&stream[len], payload_len);
+    if (num_frames % 7 == 3) {
+      stream[len + frame_len - 1] ^= 0x01;
+    } else {
+      num_frames++;
+    }
+    len += frame_len;
+    if (num_frames % 5 == 2) {
+      stream[len++] = RTCM3_PREAMBLE;
+      stream[len++] = 0x00;
+    }
+  }
+
+  static rtcm3_frame_scanner scanner;
+  rtcm3_frame frame;
+  static size_t expected[PARALLEL_TEST_MAX_FRAMES];
+  size_t num_expected = 0;
+  rtcm3_frame_scanner_init(&scanner, stream, len);
+  while (rtcm3_frame_scanner_next(&scanner, &frame)) {
+    expected[num_expected++] = frame.offset;
+  }
+  assert(num_expected == num_frames);
+
+  /* chunks smaller than a frame, and chunks holding many frames */
+  const size_t chunk_sizes[] = {7, 100, 1000, 1 << 20};
+  for (size_t i = 0; i < sizeof(chunk_sizes) / sizeof(chunk_sizes[0]); i++) {
+    static parallel_test_context ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    rtcm3_parallel_config config;
+    memset(&config, 0, sizeof(config));
+    config.num_threads = PARALLEL_TEST_THREADS;
+    config.chunk_size = chunk_sizes[i];
+    config.ordered = true;
+    config.on_frame = parallel_test_frame;
+    config.on_chunk = parallel_test_chunk;
+    config.context = &ctx;
+
+    rtcm3_parallel_stats stats;
+    assert(rtcm3_parallel_scan(stream, len, &config, &stats) == 0);
+    assert(stats.num_frames == num_expected);
+    assert(stats.skipped_bytes == scanner.skipped_bytes);
+    assert(stats.num_chunks == (len + chunk_sizes[i] - 1) / chunk_sizes[i]);
+    assert(ctx.num_frames == num_expected);
+    assert(memcmp(ctx.offsets, expected, num_expected * sizeof(size_t)) == 0);
+  }
+
+  /* unordered, with as many threads as there are CPUs */
+  size_t count = 0;
+  rtcm3_parallel_config config;
+  memset(&config, 0, sizeof(config));
+  config.chunk_size = 64;
+  config.on_frame = parallel_test_count;
+  config.context = &count;
+  rtcm3_parallel_stats stats;
+  assert(rtcm3_parallel_scan(stream, len, &config, &stats) == 0);
+  assert(count == num_expected);
+  assert(stats.num_threads == rtcm3_parallel_num_threads(&config));
+}
+
+void test_stream_framer(void) {
+  uint8_t stream[4 * RTCM3_MAX_FRAME_LEN];
+  size_t offsets[2];
+  size_t len = make_frame_stream(stream, offsets);
+
+  /* the same frames come out whichever way the stream is cut up */
+  const size_t piece_sizes[] = {1, 2, 3, 7, 64, 4 * RTCM3_MAX_FRAME_LEN};
+  for (size_t i = 0; i < sizeof(piece_sizes) / sizeof(piece_sizes[0]); i++) {
+    rtcm3_stream_framer framer;
+    rtcm3_stream_framer_init(&framer);
+    size_t found = 0;
+    for (size_t pos = 0; pos < len;) {
+      size_t piece = len - pos < piece_sizes[i] ? len - pos : piece_sizes[i];
+      size_t taken = 0;
+      size_t consumed;
+      rtcm3_frame frame;
+      while (rtcm3_stream_framer_feed(
+          &framer, &stream[pos + taken], piece - taken, &consumed, &frame)) {
+        taken += consumed;
+        assert(found < 2);
+        assert(frame.offset == offsets[found]);
+        assert(frame.msg_num == (found == 0 ? 1005 : 1033));
+        assert(memcmp(frame.payload,
+                      &stream[offsets[found] + RTCM3_FRAME_HEADER_LEN],
+                      frame.payload_len) == 0);
+        found++;
+      }
+      pos += piece;
+    }
+    assert(found == 2);
+    assert(framer.num_frames == 2);
+    assert(framer.num_crc_errors >= 1);
+    assert(framer.pos == len);
+  }
+}
+
+#define RING_TEST_COUNT 100000
+
+typedef struct {
+  rtcm3_mpmc_queue *queue;
+  uint64_t sum;
+  uint32_t count;
+} mpmc_test_thread;
+
+static void *mpmc_test_producer(void *arg) {
+  mpmc_test_thread *thread = arg;
+  for (uint32_t i = 1; i <= RING_TEST_COUNT;) {
+    if (rtcm3_mpmc_push(thread->queue, &i)) {
+      i++;
+    } else {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+static void *mpmc_test_consumer(void *arg) {
+  mpmc_test_thread *thread = arg;
+  while (thread->count < RING_TEST_COUNT) {
+    uint32_t value;
+    if (rtcm3_mpmc_pop(thread->queue, &value)) {
+      thread->sum += value;
+      thread->count++;
+    } else {
+      sched_yield();
+    }
+  }
+  return NULL;
+}
+
+void test_rings(void) {
+  /* nothing lost or duplicated with two producers and two consumers */
+  static uint8_t queue_buffer[64 * 16];
+  assert(rtcm3_mpmc_buffer_size(sizeof(uint32_t), 64) <= sizeof(queue_buffer));
+  rtcm3_mpmc_queue queue;
+  assert(!rtcm3_mpmc_init(&queue, queue_buffer, sizeof(uint32_t), 63));
+  assert(rtcm3_mpmc_init(&queue, queue_buffer, sizeof(uint32_t), 64));
+  mpmc_test_thread threads[4];
+  pthread_t ids[4];
+  for (int i = 0; i < 4; i++) {
+    memset(&threads[i], 0, sizeof(threads[i]));
+    threads[i].queue = &queue;
+    assert(pthread_create(&ids[i],
+                          NULL,
+                          i < 2 ? mpmc_test_producer : mpmc_test_consumer,
+                          &threads[i]) == 0);
+  }
+  for (int i = 0; i < 4; i++) {
+    pthread_join(ids[i], NULL);
+  }
+  uint64_t expected = (uint64_t)RING_TEST_COUNT * (RING_TEST_COUNT + 1);
+  assert(threads[2].sum + threads[3].sum == expected);
+  assert(rtcm3_mpmc_size(&queue) == 0);
+  uint32_t value;
+  assert(!rtcm3_mpmc_pop(&queue, &value));
+}
+
+#define PIPELINE_TEST_STREAMS 3
+#define PIPELINE_TEST_FRAMES 500
+
+typedef struct {
+  uint32_t received[PIPELINE_TEST_STREAMS];
+  int in_sink[PIPELINE_TEST_STREAMS];
+} pipeline_test_context;
+
+static void pipeline_test_sink(uint16_t stream,
+                               const rtcm3_frame *frame,
+                               const rtcm3_msg *msg,
+                               rtcm3_rc rc,
+                               void *context) {
+  pipeline_test_context *ctx = context;
+  /* never entered twice at once for one stream */
+  assert(__atomic_exchange_n(&ctx->in_sink[stream], 1, __ATOMIC_SEQ_CST) == 0);
+  assert(RC_OK == rc);
+  assert(frame->msg_num == msg->msg_num);
+  uint32_t index = ctx->received[stream];
+  if (index % 10 == 9) {
+    assert(msg->kind == RTCM3_MSG_1033);
+    assert(msg->msg_1033.stn_id == stream);
+  } else {
+    assert(msg->kind == RTCM3_MSG_1005);
+    assert(msg->msg_1005.stn_id == stream);
+    /* frames arrive in stream order */
+    assert(msg->msg_1005.arp_x == index);
+  }
+  ctx->received[stream]++;
+  __atomic_store_n(&ctx->in_sink[stream], 0, __ATOMIC_SEQ_CST);
+}
+
+void test_pipeline(void) {
+  static uint8_t streams[PIPELINE_TEST_STREAMS][PIPELINE_TEST_FRAMES * 64];
+  size_t lens[PIPELINE_TEST_STREAMS];
+  for (uint16_t s = 0; s < PIPELINE_TEST_STREAMS; s++) {
+    size_t len = 0;
+    for (uint32_t i = 0; i < PIPELINE_TEST_FRAMES; i++) {
+      uint8_t *payload = &streams[s][len + RTCM3_FRAME_HEADER_LEN];
+      uint16_t payload_len;
+      if (i % 10 == 9) {
+        rtcm_msg_1033 msg_1033;
+        memset(&msg_1033, 0, sizeof(msg_1033));
+        msg_1033.stn_id = s;
+        payload_len = rtcm3_encode_1033(&msg_1033, payload);
+      } else {
+        rtcm_msg_1005 msg_1005;
+        memset(&msg_1005, 0, sizeof(msg_1005));
+        msg_1005.stn_id = s;
+        msg_1005.arp_x = i;
+        payload_len = rtcm3_encode_1005(&msg_1005, payload);
+      }
+      len += rtcm3_frame_finalize(&streams[s][len], payload_len);
+      /* line noise between some frames */
+      if (i % 7 == 0) {
+        streams[s][len++] = 0x55;
+      }
+    }
+    lens[s] = len;
+  }
+
+  static pipeline_test_context ctx;
+  memset(&ctx, 0, sizeof(ctx));
+  rtcm3_pipeline_config config;
+  memset(&config, 0, sizeof(config));
+  config.num_workers = 3;
+  config.num_streams = PIPELINE_TEST_STREAMS;
+  config.window = 4;
+  config.sink = pipeline_test_sink;
+  config.context = &ctx;
+  config.window = 3;
+  assert(rtcm3_pipeline_create(&config) == NULL);
+  /* the job queue would need more than RTCM3_PIPELINE_MAX_JOBS entries */
+  config.window = 1u << 31;
+  assert(rtcm3_pipeline_create(&config) == NULL);
+  config.window = 4;
+  rtcm3_pipeline *pipeline = rtcm3_pipeline_create(&config);
+  assert(pipeline != NULL);
+
+  /* interleave the streams in odd sized pieces, taking backpressure */
+  size_t pos[PIPELINE_TEST_STREAMS] = {0};
+  bool done = false;
+  for (size_t round = 0; !done; round++) {
+    done = true;
+    for (uint16_t s = 0; s < PIPELINE_TEST_STREAMS; s++) {
+      size_t piece = 1 + (round * 37 + s * 11) % 200;
+      if (piece > lens[s] - pos[s]) {
+        piece = lens[s] - pos[s];
+      }
+      size_t taken =
+          rtcm3_pipeline_push(pipeline, s, &streams[s][pos[s]], piece);
+      if (taken < piece) {
+        /* window full, let the workers catch up */
+        sched_yield();
+      }
+      pos[s] += taken;
+      done = done && pos[s] == lens[s];
+    }
+  }
+  for (uint16_t s = 0; s < PIPELINE_TEST_STREAMS; s++) {
+    rtcm3_pipeline_flush(pipeline, s);
+    assert(ctx.received[s] == PIPELINE_TEST_FRAMES);
+    rtcm3_pipeline_stream_metrics stream_metrics;
+    rtcm3_pipeline_get_stream_metrics(pipeline, s, &stream_metrics);
+    assert(stream_metrics.frames_in == PIPELINE_TEST_FRAMES);
+    assert(stream_metrics.frames_out == PIPELINE_TEST_FRAMES);
+    assert(stream_metrics.in_flight == 0);
+    assert(stream_metrics.decode_errors == 0);
+    assert(stream_metrics.skipped_bytes == (PIPELINE_TEST_FRAMES + 6) / 7);
+  }
+  rtcm3_pipeline_metrics metrics;
+  rtcm3_pipeline_get_metrics(pipeline, &metrics);
+  assert(metrics.num_workers == 3);
+  assert(metrics.queue_depth == 0);
+  assert(metrics.jobs_decoded == PIPELINE_TEST_STREAMS * PIPELINE_TEST_FRAMES);
+  rtcm3_pipeline_destroy(pipeline);
+}
+
+#define BATCH_TEST_FRAMES 300
+
+void test_decode_batch(void) {
+  /* mixed types across more than one block, with an unsupported message
+   * number and an empty payload thrown in */
+  static uint8_t payloads[BATCH_TEST_FRAMES][64];
+  static rtcm3_frame frames[BATCH_TEST_FRAMES];
+  for (uint16_t i = 0; i < BATCH_TEST_FRAMES; i++) {
+    uint16_t payload_len;
+    if (i % 3 == 1) {
+      rtcm_msg_1033 msg_1033;
+      memset(&msg_1033, 0, sizeof(msg_1033));
+      msg_1033.stn_id = i;
+      payload_len = rtcm3_encode_1033(&msg_1033, payloads[i]);
+    } else {
+      rtcm_msg_1005 msg_1005;
+      memset(&msg_1005, 0, sizeof(msg_1005));
+      msg_1005.stn_id = i;
+      msg_1005.arp_x = i;
+      payload_len = rtcm3_encode_1005(&msg_1005, payloads[i]);
+    }
+    if (i % 50 == 20) {
+      rtcm_setbitu(payloads[i], 0, 12, 999);
+    }
+    frames[i].payload = payloads[i];
+    frames[i].payload_len = i == 77 ? 0 : payload_len;
+    frames[i].msg_num = (uint16_t)rtcm_getbitu(payloads[i], 0, 12);
+    frames[i].offset = 0;
+  }
+  frames[77].msg_num = 0;
+
+  static rtcm3_msg msgs[BATCH_TEST_FRAMES];
+  rtcm3_rc rcs[BATCH_TEST_FRAMES];
+  size_t num_ok = rtcm3_decode_batch(frames, BATCH_TEST_FRAMES, msgs, rcs);
+  assert(num_ok == BATCH_TEST_FRAMES - BATCH_TEST_FRAMES / 50 - 1);
+  for (uint16_t i = 0; i < BATCH_TEST_FRAMES; i++) {
+    if (i == 77 || i % 50 == 20) {
+      assert(RC_MESSAGE_TYPE_MISMATCH == rcs[i]);
+      assert(RTCM3_MSG_UNSUPPORTED == msgs[i].kind);
+      continue;
+    }
+    /* same result as one at a time, at the index of the frame */
+    static rtcm3_msg expected;
+    assert(rtcm3_decode_msg(payloads[i], &expected) == rcs[i]);
+    assert(RC_OK == rcs[i]);
+    assert(msgs[i].msg_num == expected.msg_num);
+    assert(msgs[i].kind == expected.kind);
+    if (RTCM3_MSG_1005 == msgs[i].kind) {
+      assert(msgs[i].msg_1005.stn_id == i);
+      assert(msgs[i].msg_1005.arp_x == i);
+    } else {
+      assert(RTCM3_MSG_1033 == msgs[i].kind);
+      assert(msgs[i].msg_1033.stn_id == i);
+    }
+  }
+  assert(rtcm3_decode_batch(frames, 0, msgs, rcs) == 0);
+}
+
+/* more frames than fit in one writev call */
+#define IOV_TEST_FRAMES 400
+
+void test_frame_iov(void) {
+  /* framed encoding of a tagged message matches encode and finalize */
+  static rtcm3_msg msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_num = 1005;
+  msg.kind = RTCM3_MSG_1005;
+  msg.msg_1005.stn_id = 21;
+  msg.msg_1005.arp_z = 4969916.8;
+  uint8_t frame[RTCM3_MAX_FRAME_LEN];
+  uint16_t frame_len = rtcm3_encode_msg_frame(&msg, frame);
+  uint8_t expected[RTCM3_MAX_FRAME_LEN];
+  uint16_t payload_len = rtcm3_encode_1005(
+      &msg.msg_1005, &expected[RTCM3_FRAME_HEADER_LEN]);
+  assert(rtcm3_frame_finalize(expected, payload_len) == frame_len);
+  assert(memcmp(frame, expected, frame_len) == 0);
+  assert(rtcm3_frame_check(frame, frame_len) == frame_len);
+  static rtcm3_msg decoded;
+  assert(RC_OK == rtcm3_decode_msg(&frame[RTCM3_FRAME_HEADER_LEN], &decoded));
+  assert(decoded.kind == RTCM3_MSG_1005);
+  assert(decoded.msg_1005.stn_id == 21);
+  msg.kind = RTCM3_MSG_SSR_ORBIT;
+  assert(rtcm3_encode_msg_frame(&msg, frame) == 0);
+
+  /* the envelope around a payload in place gives the same frame */
+  rtcm3_frame_envelope envelope;
+  assert(rtcm3_frame_envelope_init(&envelope,
+                                   &expected[RTCM3_FRAME_HEADER_LEN],
+                                   payload_len) == frame_len);
+  assert(memcmp(envelope.header, expected, RTCM3_FRAME_HEADER_LEN) == 0);
+  assert(memcmp(envelope.crc,
+                &expected[RTCM3_FRAME_HEADER_LEN + payload_len],
+                RTCM3_FRAME_CRC_LEN) == 0);
+  assert(rtcm3_frame_envelope_init(
+             &envelope, expected, RTCM3_MAX_PAYLOAD_LEN + 1) == 0);
+
+  /* a batch of payloads goes out through a pipe and frames up again */
+  static uint8_t payloads[IOV_TEST_FRAMES][32];
+  static rtcm3_frame_envelope envelopes[IOV_TEST_FRAMES];
+  static struct iovec iov[IOV_TEST_FRAMES * RTCM3_FRAME_IOV_LEN];
+  size_t total = 0;
+  for (uint16_t i = 0; i < IOV_TEST_FRAMES; i++) {
+    rtcm_msg_1005 msg_1005;
+    memset(&msg_1005, 0, sizeof(msg_1005));
+    msg_1005.stn_id = i;
+    payload_len = rtcm3_encode_1005(&msg_1005, payloads[i]);
+    total += rtcm3_frame_iov(payloads[i],
+                             payload_len,
+                             &envelopes[i],
+                             &iov[i * RTCM3_FRAME_IOV_LEN]);
+  }
+  int fds[2];
+  assert(pipe(fds) == 0);
+  size_t written = 0;
+  assert(rtcm3_writev_all(fds[1],
+                          iov,
+                          IOV_TEST_FRAMES * RTCM3_FRAME_IOV_LEN,
+                          &written) == 0);
+  assert(written == total);
+  close(fds[1]);
+  static uint8_t stream[IOV_TEST_FRAMES * 32];
+  size_t len = 0;
+  ssize_t n;
+  while ((n = read(fds[0], &stream[len], sizeof(stream) - len)) > 0) {
+    len += (size_t)n;
+  }
+  close(fds[0]);
+  assert(len == total);
+
+  rtcm3_frame_scanner scanner;
+  rtcm3_frame_scanner_init(&scanner, stream, len);
+  rtcm3_frame scanned;
+  for (uint16_t i = 0; i < IOV_TEST_FRAMES; i++) {
+    assert(rtcm3_frame_scanner_next(&scanner, &scanned));
+    assert(rtcm_getbitu(scanned.payload, 12, 12) == i);
+  }
+  assert(!rtcm3_frame_scanner_next(&scanner, &scanned));
+  assert(scanner.skipped_bytes == 0);
+
+  /* a full non-blocking pipe stops the write with EAGAIN part way */
+  static uint8_t big[1 << 20];
+  struct iovec big_iov = {big, sizeof(big)};
+  assert(pipe(fds) == 0);
+  assert(fcntl(fds[1], F_SETFL, O_NONBLOCK) == 0);
+  assert(rtcm3_writev_all(fds[1], &big_iov, 1, &written) == EAGAIN);
+  assert(written > 0 && written < sizeof(big));
+  assert(big_iov.iov_len == sizeof(big) - written);
+  close(fds[0]);
+  close(fds[1]);
+}
+
+void test_encoded_size(void) {
+  uint8_t buff[RTCM3_MAX_PAYLOAD_LEN];
+  rtcm_msg_eph msg_eph;
+  memset(&msg_eph, 0, sizeof(msg_eph));
+  assert(rtcm3_encode_gps_eph(&msg_eph, buff) ==
+         rtcm3_encoded_size_gps_eph(&msg_eph));
+  assert(rtcm3_encode_gal_eph_inav(&msg_eph, buff) ==
+         rtcm3_encoded_size_gal_eph_inav(&msg_eph));
+  assert(rtcm3_encode_gal_eph_fnav(&msg_eph, buff) ==
+         rtcm3_encoded_size_gal_eph_fnav(&msg_eph));
+  assert(rtcm3_encode_glo_eph(&msg_eph, buff) ==
+         rtcm3_encoded_size_glo_eph(&msg_eph));
+  assert(rtcm3_encode_bds_eph(&msg_eph, buff) ==
+         rtcm3_encoded_size_bds_eph(&msg_eph));
+  assert(rtcm3_encode_qzss_eph(&msg_eph, buff) ==
+         rtcm3_encoded_size_qzss_eph(&msg_eph));
+
+  /* through the tagged union, which is what a producer reserving space in a
+   * ring would use */
+  static rtcm3_msg msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_num = 1033;
+  msg.kind = RTCM3_MSG_1033;
+  msg.msg_1033.rcv_descriptor_counter = 9;
+  memcpy(msg.msg_1033.rcv_descriptor, "LEI - IGS", 9);
+  assert(rtcm3_encoded_size_msg(&msg) == 18);
+  assert(rtcm3_encode_msg(&msg, buff) == rtcm3_encoded_size_msg(&msg));
+  msg.msg_num = 1045;
+  msg.kind = RTCM3_MSG_EPH;
+  assert(rtcm3_encode_msg(&msg, buff) == rtcm3_encoded_size_msg(&msg));
+
+  /* no encoder, no size */
+  msg.msg_num = 1077;
+  msg.kind = RTCM3_MSG_MSM;
+  msg.msm.header.msg_num = 1077;
+  assert(rtcm3_encoded_size_msg(&msg) == 0);
+  assert(rtcm3_encoded_size_msm4(&msg.msm) == 0);
+  msg.kind = RTCM3_MSG_SSR_CLOCK;
+  assert(rtcm3_encoded_size_msg(&msg) == 0);
+}
+
+/* Re-encoding a patched message has to give the patched frame byte for byte */
+static void assert_frame_equals_payload(const uint8_t frame[],
+                                        const uint8_t payload[],
+                                        uint16_t payload_len) {
+  uint8_t expected[RTCM3_MAX_FRAME_LEN];
+  memcpy(&expected[RTCM3_FRAME_HEADER_LEN], payload, payload_len);
+  uint16_t frame_len = rtcm3_frame_finalize(expected, payload_len);
+  assert(rtcm3_frame_check(frame, frame_len) == frame_len);
+  assert(memcmp(frame, expected, frame_len) == 0);
+}
+
+void test_patch(void) {
+  uint8_t frame[RTCM3_MAX_FRAME_LEN];
+  uint8_t payload[RTCM3_MAX_PAYLOAD_LEN];
+  uint32_t value = 0;
+  /* the encoders leave padding bits as they find them */
+  memset(frame, 0, sizeof(frame));
+  memset(payload, 0, sizeof(payload));
+
+  /* station ID of a 1005 */
+  rtcm_msg_1005 msg_1005;
+  memset(&msg_1005, 0, sizeof(msg_1005));
+  msg_1005.stn_id = 21;
+  msg_1005.arp_x = 3573346.8;
+  uint16_t payload_len =
+      rtcm3_encode_1005(&msg_1005, &frame[RTCM3_FRAME_HEADER_LEN]);
+  uint16_t frame_len = rtcm3_frame_finalize(frame, payload_len);
+  assert(rtcm3_frame_get_field(frame, RTCM3_FIELD_STN_ID, &value));
+  assert(value == 21);
+  assert(rtcm3_frame_set_field(frame, RTCM3_FIELD_STN_ID, 4000));
+  msg_1005.stn_id = 4000;
+  assert_frame_equals_payload(
+      frame, payload, rtcm3_encode_1005(&msg_1005, payload));
+
+  /* fields the message does not have and values which do not fit leave the
+   * frame alone */
+  uint8_t before[RTCM3_MAX_FRAME_LEN];
+  memcpy(before, frame, frame_len);
+  assert(!rtcm3_frame_set_field(frame, RTCM3_FIELD_STN_ID, 4096));
+  assert(!rtcm3_frame_set_field(frame, RTCM3_FIELD_EPOCH, 0));
+  assert(!rtcm3_frame_set_field(frame, RTCM3_FIELD_IODS, 0));
+  assert(!rtcm3_frame_set_field(frame, RTCM3_FIELD_COUNT, 0));
+  assert(!rtcm3_frame_get_field(frame, RTCM3_FIELD_SSR_PROVIDER_ID, &value));
+  assert(memcmp(before, frame, frame_len) == 0);
+
+  /* a corrupt frame stays corrupt */
+  frame[RTCM3_FRAME_HEADER_LEN + 10] ^= 0x40;
+  assert(rtcm3_frame_set_field(frame, RTCM3_FIELD_STN_ID, 22));
+  assert(rtcm3_frame_check(frame, frame_len) == 0);
+
+  /* epoch of a 1004 */
+  rtcm_obs_message msg_1004;
+  memset(&msg_1004, 0, sizeof(msg_1004));
+  msg_1004.header.msg_num = 1004;
+  msg_1004.header.stn_id = 7;
+  msg_1004.header.tow_ms = 309000000;
+  msg_1004.header.n_sat = 2;
+  msg_1004.sats[0].svId = 3;
+  msg_1004.sats[1].svId = 17;
+  payload_len = rtcm3_encode_1004(&msg_1004, &frame[RTCM3_FRAME_HEADER_LEN]);
+  rtcm3_frame_finalize(frame, payload_len);
+  assert(rtcm3_frame_set_field(frame, RTCM3_FIELD_EPOCH, 309001000));
+  msg_1004.header.tow_ms = 309001000;
+  assert_frame_equals_payload(
+      frame, payload, rtcm3_encode_1004(&msg_1004, payload));
+
+  /* epoch and IODS of an MSM4 */
+  static rtcm_msm_message msg_msm;
+  memset(&msg_msm, 0, sizeof(msg_msm));
+  msg_msm.header.msg_num = 1074;
+  msg_msm.header.stn_id = 7;
+  msg_msm.header.tow_ms = 309000000;
+  msg_msm.header.satellite_mask[4] = true;
+  msg_msm.header.signal_mask[1] = true;
+  msg_msm.header.cell_mask[0] = true;
+  payload_len = rtcm3_encode_msm4(&msg_msm, &frame[RTCM3_FRAME_HEADER_LEN]);
+  rtcm3_frame_finalize(frame, payload_len);
+  assert(rtcm3_frame_set_field(frame, RTCM3_FIELD_EPOCH, 309000500));
+  assert(rtcm3_frame_set_field(frame, RTCM3_FIELD_IODS, 6));
+  assert(!rtcm3_frame_set_field(frame, RTCM3_FIELD_IODS, 8));
+  msg_msm.header.tow_ms = 309000500;
+  msg_msm.header.iods = 6;
+  assert_frame_equals_payload(
+      frame, payload, rtcm3_encode_msm4(&msg_msm, payload));
+
+  /* provider and solution of an SSR orbit and clock message, which has the
+   * reference datum bit before the IOD SSR */
+  payload_len = 9;
+  memset(&frame[RTCM3_FRAME_HEADER_LEN], 0, payload_len);
+  rtcm_setbitu(&frame[RTCM3_FRAME_HEADER_LEN], 0, 12, 1060);
+  rtcm_setbitu(&frame[RTCM3_FRAME_HEADER_LEN], 12, 20, 345600);
+  rtcm_setbitu(&frame[RTCM3_FRAME_HEADER_LEN], 38, 4, 3);
+  rtcm_setbitu(&frame[RTCM3_FRAME_HEADER_LEN], 42, 16, 1234);
+  rtcm_setbitu(&frame[RTCM3_FRAME_HEADER_LEN], 58, 4, 1);
+  frame_len = rtcm3_frame_finalize(frame, payload_len);
+  assert(rtcm3_frame_get_field(frame, RTCM3_FIELD_SSR_PROVIDER_ID, &value));
+  assert(value == 1234);
+  assert(rtcm3_frame_set_field(frame, RTCM3_FIELD_SSR_PROVIDER_ID, 4321));
+  assert(rtcm3_frame_set_field(frame, RTCM3_FIELD_SSR_SOLUTION_ID, 2));
+  assert(rtcm3_frame_set_field(frame, RTCM3_FIELD_EPOCH, 345605));
+  assert(!rtcm3_frame_set_field(frame, RTCM3_FIELD_STN_ID, 1));
+  assert(rtcm3_frame_check(frame, frame_len) == frame_len);
+  static rtcm3_msg msg;
+  assert(RC_OK == rtcm3_decode_msg(&frame[RTCM3_FRAME_HEADER_LEN], &msg));
+  assert(msg.kind == RTCM3_MSG_SSR_ORBIT_CLOCK);
+  assert(msg.orbit_clock.header.epoch_time == 345605);
+  assert(msg.orbit_clock.header.iod_ssr == 3);
+  assert(msg.orbit_clock.header.ssr_provider_id == 4321);
+  assert(msg.orbit_clock.header.ssr_solution_id == 2);
+
+  /* a field at the start of the longest payload, so the CRC difference is
+   * carried over every trailing byte */
+  payload_len = RTCM3_MAX_PAYLOAD_LEN;
+  for (uint16_t i = 0; i < payload_len; i++) {
+    frame[RTCM3_FRAME_HEADER_LEN + i] = (uint8_t)(i * 37 + 11);
+  }
+  rtcm_setbitu(&frame[RTCM3_FRAME_HEADER_LEN], 0, 12, 1005);
+  rtcm3_frame_finalize(frame, payload_len);
+  for (uint32_t stn_id = 0; stn_id < 4096; stn_id += 97) {
+    assert(rtcm3_frame_set_field(frame, RTCM3_FIELD_STN_ID, stn_id));
+    memcpy(payload, &frame[RTCM3_FRAME_HEADER_LEN], payload_len);
+    assert_frame_equals_payload(frame, payload, payload_len);
+  }
+}
+
+void test_msm_epoch(void) {
+  /* 30 satellites on 4 signals, 16 satellites fit a message */
+  static rtcm_msm_epoch epoch;
+  static rtcm_msm_cell cells[MSM_SATELLITE_MASK_SIZE * MSM_SIGNAL_MASK_SIZE];
+  memset(&epoch, 0, sizeof(epoch));
+  epoch.header.msg_num = 1074;
+  epoch.header.stn_id = 7;
+  epoch.header.tow_ms = 309000000;
+  epoch.header.iods = 2;
+  epoch.cells = cells;
+  const uint8_t sigs[] = {1, 2, 14, 21};
+  for (uint8_t sat = 0; sat < 30; sat++) {
+    epoch.sats[sat].rough_range_ms = 70 + sat * 0.25;
+    for (uint8_t k = 0; k < 4; k++) {
+      rtcm_msm_cell *cell = &cells[epoch.num_cells++];
+      memset(cell, 0, sizeof(*cell));
+      cell->sat = sat;
+      cell->sig = sigs[k];
+      cell->data.pseudorange_ms = epoch.sats[sat].rough_range_ms + k * 1e-4;
+      cell->data.flags.valid_pr = 1;
+    }
+  }
+
+  static uint8_t buff[8 * RTCM3_MAX_FRAME_LEN];
+  size_t len = 0;
+  assert(rtcm3_encode_msm_epoch(&epoch, buff, sizeof(buff), &len) == 2);
+  size_t pos = 0;
+  uint16_t cells_seen = 0;
+  static rtcm_msm_message msg;
+  for (uint8_t i = 0; i < 2; i++) {
+    uint16_t frame_len = rtcm3_frame_check(&buff[pos], len - pos);
+    assert(frame_len > 0);
+    assert(RC_OK ==
+           rtcm3_decode_msm4(&buff[pos + RTCM3_FRAME_HEADER_LEN], &msg));
+    assert(msg.header.multiple == (i == 0));
+    assert(msg.header.stn_id == 7 && msg.header.iods == 2);
+    assert(msg.header.tow_ms == 309000000);
+    uint8_t num_sats =
+        count_mask_values(MSM_SATELLITE_MASK_SIZE, msg.header.satellite_mask);
+    uint8_t num_sigs =
+        count_mask_values(MSM_SIGNAL_MASK_SIZE, msg.header.signal_mask);
+    assert(num_sats == (i == 0 ? 16 : 14) && num_sigs == 4);
+    assert(msg.header.satellite_mask[i == 0 ? 0 : 16]);
+    for (uint8_t c = 0; c < num_sats * num_sigs; c++) {
+      const rtcm_msm_cell *cell = &cells[cells_seen + c];
+      /* fine pseudorange resolution is 2^-24 ms */
+      assert(fabs(msg.signals[c].pseudorange_ms - cell->data.pseudorange_ms) <
+             1e-7);
+    }
+    cells_seen += num_sats * num_sigs;
+    pos += frame_len;
+  }
+  assert(pos == len && cells_seen == epoch.num_cells);
+
+  /* with more constellations to follow at the same epoch the last message
+   * keeps the multiple message bit of the header */
+  epoch.header.multiple = true;
+  assert(rtcm3_encode_msm_epoch(&epoch, buff, sizeof(buff), &len) == 2);
+  pos = 0;
+  for (uint8_t i = 0; i < 2; i++) {
+    uint16_t frame_len = rtcm3_frame_check(&buff[pos], len - pos);
+    assert(frame_len > 0);
+    assert(RC_OK ==
+           rtcm3_decode_msm4(&buff[pos + RTCM3_FRAME_HEADER_LEN], &msg));
+    assert(msg.header.multiple);
+    pos += frame_len;
+  }
+  assert(pos == len);
+  epoch.header.multiple = false;
+
+  /* an epoch which fits one message encodes as that message would */
+  epoch.num_cells = 12;
+  assert(rtcm3_encode_msm_epoch(&epoch, buff, sizeof(buff), &len) == 1);
+  assert(RC_OK == rtcm3_decode_msm4(&buff[RTCM3_FRAME_HEADER_LEN], &msg));
+  assert(!msg.header.multiple);
+  uint8_t payload[RTCM3_MAX_PAYLOAD_LEN];
+  memset(payload, 0, sizeof(payload));
+  uint16_t payload_len = rtcm3_encode_msm4(&msg, payload);
+  assert(len == (size_t)payload_len + RTCM3_FRAME_OVERHEAD);
+  assert(memcmp(&buff[RTCM3_FRAME_HEADER_LEN], payload, payload_len) == 0);
+  epoch.header.multiple = true;
+  assert(rtcm3_encode_msm_epoch(&epoch, buff, sizeof(buff), &len) == 1);
+  assert(RC_OK == rtcm3_decode_msm4(&buff[RTCM3_FRAME_HEADER_LEN], &msg));
+  assert(msg.header.multiple);
+  epoch.header.multiple = false;
+
+  /* satellites on disjoint signals share a message as long as the cell mask
+   * fits: 8 satellites on 8 signals in all */
+  epoch.num_cells = 0;
+  for (uint8_t sat = 0; sat < 8; sat++) {
+    rtcm_msm_cell *cell = &cells[epoch.num_cells++];
+    memset(cell, 0, sizeof(*cell));
+    cell->sat = sat;
+    cell->sig = sat;
+  }
+  assert(rtcm3_encode_msm_epoch(&epoch, buff, sizeof(buff), &len) == 1);
+
+  /* at most 32 satellites per message */
+  epoch.num_cells = 0;
+  for (uint8_t sat = 0; sat < 40; sat++) {
+    rtcm_msm_cell *cell = &cells[epoch.num_cells++];
+    memset(cell, 0, sizeof(*cell));
+    cell->sat = sat;
+  }
+  assert(rtcm3_encode_msm_epoch(&epoch, buff, sizeof(buff), &len) == 2);
+
+  /* out of order cells, no room and no encoder all fail */
+  cells[1].sat = 0;
+  assert(rtcm3_encode_msm_epoch(&epoch, buff, sizeof(buff), &len) == 0);
+  cells[1].sat = 1;
+  assert(rtcm3_encode_msm_epoch(&epoch, buff, 64, &len) == 0 && len == 0);
+  epoch.header.msg_num = 1077;
+  assert(rtcm3_encode_msm_epoch(&epoch, buff, sizeof(buff), &len) == 0);
+}
+
+void test_eph_store(void) {
+  static rtcm3_eph_store store;
+  rtcm3_eph_store_init(&store);
+  rtcm_msg_eph msg_eph;
+  memset(&msg_eph, 0, sizeof(msg_eph));
+  msg_eph.constellation = RTCM_CONSTELLATION_GPS;
+  msg_eph.sat_id = 12;
+  msg_eph.wn = 1100;
+  msg_eph.toe = 7200 / 16;
+  msg_eph.kepler.iode = 40;
+  msg_eph.kepler.sqrta = 2702000000u;
+  uint8_t buff[RTCM3_MAX_PAYLOAD_LEN];
+  memset(buff, 0, sizeof(buff));
+  uint16_t len = rtcm3_encode_gps_eph(&msg_eph, buff);
+
+  /* the first copy is decoded, repeats are not */
+  const rtcm_msg_eph *eph = NULL;
+  const rtcm_msg_eph *first = NULL;
+  bool is_new = false;
+  assert(RC_OK == rtcm3_eph_store_update(&store, buff, len, &first, &is_new));
+  assert(is_new && first->sat_id == 12 && first->kepler.iode == 40);
+  for (uint8_t i = 0; i < 5; i++) {
+    assert(RC_OK == rtcm3_eph_store_update(&store, buff, len, &eph, &is_new));
+    assert(!is_new && eph == first);
+  }
+  assert(store.decoded == 1 && store.duplicates == 5);
+
+  /* new content of the same issue replaces it */
+  msg_eph.health_bits = 1;
+  len = rtcm3_encode_gps_eph(&msg_eph, buff);
+  assert(RC_OK == rtcm3_eph_store_update(&store, buff, len, &eph, &is_new));
+  assert(is_new && eph == first && eph->health_bits == 1);
+
+  /* a new issue keeps the old one as the previous */
+  msg_eph.health_bits = 0;
+  msg_eph.toe = 14400 / 16;
+  msg_eph.kepler.iode = 41;
+  len = rtcm3_encode_gps_eph(&msg_eph, buff);
+  assert(RC_OK == rtcm3_eph_store_update(&store, buff, len, &eph, &is_new));
+  assert(is_new && eph != first && eph->kepler.iode == 41);
+  assert(rtcm3_eph_store_best(&store, RTCM_CONSTELLATION_GPS, 12, 8000) ==
+         first);
+  assert(rtcm3_eph_store_best(&store, RTCM_CONSTELLATION_GPS, 12, 12000) ==
+         eph);
+  assert(rtcm3_eph_store_best(&store, RTCM_CONSTELLATION_GPS, 12, 30000) ==
+         NULL);
+  assert(rtcm3_eph_store_best(&store, RTCM_CONSTELLATION_GPS, 13, 12000) ==
+         NULL);
+  assert(rtcm3_eph_store_best(&store, RTCM_CONSTELLATION_GAL, 12, 12000) ==
+         NULL);
+  /* the reference time wraps at the end of the week */
+  msg_eph.toe = 0;
+  msg_eph.kepler.iode = 42;
+  len = rtcm3_encode_gps_eph(&msg_eph, buff);
+  assert(RC_OK == rtcm3_eph_store_update(&store, buff, len, &eph, &is_new));
+  assert(rtcm3_eph_store_best(&store, RTCM_CONSTELLATION_GPS, 12, 604000) ==
+         eph);
+
+  /* Galileo I/NAV and F/NAV of one satellite alternate without evicting
+   * each other */
+  msg_eph.constellation = RTCM_CONSTELLATION_GAL;
+  msg_eph.toe = 7200 / 60;
+  uint8_t inav[RTCM3_MAX_PAYLOAD_LEN];
+  uint8_t fnav[RTCM3_MAX_PAYLOAD_LEN];
+  memset(inav, 0, sizeof(inav));
+  memset(fnav, 0, sizeof(fnav));
+  uint16_t inav_len = rtcm3_encode_gal_eph_inav(&msg_eph, inav);
+  uint16_t fnav_len = rtcm3_encode_gal_eph_fnav(&msg_eph, fnav);
+  uint32_t decoded = store.decoded;
+  for (uint8_t i = 0; i < 4; i++) {
+    assert(RC_OK ==
+           rtcm3_eph_store_update(&store, inav, inav_len, &eph, &is_new));
+    assert(RC_OK ==
+           rtcm3_eph_store_update(&store, fnav, fnav_len, &eph, &is_new));
+  }
+  assert(store.decoded == decoded + 2);
+  assert(rtcm3_eph_store_best(&store, RTCM_CONSTELLATION_GAL, 12, 7300) !=
+         NULL);
+
+  /* anything else is refused */
+  rtcm_msg_1005 msg_1005;
+  memset(&msg_1005, 0, sizeof(msg_1005));
+  len = rtcm3_encode_1005(&msg_1005, buff);
+  assert(RC_MESSAGE_TYPE_MISMATCH ==
+         rtcm3_eph_store_update(&store, buff, len, &eph, &is_new));
+  assert(RC_INVALID_MESSAGE ==
+         rtcm3_eph_store_update(&store, inav, 2, &eph, &is_new));
+}
+
+void test_eph_encode(void) {
+  uint8_t buff[RTCM3_MAX_PAYLOAD_LEN];
+  rtcm_msg_eph msg_eph;
+  rtcm_msg_eph decoded;
+
+  memset(&msg_eph, 0, sizeof(msg_eph));
+  msg_eph.constellation = RTCM_CONSTELLATION_GLO;
+  msg_eph.sat_id = 17;
+  msg_eph.fit_interval = 2;
+  msg_eph.ura = 3;
+  msg_eph.health_bits = 1;
+  msg_eph.glo.fcn = 11;
+  msg_eph.glo.t_b = 91;
+  msg_eph.glo.gamma = -3;
+  msg_eph.glo.tau = -180000;
+  msg_eph.glo.d_tau = 4;
+  for (uint8_t i = 0; i < 3; i++) {
+    msg_eph.glo.pos[i] = (i % 2 ? -1 : 1) * (12000000 + i * 1000003);
+    msg_eph.glo.vel[i] = (i % 2 ? 1 : -1) * (3000000 + i * 7919);
+    msg_eph.glo.acc[i] = i - 1;
+  }
+  memset(buff, 0, sizeof(buff));
+  assert(45 == rtcm3_encode_glo_eph(&msg_eph, buff));
+  assert(RC_OK == rtcm3_decode_glo_eph(buff, &decoded));
+  assert(0 == memcmp(&msg_eph, &decoded, sizeof(msg_eph)));
+
+  memset(&msg_eph, 0, sizeof(msg_eph));
+  msg_eph.constellation = RTCM_CONSTELLATION_BDS;
+  msg_eph.sat_id = 23;
+  msg_eph.wn = 850;
+  msg_eph.toe = 9000;
+  msg_eph.ura = 2;
+  msg_eph.health_bits = 1;
+  msg_eph.kepler.iode = 17;
+  msg_eph.kepler.iodc = 9;
+  msg_eph.kepler.toc = 9000;
+  msg_eph.kepler.af0 = -4000000;
+  msg_eph.kepler.af1 = 123456;
+  msg_eph.kepler.af2 = -7;
+  msg_eph.kepler.crs = -100000;
+  msg_eph.kepler.crc = 90000;
+  msg_eph.kepler.cuc = -1234;
+  msg_eph.kepler.cus = 4321;
+  msg_eph.kepler.cic = 77;
+  msg_eph.kepler.cis = -77;
+  msg_eph.kepler.dn = -9999;
+  msg_eph.kepler.m0 = -2000000000;
+  msg_eph.kepler.ecc = 3000000000u;
+  msg_eph.kepler.sqrta = 2700000000u;
+  msg_eph.kepler.omega0 = 1500000000;
+  msg_eph.kepler.omegadot = -5000000;
+  msg_eph.kepler.inc = -1000000000;
+  msg_eph.kepler.inc_dot = -5000;
+  msg_eph.kepler.w = 123456789;
+  msg_eph.kepler.tgd_bds_s[0] = -300;
+  msg_eph.kepler.tgd_bds_s[1] = 200;
+  rtcm_msg_eph bds = msg_eph;
+  memset(buff, 0, sizeof(buff));
+  assert(64 == rtcm3_encode_bds_eph(&msg_eph, buff));
+  assert(RC_OK == rtcm3_decode_bds_eph(buff, &decoded));
+  assert(0 == memcmp(&msg_eph, &decoded, sizeof(msg_eph)));
+
+  /* QZSS shares the GPS field widths, the BDS values above fit apart from
+   * the reference times and the group delays */
+  msg_eph = bds;
+  msg_eph.constellation = RTCM_CONSTELLATION_QZS;
+  msg_eph.sat_id = 3;
+  msg_eph.wn = 100;
+  msg_eph.toe = 2025;
+  msg_eph.health_bits = 0x21;
+  msg_eph.fit_interval = 1;
+  msg_eph.kepler.iode = 201;
+  msg_eph.kepler.iodc = 713;
+  msg_eph.kepler.toc = 2025;
+  msg_eph.kepler.crs = -20000;
+  msg_eph.kepler.crc = 20000;
+  msg_eph.kepler.af0 = -2000000;
+  msg_eph.kepler.af1 = 12345;
+  msg_eph.kepler.tgd_bds_s[0] = 0;
+  msg_eph.kepler.tgd_bds_s[1] = 0;
+  msg_eph.kepler.tgd_gps_s = -11;
+  memset(buff, 0, sizeof(buff));
+  assert(61 == rtcm3_encode_qzss_eph(&msg_eph, buff));
+  assert(RC_OK == rtcm3_decode_qzss_eph(buff, &decoded));
+  assert(0 == memcmp(&msg_eph, &decoded, sizeof(msg_eph)));
+}
+
+void test_eph_cache(void) {
+  static rtcm3_eph_cache cache;
+  rtcm3_eph_cache_init(&cache);
+  rtcm_msg_eph msg_eph;
+  memset(&msg_eph, 0, sizeof(msg_eph));
+  msg_eph.constellation = RTCM_CONSTELLATION_GPS;
+  msg_eph.sat_id = 5;
+  msg_eph.toe = 900;
+  msg_eph.kepler.iode = 60;
+  msg_eph.kepler.sqrta = 2702000000u;
+
+  uint8_t payload[RTCM3_EPH_MAX_PAYLOAD_LEN];
+  memset(payload, 0, sizeof(payload));
+  uint16_t payload_len = rtcm3_encode_gps_eph(&msg_eph, payload);
+
+  const uint8_t *frame = NULL;
+  uint16_t len = rtcm3_eph_cache_frame(&cache, 1019, &msg_eph, &frame);
+  assert(len == payload_len + RTCM3_FRAME_OVERHEAD);
+  assert(len == rtcm3_frame_check(frame, len));
+  assert(0 == memcmp(&frame[RTCM3_FRAME_HEADER_LEN], payload, payload_len));
+  assert(cache.encoded == 1 && cache.hits == 0);
+
+  /* rebroadcasts of the same issue come from the cache */
+  uint8_t copy[RTCM3_EPH_MAX_FRAME_LEN];
+  for (uint8_t i = 0; i < 3; i++) {
+    const uint8_t *again = NULL;
+    assert(len == rtcm3_eph_cache_frame(&cache, 1019, &msg_eph, &again));
+    assert(again == frame);
+    assert(len == rtcm3_eph_cache_copy(&cache, 1019, &msg_eph, copy));
+    assert(0 == memcmp(copy, frame, len));
+  }
+  assert(cache.encoded == 1 && cache.hits == 6);
+
+  /* a health change or a new issue is encoded again */
+  msg_eph.health_bits = 1;
+  assert(len == rtcm3_eph_cache_copy(&cache, 1019, &msg_eph, copy));
+  assert(cache.encoded == 2);
+  rtcm_msg_eph decoded;
+  assert(RC_OK ==
+         rtcm3_decode_gps_eph(&copy[RTCM3_FRAME_HEADER_LEN], &decoded));
+  assert(decoded.health_bits == 1);
+  msg_eph.kepler.iode = 61;
+  assert(len == rtcm3_eph_cache_copy(&cache, 1019, &msg_eph, copy));
+  assert(cache.encoded == 3);
+  assert(RC_OK ==
+         rtcm3_decode_gps_eph(&copy[RTCM3_FRAME_HEADER_LEN], &decoded));
+  assert(decoded.kepler.iode == 61);
+  /* issues are reused, so a changed ephemeris under the same IODE is not
+   * served from the stale frame */
+  msg_eph.kepler.crs = 100;
+  assert(len == rtcm3_eph_cache_copy(&cache, 1019, &msg_eph, copy));
+  assert(cache.encoded == 4);
+  assert(RC_OK ==
+         rtcm3_decode_gps_eph(&copy[RTCM3_FRAME_HEADER_LEN], &decoded));
+  assert(decoded.kepler.iode == 61 && decoded.kepler.crs == 100);
+
+  /* GLONASS t_b repeats every day */
+  memset(&msg_eph, 0, sizeof(msg_eph));
+  msg_eph.constellation = RTCM_CONSTELLATION_GLO;
+  msg_eph.sat_id = 5;
+  msg_eph.glo.t_b = 40;
+  assert(45 + RTCM3_FRAME_OVERHEAD ==
+         rtcm3_eph_cache_frame(&cache, 1020, &msg_eph, &frame));
+  assert(45 + RTCM3_FRAME_OVERHEAD ==
+         rtcm3_eph_cache_frame(&cache, 1020, &msg_eph, &frame));
+  assert(cache.encoded == 5 && cache.hits == 7);
+  msg_eph.glo.t_b = 41;
+  assert(45 + RTCM3_FRAME_OVERHEAD ==
+         rtcm3_eph_cache_frame(&cache, 1020, &msg_eph, &frame));
+  assert(cache.encoded == 6);
+  msg_eph.glo.pos[0] = 1000;
+  assert(45 + RTCM3_FRAME_OVERHEAD ==
+         rtcm3_eph_cache_frame(&cache, 1020, &msg_eph, &frame));
+  assert(cache.encoded == 7);
+
+  assert(0 == rtcm3_eph_cache_frame(&cache, 1005, &msg_eph, &frame));
+}
+
+static void make_test_kepler_eph(rtcm_msg_eph *eph) {
+  memset(eph, 0, sizeof(*eph));
+  eph->constellation = RTCM_CONSTELLATION_GPS;
+  eph->sat_id = 5;
+  eph->toe = 450;
+  ephemeris_kepler_raw_rtcm_t *k = &eph->kepler;
+  k->sqrta = 2701996851u;
+  k->ecc = 105656195;
+  k->m0 = 478495692;
+  k->dn = 12599;
+  k->omega0 = -1435487078;
+  k->omegadot = -22399;
+  k->w = 615208748;
+  k->inc = 656222664;
+  k->inc_dot = 559;
+  k->cuc = -644;
+  k->cus = 4294;
+  k->crc = 7376;
+  k->crs = -809;
+  k->cic = 59;
+  k->cis = -32;
+  k->af0 = 322122;
+  k->af1 = -17;
+  k->toc = 450;
+}
+
+void test_kepler(void) {
+  static rtcm3_kepler_set set;
+  static rtcm3_sat_states states;
+  static rtcm3_sat_states before;
+  static rtcm3_sat_states after;
+  rtcm_msg_eph eph;
+  make_test_kepler_eph(&eph);
+  rtcm3_kepler_set_init(&set);
+  assert(rtcm3_kepler_set_add(&set, &eph));
+
+  /* against a straight implementation of IS-GPS-200 */
+  double t = 7200 + 900;
+  rtcm3_kepler_compute(&set, &t, &states);
+  assert(fabs(states.x[0] - 10696397.737203017) < 1e-3);
+  assert(fabs(states.y[0] - -11338565.662029587) < 1e-3);
+  assert(fabs(states.z[0] - 21234937.668350007) < 1e-3);
+  assert(fabs(states.clock[0] - 0.000149977026249222) < 1e-15);
+
+  /* velocity and clock drift are the derivatives */
+  double t_before = t - 0.5;
+  double t_after = t + 0.5;
+  rtcm3_kepler_compute(&set, &t_before, &before);
+  rtcm3_kepler_compute(&set, &t_after, &after);
+  assert(fabs(after.x[0] - before.x[0] - states.vx[0]) < 1e-3);
+  assert(fabs(after.y[0] - before.y[0] - states.vy[0]) < 1e-3);
+  assert(fabs(after.z[0] - before.z[0] - states.vz[0]) < 1e-3);
+  assert(fabs(after.clock[0] - before.clock[0] - states.clock_rate[0]) <
+         1e-15);
+
+  /* a batch of constellations, each satellite at its own time across the
+   * week rollover, gives what each gives alone */
+  const rtcm_constellation_t constellations[] = {RTCM_CONSTELLATION_GPS,
+                                                 RTCM_CONSTELLATION_GAL,
+                                                 RTCM_CONSTELLATION_BDS,
+                                                 RTCM_CONSTELLATION_QZS};
+  static double times[RTCM3_KEPLER_MAX_SATS];
+  rtcm3_kepler_set_init(&set);
+  for (uint16_t i = 0; i < 100; i++) {
+    eph.constellation = constellations[i % 4];
+    eph.sat_id = (uint8_t)(i + 1);
+    eph.kepler.m0 = 478495692 + 15000000 * (i + 1);
+    /* wraps around the semicircle, as the 32 bit field does */
+    eph.kepler.omega0 =
+        (int32_t)(uint32_t)(-1435487078 + 30000000 * (int64_t)(i + 1));
+    assert(rtcm3_kepler_set_add(&set, &eph));
+    times[i] = fmod(604800 - 3600 + i * 60.0, 604800);
+  }
+  rtcm3_kepler_compute(&set, times, &states);
+  static rtcm3_kepler_set single;
+  for (uint16_t i = 0; i < set.n; i++) {
+    rtcm3_kepler_set_init(&single);
+    eph.constellation = set.constellation[i];
+    eph.kepler.m0 = 478495692 + 15000000 * (i + 1);
+    /* wraps around the semicircle, as the 32 bit field does */
+    eph.kepler.omega0 =
+        (int32_t)(uint32_t)(-1435487078 + 30000000 * (int64_t)(i + 1));
+    assert(rtcm3_kepler_set_add(&single, &eph));
+    rtcm3_kepler_compute(&single, &times[i], &after);
+    assert(fabs(after.x[0] - states.x[i]) < 1e-6);
+    assert(fabs(after.vz[0] - states.vz[i]) < 1e-9);
+    assert(fabs(after.clock[0] - states.clock[i]) < 1e-15);
+    double radius = sqrt(states.x[i] * states.x[i] +
+                         states.y[i] * states.y[i] +
+                         states.z[i] * states.z[i]);
+    assert(radius > 2.5e7 && radius < 2.8e7);
+  }
+
+  /* GLONASS has no Kepler elements */
+  eph.constellation = RTCM_CONSTELLATION_GLO;
+  assert(!rtcm3_kepler_set_add(&set, &eph));
+}
+
+void test_glo_orbit(void) {
+  /* the worked example of the GLONASS ICD */
+  rtcm_msg_eph eph;
+  memset(&eph, 0, sizeof(eph));
+  eph.constellation = RTCM_CONSTELLATION_GLO;
+  eph.sat_id = 3;
+  eph.glo.t_b = 13;
+  eph.glo.pos[0] = 14342162;
+  eph.glo.pos[1] = -24999172;
+  eph.glo.pos[2] = 43583008;
+  eph.glo.vel[0] = 821603;
+  eph.glo.vel[1] = 2940472;
+  eph.glo.vel[2] = 1418215;
+  eph.glo.acc[1] = 2;
+  eph.glo.acc[2] = -6;
+  eph.glo.tau = 1000;
+  eph.glo.gamma = 3;
+  static rtcm3_glo_orbit_set set;
+  static rtcm3_sat_states states;
+  rtcm3_glo_orbit_init(&set);
+  assert(rtcm3_glo_orbit_add(&set, &eph));
+  double t = 12300;
+  rtcm3_glo_orbit_compute(&set, &t, &states);
+  /* the ICD result, which also models the luni-solar terms */
+  assert(fabs(states.x[0] - 7523174.819) < 1);
+  assert(fabs(states.y[0] - -10506961.965) < 1);
+  assert(fabs(states.z[0] - 21999239.413) < 1);
+  /* fine step integration of the same equations */
+  assert(fabs(states.x[0] - 7523174.830145277) < 1e-3);
+  assert(fabs(states.y[0] - -10506962.059869999) < 1e-3);
+  assert(fabs(states.z[0] - 21999238.993661936) < 1e-3);
+  assert(fabs(states.vx[0] - 950.1260477830812) < 1e-6);
+  assert(fabs(states.clock[0] - (-1000 * 0x1p-30 + 3 * 0x1p-40 * 600)) <
+         1e-18);
+
+  /* stepping on from the cached state second by second agrees */
+  rtcm3_glo_orbit_add(&set, &eph);
+  for (t = 11701; t <= 12300; t++) {
+    rtcm3_glo_orbit_compute(&set, &t, &states);
+  }
+  assert(fabs(states.x[0] - 7523174.830145277) < 1e-3);
+  assert(fabs(states.z[0] - 21999238.993661936) < 1e-3);
+
+  /* back near t_b the state comes from the ephemeris again */
+  t = 11700;
+  rtcm3_glo_orbit_compute(&set, &t, &states);
+  assert(states.x[0] == 14342162 * 0x1p-11 * 1e3);
+  assert(states.vz[0] == 1418215 * 0x1p-20 * 1e3);
+
+  /* satellites at different times in one batch, a new ephemeris replaces the
+   * one of the same satellite, and the day wraps */
+  eph.sat_id = 4;
+  eph.glo.t_b = 0;
+  assert(rtcm3_glo_orbit_add(&set, &eph));
+  assert(rtcm3_glo_orbit_add(&set, &eph));
+  assert(set.n == 2);
+  double times[2] = {12300, 86400 - 600};
+  rtcm3_glo_orbit_compute(&set, times, &states);
+  assert(fabs(states.x[0] - 7523174.830145277) < 1e-3);
+  double radius =
+      sqrt(states.x[1] * states.x[1] + states.y[1] * states.y[1] +
+           states.z[1] * states.z[1]);
+  assert(radius > 2.5e7 && radius < 2.6e7);
+
+  eph.constellation = RTCM_CONSTELLATION_GPS;
+  assert(!rtcm3_glo_orbit_add(&set, &eph));
+}
+
+static void set_test_ssr_header(rtcm_msg_ssr_header *header,
+                                uint16_t message_num,
+                                uint32_t epoch_time,
+                                uint8_t iod_ssr,
+                                bool multi_message) {
+  memset(header, 0, sizeof(*header));
+  header->message_num = message_num;
+  header->constellation = RTCM_CONSTELLATION_GPS;
+  header->epoch_time = epoch_time;
+  header->iod_ssr = iod_ssr;
+  header->ssr_provider_id = 7;
+  header->ssr_solution_id = 1;
+  header->multi_message = multi_message;
+}
+
+void test_ssr_store(void) {
+  static rtcm3_ssr_store store;
+  static rtcm_msg_orbit orbit;
+  static rtcm_msg_code_bias code_bias;
+  rtcm3_ssr_corrections corr;
+  rtcm3_ssr_store_init(&store);
+
+  /* the orbit set of epoch 1000 comes in two messages */
+  set_test_ssr_header(&orbit.header, 1057, 1000, 2, true);
+  orbit.header.num_sats = 2;
+  orbit.orbit[0].sat_id = 3;
+  orbit.orbit[0].radial = 100;
+  orbit.orbit[1].sat_id = 5;
+  assert(RC_OK == rtcm3_ssr_store_add_orbit(&store, &orbit));
+
+  /* the clock message goes through the raw path, one satellite */
+  uint8_t payload[18];
+  memset(payload, 0, sizeof(payload));
+  rtcm_setbitu(payload, 0, 12, 1058);
+  rtcm_setbitu(payload, 12, 20, 1000);
+  rtcm_setbitu(payload, 37, 4, 2);
+  rtcm_setbitu(payload, 41, 16, 7);
+  rtcm_setbitu(payload, 57, 4, 1);
+  rtcm_setbitu(payload, 61, 6, 1);
+  rtcm_setbitu(payload, 67, 6, 3);
+  rtcm_setbits(payload, 73, 22, -55);
+  assert(RC_OK == rtcm3_ssr_store_update(&store, payload));
+  assert(!rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 3, 0, 1010, &corr));
+
+  set_test_ssr_header(&orbit.header, 1057, 1000, 2, false);
+  orbit.header.num_sats = 1;
+  orbit.orbit[0].sat_id = 9;
+  assert(RC_OK == rtcm3_ssr_store_add_orbit(&store, &orbit));
+  assert(rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 3, 0, 1010, &corr));
+  assert(corr.iod_ssr == 2 && corr.orbit_epoch_time == 1000);
+  assert(corr.orbit->radial == 100 && corr.clock->c0 == -55);
+  assert(corr.code_bias == NULL && corr.phase_bias == NULL);
+  /* no clock for these */
+  assert(!rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 5, 0, 1010, &corr));
+  assert(!rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 9, 0, 1010, &corr));
+  /* too old, and a correction of the next week */
+  assert(!rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 3, 0, 1091, &corr));
+  assert(!rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 3, 0, 999, &corr));
+
+  set_test_ssr_header(&code_bias.header, 1059, 1000, 2, false);
+  code_bias.header.num_sats = 1;
+  code_bias.sats[0].sat_id = 3;
+  code_bias.sats[0].num_code_biases = 2;
+  code_bias.sats[0].signals[0].signal_id = 0;
+  code_bias.sats[0].signals[0].code_bias = -12;
+  code_bias.sats[0].signals[1].signal_id = 11;
+  code_bias.sats[0].signals[1].code_bias = 34;
+  assert(RC_OK == rtcm3_ssr_store_add_code_bias(&store, &code_bias));
+  assert(rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 3, 11, 1010, &corr));
+  assert(corr.code_bias && *corr.code_bias == 34);
+  assert(rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 3, 2, 1010, &corr));
+  assert(corr.code_bias == NULL);
+
+  /* the previous set is served until the next one is complete */
+  set_test_ssr_header(&orbit.header, 1057, 1005, 2, true);
+  orbit.header.num_sats = 1;
+  orbit.orbit[0].sat_id = 3;
+  orbit.orbit[0].radial = 200;
+  assert(RC_OK == rtcm3_ssr_store_add_orbit(&store, &orbit));
+  assert(rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 3, 0, 1010, &corr));
+  assert(corr.orbit->radial == 100);
+  set_test_ssr_header(&orbit.header, 1057, 1005, 2, false);
+  orbit.header.num_sats = 0;
+  assert(RC_OK == rtcm3_ssr_store_add_orbit(&store, &orbit));
+  assert(rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 3, 0, 1010, &corr));
+  assert(corr.orbit->radial == 200 && corr.orbit_epoch_time == 1005);
+
+  /* a new IOD SSR does not combine with the old clocks and biases */
+  set_test_ssr_header(&orbit.header, 1057, 1010, 3, false);
+  orbit.header.num_sats = 2;
+  orbit.orbit[0].sat_id = 3;
+  orbit.orbit[1].sat_id = 5;
+  assert(RC_OK == rtcm3_ssr_store_add_orbit(&store, &orbit));
+  assert(!rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 3, 0, 1010, &corr));
+
+  /* a set that never completes is dropped with its satellites */
+  static rtcm_msg_clock clock;
+  set_test_ssr_header(&clock.header, 1058, 1010, 3, true);
+  clock.header.num_sats = 1;
+  clock.clock[0].sat_id = 5;
+  assert(RC_OK == rtcm3_ssr_store_add_clock(&store, &clock));
+  set_test_ssr_header(&clock.header, 1058, 1015, 3, false);
+  clock.header.num_sats = 1;
+  clock.clock[0].sat_id = 3;
+  assert(RC_OK == rtcm3_ssr_store_add_clock(&store, &clock));
+  assert(rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 3, 11, 1020, &corr));
+  assert(corr.iod_ssr == 3 && corr.clock_epoch_time == 1015);
+  assert(corr.code_bias == NULL);
+  assert(!rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 5, 0, 1020, &corr));
+
+  /* other providers are not mixed in */
+  set_test_ssr_header(&clock.header, 1058, 1020, 3, false);
+  clock.header.ssr_provider_id = 8;
+  assert(RC_INVALID_MESSAGE == rtcm3_ssr_store_add_clock(&store, &clock));
+  assert(store.rejected == 1);
+  assert(!rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GAL, 3, 0, 1020, &corr));
+  assert(!rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 64, 0, 1020, &corr));
+}
+
+/* Collects what rtcm3_decode_ssr_visit hands out into the message structs
+ * of the regular decoders */
+typedef struct {
+  rtcm_msg_ssr_header header;
+  uint8_t num_orbits;
+  uint8_t num_clocks;
+  int num_sats;
+  rtcm_msg_orbit_clock orbit_clock;
+  rtcm_msg_code_bias code_bias;
+  rtcm_msg_phase_bias phase_bias;
+} ssr_visit_result;
+
+static bool visit_header(void *ctx, const rtcm_msg_ssr_header *header) {
+  ssr_visit_result *result = ctx;
+  result->header = *header;
+  return true;
+}
+
+static void visit_orbit(void *ctx, const rtcm_msg_ssr_orbit_corr *orbit) {
+  ssr_visit_result *result = ctx;
+  result->orbit_clock.orbit[result->num_orbits++] = *orbit;
+}
+
+static void visit_clock(void *ctx, const rtcm_msg_ssr_clock_corr *clock) {
+  ssr_visit_result *result = ctx;
+  result->orbit_clock.clock[result->num_clocks++] = *clock;
+}
+
+static void visit_bias_sat(void *ctx, const rtcm3_ssr_bias_sat *sat) {
+  ssr_visit_result *result = ctx;
+  result->num_sats++;
+  rtcm_msg_ssr_code_bias_sat *code =
+      &result->code_bias.sats[result->num_sats - 1];
+  code->sat_id = sat->sat_id;
+  rtcm_msg_ssr_phase_bias_sat *phase =
+      &result->phase_bias.sats[result->num_sats - 1];
+  phase->sat_id = sat->sat_id;
+  phase->yaw_angle = sat->yaw_angle;
+  phase->yaw_rate = sat->yaw_rate;
+}
+
+static void visit_code_bias(void *ctx,
+                            uint8_t sat_id,
+                            const rtcm_msg_ssr_code_bias_sig *sig) {
+  ssr_visit_result *result = ctx;
+  rtcm_msg_ssr_code_bias_sat *sat =
+      &result->code_bias.sats[result->num_sats - 1];
+  assert(sat->sat_id == sat_id);
+  sat->signals[sat->num_code_biases++] = *sig;
+}
+
+static void visit_phase_bias(void *ctx,
+                             uint8_t sat_id,
+                             const rtcm_msg_ssr_phase_bias_sig *sig) {
+  ssr_visit_result *result = ctx;
+  rtcm_msg_ssr_phase_bias_sat *sat =
+      &result->phase_bias.sats[result->num_sats - 1];
+  assert(sat->sat_id == sat_id);
+  sat->signals[sat->num_phase_biases++] = *sig;
+}
+
+static const rtcm3_ssr_visitor test_ssr_visitor = {visit_header,
+                                                   visit_orbit,
+                                                   visit_clock,
+                                                   visit_bias_sat,
+                                                   visit_code_bias,
+                                                   visit_phase_bias};
+
+static void write_test_bits(uint8_t buff[],
+                            uint16_t *bit,
+                            uint8_t len,
+                            uint32_t value) {
+  rtcm_setbitu(buff, *bit, len, value);
+  *bit += len;
+}
+
+/* SSR header of a GPS message with num_sats satellites */
+static void write_test_ssr_header(uint8_t buff[],
+                                  uint16_t *bit,
+                                  uint16_t msg_num,
+                                  uint8_t num_sats) {
+  write_test_bits(buff, bit, 12, msg_num);
+  write_test_bits(buff, bit, 20, 345600);
+  write_test_bits(buff, bit, 4, 2);
+  write_test_bits(buff, bit, 1, 0);
+  if (1060 == msg_num) {
+    write_test_bits(buff, bit, 1, 1);
+  }
+  write_test_bits(buff, bit, 4, 5);
+  write_test_bits(buff, bit, 16, 300);
+  write_test_bits(buff, bit, 4, 1);
+  if (1265 == msg_num) {
+    write_test_bits(buff, bit, 2, 3);
+  }
+  write_test_bits(buff, bit, 6, num_sats);
+}
+
+void test_ssr_visit(void) {
+  static uint8_t buff[RTCM3_MAX_PAYLOAD_LEN];
+  static ssr_visit_result result;
+  static rtcm3_msg msg;
+  uint16_t bit = 0;
+
+  /* combined orbit and clock */
+  memset(buff, 0, sizeof(buff));
+  write_test_ssr_header(buff, &bit, 1060, 3);
+  for (uint8_t i = 0; i < 3; i++) {
+    write_test_bits(buff, &bit, 6, 4 + i * 9);
+    write_test_bits(buff, &bit, 8, 100 + i);
+    static const uint8_t widths[] = {22, 20, 20, 21, 19, 19, 22, 21, 27};
+    for (uint8_t j = 0; j < sizeof(widths); j++) {
+      write_test_bits(buff, &bit, widths[j], (i * 131u + j * 17u) * 977u);
+    }
+  }
+  memset(&result, 0, sizeof(result));
+  assert(RC_OK == rtcm3_decode_ssr_visit(buff, &test_ssr_visitor, &result));
+  assert(RC_OK == rtcm3_decode_orbit_clock(buff, &msg.orbit_clock));
+  assert(result.header.num_sats == 3 && result.header.iod_ssr == 5);
+  assert(result.header.sat_ref_datum);
+  assert(result.num_orbits == 3 && result.num_clocks == 3);
+  for (uint8_t i = 0; i < 3; i++) {
+    const rtcm_msg_ssr_orbit_corr *a = &result.orbit_clock.orbit[i];
+    const rtcm_msg_ssr_orbit_corr *b = &msg.orbit_clock.orbit[i];
+    assert(a->sat_id == b->sat_id && a->iode == b->iode);
+    assert(a->radial == b->radial && a->along_track == b->along_track);
+    assert(a->cross_track == b->cross_track);
+    assert(a->dot_radial == b->dot_radial);
+    assert(a->dot_along_track == b->dot_along_track);
+    assert(a->dot_cross_track == b->dot_cross_track);
+    const rtcm_msg_ssr_clock_corr *c = &result.orbit_clock.clock[i];
+    const rtcm_msg_ssr_clock_corr *d = &msg.orbit_clock.clock[i];
+    assert(c->sat_id == d->sat_id && c->c0 == d->c0);
+    assert(c->c1 == d->c1 && c->c2 == d->c2);
+  }
+
+  /* code biases, the second satellite without any */
+  bit = 0;
+  memset(buff, 0, sizeof(buff));
+  write_test_ssr_header(buff, &bit, 1059, 3);
+  for (uint8_t i = 0; i < 3; i++) {
+    uint8_t num_biases = (uint8_t)(1 == i ? 0 : 2 + i);
+    write_test_bits(buff, &bit, 6, 10 + i);
+    write_test_bits(buff, &bit, 5, num_biases);
+    for (uint8_t j = 0; j < num_biases; j++) {
+      write_test_bits(buff, &bit, 5, j * 3u);
+      write_test_bits(buff, &bit, 14, 8000u + i * 500u + j);
+    }
+  }
+  memset(&result, 0, sizeof(result));
+  assert(RC_OK == rtcm3_decode_ssr_visit(buff, &test_ssr_visitor, &result));
+  assert(RC_OK == rtcm3_decode_code_bias(buff, &msg.code_bias));
+  assert(result.num_sats == 3);
+  for (uint8_t i = 0; i < 3; i++) {
+    const rtcm_msg_ssr_code_bias_sat *a = &result.code_bias.sats[i];
+    const rtcm_msg_ssr_code_bias_sat *b = &msg.code_bias.sats[i];
+    assert(a->sat_id == b->sat_id);
+    assert(a->num_code_biases == b->num_code_biases);
+    for (uint8_t j = 0; j < a->num_code_biases; j++) {
+      assert(a->signals[j].signal_id == b->signals[j].signal_id);
+      assert(a->signals[j].code_bias == b->signals[j].code_bias);
+    }
+  }
+
+  /* phase biases */
+  bit = 0;
+  memset(buff, 0, sizeof(buff));
+  write_test_ssr_header(buff, &bit, 1265, 2);
+  for (uint8_t i = 0; i < 2; i++) {
+    write_test_bits(buff, &bit, 6, 20 + i);
+    write_test_bits(buff, &bit, 5, 3);
+    write_test_bits(buff, &bit, 9, 300 + i);
+    write_test_bits(buff, &bit, 8, 250);
+    for (uint8_t j = 0; j < 3; j++) {
+      write_test_bits(buff, &bit, 5, 1 + j);
+      write_test_bits(buff, &bit, 1, j & 1);
+      write_test_bits(buff, &bit, 2, j);
+      write_test_bits(buff, &bit, 4, 9);
+      write_test_bits(buff, &bit, 20, 0xF0000u + i * 77u + j);
+    }
+  }
+  memset(&result, 0, sizeof(result));
+  assert(RC_OK == rtcm3_decode_ssr_visit(buff, &test_ssr_visitor, &result));
+  assert(RC_OK == rtcm3_decode_phase_bias(buff, &msg.phase_bias));
+  assert(result.header.dispersive_bias_consistency);
+  assert(result.num_sats == 2);
+  for (uint8_t i = 0; i < 2; i++) {
+    const rtcm_msg_ssr_phase_bias_sat *a = &result.phase_bias.sats[i];
+    const rtcm_msg_ssr_phase_bias_sat *b = &msg.phase_bias.sats[i];
+    assert(a->sat_id == b->sat_id);
+    assert(a->yaw_angle == b->yaw_angle && a->yaw_rate == -6);
+    assert(a->num_phase_biases == b->num_phase_biases);
+    for (uint8_t j = 0; j < a->num_phase_biases; j++) {
+      const rtcm_msg_ssr_phase_bias_sig *c = &a->signals[j];
+      const rtcm_msg_ssr_phase_bias_sig *d = &b->signals[j];
+      assert(c->signal_id == d->signal_id);
+      assert(c->integer_indicator == d->integer_indicator);
+      assert(c->widelane_indicator == d->widelane_indicator);
+      assert(c->discontinuity_indicator == d->discontinuity_indicator);
+      assert(c->phase_bias == d->phase_bias && c->phase_bias < 0);
+    }
+  }
+
+  /* the raw path of the store goes through the visitor */
+  static rtcm3_ssr_store store;
+  rtcm3_ssr_store_init(&store);
+  assert(RC_OK == rtcm3_ssr_store_update(&store, buff));
+  assert(store.sats[RTCM_CONSTELLATION_GPS][21].yaw_angle[1] == 301);
+  assert(store.sats[RTCM_CONSTELLATION_GPS][21].phase_bias_mask[1] == 0xE);
+
+  /* only SSR messages are walked */
+  rtcm_setbitu(buff, 0, 12, 1005);
+  assert(RC_MESSAGE_TYPE_MISMATCH ==
+         rtcm3_decode_ssr_visit(buff, &test_ssr_visitor, &result));
+}
+
+void test_ssr_encode(void) {
+  static uint8_t buff[RTCM3_MAX_PAYLOAD_LEN];
+  static uint8_t encoded[RTCM3_MAX_PAYLOAD_LEN];
+  static rtcm3_msg msg;
+  static rtcm_msg_orbit_clock orbit_clock;
+  uint16_t bit = 0;
+
+  /* a hand written message encodes back to the same bytes */
+  memset(buff, 0, sizeof(buff));
+  write_test_ssr_header(buff, &bit, 1060, 3);
+  for (uint8_t i = 0; i < 3; i++) {
+    write_test_bits(buff, &bit, 6, 4 + i * 9);
+    write_test_bits(buff, &bit, 8, 100 + i);
+    static const uint8_t widths[] = {22, 20, 20, 21, 19, 19, 22, 21, 27};
+    for (uint8_t j = 0; j < sizeof(widths); j++) {
+      write_test_bits(buff, &bit, widths[j], (i * 131u + j * 17u) * 977u);
+    }
+  }
+  uint16_t len = (uint16_t)((bit + 7) / 8);
+  memset(&msg, 0, sizeof(msg));
+  assert(RC_OK == rtcm3_decode_msg(buff, &msg));
+  assert(RTCM3_MSG_SSR_ORBIT_CLOCK == msg.kind);
+  assert(rtcm3_encoded_size_msg(&msg) == len);
+  memset(encoded, 0xff, sizeof(encoded));
+  assert(rtcm3_encode_msg(&msg, encoded) == len);
+  assert(0 == memcmp(buff, encoded, len));
+
+  bit = 0;
+  memset(buff, 0, sizeof(buff));
+  write_test_ssr_header(buff, &bit, 1265, 2);
+  for (uint8_t i = 0; i < 2; i++) {
+    write_test_bits(buff, &bit, 6, 20 + i);
+    write_test_bits(buff, &bit, 5, 3);
+    write_test_bits(buff, &bit, 9, 300 + i);
+    write_test_bits(buff, &bit, 8, 250);
+    for (uint8_t j = 0; j < 3; j++) {
+      write_test_bits(buff, &bit, 5, 1 + j);
+      write_test_bits(buff, &bit, 1, j & 1);
+      write_test_bits(buff, &bit, 2, j);
+      write_test_bits(buff, &bit, 4, 9);
+      write_test_bits(buff, &bit, 20, 0xfff00u + j);
+    }
+  }
+  len = (uint16_t)((bit + 7) / 8);
+  assert(RC_OK == rtcm3_decode_phase_bias(buff, &msg.phase_bias));
+  assert(rtcm3_encoded_size_phase_bias(&msg.phase_bias) == len);
+  assert(rtcm3_encode_phase_bias(&msg.phase_bias, encoded) == len);
+  assert(0 == memcmp(buff, encoded, len));
+
+  /* BDS orbits carry the IODCRC, GLONASS a shorter epoch time */
+  memset(&orbit_clock, 0, sizeof(orbit_clock));
+  orbit_clock.header.message_num = 1261;
+  orbit_clock.header.epoch_time = 604799;
+  orbit_clock.header.num_sats = 2;
+  for (uint8_t i = 0; i < 2; i++) {
+    orbit_clock.orbit[i].sat_id = 30 + i;
+    orbit_clock.clock[i].sat_id = 30 + i;
+    orbit_clock.orbit[i].iode = 200 + i;
+    orbit_clock.orbit[i].iodcrc = 0xabcdef - i;
+    orbit_clock.orbit[i].radial = -2000000 + i;
+    orbit_clock.orbit[i].dot_cross_track = 262143;
+    orbit_clock.clock[i].c2 = -67108864;
+  }
+  assert(rtcm3_encode_orbit_clock(&orbit_clock, buff) ==
+         rtcm3_encoded_size_orbit_clock(&orbit_clock));
+  assert(RC_OK == rtcm3_decode_orbit_clock(buff, &msg.orbit_clock));
+  assert(msg.orbit_clock.header.epoch_time == 604799);
+  for (uint8_t i = 0; i < 2; i++) {
+    assert(msg.orbit_clock.orbit[i].sat_id == 30 + i);
+    assert(msg.orbit_clock.orbit[i].iodcrc == 0xabcdefu - i);
+    assert(msg.orbit_clock.orbit[i].radial == -2000000 + i);
+    assert(msg.orbit_clock.orbit[i].dot_cross_track == 262143);
+    assert(msg.orbit_clock.clock[i].c2 == -67108864);
+  }
+  msg.clock.header.message_num = 1064;
+  msg.clock.header.epoch_time = 86399;
+  msg.clock.header.num_sats = 1;
+  msg.clock.clock[0].sat_id = 24;
+  msg.clock.clock[0].c1 = -5;
+  assert(rtcm3_encode_clock(&msg.clock, buff) == 18);
+  assert(RC_OK == rtcm3_decode_clock(buff, &msg.clock));
+  assert(msg.clock.header.epoch_time == 86399);
+  assert(msg.clock.clock[0].sat_id == 24 && msg.clock.clock[0].c1 == -5);
+
+  /* the wrong type, too many satellites or biases are rejected */
+  orbit_clock.header.message_num = 1258;
+  assert(rtcm3_encode_orbit_clock(&orbit_clock, buff) == 0);
+  orbit_clock.header.message_num = 1261;
+  orbit_clock.header.num_sats = 64;
+  assert(rtcm3_encoded_size_orbit_clock(&orbit_clock) == 0);
+  msg.phase_bias.sats[1].num_phase_biases = 32;
+  assert(rtcm3_encode_phase_bias(&msg.phase_bias, buff) == 0);
+
+  /* satellites are split over frames by count and by payload size */
+  static rtcm_msg_code_bias code_bias;
+  static uint8_t frames[8 * RTCM3_MAX_FRAME_LEN];
+  size_t frames_len = 0;
+  memset(&code_bias, 0, sizeof(code_bias));
+  code_bias.header.message_num = 1059;
+  code_bias.header.num_sats = 64;
+  for (uint8_t i = 0; i < 64; i++) {
+    code_bias.sats[i].sat_id = i;
+  }
+  assert(rtcm3_encode_code_bias(&code_bias, buff) == 0);
+  assert(rtcm3_encode_code_bias_frames(
+             &code_bias, frames, sizeof(frames), &frames_len) == 2);
+  size_t pos = 0;
+  for (uint8_t i = 0; i < 2; i++) {
+    uint16_t frame_len = rtcm3_frame_check(&frames[pos], frames_len - pos);
+    assert(frame_len > 0);
+    assert(RC_OK == rtcm3_decode_code_bias(
+                        &frames[pos + RTCM3_FRAME_HEADER_LEN], &msg.code_bias));
+    assert(msg.code_bias.header.multi_message == (i == 0));
+    assert(msg.code_bias.header.num_sats == (i == 0 ? 63 : 1));
+    assert(msg.code_bias.sats[0].sat_id == (i == 0 ? 0 : 63));
+    pos += frame_len;
+  }
+  assert(pos == frames_len);
+
+  static rtcm_msg_phase_bias phase_bias;
+  memset(&phase_bias, 0, sizeof(phase_bias));
+  phase_bias.header.message_num = 1265;
+  phase_bias.header.multi_message = true;
+  phase_bias.header.num_sats = 20;
+  for (uint8_t i = 0; i < 20; i++) {
+    phase_bias.sats[i].sat_id = i + 1;
+    phase_bias.sats[i].num_phase_biases = 31;
+    for (uint8_t j = 0; j < 31; j++) {
+      phase_bias.sats[i].signals[j].signal_id = j;
+      phase_bias.sats[i].signals[j].phase_bias = -i * 1000 - j;
+    }
+  }
+  /* 1020 bits per satellite, 7 fit into one payload */
+  assert(rtcm3_encoded_size_phase_bias(&phase_bias) == 0);
+  assert(rtcm3_encode_phase_bias_frames(
+             &phase_bias, frames, sizeof(frames), &frames_len) == 3);
+  pos = 0;
+  uint8_t sats_seen = 0;
+  for (uint8_t i = 0; i < 3; i++) {
+    uint16_t frame_len = rtcm3_frame_check(&frames[pos], frames_len - pos);
+    assert(frame_len > 0 && frame_len <= RTCM3_MAX_FRAME_LEN);
+    assert(RC_OK ==
+           rtcm3_decode_phase_bias(&frames[pos + RTCM3_FRAME_HEADER_LEN],
+                                   &msg.phase_bias));
+    /* the last frame keeps the flag of the header */
+    assert(msg.phase_bias.header.multi_message);
+    for (uint8_t s = 0; s < msg.phase_bias.header.num_sats; s++) {
+      const rtcm_msg_ssr_phase_bias_sat *sat = &msg.phase_bias.sats[s];
+      assert(sat->sat_id == sats_seen + 1);
+      assert(sat->num_phase_biases == 31);
+      assert(sat->signals[30].phase_bias == -sats_seen * 1000 - 30);
+      sats_seen++;
+    }
+    pos += frame_len;
+  }
+  assert(pos == frames_len && sats_seen == 20);
+  /* the frames do not fit into a smaller buffer */
+  assert(rtcm3_encode_phase_bias_frames(
+             &phase_bias, frames, 2 * RTCM3_MAX_FRAME_LEN, &frames_len) == 0);
+  assert(frames_len == 0);
+}
+
+void test_ssr_hr_clock(void) {
+  static uint8_t buff[RTCM3_MAX_PAYLOAD_LEN];
+  static rtcm3_ssr_clock_table table;
+  static rtcm3_ssr_store store;
+  rtcm_msg_ssr_header header;
+  uint16_t bit = 0;
+
+  static const uint8_t sat_ids[] = {4, 13, 22};
+  static const int32_t hr_clocks[] = {-2097152, 5, 2097151};
+  memset(buff, 0, sizeof(buff));
+  write_test_ssr_header(buff, &bit, 1062, 3);
+  for (uint8_t i = 0; i < 3; i++) {
+    write_test_bits(buff, &bit, 6, sat_ids[i]);
+    write_test_bits(buff, &bit, 22, (uint32_t)hr_clocks[i]);
+  }
+  rtcm3_ssr_clock_table_init(&table);
+  assert(RC_OK == rtcm3_decode_hr_clock(buff, &header, &table));
+  assert(header.epoch_time == 345600 && header.iod_ssr == 5);
+  assert(header.ssr_provider_id == 300 && header.num_sats == 3);
+  const rtcm3_ssr_clock_sat *sats = table.sats[RTCM_CONSTELLATION_GPS];
+  for (uint8_t i = 0; i < 3; i++) {
+    const rtcm3_ssr_clock_sat *sat = &sats[sat_ids[i]];
+    assert(sat->has_hr_clock && !sat->has_ura);
+    assert(sat->high_rate_clock == hr_clocks[i]);
+    assert(sat->hr_clock_epoch_time == 345600 && sat->hr_clock_iod_ssr == 5);
+  }
+  assert(!sats[5].has_hr_clock);
+  assert(RC_MESSAGE_TYPE_MISMATCH == rtcm3_decode_ura(buff, &header, &table));
+
+  /* the URA of the same satellites */
+  static uint8_t ura_buff[RTCM3_MAX_PAYLOAD_LEN];
+  bit = 0;
+  memset(ura_buff, 0, sizeof(ura_buff));
+  write_test_ssr_header(ura_buff, &bit, 1061, 3);
+  for (uint8_t i = 0; i < 3; i++) {
+    write_test_bits(ura_buff, &bit, 6, sat_ids[i]);
+    write_test_bits(ura_buff, &bit, 6, 0x3fu - i);
+  }
+  assert(RC_OK == rtcm3_decode_ura(ura_buff, &header, &table));
+  for (uint8_t i = 0; i < 3; i++) {
+    const rtcm3_ssr_clock_sat *sat = &sats[sat_ids[i]];
+    assert(sat->has_ura && sat->ura == 0x3f - i);
+    assert(sat->high_rate_clock == hr_clocks[i]);
+  }
+
+  /* the store adds both to the orbit and clock of the same IOD SSR */
+  static uint8_t orbit_clock_buff[RTCM3_MAX_PAYLOAD_LEN];
+  bit = 0;
+  memset(orbit_clock_buff, 0, sizeof(orbit_clock_buff));
+  write_test_ssr_header(orbit_clock_buff, &bit, 1060, 3);
+  for (uint8_t i = 0; i < 3; i++) {
+    write_test_bits(orbit_clock_buff, &bit, 6, sat_ids[i]);
+    write_test_bits(orbit_clock_buff, &bit, 8, 100 + i);
+    static const uint8_t widths[] = {22, 20, 20, 21, 19, 19, 22, 21, 27};
+    for (uint8_t j = 0; j < sizeof(widths); j++) {
+      write_test_bits(orbit_clock_buff, &bit, widths[j], j);
+    }
+  }
+  rtcm3_ssr_corrections corr;
+  rtcm3_ssr_store_init(&store);
+  assert(RC_OK == rtcm3_ssr_store_update(&store, orbit_clock_buff));
+  assert(rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 13, 0, 345601, &corr));
+  assert(NULL == corr.high_rate_clock && NULL == corr.ura);
+  assert(RC_OK == rtcm3_ssr_store_update(&store, buff));
+  assert(RC_OK == rtcm3_ssr_store_update(&store, ura_buff));
+  assert(rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 13, 0, 345601, &corr));
+  assert(NULL != corr.high_rate_clock && *corr.high_rate_clock == 5);
+  assert(NULL != corr.ura && *corr.ura == 0x3e);
+
+  /* a high rate clock older than the clock is not applied */
+  rtcm_setbitu(orbit_clock_buff, 12, 20, 345605);
+  assert(RC_OK == rtcm3_ssr_store_update(&store, orbit_clock_buff));
+  assert(rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 13, 0, 345606, &corr));
+  assert(NULL == corr.high_rate_clock && NULL != corr.ura);
+
+  /* nor is one of another IOD SSR, or of another provider */
+  rtcm_setbitu(buff, 12, 20, 345606);
+  rtcm_setbitu(buff, 37, 4, 6);
+  assert(RC_OK == rtcm3_ssr_store_update(&store, buff));
+  assert(rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 13, 0, 345606, &corr));
+  assert(NULL == corr.high_rate_clock);
+  rtcm_setbitu(buff, 37, 4, 5);
+  rtcm_setbitu(buff, 41, 16, 301);
+  assert(RC_INVALID_MESSAGE == rtcm3_ssr_store_update(&store, buff));
+  assert(store.rejected == 1);
+  rtcm_setbitu(buff, 41, 16, 300);
+  assert(RC_OK == rtcm3_ssr_store_update(&store, buff));
+  assert(rtcm3_ssr_store_lookup(
+      &store, RTCM_CONSTELLATION_GPS, 13, 0, 345606, &corr));
+  assert(NULL != corr.high_rate_clock);
+}
+
+/* displacement of a corrected position along a unit vector */
+static double test_displacement(const rtcm3_sat_states *broadcast,
+                                const rtcm3_sat_states *precise,
+                                uint16_t i,
+                                const double dir[3]) {
+  return (precise->x[i] - broadcast->x[i]) * dir[0] +
+         (precise->y[i] - broadcast->y[i]) * dir[1] +
+         (precise->z[i] - broadcast->z[i]) * dir[2];
+}
+
+void test_ssr_apply(void) {
+  static rtcm3_kepler_set set;
+  static rtcm3_ssr_store store;
+  static rtcm3_ssr_batch batch;
+  static rtcm3_sat_states broadcast;
+  static rtcm3_sat_states precise;
+  static rtcm_msg_orbit_clock orbit_clock;
+
+  /* sat 22 has a correction of another IODE, sat 30 none at all */
+  static const uint8_t sat_ids[] = {4, 13, 22, 30};
+  rtcm_msg_eph eph;
+  make_test_kepler_eph(&eph);
+  rtcm3_kepler_set_init(&set);
+  double t[4];
+  for (uint8_t i = 0; i < 4; i++) {
+    eph.sat_id = sat_ids[i];
+    eph.kepler.iode = 100 + i;
+    eph.kepler.m0 = 478495692 + 150000000 * i;
+    assert(rtcm3_kepler_set_add(&set, &eph));
+    t[i] = 7210;
+  }
+  memset(&orbit_clock, 0, sizeof(orbit_clock));
+  orbit_clock.header.message_num = 1060;
+  orbit_clock.header.constellation = RTCM_CONSTELLATION_GPS;
+  orbit_clock.header.epoch_time = 7200;
+  orbit_clock.header.iod_ssr = 1;
+  orbit_clock.header.num_sats = 3;
+  for (uint8_t i = 0; i < 3; i++) {
+    orbit_clock.orbit[i].sat_id = sat_ids[i];
+    orbit_clock.clock[i].sat_id = sat_ids[i];
+    orbit_clock.orbit[i].iode = 100 + i + (2 == i);
+  }
+  /* 1 m radial plus 1 mm/s, 3 m clock plus 1 mm/s */
+  orbit_clock.orbit[0].radial = 10000;
+  orbit_clock.orbit[0].dot_radial = 1000;
+  orbit_clock.clock[0].c0 = 30000;
+  orbit_clock.clock[0].c1 = 1000;
+  /* 1 m along and cross track */
+  orbit_clock.orbit[1].along_track = 2500;
+  orbit_clock.orbit[1].cross_track = 2500;
+  rtcm3_ssr_store_init(&store);
+  assert(RC_OK == rtcm3_ssr_store_add_orbit_clock(&store, &orbit_clock));
+
+  rtcm3_kepler_compute(&set, t, &broadcast);
+  assert(rtcm3_ssr_batch_kepler(&batch, &store, &set, 7210) == 2);
+  assert(batch.corrected[0] && batch.corrected[1]);
+  assert(!batch.corrected[2] && !batch.corrected[3]);
+  rtcm3_ssr_batch_apply(&batch, t, &broadcast, &precise);
+
+  for (uint8_t i = 0; i < 4; i++) {
+    double r = sqrt(broadcast.x[i] * broadcast.x[i] +
+                    broadcast.y[i] * broadcast.y[i] +
+                    broadcast.z[i] * broadcast.z[i]);
+    double v = sqrt(broadcast.vx[i] * broadcast.vx[i] +
+                    broadcast.vy[i] * broadcast.vy[i] +
+                    broadcast.vz[i] * broadcast.vz[i]);
+    const double radial[3] = {
+        broadcast.x[i] / r, broadcast.y[i] / r, broadcast.z[i] / r};
+    const double along[3] = {
+        broadcast.vx[i] / v, broadcast.vy[i] / v, broadcast.vz[i] / v};
+    double dx = precise.x[i] - broadcast.x[i];
+    double dy = precise.y[i] - broadcast.y[i];
+    double dz = precise.z[i] - broadcast.z[i];
+    double moved = sqrt(dx * dx + dy * dy + dz * dz);
+    if (0 == i) {
+      /* the orbit is nearly circular, radial is close to the position */
+      assert(fabs(moved - 1.01) < 1e-9);
+      assert(fabs(test_displacement(&broadcast, &precise, i, radial) + 1.01) <
+             1e-3);
+      assert(fabs(precise.clock[i] - broadcast.clock[i] - 3.01 / GPS_C) <
+             1e-15);
+      assert(fabs(precise.clock_rate[i] - broadcast.clock_rate[i] -
+                  0.001 / GPS_C) < 1e-18);
+    } else if (1 == i) {
+      assert(fabs(moved - sqrt(2)) < 1e-9);
+      assert(fabs(test_displacement(&broadcast, &precise, i, along) + 1) <
+             1e-9);
+      /* the velocity is off the horizontal by the flight path angle */
+      assert(fabs(test_displacement(&broadcast, &precise, i, radial)) < 0.02);
+      assert(precise.clock[i] == broadcast.clock[i]);
+    } else {
+      assert(precise.x[i] == broadcast.x[i] && precise.y[i] == broadcast.y[i]);
+      assert(precise.z[i] == broadcast.z[i]);
+      assert(precise.vx[i] == broadcast.vx[i]);
+      assert(precise.clock[i] == broadcast.clock[i]);
+    }
+  }
+
+  /* in place */
+  rtcm3_ssr_batch_apply(&batch, t, &broadcast, &broadcast);
+  assert(broadcast.x[0] == precise.x[0] && broadcast.vz[1] == precise.vz[1]);
+
+  /* GLONASS matches on t_b, the time is the one of the day */
+  memset(&eph, 0, sizeof(eph));
+  eph.constellation = RTCM_CONSTELLATION_GLO;
+  eph.sat_id = 3;
+  eph.glo.t_b = 0;
+  eph.glo.pos[0] = 14342162;
+  eph.glo.pos[1] = -24999172;
+  eph.glo.pos[2] = 43583008;
+  eph.glo.vel[0] = 821603;
+  eph.glo.vel[1] = 2940472;
+  eph.glo.vel[2] = 1418215;
+  static rtcm3_glo_orbit_set glo_set;
+  rtcm3_glo_orbit_init(&glo_set);
+  assert(rtcm3_glo_orbit_add(&glo_set, &eph));
+  orbit_clock.header.message_num = 1066;
+  orbit_clock.header.constellation = RTCM_CONSTELLATION_GLO;
+  orbit_clock.header.epoch_time = 86390;
+  orbit_clock.header.num_sats = 1;
+  orbit_clock.orbit[0].sat_id = 3;
+  orbit_clock.clock[0].sat_id = 3;
+  orbit_clock.orbit[0].iode = 0;
+  assert(RC_OK == rtcm3_ssr_store_add_orbit_clock(&store, &orbit_clock));
+  /* 20 s after the corrections, across the end of the day */
+  double glo_t = 10;
+  rtcm3_glo_orbit_compute(&glo_set, &glo_t, &broadcast);
+  assert(rtcm3_ssr_batch_glo(&batch, &store, &glo_set, 10) == 1);
+  rtcm3_ssr_batch_apply(&batch, &glo_t, &broadcast, &precise);
+  assert(fabs(precise.clock[0] - broadcast.clock[0] - 3.02 / GPS_C) < 1e-15);
+  glo_set.iode[0] = 1;
+  assert(rtcm3_ssr_batch_glo(&batch, &store, &glo_set, 10) == 0);
+}
+
+void test_bytes(void) {
+  uint8_t src[64];
+  for (uint8_t i = 0; i < sizeof(src); i++) {
+    src[i] = rand();
+  }
+
+  for (uint32_t pos = 0; pos < 16; pos++) {
+    for (uint32_t len = 0; len <= 40; len++) {
+      /* reading back matches the bit at a time accessor */
+      uint8_t out[48];
+      memset(out, 0xa5, sizeof(out));
+      rtcm_getbytes(src, pos, out, len);
+      for (uint32_t i = 0; i < len; i++) {
+        assert(out[i] == rtcm_getbitu(src, pos + 8 * i, 8));
+      }
+      assert(0xa5 == out[len]);
+
+      /* writing matches the bit at a time setter, including the bits either
+       * side of the run */
+      uint8_t expected[64];
+      uint8_t actual[64];
+      memset(expected, 0x5a, sizeof(expected));
+      memset(actual, 0x5a, sizeof(actual));
+      for (uint32_t i = 0; i < len; i++) {
+        rtcm_setbitu(expected, pos + 8 * i, 8, src[i]);
+      }
+      rtcm_setbytes(actual, pos, src, len);
+      assert(0 == memcmp(expected, actual, sizeof(actual)));
+    }
+  }
+}
+
+void test_sbp_tunnel(void) {
+  rtcm_msg_swift_proprietary msg;
+  msg.msg_type = 0x0102;
+  msg.sender_id = 0x4242;
+  msg.len = 200;
+  for (uint8_t i = 0; i < msg.len; ++i) {
+    msg.data[i] = rand();
+  }
+
+  /* the same frame as encoding the struct and framing it */
+  uint8_t expected[RTCM3_SBP_MAX_FRAME_LEN];
+  uint16_t expected_len = rtcm3_frame_finalize(
+      expected, rtcm3_encode_4062(&msg, &expected[RTCM3_FRAME_HEADER_LEN]));
+  rtcm_msg_swift_proprietary_view sbp = {
+      msg.msg_type, msg.sender_id, msg.len, msg.data};
+  uint8_t frame[RTCM3_SBP_MAX_FRAME_LEN + 1];
+  uint16_t frame_len = rtcm3_sbp_wrap(&sbp, frame);
+  assert(frame_len == expected_len);
+  assert(0 == memcmp(frame, expected, frame_len));
+
+  /* a payload already in place is not moved */
+  uint8_t in_place[RTCM3_SBP_MAX_FRAME_LEN];
+  uint8_t *payload =
+      &in_place[RTCM3_FRAME_HEADER_LEN + RTCM3_4062_HEADER_LEN];
+  memcpy(payload, msg.data, msg.len);
+  sbp.data = payload;
+  assert(frame_len == rtcm3_sbp_wrap(&sbp, in_place));
+  assert(0 == memcmp(in_place, expected, frame_len));
+
+  /* unwrapping points back into the frame */
+  rtcm3_frame_scanner scanner;
+  rtcm3_frame_scanner_init(&scanner, frame, frame_len);
+  rtcm3_frame found;
+  assert(rtcm3_frame_scanner_next(&scanner, &found));
+  rtcm_msg_swift_proprietary_view out;
+  assert(RC_OK == rtcm3_sbp_unwrap(&found, &out));
+  assert(out.msg_type == msg.msg_type && out.sender_id == msg.sender_id &&
+         out.len == msg.len);
+  assert(out.data == &frame[RTCM3_FRAME_HEADER_LEN + RTCM3_4062_HEADER_LEN]);
+
+  /* an empty SBP payload still frames */
+  sbp.len = 0;
+  sbp.data = NULL;
+  frame_len = rtcm3_sbp_wrap(&sbp, frame);
+  assert(RTCM3_FRAME_OVERHEAD + RTCM3_4062_HEADER_LEN == frame_len);
+  assert(frame_len == rtcm3_frame_check(frame, frame_len));
+  found.payload_len = RTCM3_4062_HEADER_LEN;
+  assert(RC_OK == rtcm3_sbp_unwrap(&found, &out) && 0 == out.len);
+
+  /* the SBP length has to match the frame */
+  found.payload_len = RTCM3_4062_HEADER_LEN + 1;
+  assert(RC_INVALID_MESSAGE == rtcm3_sbp_unwrap(&found, &out));
+  found.payload_len = RTCM3_4062_HEADER_LEN - 1;
+  assert(RC_INVALID_MESSAGE == rtcm3_sbp_unwrap(&found, &out));
+
+  /* so do the reserved bits and the message number */
+  found.payload_len = RTCM3_4062_HEADER_LEN;
+  rtcm_setbitu(&frame[RTCM3_FRAME_HEADER_LEN], 12, 4, 3);
+  assert(RC_INVALID_MESSAGE == rtcm3_sbp_unwrap(&found, &out));
+  found.msg_num = 1005;
+  assert(RC_MESSAGE_TYPE_MISMATCH == rtcm3_sbp_unwrap(&found, &out));
+}
+
+#define STATION_TEST_UPDATES 100000
+
+typedef struct {
+  const rtcm3_station_registry *registry;
+  uint32_t stop;
+  uint32_t reads;
+} station_test_reader;
+
+/* every copy has to be one of the two positions with its own height */
+static void *station_test_read(void *arg) {
+  station_test_reader *reader = arg;
+  do {
+    rtcm3_station_info info;
+    if (rtcm3_station_registry_get(reader->registry, 9, &info)) {
+      double x = info.arp.msg_1005.arp_x;
+      assert((x == 1000.0 && info.arp.ant_height == 1.0) ||
+             (x == 2000.0 && info.arp.ant_height == 2.0));
+      reader->reads++;
+    }
+  } while (!__atomic_load_n(&reader->stop, __ATOMIC_ACQUIRE));
+  return NULL;
+}
+
+void test_station_registry(void) {
+  static rtcm3_station_registry registry;
+  rtcm3_station_registry_init(&registry);
+
+  rtcm_msg_1006 msg_1006;
+  memset(&msg_1006, 0, sizeof(msg_1006));
+  msg_1006.msg_1005.stn_id = 7;
+  msg_1006.msg_1005.GPS_ind = 1;
+  msg_1006.msg_1005.arp_x = 3578346.5475;
+  msg_1006.msg_1005.arp_y = -5578346.5578;
+  msg_1006.msg_1005.arp_z = 2578346.6757;
+  msg_1006.ant_height = 1.5;
+  uint8_t buff_1006[64];
+  uint16_t len_1006 = rtcm3_encode_1006(&msg_1006, buff_1006);
+  rtcm_msg_1006 decoded_1006;
+  assert(RC_OK == rtcm3_decode_1006(buff_1006, &decoded_1006));
+
+  rtcm3_station_info info;
+  assert(!rtcm3_station_registry_get(&registry, 7, &info));
+  assert(!rtcm3_station_registry_get(&registry, 5000, &info));
+
+  /* repeats of the same payload are not decoded again */
+  bool is_new = false;
+  assert(RC_OK == rtcm3_station_registry_update(
+                      &registry, buff_1006, len_1006, &is_new));
+  assert(is_new);
+  assert(RC_OK == rtcm3_station_registry_update(
+                      &registry, buff_1006, len_1006, &is_new));
+  assert(!is_new);
+  assert(1 == registry.decoded && 1 == registry.duplicates);
+  assert(rtcm3_station_registry_get(&registry, 7, &info));
+  assert((RTCM3_STATION_ARP | RTCM3_STATION_ARP_HEIGHT) == info.have);
+  assert(msg1006_equals(&decoded_1006, &info.arp));
+
+  /* a 1005 moves the position and keeps the height */
+  rtcm_msg_1005 msg_1005 = msg_1006.msg_1005;
+  msg_1005.arp_x += 10.0;
+  uint8_t buff_1005[64];
+  uint16_t len_1005 = rtcm3_encode_1005(&msg_1005, buff_1005);
+  assert(RC_OK == rtcm3_station_registry_update(
+                      &registry, buff_1005, len_1005, &is_new));
+  assert(is_new);
+  assert(rtcm3_station_registry_get(&registry, 7, &info));
+  assert(fabs(info.arp.msg_1005.arp_x - msg_1005.arp_x) < 1e-3);
+  assert(info.arp.ant_height == decoded_1006.ant_height);
+
+  /* after which the unchanged 1006 is new content again */
+  assert(RC_OK == rtcm3_station_registry_update(
+                      &registry, buff_1006, len_1006, &is_new));
+  assert(is_new);
+  assert(rtcm3_station_registry_get(&registry, 7, &info));
+  assert(msg1006_equals(&decoded_1006, &info.arp));
+
+  /* antenna, receiver and GLO biases of the same station */
+  rtcm_msg_1008 msg_1008;
+  memset(&msg_1008, 0, sizeof(msg_1008));
+  msg_1008.msg_1007.stn_id = 7;
+  msg_1008.msg_1007.ant_descriptor_counter = 5;
+  strncpy(msg_1008.msg_1007.ant_descriptor, "hello", RTCM_MAX_STRING_LEN);
+  msg_1008.ant_serial_num_counter = 3;
+  strncpy(msg_1008.ant_serial_num, "777", RTCM_MAX_STRING_LEN);
+  rtcm_msg_1033 msg_1033;
+  memset(&msg_1033, 0, sizeof(msg_1033));
+  msg_1033.stn_id = 7;
+  msg_1033.rcv_descriptor_counter = 9;
+  strncpy(msg_1033.rcv_descriptor, "LEI - IGS", RTCM_MAX_STRING_LEN);
+  rtcm_msg_1230 msg_1230;
+  memset(&msg_1230, 0, sizeof(msg_1230));
+  msg_1230.stn_id = 7;
+  msg_1230.fdma_signal_mask = 0x0F;
+  msg_1230.L1_CA_cpb_meter = 35.32;
+  uint8_t buff[1024];
+  uint16_t len = rtcm3_encode_1008(&msg_1008, buff);
+  assert(RC_OK ==
+         rtcm3_station_registry_update(&registry, buff, len, &is_new));
+  len = rtcm3_encode_1033(&msg_1033, buff);
+  assert(RC_OK ==
+         rtcm3_station_registry_update(&registry, buff, len, &is_new));
+  len = rtcm3_encode_1230(&msg_1230, buff);
+  assert(RC_OK ==
+         rtcm3_station_registry_update(&registry, buff, len, &is_new));
+  assert(rtcm3_station_registry_get(&registry, 7, &info));
+  assert(0x3F == info.have);
+  assert(msg1008_equals(&msg_1008, &info.antenna));
+  assert(msg1033_equals(&msg_1033, &info.descriptors));
+  assert(fabs(info.glo_biases.L1_CA_cpb_meter - 35.32) < 0.02);
+  assert(!rtcm3_station_registry_get(&registry, 8, &info));
+
+  /* a matching hash alone is not taken for a repeat, the payload is
+   * compared too */
+  len = rtcm3_encode_1033(&msg_1033, buff);
+  assert(RC_OK ==
+         rtcm3_station_registry_update(&registry, buff, len, &is_new));
+  assert(!is_new);
+  memset(registry.stations[7].payloads, 0, RTCM3_STATION_PAYLOAD_BYTES);
+  assert(RC_OK ==
+         rtcm3_station_registry_update(&registry, buff, len, &is_new));
+  assert(is_new);
+
+  /* longest 1033 there is, anything longer is no valid 1033 */
+  memset(&msg_1033, 'x', sizeof(msg_1033));
+  msg_1033.stn_id = 7;
+  msg_1033.ant_descriptor_counter = RTCM_MAX_STRING_LEN - 1;
+  msg_1033.ant_serial_num_counter = RTCM_MAX_STRING_LEN - 1;
+  msg_1033.rcv_descriptor_counter = RTCM_MAX_STRING_LEN - 1;
+  msg_1033.rcv_fw_version_counter = RTCM_MAX_STRING_LEN - 1;
+  msg_1033.rcv_serial_num_counter = RTCM_MAX_STRING_LEN - 1;
+  len = rtcm3_encode_1033(&msg_1033, buff);
+  assert(RC_OK ==
+         rtcm3_station_registry_update(&registry, buff, len, &is_new));
+  assert(rtcm3_station_registry_get(&registry, 7, &info));
+  assert(msg1033_equals(&msg_1033, &info.descriptors));
+  assert(RC_INVALID_MESSAGE ==
+         rtcm3_station_registry_update(&registry, buff, len + 1, &is_new));
+
+  len = rtcm3_encode_1029(&(rtcm_msg_1029){0}, buff);
+  assert(RC_MESSAGE_TYPE_MISMATCH ==
+         rtcm3_station_registry_update(&registry, buff, len, &is_new));
+  assert(RC_INVALID_MESSAGE ==
+         rtcm3_station_registry_update(&registry, buff, 2, &is_new));
+
+  /* readers on another thread never see a half written update */
+  uint8_t positions[2][64];
+  uint16_t position_len[2];
+  for (uint8_t i = 0; i < 2; i++) {
+    msg_1006.msg_1005.stn_id = 9;
+    msg_1006.msg_1005.arp_x = 1000.0 * (i + 1);
+    msg_1006.ant_height = i + 1;
+    position_len[i] = rtcm3_encode_1006(&msg_1006, positions[i]);
+  }
+  station_test_reader reader = {&registry, 0, 0};
+  pthread_t thread;
+  assert(pthread_create(&thread, NULL, station_test_read, &reader) == 0);
+  for (uint32_t i = 0; i < STATION_TEST_UPDATES; i++) {
+    assert(RC_OK == rtcm3_station_registry_update(&registry,
+                                                  positions[i % 2],
+                                                  position_len[i % 2],
+                                                  &is_new));
+    assert(is_new);
+  }
+  __atomic_store_n(&reader.stop, 1, __ATOMIC_RELEASE);
+  assert(pthread_join(thread, NULL) == 0);
+  assert(reader.reads > 0);
+}
+
+/* an MSM with one L1 C/A cell for each of satellites 3, 5 and 9 */
+static uint16_t write_test_glo_msm(uint16_t msg_num,
+                                   const uint8_t fcn[3],
+                                   uint8_t buff[]) {
+  rtcm_msm_message msm;
+  memset(&msm, 0, sizeof(msm));
+  msm.header.msg_num = msg_num;
+  msm.header.tow_ms = 49800;
+  msm.header.satellite_mask[2] = true;
+  msm.header.satellite_mask[4] = true;
+  msm.header.satellite_mask[8] = true;
+  msm.header.signal_mask[1] = true;
+  for (uint8_t i = 0; i < 3; i++) {
+    msm.header.cell_mask[i] = true;
+    msm.sats[i].rough_range_ms = 70 + i;
+    msm.sats[i].glo_fcn = fcn[i];
+    msm.signals[i].pseudorange_ms = msm.sats[i].rough_range_ms;
+    msm.signals[i].flags.valid_pr = 1;
+  }
+  if (1084 == msg_num || 1074 == msg_num) {
+    return rtcm3_encode_msm4(&msm, buff);
+  }
+  return rtcm3_encode_msm5(&msm, buff);
+}
+
+void test_glo_fcn(void) {
+  rtcm3_glo_fcn_table table;
+  rtcm3_glo_fcn_table_init(&table);
+  assert(MSM_GLO_FCN_UNKNOWN == rtcm3_glo_fcn_get(&table, 3));
+  assert(0 == table.l1_wavelength_m[2]);
+  assert(!rtcm3_glo_fcn_set(&table, 0, 7));
+  assert(!rtcm3_glo_fcn_set(&table, RTCM3_GLO_FCN_MAX_SATS + 1, 7));
+  assert(!rtcm3_glo_fcn_set(&table, 3, MSM_GLO_MAX_FCN + 1));
+
+  /* from a GLONASS ephemeris, channel +1 */
+  rtcm_msg_eph eph;
+  memset(&eph, 0, sizeof(eph));
+  eph.constellation = RTCM_CONSTELLATION_GLO;
+  eph.sat_id = 3;
+  eph.glo.fcn = 8;
+  rtcm3_glo_fcn_from_eph(&table, &eph);
+  eph.constellation = RTCM_CONSTELLATION_GPS;
+  eph.sat_id = 4;
+  rtcm3_glo_fcn_from_eph(&table, &eph);
+  assert(8 == rtcm3_glo_fcn_get(&table, 3));
+  assert(MSM_GLO_FCN_UNKNOWN == rtcm3_glo_fcn_get(&table, 4));
+  assert(fabs(table.l1_wavelength_m[2] -
+              GPS_C / (GLO_L1_HZ + GLO_L1_DELTA_HZ)) < 1e-12);
+  assert(fabs(table.l2_wavelength_m[2] -
+              GPS_C / (GLO_L2_HZ + GLO_L2_DELTA_HZ)) < 1e-12);
+
+  /* from 1012 observations, DF040 beyond the channels in use is skipped */
+  rtcm_obs_message obs;
+  memset(&obs, 0, sizeof(obs));
+  obs.header.msg_num = 1012;
+  obs.header.n_sat = 2;
+  obs.sats[0].svId = 5;
+  obs.sats[0].fcn = 2;
+  obs.sats[1].svId = 6;
+  obs.sats[1].fcn = MT1012_GLO_MAX_FCN;
+  rtcm3_glo_fcn_from_obs(&table, &obs);
+  obs.header.msg_num = 1004;
+  obs.sats[1].fcn = 1;
+  rtcm3_glo_fcn_from_obs(&table, &obs);
+  assert(2 == rtcm3_glo_fcn_get(&table, 5));
+  assert(MSM_GLO_FCN_UNKNOWN == rtcm3_glo_fcn_get(&table, 6));
+
+  /* MSM4 is filled in from the table */
+  uint8_t buff[1024];
+  rtcm3_msg msg;
+  const uint8_t no_fcn[3] = {0, 0, 0};
+  write_test_glo_msm(1084, no_fcn, buff);
+  assert(RC_OK == rtcm3_glo_fcn_decode_msg(&table, buff, &msg));
+  assert(8 == msg.msm.sats[0].glo_fcn && 2 == msg.msm.sats[1].glo_fcn &&
+         MSM_GLO_FCN_UNKNOWN == msg.msm.sats[2].glo_fcn);
+
+  /* MSM5 teaches the table, an invalid FCN in it is resolved too */
+  const uint8_t msm5_fcn[3] = {8, 15, 10};
+  write_test_glo_msm(1085, msm5_fcn, buff);
+  assert(RC_OK == rtcm3_glo_fcn_decode_msg(&table, buff, &msg));
+  assert(8 == msg.msm.sats[0].glo_fcn && 2 == msg.msm.sats[1].glo_fcn &&
+         10 == msg.msm.sats[2].glo_fcn);
+  assert(10 == rtcm3_glo_fcn_get(&table, 9));
+
+  write_test_glo_msm(1084, no_fcn, buff);
+  assert(RC_OK == rtcm3_glo_fcn_decode_msg(&table, buff, &msg));
+  assert(10 == msg.msm.sats[2].glo_fcn);
+
+  /* other constellations are left alone */
+  write_test_glo_msm(1074, no_fcn, buff);
+  assert(RC_OK == rtcm3_glo_fcn_decode_msg(&table, buff, &msg));
+  assert(0 == msg.msm.sats[0].glo_fcn);
+}
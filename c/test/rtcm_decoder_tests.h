@@ -37,6 +37,33 @@ static void test_rtcm_random_bits(void);
 static void test_msm_bit_utils(void);
 static void test_lock_time_decoding(void);
 static void test_logging(void);
+static void test_timing(void);
+static void test_frame(void);
+static void test_frame_scanner(void);
+static void test_archive(void);
+static void test_parallel_scan(void);
+static void test_stream_framer(void);
+static void test_rings(void);
+static void test_pipeline(void);
+static void test_decode_batch(void);
+static void test_frame_iov(void);
+static void test_encoded_size(void);
+static void test_patch(void);
+static void test_msm_epoch(void);
+static void test_eph_store(void);
+static void test_eph_encode(void);
+static void test_eph_cache(void);
+static void test_kepler(void);
+static void test_glo_orbit(void);
+static void test_ssr_store(void);
+static void test_ssr_visit(void);
+static void test_ssr_encode(void);
+static void test_ssr_hr_clock(void);
+static void test_ssr_apply(void);
+static void test_bytes(void);
+static void test_sbp_tunnel(void);
+static void test_station_registry(void);
+static void test_glo_fcn(void);
 
 bool msgobs_equals(const rtcm_obs_message *msg_in,
                    const rtcm_obs_message *msg_out);
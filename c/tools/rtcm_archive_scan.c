@@ -0,0 +1,180 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Walk a recorded RTCM archive in place and report what it contains
+ *
+ *   rtcm_archive_scan [--decode] [--threads N] FILE
+ *
+ * The file is memory mapped and the frames are handed to the batch decoder
+ * as views into the mapping, nothing is copied. The chunks of the file are
+ * scanned on N threads, all online CPUs by default. Prints the frame count
+ * per message type, the framing errors and the throughput.
+ */
+
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "rtcm3/archive.h"
+#include "rtcm3/dispatch.h"
+#include "rtcm3/frame.h"
+#include "rtcm3/parallel.h"
+
+#define SCAN_NUM_MSG_NUMS 4096
+
+typedef struct {
+  uint64_t counts[SCAN_NUM_MSG_NUMS];
+  uint64_t decode_errors;
+  /* frames are views into the mapping, decoded a block at a time */
+  rtcm3_frame frames[RTCM3_DECODE_BATCH_BLOCK];
+  uint16_t num_frames;
+  rtcm3_msg msgs[RTCM3_DECODE_BATCH_BLOCK];
+  rtcm3_rc rcs[RTCM3_DECODE_BATCH_BLOCK];
+} scan_slot;
+
+typedef struct {
+  bool decode;
+  scan_slot *slots;
+  uint64_t counts[SCAN_NUM_MSG_NUMS];
+  uint64_t decode_errors;
+} scan_context;
+
+/* Message types without a decoder are only counted */
+static void decode_frames(scan_slot *state) {
+  rtcm3_decode_batch(
+      state->frames, state->num_frames, state->msgs, state->rcs);
+  for (uint16_t i = 0; i < state->num_frames; i++) {
+    if (RC_INVALID_MESSAGE == state->rcs[i]) {
+      state->decode_errors++;
+    }
+  }
+  state->num_frames = 0;
+}
+
+static void on_frame(const rtcm3_frame *frame, unsigned slot, void *context) {
+  scan_context *ctx = context;
+  scan_slot *state = &ctx->slots[slot];
+  state->counts[frame->msg_num]++;
+  if (ctx->decode) {
+    state->frames[state->num_frames++] = *frame;
+    if (RTCM3_DECODE_BATCH_BLOCK == state->num_frames) {
+      decode_frames(state);
+    }
+  }
+}
+
+/* chunks are delivered in order, so only one thread merges at a time */
+static void on_chunk(size_t chunk, unsigned slot, void *context) {
+  (void)chunk;
+  scan_context *ctx = context;
+  scan_slot *state = &ctx->slots[slot];
+  decode_frames(state);
+  for (uint16_t i = 0; i < SCAN_NUM_MSG_NUMS; i++) {
+    ctx->counts[i] += state->counts[i];
+    state->counts[i] = 0;
+  }
+  ctx->decode_errors += state->decode_errors;
+  state->decode_errors = 0;
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr, "usage: %s [--decode] [--threads N] FILE\n", argv0);
+}
+
+int main(int argc, char *argv[]) {
+  static const struct option long_options[] = {
+      {"decode", no_argument, NULL, 'd'},
+      {"threads", required_argument, NULL, 'j'},
+      {NULL, 0, NULL, 0},
+  };
+  static scan_context ctx;
+  rtcm3_parallel_config config;
+  memset(&config, 0, sizeof(config));
+  config.ordered = true;
+  config.on_frame = on_frame;
+  config.on_chunk = on_chunk;
+  config.context = &ctx;
+
+  int opt;
+  while ((opt = getopt_long(argc, argv, "dj:", long_options, NULL)) != -1) {
+    switch (opt) {
+      case 'd':
+        ctx.decode = true;
+        break;
+      case 'j':
+        config.num_threads = (unsigned)strtoul(optarg, NULL, 0);
+        break;
+      default:
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+  if (optind + 1 != argc) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  rtcm3_archive archive;
+  int err = rtcm3_archive_open(&archive, argv[optind]);
+  if (0 != err) {
+    fprintf(stderr, "%s: %s\n", argv[optind], strerror(err));
+    return EXIT_FAILURE;
+  }
+  unsigned num_slots =
+      RTCM3_PARALLEL_NUM_SLOTS(rtcm3_parallel_num_threads(&config));
+  ctx.slots = calloc(num_slots, sizeof(scan_slot));
+  if (NULL == ctx.slots) {
+    fprintf(stderr, "out of memory\n");
+    return EXIT_FAILURE;
+  }
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  rtcm3_parallel_stats stats;
+  err = rtcm3_parallel_scan(archive.data, archive.len, &config, &stats);
+  if (0 != err) {
+    fprintf(stderr, "scan failed: %s\n", strerror(err));
+    return EXIT_FAILURE;
+  }
+
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double elapsed_s = (double)(end.tv_sec - start.tv_sec) +
+                     (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+
+  for (uint16_t i = 0; i < SCAN_NUM_MSG_NUMS; i++) {
+    if (ctx.counts[i] > 0) {
+      printf("%4u %llu\n", i, (unsigned long long)ctx.counts[i]);
+    }
+  }
+  fprintf(stderr,
+          "%llu frames, %llu CRC errors, %llu bytes skipped, "
+          "%llu decode errors\n",
+          (unsigned long long)stats.num_frames,
+          (unsigned long long)stats.num_crc_errors,
+          (unsigned long long)stats.skipped_bytes,
+          (unsigned long long)ctx.decode_errors);
+  fprintf(stderr,
+          "%zu bytes in %.3f s on %u threads (%.1f MB/s)\n",
+          archive.len,
+          elapsed_s,
+          stats.num_threads,
+          (double)archive.len / 1e6 / (elapsed_s > 0 ? elapsed_s : 1e-9));
+
+  free(ctx.slots);
+  rtcm3_archive_close(&archive);
+  return 0 == ctx.decode_errors ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,695 @@
+/*
+ * Copyright (C) 2019 Swift Navigation Inc.
+ * Contact: Swift Navigation <dev@swiftnav.com>
+ *
+ * This source is subject to the license found in the file 'LICENSE' which must
+ * be distributed together with this source. All other rights reserved.
+ *
+ * THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF ANY KIND,
+ * EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A PARTICULAR PURPOSE.
+ */
+
+/* Synthetic RTCM v3 corpus generator
+ *
+ * Writes a framed, CRC'd stream for a network of reference stations. Every
+ * epoch each station sends one MSM4 or MSM5 message per constellation, GPS
+ * and GLONASS legacy observables (1004/1012) when requested, and one GPS
+ * ephemeris (1019) per second. The station description (1005/1033) is
+ * repeated every GEN_STATION_INFO_PERIOD_S seconds.
+ *
+ * The output only depends on the options and the seed. The observations are
+ * fully re-encoded every --refresh epochs, in between the previous payloads
+ * are re-stamped with the new epoch time, which is what lets large corpora be
+ * written at memory speed.
+ */
+
+#include <getopt.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "rtcm3/bits.h"
+#include "rtcm3/constants.h"
+#include "rtcm3/encode.h"
+#include "rtcm3/eph_encode.h"
+#include "rtcm3/frame.h"
+#include "rtcm3/messages.h"
+
+#define GEN_MAX_STATIONS 4096
+#define GEN_NUM_CONSTELLATIONS 5
+#define GEN_MAX_SIGNALS 4
+#define GEN_MAX_SATS 16
+/* one MSM per constellation plus 1004 and 1012 */
+#define GEN_MAX_OBS_MESSAGES (GEN_NUM_CONSTELLATIONS + 2)
+#define GEN_OUTPUT_BUFFER_SIZE (16 * 1024 * 1024)
+#define GEN_STATION_INFO_PERIOD_S 10
+#define GEN_WEEK_MS (7 * 24 * 3600 * 1000)
+#define GEN_DAY_MS (24 * 3600 * 1000)
+/* probability in percent that a cell is missing from the cell mask */
+#define GEN_CELL_DROPOUT_PERCENT 4
+
+typedef struct {
+  const char *name;
+  rtcm_constellation_t constellation;
+  uint16_t msm_base; /* MSM1 message number minus one */
+  uint8_t max_sats;  /* size of the used part of the satellite mask */
+  uint8_t min_visible;
+  uint8_t max_visible;
+  uint8_t signals[GEN_MAX_SIGNALS]; /* signal mask positions, 0 based */
+} gen_constellation;
+
+/* signals in order of how commonly they are tracked */
+static const gen_constellation constellations_[GEN_NUM_CONSTELLATIONS] = {
+    {"gps", RTCM_CONSTELLATION_GPS, 1070, 32, 8, 12, {1, 14, 21, 2}},
+    {"glo", RTCM_CONSTELLATION_GLO, 1080, 24, 6, 9, {1, 7, 2, 8}},
+    {"gal", RTCM_CONSTELLATION_GAL, 1090, 36, 6, 10, {1, 21, 13, 7}},
+    {"bds", RTCM_CONSTELLATION_BDS, 1120, 37, 6, 12, {1, 13, 7, 21}},
+    {"qzs", RTCM_CONSTELLATION_QZS, 1110, 10, 1, 3, {1, 14, 21, 8}},
+};
+
+typedef enum {
+  GEN_TOW_NONE,    /* message without an epoch time */
+  GEN_TOW_30BIT,   /* 30 bit time of week */
+  GEN_TOW_GLO_MSM, /* 3 bit day of week and 27 bit time of day */
+  GEN_TOW_GLO_TOD  /* 27 bit time of day */
+} gen_tow_format;
+
+typedef struct {
+  uint8_t prn_index;
+  uint8_t fcn;
+  double range_m;
+  double rate_m_s;
+  double cnr;
+  uint32_t lock_epochs;
+} gen_sat;
+
+typedef struct {
+  uint8_t payload[RTCM3_MAX_PAYLOAD_LEN];
+  uint16_t len;
+  gen_tow_format tow_format;
+} gen_template;
+
+typedef struct {
+  uint16_t stn_id;
+  uint8_t msm_type;
+  uint8_t num_sats[GEN_NUM_CONSTELLATIONS];
+  gen_sat sats[GEN_NUM_CONSTELLATIONS][GEN_MAX_SATS];
+  gen_template info[2];
+  gen_template obs[GEN_MAX_OBS_MESSAGES];
+  uint8_t num_obs;
+  uint8_t next_eph;
+} gen_station;
+
+typedef struct {
+  uint16_t stations;
+  uint8_t constellations;
+  uint8_t signals;
+  double rate_hz;
+  double duration_s;
+  uint64_t seed;
+  uint32_t refresh;
+  uint8_t msm; /* 4, 5 or 0 for a mix of both */
+  bool legacy;
+  const char *output;
+} gen_options;
+
+typedef struct {
+  FILE *file;
+  uint8_t *buff;
+  size_t used;
+  uint64_t total_bytes;
+  uint64_t total_frames;
+} gen_writer;
+
+static uint64_t prng_state_;
+
+/* xorshift64* */
+static uint64_t prng_next(void) {
+  prng_state_ ^= prng_state_ >> 12;
+  prng_state_ ^= prng_state_ << 25;
+  prng_state_ ^= prng_state_ >> 27;
+  return prng_state_ * 0x2545F4914F6CDD1DULL;
+}
+
+static uint32_t prng_range(uint32_t max) {
+  return (uint32_t)(prng_next() % max);
+}
+
+static double prng_uniform(double low, double high) {
+  return low + (high - low) * (double)(prng_next() >> 11) / 9007199254740992.0;
+}
+
+/* Output */
+
+static void writer_flush(gen_writer *writer) {
+  if (writer->used > 0 &&
+      fwrite(writer->buff, 1, writer->used, writer->file) != writer->used) {
+    perror("write");
+    exit(EXIT_FAILURE);
+  }
+  writer->used = 0;
+}
+
+/* Space for one frame at the end of the output buffer */
+static uint8_t *writer_reserve(gen_writer *writer) {
+  if (writer->used + RTCM3_MAX_FRAME_LEN > GEN_OUTPUT_BUFFER_SIZE) {
+    writer_flush(writer);
+  }
+  return &writer->buff[writer->used];
+}
+
+static void writer_commit(gen_writer *writer, uint16_t frame_len) {
+  writer->used += frame_len;
+  writer->total_bytes += frame_len;
+  writer->total_frames++;
+}
+
+/* Frame a payload that has been encoded in place after writer_reserve */
+static void emit_encoded(gen_writer *writer, uint16_t payload_len) {
+  if (0 == payload_len) {
+    fprintf(stderr, "encoding failed\n");
+    exit(EXIT_FAILURE);
+  }
+  uint8_t *frame = &writer->buff[writer->used];
+  writer_commit(writer, rtcm3_frame_finalize(frame, payload_len));
+}
+
+static void emit_template(gen_writer *writer,
+                          const gen_template *tmpl,
+                          uint32_t tow_ms) {
+  uint8_t *frame = writer_reserve(writer);
+  uint8_t *payload = &frame[RTCM3_FRAME_HEADER_LEN];
+  memcpy(payload, tmpl->payload, tmpl->len);
+  switch (tmpl->tow_format) {
+    case GEN_TOW_NONE:
+      break;
+    case GEN_TOW_30BIT:
+      rtcm_setbitu(payload, 24, 30, tow_ms);
+      break;
+    case GEN_TOW_GLO_MSM:
+      rtcm_setbitu(payload, 24, 3, tow_ms / GEN_DAY_MS);
+      rtcm_setbitu(payload, 27, 27, tow_ms % GEN_DAY_MS);
+      break;
+    case GEN_TOW_GLO_TOD:
+      rtcm_setbitu(payload, 24, 27, tow_ms % GEN_DAY_MS);
+      break;
+    default:
+      break;
+  }
+  writer_commit(writer, rtcm3_frame_finalize(frame, tmpl->len));
+}
+
+/* Store the payload that was just encoded in place so that it can be re-sent
+ * with a new epoch time */
+static void save_template(gen_writer *writer,
+                          gen_template *tmpl,
+                          uint16_t payload_len,
+                          gen_tow_format tow_format) {
+  if (0 == payload_len) {
+    fprintf(stderr, "encoding failed\n");
+    exit(EXIT_FAILURE);
+  }
+  const uint8_t *frame = &writer->buff[writer->used];
+  memcpy(tmpl->payload, &frame[RTCM3_FRAME_HEADER_LEN], payload_len);
+  tmpl->len = payload_len;
+  tmpl->tow_format = tow_format;
+}
+
+/* Station setup */
+
+static void make_string(char str[], uint8_t *len, const char *prefix) {
+  *len = (uint8_t)snprintf(str,
+                           RTCM_MAX_STRING_LEN,
+                           "%s%08X",
+                           prefix,
+                           (uint32_t)prng_range(UINT32_MAX));
+}
+
+static void init_station(gen_station *station,
+                         uint16_t index,
+                         const gen_options *options,
+                         gen_writer *writer) {
+  memset(station, 0, sizeof(*station));
+  station->stn_id = index;
+  station->msm_type = options->msm != 0 ? options->msm : (index % 2 ? 5 : 4);
+
+  uint8_t max_sats = MSM_MAX_CELLS / options->signals;
+  for (uint8_t c = 0; c < options->constellations; c++) {
+    const gen_constellation *cons = &constellations_[c];
+    uint8_t num_sats =
+        cons->min_visible +
+        (uint8_t)prng_range(cons->max_visible - cons->min_visible + 1);
+    if (num_sats > max_sats) {
+      num_sats = max_sats;
+    }
+    if (num_sats > GEN_MAX_SATS) {
+      num_sats = GEN_MAX_SATS;
+    }
+    station->num_sats[c] = num_sats;
+
+    /* a random set of distinct satellites, in mask order */
+    uint8_t first = (uint8_t)prng_range(cons->max_sats);
+    uint8_t step = 1 + (uint8_t)prng_range(2);
+    for (uint8_t i = 0; i < num_sats; i++) {
+      gen_sat *sat = &station->sats[c][i];
+      sat->prn_index = (uint8_t)((first + i * step) % cons->max_sats);
+      sat->fcn = (uint8_t)prng_range(MSM_GLO_MAX_FCN + 1);
+      sat->range_m = prng_uniform(20.0e6, 25.5e6);
+      sat->rate_m_s = prng_uniform(-800.0, 800.0);
+      sat->cnr = prng_uniform(32.0, 52.0);
+      sat->lock_epochs = prng_range(10000);
+    }
+    /* the satellite mask must be sorted, the cells follow its order */
+    for (uint8_t i = 1; i < num_sats; i++) {
+      for (uint8_t j = i; j > 0; j--) {
+        gen_sat *a = &station->sats[c][j - 1];
+        gen_sat *b = &station->sats[c][j];
+        if (a->prn_index < b->prn_index) {
+          break;
+        }
+        gen_sat tmp = *a;
+        *a = *b;
+        *b = tmp;
+      }
+    }
+  }
+
+  /* the station description never changes, encode it once */
+  rtcm_msg_1005 msg_1005;
+  memset(&msg_1005, 0, sizeof(msg_1005));
+  msg_1005.stn_id = station->stn_id;
+  msg_1005.GPS_ind = 1;
+  msg_1005.GLO_ind = options->constellations > 1;
+  msg_1005.GAL_ind = options->constellations > 2;
+  msg_1005.ref_stn_ind = 1;
+  msg_1005.arp_x = round(prng_uniform(-6.4e6, 6.4e6) * 1e4) / 1e4;
+  msg_1005.arp_y = round(prng_uniform(-6.4e6, 6.4e6) * 1e4) / 1e4;
+  msg_1005.arp_z = round(prng_uniform(-6.4e6, 6.4e6) * 1e4) / 1e4;
+  uint8_t *frame = writer_reserve(writer);
+  save_template(writer,
+                &station->info[0],
+                rtcm3_encode_1005(&msg_1005, &frame[RTCM3_FRAME_HEADER_LEN]),
+                GEN_TOW_NONE);
+
+  rtcm_msg_1033 msg_1033;
+  memset(&msg_1033, 0, sizeof(msg_1033));
+  msg_1033.stn_id = station->stn_id;
+  make_string(msg_1033.ant_descriptor, &msg_1033.ant_descriptor_counter, "ANT");
+  make_string(msg_1033.ant_serial_num, &msg_1033.ant_serial_num_counter, "SN");
+  make_string(msg_1033.rcv_descriptor, &msg_1033.rcv_descriptor_counter, "RCV");
+  make_string(msg_1033.rcv_fw_version, &msg_1033.rcv_fw_version_counter, "FW");
+  make_string(msg_1033.rcv_serial_num, &msg_1033.rcv_serial_num_counter, "SN");
+  frame = writer_reserve(writer);
+  save_template(writer,
+                &station->info[1],
+                rtcm3_encode_1033(&msg_1033, &frame[RTCM3_FRAME_HEADER_LEN]),
+                GEN_TOW_NONE);
+}
+
+/* Propagate the satellite ranges by one epoch */
+static void step_station(gen_station *station,
+                         const gen_options *options,
+                         double dt_s) {
+  for (uint8_t c = 0; c < options->constellations; c++) {
+    for (uint8_t i = 0; i < station->num_sats[c]; i++) {
+      gen_sat *sat = &station->sats[c][i];
+      sat->range_m += sat->rate_m_s * dt_s;
+      sat->rate_m_s += prng_uniform(-0.05, 0.05);
+      sat->cnr += prng_uniform(-0.2, 0.2);
+      sat->cnr = fmin(fmax(sat->cnr, 25.0), 55.0);
+      sat->lock_epochs++;
+    }
+  }
+}
+
+/* Encoding */
+
+static void fill_msm(const gen_station *station,
+                     const gen_options *options,
+                     uint8_t c,
+                     uint32_t tow_ms,
+                     bool multiple,
+                     rtcm_msm_message *msg) {
+  const gen_constellation *cons = &constellations_[c];
+  rtcm_msm_header *header = &msg->header;
+  memset(header, 0, sizeof(*header));
+  header->msg_num = cons->msm_base + station->msm_type;
+  header->stn_id = station->stn_id;
+  header->tow_ms = tow_ms;
+  header->multiple = multiple;
+
+  uint8_t num_sats = station->num_sats[c];
+  for (uint8_t i = 0; i < num_sats; i++) {
+    header->satellite_mask[station->sats[c][i].prn_index] = true;
+  }
+  /* the signal mask is sorted as well, the cells follow the mask order */
+  uint8_t sig_index[GEN_MAX_SIGNALS];
+  uint8_t num_sigs = 0;
+  for (uint8_t pos = 0; pos < MSM_SIGNAL_MASK_SIZE; pos++) {
+    for (uint8_t s = 0; s < options->signals; s++) {
+      if (cons->signals[s] == pos) {
+        header->signal_mask[pos] = true;
+        sig_index[num_sigs++] = s;
+      }
+    }
+  }
+
+  double lock_scale = 1.0 / options->rate_hz;
+  uint8_t cell = 0;
+  uint8_t num_cells = 0;
+  for (uint8_t i = 0; i < num_sats; i++) {
+    const gen_sat *sat = &station->sats[c][i];
+    double range_ms = sat->range_m / PRUNIT_GPS;
+    msg->sats[i].rough_range_ms = round(range_ms * 1024) / 1024;
+    msg->sats[i].rough_range_rate_m_s = round(sat->rate_m_s);
+    msg->sats[i].glo_fcn = sat->fcn;
+    for (uint8_t s = 0; s < num_sigs; s++, cell++) {
+      /* the first signal is always tracked, the others drop out at times */
+      bool present = (0 == sig_index[s]) ||
+                     prng_range(100) >= GEN_CELL_DROPOUT_PERCENT;
+      header->cell_mask[cell] = present;
+      if (!present) {
+        continue;
+      }
+      rtcm_msm_signal_data *data = &msg->signals[num_cells++];
+      memset(data, 0, sizeof(*data));
+      /* code biases and noise between the signals */
+      data->pseudorange_ms =
+          range_ms + (sig_index[s] * 0.7 + prng_uniform(-0.3, 0.3)) /
+                         PRUNIT_GPS;
+      data->carrier_phase_ms =
+          range_ms + prng_uniform(-0.01, 0.01) / PRUNIT_GPS;
+      data->lock_time_s = sat->lock_epochs * lock_scale;
+      data->cnr = sat->cnr - sig_index[s] * 2.0;
+      data->range_rate_m_s = sat->rate_m_s + prng_uniform(-0.05, 0.05);
+      data->flags.valid_pr = 1;
+      data->flags.valid_cp = 1;
+      data->flags.valid_lock = 1;
+      data->flags.valid_cnr = 1;
+      data->flags.valid_dop = 1;
+    }
+  }
+}
+
+static void fill_obs(const gen_station *station,
+                     const gen_options *options,
+                     uint8_t c,
+                     uint32_t tow_ms,
+                     rtcm_obs_message *msg) {
+  bool glo = (RTCM_CONSTELLATION_GLO == constellations_[c].constellation);
+  memset(&msg->header, 0, sizeof(msg->header));
+  msg->header.msg_num = glo ? 1012 : 1004;
+  msg->header.stn_id = station->stn_id;
+  msg->header.tow_ms = glo ? tow_ms % GEN_DAY_MS : tow_ms;
+  msg->header.sync = 1;
+  msg->header.n_sat = station->num_sats[c];
+
+  for (uint8_t i = 0; i < station->num_sats[c]; i++) {
+    const gen_sat *sat = &station->sats[c][i];
+    rtcm_sat_data *data = &msg->sats[i];
+    memset(data, 0, sizeof(*data));
+    data->svId = sat->prn_index + 1;
+    data->fcn = sat->fcn;
+    for (uint8_t freq = 0; freq < NUM_FREQS; freq++) {
+      double freq_hz;
+      if (glo) {
+        double fcn = (double)sat->fcn - MSM_GLO_FCN_OFFSET;
+        freq_hz = (L1_FREQ == freq) ? GLO_L1_HZ + fcn * GLO_L1_DELTA_HZ
+                                    : GLO_L2_HZ + fcn * GLO_L2_DELTA_HZ;
+      } else {
+        freq_hz = (L1_FREQ == freq) ? GPS_L1_HZ : GPS_L2_HZ;
+      }
+      rtcm_freq_data *obs = &data->obs[freq];
+      obs->pseudorange = sat->range_m + freq * 0.9 + prng_uniform(-0.3, 0.3);
+      obs->carrier_phase = sat->range_m / (GPS_C / freq_hz);
+      obs->lock = sat->lock_epochs / options->rate_hz;
+      obs->cnr = sat->cnr - freq * 3.0;
+      obs->flags.valid_pr = 1;
+      obs->flags.valid_cp = 1;
+      obs->flags.valid_lock = 1;
+      obs->flags.valid_cnr = 1;
+    }
+  }
+}
+
+static void encode_observations(gen_station *station,
+                                const gen_options *options,
+                                uint32_t tow_ms,
+                                gen_writer *writer) {
+  static rtcm_msm_message msm;
+  static rtcm_obs_message obs;
+  station->num_obs = 0;
+
+  if (options->legacy) {
+    for (uint8_t c = 0; c < options->constellations && c < 2; c++) {
+      fill_obs(station, options, c, tow_ms, &obs);
+      uint8_t *frame = writer_reserve(writer);
+      uint8_t *payload = &frame[RTCM3_FRAME_HEADER_LEN];
+      uint16_t len = (0 == c) ? rtcm3_encode_1004(&obs, payload)
+                              : rtcm3_encode_1012(&obs, payload);
+      save_template(writer,
+                    &station->obs[station->num_obs++],
+                    len,
+                    (0 == c) ? GEN_TOW_30BIT : GEN_TOW_GLO_TOD);
+      emit_encoded(writer, len);
+    }
+  }
+
+  for (uint8_t c = 0; c < options->constellations; c++) {
+    bool last = (c + 1 == options->constellations);
+    fill_msm(station, options, c, tow_ms, !last, &msm);
+    uint8_t *frame = writer_reserve(writer);
+    uint8_t *payload = &frame[RTCM3_FRAME_HEADER_LEN];
+    uint16_t len = (4 == station->msm_type) ? rtcm3_encode_msm4(&msm, payload)
+                                            : rtcm3_encode_msm5(&msm, payload);
+    bool glo = (RTCM_CONSTELLATION_GLO == constellations_[c].constellation);
+    save_template(writer,
+                  &station->obs[station->num_obs++],
+                  len,
+                  glo ? GEN_TOW_GLO_MSM : GEN_TOW_30BIT);
+    emit_encoded(writer, len);
+  }
+}
+
+static void encode_ephemeris(gen_station *station,
+                             uint32_t tow_ms,
+                             gen_writer *writer) {
+  if (0 == station->num_sats[0]) {
+    return;
+  }
+  const gen_sat *sat = &station->sats[0][station->next_eph];
+  station->next_eph = (station->next_eph + 1) % station->num_sats[0];
+
+  rtcm_msg_eph eph;
+  memset(&eph, 0, sizeof(eph));
+  eph.constellation = RTCM_CONSTELLATION_GPS;
+  eph.sat_id = sat->prn_index + 1;
+  eph.wn = 2200 % 1024;
+  /* reference time at the last full two hours, in units of 16 s */
+  eph.toe = (tow_ms / 1000 / 7200 * 7200) / 16;
+  eph.ura = 2;
+  eph.fit_interval = 4;
+  ephemeris_kepler_raw_rtcm_t *kepler = &eph.kepler;
+  kepler->toc = eph.toe;
+  kepler->iode = (uint16_t)((tow_ms / 1000 / 7200) % 256);
+  kepler->iodc = kepler->iode;
+  kepler->sqrta = 2702000000u + (uint32_t)sat->prn_index * 17u;
+  kepler->ecc = 42949673u + (uint32_t)sat->prn_index * 1000u;
+  kepler->inc = 687194767 + sat->prn_index * 1024;
+  kepler->m0 = (int32_t)(sat->prn_index * 67108864u);
+  kepler->omega0 = (int32_t)(sat->prn_index * 134217728u);
+  kepler->w = -1073741824 + sat->prn_index * 2048;
+  kepler->omegadot = -21000 - sat->prn_index;
+  kepler->af0 = 1000 * sat->prn_index;
+  kepler->tgd_gps_s = -11;
+
+  uint8_t *frame = writer_reserve(writer);
+  emit_encoded(writer,
+               rtcm3_encode_gps_eph(&eph, &frame[RTCM3_FRAME_HEADER_LEN]));
+}
+
+/* Options */
+
+static void usage(const char *argv0) {
+  fprintf(stderr,
+          "usage: %s [options]\n"
+          "  -n, --stations N        number of reference stations (1)\n"
+          "  -c, --constellations M  gps, glo, gal, bds, qzs, first M (2)\n"
+          "  -k, --signals K         signals per constellation, 1-4 (2)\n"
+          "  -r, --rate HZ           epochs per second (1)\n"
+          "  -d, --duration S        length of the stream in seconds (60)\n"
+          "  -s, --seed SEED         random seed (1)\n"
+          "  -m, --msm TYPE          4, 5 or 0 for a mix of both (0)\n"
+          "  -f, --refresh N         re-encode observations every N epochs (1)\n"
+          "  -l, --legacy            also write 1004 and 1012\n"
+          "  -o, --output FILE       output file, - for stdout (-)\n",
+          argv0);
+}
+
+static bool parse_options(int argc, char *argv[], gen_options *options) {
+  static const struct option long_options[] = {
+      {"stations", required_argument, NULL, 'n'},
+      {"constellations", required_argument, NULL, 'c'},
+      {"signals", required_argument, NULL, 'k'},
+      {"rate", required_argument, NULL, 'r'},
+      {"duration", required_argument, NULL, 'd'},
+      {"seed", required_argument, NULL, 's'},
+      {"msm", required_argument, NULL, 'm'},
+      {"refresh", required_argument, NULL, 'f'},
+      {"legacy", no_argument, NULL, 'l'},
+      {"output", required_argument, NULL, 'o'},
+      {NULL, 0, NULL, 0},
+  };
+
+  options->stations = 1;
+  options->constellations = 2;
+  options->signals = 2;
+  options->rate_hz = 1.0;
+  options->duration_s = 60.0;
+  options->seed = 1;
+  options->refresh = 1;
+  options->msm = 0;
+  options->legacy = false;
+  options->output = "-";
+
+  int opt;
+  while ((opt = getopt_long(
+              argc, argv, "n:c:k:r:d:s:m:f:lo:", long_options, NULL)) != -1) {
+    switch (opt) {
+      case 'n':
+        options->stations = (uint16_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'c':
+        options->constellations = (uint8_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'k':
+        options->signals = (uint8_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'r':
+        options->rate_hz = strtod(optarg, NULL);
+        break;
+      case 'd':
+        options->duration_s = strtod(optarg, NULL);
+        break;
+      case 's':
+        options->seed = strtoull(optarg, NULL, 0);
+        break;
+      case 'm':
+        options->msm = (uint8_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'f':
+        options->refresh = (uint32_t)strtoul(optarg, NULL, 0);
+        break;
+      case 'l':
+        options->legacy = true;
+        break;
+      case 'o':
+        options->output = optarg;
+        break;
+      default:
+        return false;
+    }
+  }
+
+  return options->stations >= 1 && options->stations <= GEN_MAX_STATIONS &&
+         options->constellations >= 1 &&
+         options->constellations <= GEN_NUM_CONSTELLATIONS &&
+         options->signals >= 1 && options->signals <= GEN_MAX_SIGNALS &&
+         options->rate_hz > 0.0 && options->rate_hz <= 100.0 &&
+         options->duration_s > 0.0 && options->refresh >= 1 &&
+         (0 == options->msm || 4 == options->msm || 5 == options->msm);
+}
+
+int main(int argc, char *argv[]) {
+  gen_options options;
+  if (!parse_options(argc, argv, &options)) {
+    usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+  /* xorshift must not start from zero */
+  prng_state_ = options.seed * 0x9E3779B97F4A7C15ULL + 1;
+
+  gen_writer writer;
+  memset(&writer, 0, sizeof(writer));
+  writer.file = stdout;
+  if (0 != strcmp(options.output, "-")) {
+    writer.file = fopen(options.output, "wb");
+    if (NULL == writer.file) {
+      perror(options.output);
+      return EXIT_FAILURE;
+    }
+  }
+  /* the frames are assembled in our own buffer, so skip stdio's */
+  setvbuf(writer.file, NULL, _IONBF, 0);
+  writer.buff = malloc(GEN_OUTPUT_BUFFER_SIZE);
+  gen_station *stations = calloc(options.stations, sizeof(gen_station));
+  if (NULL == writer.buff || NULL == stations) {
+    fprintf(stderr, "out of memory\n");
+    return EXIT_FAILURE;
+  }
+
+  for (uint16_t i = 0; i < options.stations; i++) {
+    init_station(&stations[i], i, &options, &writer);
+  }
+
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+
+  double dt_s = 1.0 / options.rate_hz;
+  uint64_t num_epochs = (uint64_t)ceil(options.duration_s * options.rate_hz);
+  uint32_t epochs_per_s = (uint32_t)ceil(options.rate_hz);
+  uint32_t start_tow_ms = (uint32_t)(prng_range(7 * 24 * 3600) * 1000);
+
+  for (uint64_t epoch = 0; epoch < num_epochs; epoch++) {
+    uint32_t tow_ms =
+        (uint32_t)((start_tow_ms + (uint64_t)round(epoch * dt_s * 1000)) %
+                   GEN_WEEK_MS);
+    bool refresh = (0 == epoch % options.refresh);
+    bool new_second = (0 == epoch % epochs_per_s);
+    bool send_info =
+        (0 == epoch % ((uint64_t)epochs_per_s * GEN_STATION_INFO_PERIOD_S));
+
+    for (uint16_t i = 0; i < options.stations; i++) {
+      gen_station *station = &stations[i];
+      if (send_info) {
+        emit_template(&writer, &station->info[0], tow_ms);
+        emit_template(&writer, &station->info[1], tow_ms);
+      }
+      if (refresh) {
+        encode_observations(station, &options, tow_ms, &writer);
+      } else {
+        for (uint8_t m = 0; m < station->num_obs; m++) {
+          emit_template(&writer, &station->obs[m], tow_ms);
+        }
+      }
+      if (new_second) {
+        encode_ephemeris(station, tow_ms, &writer);
+      }
+      step_station(station, &options, dt_s);
+    }
+  }
+  writer_flush(&writer);
+
+  struct timespec end;
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double elapsed_s = (double)(end.tv_sec - start.tv_sec) +
+                     (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+  fprintf(stderr,
+          "%llu frames, %llu bytes in %.3f s (%.1f MB/s)\n",
+          (unsigned long long)writer.total_frames,
+          (unsigned long long)writer.total_bytes,
+          elapsed_s,
+          (double)writer.total_bytes / 1e6 / fmax(elapsed_s, 1e-9));
+
+  if (stdout != writer.file) {
+    fclose(writer.file);
+  }
+  free(stations);
+  free(writer.buff);
+  return EXIT_SUCCESS;
+}